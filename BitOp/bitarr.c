@@ -33,24 +33,35 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <memory.h>
-#include "bitsop.h"
 #include "bitarr.h"
 
-#define CHAR_SIZE   8
+#define BIT_WORD_INDEX(index)   ((index) / BIT_WORD_SIZE)
+#define BIT_WORD_MASK(index)    (1ULL << ((index) % BIT_WORD_SIZE))
 
 void
 init_bit_array(bit_array_t *bitarr, unsigned int n_bits){
 
-    unsigned int n_byte_blocks = n_bits/CHAR_SIZE;
+    unsigned int n_words = BIT_WORDS(n_bits);
 
-    if(n_bits % CHAR_SIZE)
-        n_byte_blocks++;
-    if(!bitarr->array)
-        bitarr->array = calloc(1, n_byte_blocks);
+    if(!bitarr->array || n_words > bitarr->n_words){
+        free(bitarr->array);
+        bitarr->array = calloc(n_words ? n_words : 1, sizeof(bit_word_t));
+        bitarr->n_words = n_words ? n_words : 1;
+    }
     else
-        memset(bitarr->array, 0, n_byte_blocks);
+        memset(bitarr->array, 0, bitarr->n_words * sizeof(bit_word_t));
     bitarr->size = n_bits;
-    bitarr->trail_bits = n_bits % CHAR_SIZE;
+    bitarr->trail_bits = n_bits % BIT_WORD_SIZE;
+}
+
+void
+free_bit_array(bit_array_t *bitarr){
+
+    free(bitarr->array);
+    bitarr->array = NULL;
+    bitarr->size = 0;
+    bitarr->n_words = 0;
+    bitarr->trail_bits = 0;
 }
 
 void
@@ -61,20 +72,7 @@ set_bit(bit_array_t *bitarr, unsigned int index){
             index, 0, bitarr->size -1);
         return;
     }
-
-    unsigned byte_block = 0,
-             residual_bit = 0;
-
-    byte_block = index / CHAR_SIZE;
-    residual_bit = index % CHAR_SIZE;
-
-#if 0    
-    assert(bitarr->size/CHAR_SIZE == byte_block && 
-        bitarr->trail_bits >= residual_bit);
-#endif
-
-    char *ptr = bitarr->array + byte_block;
-    SET_BIT((*ptr), (CHAR_SIZE - residual_bit));
+    bitarr->array[BIT_WORD_INDEX(index)] |= BIT_WORD_MASK(index);
 }
 
 void
@@ -85,86 +83,101 @@ unset_bit(bit_array_t *bitarr, unsigned int index){
             index, 0, bitarr->size -1);
         return;
     }
-
-    unsigned byte_block = 0,
-             residual_bit = 0;
-
-    byte_block = index / CHAR_SIZE;
-    residual_bit = index % CHAR_SIZE;
-
-#if 0
-    assert(bitarr->size/CHAR_SIZE == byte_block && 
-        bitarr->trail_bits >= residual_bit);
-#endif
-
-    char *ptr = bitarr->array + byte_block;
-    UNSET_BIT((*ptr), (CHAR_SIZE - residual_bit));
+    bitarr->array[BIT_WORD_INDEX(index)] &= ~BIT_WORD_MASK(index);
 }
 
 char
 is_bit_set(bit_array_t *bitarr, unsigned int index){
 
-    
     if(index >= bitarr->size){
         printf("%u is out of array bounds [%u,%u]\n", 
             index, 0, bitarr->size -1);
         return 0;
     }
-
-    unsigned byte_block = 0,
-             residual_bit = 0;
-
-    byte_block = index / CHAR_SIZE;
-    residual_bit = index % CHAR_SIZE;
-    
-#if 0
-    assert(bitarr->size/CHAR_SIZE == byte_block && 
-        bitarr->trail_bits >= residual_bit);
-#endif
-    char *ptr = bitarr->array + byte_block;
-    return (char)(IS_BIT_SET((*ptr), (CHAR_SIZE - residual_bit)));
+    return (bitarr->array[BIT_WORD_INDEX(index)] & BIT_WORD_MASK(index)) ? 1 : 0;
 }
 
 unsigned int
 get_next_available_bit(bit_array_t *bitarr){
 
-    unsigned int i = 0;
-    for(; i < bitarr->size; i++){
-        if(is_bit_set(bitarr, i))
+    unsigned int i = 0, index = 0;
+    bit_word_t word = 0;
+
+    for(; i < BIT_WORDS(bitarr->size); i++){
+        word = ~bitarr->array[i];
+        if(!word)
             continue;
-        return i;
+        index = (i * BIT_WORD_SIZE) + __builtin_ctzll(word);
+        return index < bitarr->size ? index : BIT_ARRAY_NO_BIT;
     }
-    return 0xFFFFFFFF;
+    return BIT_ARRAY_NO_BIT;
 }
 
-void
-print_bit_array(bit_array_t *bitarr){
+unsigned int
+get_next_set_bit(bit_array_t *bitarr, unsigned int from){
 
-    unsigned int i = 0, index = 0,
-                 byte_blocks = 0,
-                 residual_bits = 0;
+    unsigned int i = 0, index = 0;
+    bit_word_t word = 0;
 
-    int j = 0;
+    if(from >= bitarr->size)
+        return BIT_ARRAY_NO_BIT;
 
-    byte_blocks = bitarr->size / CHAR_SIZE;
-    residual_bits = bitarr->size % CHAR_SIZE;
-    //assert(bitarr->trail_bits >= residual_bit);
-    char *ptr = bitarr->array;
-    char byte = 0;
+    i = BIT_WORD_INDEX(from);
+    /*Mask off the bits below from in the first word*/
+    word = bitarr->array[i] & (~0ULL << (from % BIT_WORD_SIZE));
 
-    for( ; i < byte_blocks; i++){
-        byte = *(ptr+i);
-        for(j = 7; j >= 0; j--, index++){
-            printf("[%u] : %c\n", index, IS_BIT_SET(byte, j) ? '1' : '0');
+    for(;;){
+        if(word){
+            index = (i * BIT_WORD_SIZE) + __builtin_ctzll(word);
+            return index < bitarr->size ? index : BIT_ARRAY_NO_BIT;
         }
+        if(++i >= BIT_WORDS(bitarr->size))
+            break;
+        word = bitarr->array[i];
     }
+    return BIT_ARRAY_NO_BIT;
+}
 
-    if(!residual_bits)
-        return;
+void
+bit_array_and(bit_array_t *dst, bit_array_t *src){
+
+    unsigned int i = 0;
+    for(; i < BIT_WORDS(dst->size); i++)
+        dst->array[i] &= src->array[i];
+}
+
+void
+bit_array_or(bit_array_t *dst, bit_array_t *src){
+
+    unsigned int i = 0;
+    for(; i < BIT_WORDS(dst->size); i++)
+        dst->array[i] |= src->array[i];
+}
+
+void
+bit_array_and_not(bit_array_t *dst, bit_array_t *src){
+
+    unsigned int i = 0;
+    for(; i < BIT_WORDS(dst->size); i++)
+        dst->array[i] &= ~src->array[i];
+}
+
+unsigned int
+bit_array_count(bit_array_t *bitarr){
+
+    unsigned int i = 0, count = 0;
+    for(; i < BIT_WORDS(bitarr->size); i++)
+        count += __builtin_popcountll(bitarr->array[i]);
+    return count;
+}
+
+void
+print_bit_array(bit_array_t *bitarr){
+
+    unsigned int i = 0;
 
-    byte = *(ptr+i);
-    for(j = 7; j >= CHAR_SIZE - residual_bits; j--, index++){
-        printf("[%u] : %c\n", index, IS_BIT_SET(byte, j) ? '1' : '0');
+    for( ; i < bitarr->size; i++){
+        printf("[%u] : %c\n", i, is_bit_set(bitarr, i) ? '1' : '0');
     }
 }
 
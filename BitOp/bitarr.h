@@ -33,15 +33,27 @@
 #ifndef __BIT_ARRAY__
 #define __BIT_ARRAY__
 
+/*Bits are packed into 64-bit words so that set operations
+ * (and/or/andnot/popcount) process 64 members per instruction*/
+typedef unsigned long long bit_word_t;
+
+#define BIT_WORD_SIZE   64
+#define BIT_WORDS(n_bits)   (((n_bits) + BIT_WORD_SIZE - 1)/BIT_WORD_SIZE)
+#define BIT_ARRAY_NO_BIT    0xFFFFFFFF
+
 typedef struct _bit_array{
-    unsigned int size;
-    char *array;
+    unsigned int size;      /*No of bits in use*/
+    unsigned int n_words;   /*No of words allocated*/
+    bit_word_t *array;
     char trail_bits;
 } bit_array_t;
 
 void 
 init_bit_array(bit_array_t *bitarr, unsigned int size);
 
+void
+free_bit_array(bit_array_t *bitarr);
+
 void
 set_bit(bit_array_t *bitarr, unsigned int index);
 
@@ -54,4 +66,32 @@ is_bit_set(bit_array_t *bitarr, unsigned int index);
 unsigned int
 get_next_available_bit(bit_array_t *bitarr);
 
+/*Returns the index of first set bit at or after index from,
+ * BIT_ARRAY_NO_BIT if there is none*/
+unsigned int
+get_next_set_bit(bit_array_t *bitarr, unsigned int from);
+
+/*Word level set operations, dst and src must be of same size*/
+void
+bit_array_and(bit_array_t *dst, bit_array_t *src);
+
+void
+bit_array_or(bit_array_t *dst, bit_array_t *src);
+
+void
+bit_array_and_not(bit_array_t *dst, bit_array_t *src);
+
+unsigned int
+bit_array_count(bit_array_t *bitarr);
+
+void
+print_bit_array(bit_array_t *bitarr);
+
+#define ITERATE_BIT_ARRAY_SET_BITS_BEGIN(bitarr_ptr, _index)             \
+    for(_index = get_next_set_bit(bitarr_ptr, 0);                        \
+        _index != BIT_ARRAY_NO_BIT;                                      \
+        _index = get_next_set_bit(bitarr_ptr, _index + 1)){
+
+#define ITERATE_BIT_ARRAY_SET_BITS_END   }
+
 #endif /* __BIT_ARRAY__ */
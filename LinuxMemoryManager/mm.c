@@ -29,6 +29,7 @@
  */
 
 #include "mm.h"
+#include "uapi_mm.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
@@ -45,6 +46,7 @@
 static vm_page_for_families_t *first_vm_page_for_families = NULL;
 static size_t SYSTEM_PAGE_SIZE = 0;
 void *gb_hsba = NULL;
+static mm_stats_t mm_stats;
 
 void
 mm_init(){
@@ -63,28 +65,6 @@ mm_max_page_allocatable_memory(int units){
 #define MAX_PAGE_ALLOCATABLE_MEMORY(units) \
     (mm_max_page_allocatable_memory(units))
 
-static vm_page_t *
-mm_get_available_page_index(vm_page_family_t *vm_page_family){
-
-    vm_page_t *curr, *prev;
-    int page_index = -1;
-
-    if(!vm_page_family->first_page)
-        return NULL;
-
-    ITERATE_VM_PAGE_BEGIN(vm_page_family, curr){
-
-        if((int)(curr->page_index) == page_index + 1){
-            page_index++;
-            prev = curr;
-            continue;
-        }
-        return curr->prev;
-    } ITERATE_VM_PAGE_END(vm_page_family, curr)
-
-    return prev;
-}
-
 static vm_page_t *
 mm_sbrk_get_available_page_from_heap_segment(int units){
 
@@ -195,9 +175,6 @@ mm_return_vm_page_to_kernel(void *ptr, int units){
 vm_page_t *
 allocate_vm_page(vm_page_family_t *vm_page_family){
 
-    vm_page_t *prev_page = 
-        mm_get_available_page_index(vm_page_family);
-
     vm_page_t *vm_page = mm_get_new_vm_page_from_kernel(1);
     vm_page->block_meta_data.is_free = MM_TRUE;
     vm_page->block_meta_data.block_size = 
@@ -211,26 +188,21 @@ allocate_vm_page(vm_page_family_t *vm_page_family){
     vm_page->prev = NULL;
     vm_page_family->no_of_system_calls_to_alloc_dealloc_vm_pages++;
     vm_page->pg_family = vm_page_family;
-
-    if(!prev_page){
-        vm_page->page_index = 0;
-        vm_page->next = vm_page_family->first_page;
-        if(vm_page_family->first_page)
-            vm_page_family->first_page->prev = vm_page;
-        vm_page_family->first_page = vm_page;
-        return vm_page;
-    }
-
-    vm_page->next = prev_page->next;
-    vm_page->prev = prev_page;
-    if(vm_page->next)
-        vm_page->next->prev = vm_page;
-    prev_page->next = vm_page;
-    vm_page->page_index = prev_page->page_index + 1;
+    if(++mm_stats.vm_pages_in_use > mm_stats.peak_vm_pages_in_use)
+        mm_stats.peak_vm_pages_in_use = mm_stats.vm_pages_in_use;
+
+    /* New pages are added at the front of the family, searching the
+     * family for the first unused page index costs a walk over all pages
+     * of the family per new page*/
+    vm_page->page_index = vm_page_family->first_page ?
+        vm_page_family->first_page->page_index + 1 : 0;
+    vm_page->next = vm_page_family->first_page;
+    if(vm_page_family->first_page)
+        vm_page_family->first_page->prev = vm_page;
+    vm_page_family->first_page = vm_page;
     return vm_page;
 }
 
-
 void
 mm_instantiate_new_page_family(
     char *struct_name,
@@ -405,8 +377,10 @@ mm_split_free_data_block_for_allocation(
         next_block_meta_data->offset = block_meta_data->offset +
             sizeof(block_meta_data_t) + block_meta_data->block_size;
         init_glthread(&next_block_meta_data->priority_thread_glue);
-        mm_add_free_block_meta_data_to_free_block_list(
-                vm_page_family, next_block_meta_data);
+        /* Too small to satisfy any request of this family, it is not
+         * added to the free block list (it would be inserted at its tail
+         * by a walk over the whole list) and is reclaimed when its
+         * neighbour is freed*/
         mm_bind_blocks_for_allocation(block_meta_data, next_block_meta_data);
     }
 
@@ -506,6 +480,10 @@ xcalloc(char *struct_name, int units){
                             pg_family, units * pg_family->struct_size);
 
     if(free_block_meta_data){
+        mm_stats.n_allocs++;
+        mm_stats.bytes_in_use += free_block_meta_data->block_size;
+        if(mm_stats.bytes_in_use > mm_stats.peak_bytes_in_use)
+            mm_stats.peak_bytes_in_use = mm_stats.bytes_in_use;
         memset((char *)(free_block_meta_data + 1), 0, free_block_meta_data->block_size);
         return  (void *)(free_block_meta_data + 1);
     }
@@ -541,6 +519,7 @@ mm_vm_page_delete_and_free(
         vm_page->pg_family;
 
     assert(vm_page_family->first_page);
+    mm_stats.vm_pages_in_use--;
 
     if(vm_page_family->first_page == vm_page){
         vm_page_family->first_page = vm_page->next;
@@ -629,9 +608,17 @@ xfree(void *app_data){
         (block_meta_data_t *)((char *)app_data - sizeof(block_meta_data_t));
     
     assert(block_meta_data->is_free == MM_FALSE);
+    mm_stats.n_frees++;
+    mm_stats.bytes_in_use -= block_meta_data->block_size;
     mm_free_blocks(block_meta_data);
 }
 
+void
+mm_get_stats(mm_stats_t *stats){
+
+    *stats = mm_stats;
+}
+
 vm_bool_t
 mm_is_vm_page_empty(vm_page_t *vm_page){
 
@@ -44,6 +44,20 @@ void mm_print_memory_usage(char *struct_name);
 void mm_print_block_usage();
 void mm_print_registered_page_families();
 
+/*Statistics of all page families, block sizes exclude the meta data*/
+typedef struct mm_stats_{
+
+    uint64_t n_allocs;              /*xcalloc() calls*/
+    uint64_t n_frees;               /*xfree() calls*/
+    uint64_t bytes_in_use;
+    uint64_t peak_bytes_in_use;
+    uint32_t vm_pages_in_use;       /*data pages*/
+    uint32_t peak_vm_pages_in_use;
+} mm_stats_t;
+
+void
+mm_get_stats(mm_stats_t *stats);
+
 /*Initialization Functions*/
 void
 mm_init();
@@ -31,14 +31,15 @@
  */
 
 #include <assert.h>
-#include <unistd.h>
 #include "advert.h"
 #include "instance.h"
 #include "spfutil.h"
-#include "Queue.h"
 #include "spftrace.h"
+#include "spfsim.h"
 #include "LinuxMemoryManager/uapi_mm.h"
 
+extern instance_t *instance;
+
 char *
 advert_id_str(ADVERT_ID_T advert_id){
 
@@ -58,18 +59,22 @@ lsp_distribution_routine(node_t *lsp_generator,
                 node_t *lsp_receiver,
                 dist_info_hdr_t *dist_info){
     
+     /*SPF runs are scheduled, and run once the distribution completes*/
      switch(dist_info->advert_id){
         case TLV128:
-                partial_spf_run(lsp_receiver, dist_info->info_dist_level);
+                spf_sched_trigger(instance, lsp_receiver, dist_info->info_dist_level,
+                    SPF_SCHED_EVENT_PREFIX);
                 break;
 
         case TLV2:
-                spf_computation(lsp_receiver, &lsp_receiver->spf_info, dist_info->info_dist_level, FULL_RUN, 0);
+                spf_sched_trigger(instance, lsp_receiver, dist_info->info_dist_level,
+                    SPF_SCHED_EVENT_TOPOLOGY);
                 break;
 
         case OVERLOAD:
                 /*Trigger full spf run if router overloads/or unoverloads*/
-                spf_computation(lsp_receiver, &lsp_receiver->spf_info, dist_info->info_dist_level, FULL_RUN, 0);
+                spf_sched_trigger(instance, lsp_receiver, dist_info->info_dist_level,
+                    SPF_SCHED_EVENT_TOPOLOGY);
                 break;  
         default:
             ; 
@@ -88,78 +93,14 @@ init_instance_traversal(instance_t * instance){
     }ITERATE_LIST_END;  
 }
 
-static void
-init_instance_lsp_distribution_traversal(instance_t * instance){
-
-    singly_ll_node_t *list_node = NULL;
-    node_t *node = NULL;
-
-    ITERATE_LIST_BEGIN(instance->instance_node_list, list_node){
-        node = (node_t *)list_node->data;
-        node->lsp_distribution_bit = 0;
-    }ITERATE_LIST_END;
-}
-
-
-/*fn to simulate LSP generation and distribution at its simplest.*/
+/*fn to simulate LSP generation and distribution : the LSP is flooded in
+ * virtual time by the simulation of the instance (spfsim.h)*/
 void
 generate_lsp(instance_t *instance, 
                   node_t *lsp_generator,
                   info_dist_fn_ptr fn_ptr, dist_info_hdr_t *dist_info){
 
-    node_t  *curr_node = NULL,
-            *nbr_node = NULL,
-            *pn_node = NULL;
-
-    edge_t *edge1 = NULL,  /*Edge connecting curr node with PN*/
-           *edge2 = NULL;  /*Edge connecting PN to its nbr*/
-
-    LEVEL level_of_info_dist = dist_info->info_dist_level,
-          level_it = LEVEL_UNKNOWN;
-
-    /*distribute the info to self*/
-    fn_ptr(lsp_generator, lsp_generator, dist_info);
-
-    /*distribute info in the network at a given level*/
-    Queue_t *q = initQ();
-
-    for(level_it = LEVEL1 ; level_it < MAX_LEVEL; level_it++){
-
-        if(!IS_LEVEL_SET(level_of_info_dist, level_it))
-            continue;
-
-        init_instance_lsp_distribution_traversal(instance);
-
-        lsp_generator->lsp_distribution_bit = 1;
-        enqueue(q, lsp_generator);
-        unsigned int propogation_delay = 0;
-
-        while(!is_queue_empty(q)){
-
-            curr_node = deque(q);
-            sleep(propogation_delay); /*Let us introduce some delay in information propogation*/
-            ITERATE_NODE_PHYSICAL_NBRS_BEGIN(curr_node, nbr_node, pn_node, edge1, 
-                                            edge2, level_it){
-
-                if(nbr_node->lsp_distribution_bit){
-                    ITERATE_NODE_PHYSICAL_NBRS_CONTINUE(curr_node, nbr_node, pn_node, level_it);
-                }
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "LSP Distribution Src : %s, Des Node : %s", 
-                        lsp_generator->node_name, nbr_node->node_name); 
-                trace(instance->traceopts, SPF_EVENTS_BIT);
-#endif
-
-                fn_ptr(lsp_generator, nbr_node, dist_info);
-                nbr_node->lsp_distribution_bit = 1;
-                enqueue(q, nbr_node);
-            }
-            ITERATE_NODE_PHYSICAL_NBRS_END(curr_node, nbr_node, pn_node, level_it);
-        }
-        assert(is_queue_empty(q));
-        reuse_q(q);
-    }
-    XFREE(q);
-    q = NULL;
+    spf_sim_originate_lsp(instance, lsp_generator, fn_ptr, dist_info);
+    spf_sim_settle(instance);
 }
 
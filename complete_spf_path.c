@@ -30,6 +30,7 @@
  * =====================================================================================
  */
 
+#include <limits.h>
 #include "routes.h"
 #include "data_plane.h"
 #include "prefix.h"
@@ -44,19 +45,21 @@
 
 extern instance_t *instance;
 extern void init_instance_traversal(instance_t * instance);
-extern boolean tilfa_is_link_pruned(edge_t *edge);
-extern boolean tilfa_is_node_pruned(node_t *node);
+extern boolean tilfa_is_link_pruned(node_t *spf_root, edge_t *edge);
+extern boolean tilfa_is_node_pruned(node_t *spf_root, node_t *node);
 extern void tilfa_clear_post_convergence_spf_path(
-            glthread_t *post_convergence_spf_path_head);
+            tilfa_info_t *tilfa_info, LEVEL level);
 
 static unsigned int spf_level_version[MAX_LEVEL] = {0, 0, 0};
 
-typedef struct tilfa_info_ tilfa_info_t;
-
 extern glthread_t *
 tilfa_get_post_convergence_spf_path_head(
         tilfa_info_t *tilfa_info, LEVEL level);
 
+extern spf_path_result_table_t *
+tilfa_get_post_convergence_spf_path_table(
+        tilfa_info_t *tilfa_info, LEVEL level);
+
 extern
 spf_path_result_t *
 TILFA_GET_SPF_PATH_RESULT(node_t *node, node_t *candidate_node,
@@ -92,20 +95,90 @@ init_spf_paths_lists(instance_t *instance, LEVEL level){
 }
 
 void
-clear_spf_predecessors(glthread_t *spf_predecessors){
+spf_path_result_table_init(spf_path_result_table_t *table, glthread_t *head){
 
-    glthread_t *curr = NULL;
+    memset(table, 0, sizeof(spf_path_result_table_t));
+    table->head = head;
+    init_glthread(head);
+}
 
-    ITERATE_GLTHREAD_BEGIN(spf_predecessors, curr){
+/*O(1) unless nodes were created since the last run*/
+void
+spf_path_result_table_reset(spf_path_result_table_t *table){
+
+    init_glthread(table->head);
+    table->n_results = 0;
+
+    if(table->max_results < instance->n_node_index){
+        free(table->results);
+        free(table->slot);
+        table->max_results = instance->n_node_index;
+        table->results = calloc(table->max_results, sizeof(spf_path_result_t));
+        table->slot = calloc(table->max_results, sizeof(unsigned int));
+        assert(table->results && table->slot);
+    }
 
-        pred_info_t *pred_info = glthread_to_pred_info(curr);
-        remove_glthread(curr);
-        XFREE(pred_info);
-    } ITERATE_GLTHREAD_END(spf_predecessors, curr);
+    table->curr_pred_chunk = table->pred_chunks;
+    if(table->curr_pred_chunk)
+        table->curr_pred_chunk->n_used = 0;
+}
+
+spf_path_result_t *
+spf_path_result_table_add(spf_path_result_table_t *table, node_t *node){
+
+    spf_path_result_t *res = NULL;
+
+    assert(node->node_index < table->max_results);
+    assert(table->n_results < table->max_results);
+
+    res = &table->results[table->n_results];
+    table->slot[node->node_index] = table->n_results++;
+
+    res->node = node;
+    init_glthread(&res->pred_db);
+    init_glthread(&res->glue);
+    glthread_add_next(table->head, &res->glue);
+    return res;
+}
+
+pred_info_t *
+spf_path_result_table_pred_info_alloc(spf_path_result_table_t *table){
+
+    spf_path_pred_chunk_t *chunk = table->curr_pred_chunk;
+    pred_info_t *pred_info = NULL;
+
+    if(!chunk || chunk->n_used == SPF_PATH_PRED_CHUNK_SIZE){
+        if(chunk && chunk->next){
+            chunk = chunk->next;
+        }
+        else{
+            chunk = calloc(1, sizeof(spf_path_pred_chunk_t));
+            assert(chunk);
+            if(table->curr_pred_chunk)
+                table->curr_pred_chunk->next = chunk;
+            else
+                table->pred_chunks = chunk;
+        }
+        chunk->n_used = 0;
+        table->curr_pred_chunk = chunk;
+    }
+
+    pred_info = &chunk->pred_info[chunk->n_used++];
+    memset(pred_info, 0, sizeof(pred_info_t));
+    init_glthread(&pred_info->glue);
+    return pred_info;
 }
 
+/*Predecessors are owned by the arena of the spf paths run which 
+ * allocated them, just drop them from the list*/
 void
-add_pred_info_to_spf_predecessors(spf_info_t *spf_info, 
+clear_spf_predecessors(glthread_t *spf_predecessors){
+
+    init_glthread(spf_predecessors);
+}
+
+void
+add_pred_info_to_spf_predecessors(spf_path_result_table_t *table, 
                                   glthread_t *spf_predecessors,
                                   node_t *pred_node,
                                   edge_end_t *oif, 
@@ -115,9 +188,18 @@ add_pred_info_to_spf_predecessors(spf_info_t *spf_info,
     glthread_t *curr = NULL;
     pred_info_t *temp = NULL;
 
-    pred_info_t *pred_info = NULL;
+    pred_info_t *pred_info = NULL, key;
+
+    key.node = pred_node;
+
+    /*Check for duplicates*/
+    ITERATE_GLTHREAD_BEGIN(spf_predecessors, curr){
+        temp = glthread_to_pred_info(curr);
+        if(pred_info_compare_fn((void *)&key, (void *)temp) == 0)
+            return;
+    } ITERATE_GLTHREAD_END(spf_predecessors, curr);
     
-    pred_info = XCALLOC(1, pred_info_t);
+    pred_info = spf_path_result_table_pred_info_alloc(table);
 
     pred_info->oif = oif;
     
@@ -126,17 +208,6 @@ add_pred_info_to_spf_predecessors(spf_info_t *spf_info,
 
     pred_info->node = pred_node;
 
-    init_glthread(&(pred_info->glue));
-
-    /*Check for duplicates*/
-    ITERATE_GLTHREAD_BEGIN(spf_predecessors, curr){
-        temp = glthread_to_pred_info(curr);
-        if(pred_info_compare_fn((void *)pred_info, (void *)temp) == 0){
-            XFREE(pred_info);
-            return;
-        }
-    } ITERATE_GLTHREAD_END(spf_predecessors, curr);
-    
     glthread_add_next(spf_predecessors, &(pred_info->glue));
 }
 
@@ -157,7 +228,6 @@ del_pred_info_from_spf_predecessors(glthread_t *spf_predecessors, node_t *pred_n
         if(pred_info_compare_fn(&pred_info, lst_pred_info))
             continue;
         remove_glthread(&(lst_pred_info->glue));
-        XFREE(lst_pred_info);
         return; 
     } ITERATE_GLTHREAD_END(spf_predecessors, curr);
     assert(0);
@@ -285,44 +355,228 @@ print_sr_tunnel_paths(glthread_t *path, void *arg){
     printf("(%s)%s (%u)", prev_gw_prefix, pred_info->node->node_name, outgoing_label);
 }
 
-static void
-construct_spf_path_recursively(node_t *spf_root, 
-                               glthread_t *spf_predecessors, 
-                               LEVEL level, 
-                               nh_type_t nh, 
-                               glthread_t *path, 
-                               spf_path_processing_fn_ptr fn_ptr, 
-                               void *fn_ptr_arg,
-                               boolean is_post_conv_path){
+#define SPF_PATH_DAG_SAT_ADD(a, b)   \
+    ((a) > ULLONG_MAX - (b) ? ULLONG_MAX : (a) + (b))
+
+#define SPF_PATH_DAG_REALLOC(ptr, n)    \
+    do{ (ptr) = realloc((ptr), (n) * sizeof(*(ptr))); assert(ptr); } while(0)
 
+int
+spf_path_dag_node_index(spf_path_dag_t *dag, node_t *node){
+
+    if(node->node_index >= dag->dag_index_alloc)
+        return -1;
+    return (int)dag->dag_index[node->node_index] - 1;
+}
+
+static unsigned int
+spf_path_dag_add_node(spf_path_dag_t *dag, node_t *node){
+
+    if(dag->n_nodes == dag->node_alloc){
+        dag->node_alloc = dag->node_alloc ? dag->node_alloc * 2 : 32;
+        SPF_PATH_DAG_REALLOC(dag->nodes, dag->node_alloc);
+        SPF_PATH_DAG_REALLOC(dag->pred_offset, dag->node_alloc + 1);
+        SPF_PATH_DAG_REALLOC(dag->order, dag->node_alloc);
+        SPF_PATH_DAG_REALLOC(dag->n_paths_to_root, dag->node_alloc);
+        SPF_PATH_DAG_REALLOC(dag->path, dag->node_alloc + 1);
+        SPF_PATH_DAG_REALLOC(dag->path_edge, dag->node_alloc + 1);
+        SPF_PATH_DAG_REALLOC(dag->path_cursor, dag->node_alloc + 1);
+    }
+    assert(node->node_index < dag->dag_index_alloc);
+    dag->dag_index[node->node_index] = dag->n_nodes + 1;
+    dag->nodes[dag->n_nodes] = node;
+    return dag->n_nodes++;
+}
+
+/* Compact the pred_db lists reachable from dst_node into the DAG, in one
+ * pass over the spf path results instead of one lookup per path edge.
+ * Returns FALSE if dst_node has no spf path result*/
+boolean
+spf_path_dag_build(spf_path_dag_t *dag, node_t *spf_root, node_t *dst_node,
+                   LEVEL level, boolean is_post_conv_path){
+
+    int j = 0;
+    unsigned int i = 0, 
+                 k = 0,
+                 e = 0,
+                 head = 0,
+                 tail = 0;
+    unsigned int *indegree = NULL;
     glthread_t *curr = NULL;
     pred_info_t *pred_info = NULL;
     spf_path_result_t *res = NULL;
 
-    ITERATE_GLTHREAD_BEGIN(spf_predecessors, curr){
+    /*Unmap the nodes of the previous build only, keeps the build O(DAG)*/
+    for(i = 0; i < dag->n_nodes; i++){
+        if(dag->nodes[i]->node_index < dag->dag_index_alloc)
+            dag->dag_index[dag->nodes[i]->node_index] = 0;
+    }
+    if(instance->n_node_index > dag->dag_index_alloc){
+        dag->dag_index = realloc(dag->dag_index, instance->n_node_index * sizeof(unsigned int));
+        assert(dag->dag_index);
+        memset(dag->dag_index + dag->dag_index_alloc, 0,
+            (instance->n_node_index - dag->dag_index_alloc) * sizeof(unsigned int));
+        dag->dag_index_alloc = instance->n_node_index;
+    }
 
-        pred_info = glthread_to_pred_info(curr);
-        pred_info_wrapper_t pred_info_wrapper;
-        pred_info_wrapper.pred_info = pred_info;
-        init_glthread(&pred_info_wrapper.glue);
-        glthread_add_next(path, &pred_info_wrapper.glue);
-        if(!is_post_conv_path){
-            res = GET_SPF_PATH_RESULT(spf_root, pred_info->node, level, nh);
+    dag->spf_root = spf_root;
+    dag->dst_node = dst_node;
+    dag->level = level;
+    dag->n_nodes = 0;
+    dag->n_edges = 0;
+
+    res = is_post_conv_path ? 
+        TILFA_GET_SPF_PATH_RESULT(spf_root, dst_node, level) :
+        GET_SPF_PATH_RESULT(spf_root, dst_node, level, IPNH);
+    if(!res)
+        return FALSE;
+
+    spf_path_dag_add_node(dag, dst_node);
+
+    for(i = 0; i < dag->n_nodes; i++){
+
+        if(i){
+            res = is_post_conv_path ? 
+                TILFA_GET_SPF_PATH_RESULT(spf_root, dag->nodes[i], level) :
+                GET_SPF_PATH_RESULT(spf_root, dag->nodes[i], level, IPNH);
+            assert(res);
         }
-        else{
-            res = TILFA_GET_SPF_PATH_RESULT(spf_root, pred_info->node, level); 
+
+        dag->pred_offset[i] = dag->n_edges;
+
+        ITERATE_GLTHREAD_BEGIN(&res->pred_db, curr){
+
+            pred_info = glthread_to_pred_info(curr);
+            j = spf_path_dag_node_index(dag, pred_info->node);
+            if(j < 0)
+                j = spf_path_dag_add_node(dag, pred_info->node);
+
+            if(dag->n_edges == dag->edge_alloc){
+                dag->edge_alloc = dag->edge_alloc ? dag->edge_alloc * 2 : 64;
+                SPF_PATH_DAG_REALLOC(dag->pred_node, dag->edge_alloc);
+                SPF_PATH_DAG_REALLOC(dag->pred_info, dag->edge_alloc);
+            }
+            dag->pred_node[dag->n_edges] = (unsigned int)j;
+            dag->pred_info[dag->n_edges] = pred_info;
+            dag->n_edges++;
+        } ITERATE_GLTHREAD_END(&res->pred_db, curr);
+    }
+    dag->pred_offset[dag->n_nodes] = dag->n_edges;
+
+    j = spf_path_dag_node_index(dag, spf_root);
+    dag->root_index = j < 0 ? dag->n_nodes : (unsigned int)j;
+
+    /*Topological order, a node comes before all its preds*/
+    indegree = dag->path_cursor;
+    memset(indegree, 0, dag->n_nodes * sizeof(unsigned int));
+    for(e = 0; e < dag->n_edges; e++)
+        indegree[dag->pred_node[e]]++;
+
+    dag->order[tail++] = 0;
+    while(head < tail){
+        i = dag->order[head++];
+        for(e = dag->pred_offset[i]; e < dag->pred_offset[i + 1]; e++){
+            if(--indegree[dag->pred_node[e]] == 0)
+                dag->order[tail++] = dag->pred_node[e];
+        }
+    }
+    assert(tail == dag->n_nodes);
+
+    for(k = dag->n_nodes; k-- > 0;){
+        i = dag->order[k];
+        dag->n_paths_to_root[i] = (i == dag->root_index) ? 1 : 0;
+        for(e = dag->pred_offset[i]; e < dag->pred_offset[i + 1]; e++){
+            dag->n_paths_to_root[i] = SPF_PATH_DAG_SAT_ADD(
+                dag->n_paths_to_root[i], dag->n_paths_to_root[dag->pred_node[e]]);
+        }
+    }
+    return TRUE;
+}
+
+void
+spf_path_dag_free(spf_path_dag_t *dag){
+
+    free(dag->nodes);
+    free(dag->pred_offset);
+    free(dag->order);
+    free(dag->dag_index);
+    free(dag->n_paths_to_root);
+    free(dag->path);
+    free(dag->path_edge);
+    free(dag->path_cursor);
+    free(dag->pred_node);
+    free(dag->pred_info);
+    memset(dag, 0, sizeof(spf_path_dag_t));
+}
+
+/* Walk the DAG depth first from dst_node, and call fn_ptr on every path
+ * reaching spf_root, in the order the pred_db lists give. The path handed
+ * to fn_ptr is the glthread of pred_info_wrapper_t from spf_root to 
+ * dst_node. Stops after max_paths paths, returns the paths walked*/
+unsigned int
+spf_path_dag_enumerate(spf_path_dag_t *dag, spf_path_processing_fn_ptr fn_ptr, 
+                       void *fn_ptr_arg, unsigned int max_paths,
+                       boolean *truncated){
+
+    unsigned int depth = 0,
+                 node = 0,
+                 e = 0,
+                 n_paths = 0;
+    glthread_t path;
+    pred_info_t dst_pred_info;
+    pred_info_wrapper_t dst_pred_info_wrapper;
+
+    if(truncated)
+        *truncated = spf_path_dag_n_paths(dag) > max_paths;
+
+    if(!dag->n_nodes || !max_paths)
+        return 0;
+
+    init_glthread(&path);
+    memset(&dst_pred_info, 0, sizeof(pred_info_t));
+    dst_pred_info.node = dag->dst_node;
+    dst_pred_info_wrapper.pred_info = &dst_pred_info;
+    init_glthread(&dst_pred_info_wrapper.glue);
+    glthread_add_next(&path, &dst_pred_info_wrapper.glue);
+
+    dag->path_cursor[0] = dag->pred_offset[0];
+
+    while(1){
+
+        node = depth ? dag->pred_node[dag->path_edge[depth - 1]] : 0;
+
+        if(dag->path_cursor[depth] < dag->pred_offset[node + 1]){
+
+            e = dag->path_cursor[depth]++;
+            dag->path_edge[depth] = e;
+            dag->path[depth].pred_info = dag->pred_info[e];
+            init_glthread(&dag->path[depth].glue);
+            glthread_add_next(&path, &dag->path[depth].glue);
+            depth++;
+            dag->path_cursor[depth] = dag->pred_offset[dag->pred_node[e]];
+            continue;
         }
-        assert(res);
 
-        construct_spf_path_recursively(spf_root, &res->pred_db, 
-                level, nh, path, fn_ptr, fn_ptr_arg, is_post_conv_path);
+        if(!depth) break;
 
-        if(pred_info->node == spf_root){
-            fn_ptr(path, fn_ptr_arg);
+        /*All paths through the pred taken at depth are done*/
+        depth--;
+        e = dag->path_edge[depth];
+        if(dag->pred_info[e]->node == dag->spf_root){
+            fn_ptr(&path, fn_ptr_arg);
             printf("\n");
+            if(++n_paths == max_paths)
+                break;
         }
-        remove_glthread(path->right);
-    } ITERATE_GLTHREAD_END(spf_predecessors, curr);
+        remove_glthread(path.right);
+    }
+    return n_paths;
+}
+
+unsigned long long
+spf_path_dag_n_paths(spf_path_dag_t *dag){
+
+    return dag->n_nodes ? dag->n_paths_to_root[0] : 0;
 }
 
 void
@@ -333,51 +587,17 @@ trace_spf_path_to_destination_node(node_t *spf_root,
                                    void *fn_ptr_arg,
                                    boolean is_post_conv_path){
 
-   nh_type_t nh;
-   glthread_t path;
-   spf_path_result_t *res = NULL;
-   pred_info_wrapper_t pred_info_wrapper;
-   pred_info_t pred_info;
-
-   init_glthread(&path);
-
-   /*Optimization - If Full spf run hasnt been run since the last
-    * time user triggered the command to display all SR tunnels, 
-    * then there is no need to recompute all tunnel paths again*/
-#if 0
-   if((spf_level_version[level] != 
-           spf_root->spf_info.spf_level_info[level].version) ||
-           !spf_level_version[level]){
+   static spf_path_dag_t dag;
+   boolean truncated = FALSE;
 
-       spf_level_version[level] = 
-           spf_root->spf_info.spf_level_info[level].version;
-    
-       if(!is_post_conv_path)
-           compute_spf_paths(spf_root, level, FULL_RUN);
-       else
-           compute_spf_paths(spf_root, level, TILFA_RUN);
-   }
-#endif
-   /*Add destination node as pred_info*/
-   memset(&pred_info, 0 , sizeof(pred_info_t));
-   pred_info.node = dst_node;
-   pred_info_wrapper.pred_info = &pred_info;
-   init_glthread(&pred_info_wrapper.glue);
-   glthread_add_next(&path, &pred_info_wrapper.glue);    
-   nh = IPNH;
-   if(!is_post_conv_path){
-       res = GET_SPF_PATH_RESULT(spf_root, dst_node, level, nh);
-   }
-   else{
-       res = TILFA_GET_SPF_PATH_RESULT(spf_root, dst_node, level);
-   }
-   if(!res){
+   if(!spf_path_dag_build(&dag, spf_root, dst_node, level, is_post_conv_path))
        return;
+
+   spf_path_dag_enumerate(&dag, fn_ptr, fn_ptr_arg, SPF_PATH_ENUMERATION_LIMIT, &truncated);
+   if(truncated){
+       printf("Info : %s to %s : %llu spf paths, first %u shown\n", spf_root->node_name,
+           dst_node->node_name, spf_path_dag_n_paths(&dag), SPF_PATH_ENUMERATION_LIMIT);
    }
-   glthread_t *spf_predecessors = &res->pred_db;
-   construct_spf_path_recursively(spf_root, spf_predecessors, 
-                                    level, nh, &path, fn_ptr, fn_ptr_arg,
-                                    is_post_conv_path);
 }
 
 sr_tunn_trace_info_t
@@ -421,14 +641,17 @@ show_sr_tunnels(node_t *spf_root, char *str_prefix){
     return reason;
 }
 
+/* Settle the candidate node : record its spf path result and relax
+ * its nbrs. Relaxation never queues a node frozen by an incremental run,
+ * such nodes are settled in order by the caller*/
 static void
-run_spf_paths_dijkastra(node_t *spf_root, 
-                        LEVEL level, 
-                        candidate_tree_t *ctree,
-                        spf_type_t spf_type){
+spf_paths_settle_node(node_t *spf_root,
+                      LEVEL level,
+                      candidate_tree_t *ctree,
+                      spf_type_t spf_type,
+                      node_t *candidate_node){
 
-    node_t *candidate_node = NULL,
-    *nbr_node = NULL;
+    node_t *nbr_node = NULL;
 
     edge_t *edge = NULL; 
 
@@ -444,236 +667,216 @@ run_spf_paths_dijkastra(node_t *spf_root,
      * from IGP links*/
     nh_type_t nh = IPNH;
 
-    sprintf(instance->traceopts->b, "Node : %s : Running %s() with spf_root = %s, at %s", 
-            spf_root->node_name, __FUNCTION__, spf_root->node_name, get_str_level(level));
-    trace(instance->traceopts, DIJKSTRA_BIT);
-
-    while(!SPF_IS_CANDIDATE_TREE_EMPTY(ctree)){
-
-        /*Take the node with miminum spf_metric off the candidate tree*/
-        candidate_node = SPF_GET_CANDIDATE_TREE_TOP(ctree);
-        SPF_REMOVE_CANDIDATE_TREE_TOP(ctree);
-        candidate_node->is_node_on_heap = FALSE;
+    spf_path_result_table_t *table = spf_type == TILFA_RUN ? 
+        tilfa_get_post_convergence_spf_path_table(spf_root->tilfa_info, level) :
+        spf_root->spf_path_table[level][nh];
 
 #ifdef __ENABLE_TRACE__    
-        sprintf(instance->traceopts->b, "Node : %s : Candidate node removed : %s(spf_metric = %u)", 
-                spf_root->node_name, candidate_node->node_name, candidate_node->spf_metric[level]);
-        trace(instance->traceopts, DIJKSTRA_BIT);
+    SPF_TRACE(DIJKSTRA_BIT, "Node : %s : Candidate node removed : %s(spf_metric = %u)", 
+            spf_root->node_name, candidate_node->node_name, candidate_node->spf_metric[level]);
 #endif
-        if(candidate_node->node_type[level] != PSEUDONODE){
-            if(spf_type != TILFA_RUN){
-
-                /*copy spf path list from node to its result*/
-                res = GET_SPF_PATH_RESULT(spf_root, candidate_node, level, nh);
-                assert(!res);
-                res = XCALLOC(1, spf_path_result_t);
-                init_glthread(&res->pred_db);
-                init_glthread(&res->glue);
-                glthread_add_next(&spf_root->spf_path_result[level][nh], &res->glue);
+    if(candidate_node->node_type[level] != PSEUDONODE){
+        if(spf_type != TILFA_RUN){
+
+            /*copy spf path list from node to its result*/
+            res = GET_SPF_PATH_RESULT(spf_root, candidate_node, level, nh);
+            assert(!res);
+            res = spf_path_result_table_add(table, candidate_node);
 #ifdef __ENABLE_TRACE__
-                sprintf(instance->traceopts->b, "Node : %s : New Result Recorded for node %s for NH type : %s", 
-                        spf_root->node_name, candidate_node->node_name, nh == IPNH ? "IPNH" : "LSPNH");
-                trace(instance->traceopts, DIJKSTRA_BIT);
+            SPF_TRACE(DIJKSTRA_BIT, "Node : %s : New Result Recorded for node %s for NH type : %s", 
+                    spf_root->node_name, candidate_node->node_name, nh == IPNH ? "IPNH" : "LSPNH");
 #endif
-                res->node = candidate_node;
-                clear_spf_predecessors(&res->pred_db);
-                if(!IS_GLTHREAD_LIST_EMPTY(&candidate_node->pred_lst[level][nh])){
-                    glthread_add_next(&res->pred_db, candidate_node->pred_lst[level][nh].right);
-                    init_glthread(&candidate_node->pred_lst[level][nh]);
-                }
+            if(!IS_GLTHREAD_LIST_EMPTY(&candidate_node->pred_lst[level][nh])){
+                glthread_add_next(&res->pred_db, candidate_node->pred_lst[level][nh].right);
+                init_glthread(&candidate_node->pred_lst[level][nh]);
             }
-            else if(spf_type == TILFA_RUN){
-                res = TILFA_GET_SPF_PATH_RESULT(spf_root, candidate_node, level);
-                assert(!res);
-                res = XCALLOC(1, spf_path_result_t);
-                init_glthread(&res->pred_db);
-                init_glthread(&res->glue);
-                glthread_add_next(tilfa_get_post_convergence_spf_path_head(
-                            spf_root->tilfa_info, level), &res->glue);
+        }
+        else if(spf_type == TILFA_RUN){
+            res = TILFA_GET_SPF_PATH_RESULT(spf_root, candidate_node, level);
+            assert(!res);
+            res = spf_path_result_table_add(table, candidate_node);
 #ifdef __ENABLE_TRACE__
-                sprintf(instance->traceopts->b, "Node : %s : New Result Recorded for node %s for NH type : %s", 
-                        spf_root->node_name, candidate_node->node_name, nh == IPNH ? "IPNH" : "LSPNH");
-                trace(instance->traceopts, DIJKSTRA_BIT);
+            SPF_TRACE(DIJKSTRA_BIT, "Node : %s : New Result Recorded for node %s for NH type : %s", 
+                    spf_root->node_name, candidate_node->node_name, nh == IPNH ? "IPNH" : "LSPNH");
 #endif
-                res->node = candidate_node;
-                clear_spf_predecessors(&res->pred_db);
-                if(!IS_GLTHREAD_LIST_EMPTY(&candidate_node->pred_lst[level][nh])){
-                    glthread_add_next(&res->pred_db, candidate_node->pred_lst[level][nh].right);
-                    init_glthread(&candidate_node->pred_lst[level][nh]);
-                }
+            if(!IS_GLTHREAD_LIST_EMPTY(&candidate_node->pred_lst[level][nh])){
+                glthread_add_next(&res->pred_db, candidate_node->pred_lst[level][nh].right);
+                init_glthread(&candidate_node->pred_lst[level][nh]);
             }
-            else
-                assert(0);
         }
+        else
+            assert(0);
+    }
 
-        /*Iterare over all the nbrs of Candidate node*/
+    /*Iterare over all the nbrs of Candidate node*/
 
-        ITERATE_NODE_LOGICAL_NBRS_BEGIN(candidate_node, nbr_node, edge, level){
-            /* Two way handshake check. Nbr-ship should be two way with nbr, even if nbr is PN. Do
-             * not consider the node for SPF computation if we find 2-way nbrship is broken. */
+    ITERATE_NODE_LOGICAL_NBRS_BEGIN(candidate_node, nbr_node, edge, level){
+        /* Two way handshake check. Nbr-ship should be two way with nbr, even if nbr is PN. Do
+         * not consider the node for SPF computation if we find 2-way nbrship is broken. */
 #ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s : Exploring : Candidate Node = %s, Nbr = %s, oif = %s",
-                    spf_root->node_name, candidate_node->node_name, nbr_node->node_name, edge->from.intf_name);
-            trace(instance->traceopts, DIJKSTRA_BIT);
+        SPF_TRACE(DIJKSTRA_BIT, "Node : %s : Exploring : Candidate Node = %s, Nbr = %s, oif = %s",
+                spf_root->node_name, candidate_node->node_name, nbr_node->node_name, edge->from.intf_name);
 #endif
-            if(!is_two_way_nbrship(candidate_node, nbr_node, level) || 
-                    edge->status == 0){
-                sprintf(instance->traceopts->b, "Node : %s : Two way nbr ship failed for Candidate Node = %s, Nbr = %s",
-                        spf_root->node_name, candidate_node->node_name, nbr_node->node_name);
-                trace(instance->traceopts, DIJKSTRA_BIT);
-                continue;
-            }
+        if(!is_two_way_nbrship(candidate_node, nbr_node, level) || 
+                edge->status == 0){
+            SPF_TRACE(DIJKSTRA_BIT, "Node : %s : Two way nbr ship failed for Candidate Node = %s, Nbr = %s",
+                    spf_root->node_name, candidate_node->node_name, nbr_node->node_name);
+            continue;
+        }
 
-            if(tilfa_is_link_pruned(edge) ||
-                    tilfa_is_node_pruned(nbr_node)){
-                continue; 
-            }
+        if(tilfa_is_link_pruned(spf_root, edge) ||
+                tilfa_is_node_pruned(spf_root, nbr_node)){
+            continue; 
+        }
 
-            if((unsigned long long)candidate_node->spf_metric[level] + (IS_OVERLOADED(candidate_node, level) 
-                        ? (unsigned long long)INFINITE_METRIC : (unsigned long long)edge->metric[level]) < 
-                    (unsigned long long)nbr_node->spf_metric[level]){
+        if((unsigned long long)candidate_node->spf_metric[level] + (IS_OVERLOADED(candidate_node, level) 
+                    ? (unsigned long long)INFINITE_METRIC : (unsigned long long)edge->metric[level]) < 
+                (unsigned long long)nbr_node->spf_metric[level]){
 
 #ifdef __ENABLE_TRACE__
-                sprintf(instance->traceopts->b, "Node : %s : Candidate Node : %s, Nbr Node %s, pred DB cleared", 
-                        spf_root->node_name, candidate_node->node_name, nbr_node->node_name);
-                trace(instance->traceopts, DIJKSTRA_BIT);
+            SPF_TRACE(DIJKSTRA_BIT, "Node : %s : Candidate Node : %s, Nbr Node %s, pred DB cleared", 
+                    spf_root->node_name, candidate_node->node_name, nbr_node->node_name);
 #endif
-                clear_spf_predecessors(&nbr_node->pred_lst[level][nh]);
-                assert(IS_GLTHREAD_LIST_EMPTY(&nbr_node->pred_lst[level][nh]));
+            clear_spf_predecessors(&nbr_node->pred_lst[level][nh]);
+            assert(IS_GLTHREAD_LIST_EMPTY(&nbr_node->pred_lst[level][nh]));
 
-                if(candidate_node->node_type[level] != PSEUDONODE){
+            if(candidate_node->node_type[level] != PSEUDONODE){
 #ifdef __ENABLE_TRACE__                            
-                    sprintf(instance->traceopts->b, "Node : %s : Node = %s , predecossor Added = %s",
-                            spf_root->node_name,  nbr_node->node_name, candidate_node->node_name);
-                    trace(instance->traceopts, DIJKSTRA_BIT);
+                SPF_TRACE(DIJKSTRA_BIT, "Node : %s : Node = %s , predecossor Added = %s",
+                        spf_root->node_name,  nbr_node->node_name, candidate_node->node_name);
 #endif
-                    add_pred_info_to_spf_predecessors(&spf_root->spf_info, &nbr_node->pred_lst[level][nh], 
-                            candidate_node, &edge->from, 
-                            nbr_node->node_type[level] != PSEUDONODE ? \
-                            edge->to.prefix[level]->prefix : NULL, level);
-                }
-                else{
-                    /*copy (do not move) all predecessors of PN into nbr node*/
+                add_pred_info_to_spf_predecessors(table, &nbr_node->pred_lst[level][nh], 
+                        candidate_node, &edge->from, 
+                        nbr_node->node_type[level] != PSEUDONODE ? \
+                        edge->to.prefix[level]->prefix : NULL, level);
+            }
+            else{
+                /*copy (do not move) all predecessors of PN into nbr node*/
 #ifdef __ENABLE_TRACE__                            
-                    sprintf(instance->traceopts->b, "Node : %s : Candidate Node = %s (PN case), presecessor copied to %s",
-                            spf_root->node_name,  candidate_node->node_name, nbr_node->node_name);
-                    trace(instance->traceopts, DIJKSTRA_BIT);
+                SPF_TRACE(DIJKSTRA_BIT, "Node : %s : Candidate Node = %s (PN case), presecessor copied to %s",
+                        spf_root->node_name,  candidate_node->node_name, nbr_node->node_name);
 #endif
-                    ITERATE_GLTHREAD_BEGIN(&candidate_node->pred_lst[level][nh], curr){
+                ITERATE_GLTHREAD_BEGIN(&candidate_node->pred_lst[level][nh], curr){
 
-                        pred_info = glthread_to_pred_info(curr);  
-                        pred_info_copy = XCALLOC(1, pred_info_t);
-                        memcpy(pred_info_copy, pred_info, sizeof(pred_info_t));
+                    pred_info = glthread_to_pred_info(curr);  
+                    pred_info_copy = spf_path_result_table_pred_info_alloc(table);
+                    memcpy(pred_info_copy, pred_info, sizeof(pred_info_t));
 #ifdef __ENABLE_TRACE__                                
-                        sprintf(instance->traceopts->b, "Node : %s : Predecessor copied = %s", 
-                                spf_root->node_name, pred_info->node->node_name);
-                        trace(instance->traceopts, DIJKSTRA_BIT);
+                    SPF_TRACE(DIJKSTRA_BIT, "Node : %s : Predecessor copied = %s", 
+                            spf_root->node_name, pred_info->node->node_name);
 #endif
-                        init_glthread(&pred_info_copy->glue);
-                        strncpy(pred_info_copy->gw_prefix, edge->to.prefix[level]->prefix, PREFIX_LEN);
-                        glthread_add_next(&nbr_node->pred_lst[level][nh], &pred_info_copy->glue);   
-                    } ITERATE_GLTHREAD_END(&candidate_node->pred_lst[level][nh], curr);
-                }
-
-                nbr_node->spf_metric[level] =  IS_OVERLOADED(candidate_node, level) ? 
-                    INFINITE_METRIC : candidate_node->spf_metric[level] + edge->metric[level]; 
+                    init_glthread(&pred_info_copy->glue);
+                    strncpy(pred_info_copy->gw_prefix, edge->to.prefix[level]->prefix, PREFIX_LEN);
+                    glthread_add_next(&nbr_node->pred_lst[level][nh], &pred_info_copy->glue);   
+                } ITERATE_GLTHREAD_END(&candidate_node->pred_lst[level][nh], curr);
+            }
+
+            nbr_node->spf_metric[level] =  IS_OVERLOADED(candidate_node, level) ? 
+                INFINITE_METRIC : candidate_node->spf_metric[level] + edge->metric[level]; 
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Node = %s metric improved to = %u",
-                        spf_root->node_name,  nbr_node->node_name, nbr_node->spf_metric[level]);
-                trace(instance->traceopts, DIJKSTRA_BIT);
+            SPF_TRACE(DIJKSTRA_BIT, "Node : %s : Node = %s metric improved to = %u",
+                    spf_root->node_name,  nbr_node->node_name, nbr_node->spf_metric[level]);
 #endif
 
-                if(nbr_node->is_node_on_heap == FALSE){
-                    SPF_INSERT_NODE_INTO_CANDIDATE_TREE(ctree, nbr_node, level);
+            if(nbr_node->is_node_on_heap == FALSE){
+                SPF_INSERT_NODE_INTO_CANDIDATE_TREE(ctree, nbr_node, level);
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : Node %s Added to Candidate tree", 
-                            spf_root->node_name, nbr_node->node_name);
-                    trace(instance->traceopts, DIJKSTRA_BIT);
+                SPF_TRACE(DIJKSTRA_BIT, "Node : %s : Node %s Added to Candidate tree", 
+                        spf_root->node_name, nbr_node->node_name);
 #endif
-                    nbr_node->is_node_on_heap = TRUE;
-                }
-                else{
-                    /* We should remove the node and then add again into candidate tree*/
-                    SPF_CANDIDATE_TREE_NODE_REFRESH(ctree, nbr_node, level);
-                }
+                nbr_node->is_node_on_heap = TRUE;
             }
+            else{
+                /* We should remove the node and then add again into candidate tree*/
+                SPF_CANDIDATE_TREE_NODE_REFRESH(ctree, nbr_node, level);
+            }
+        }
 
-            else if((unsigned long long)candidate_node->spf_metric[level] + (IS_OVERLOADED(candidate_node, level) 
-                        ? (unsigned long long)INFINITE_METRIC : (unsigned long long)edge->metric[level]) == 
-                    (unsigned long long)nbr_node->spf_metric[level]){
+        else if((unsigned long long)candidate_node->spf_metric[level] + (IS_OVERLOADED(candidate_node, level) 
+                    ? (unsigned long long)INFINITE_METRIC : (unsigned long long)edge->metric[level]) == 
+                (unsigned long long)nbr_node->spf_metric[level]){
 
-                if(candidate_node->node_type[level] != PSEUDONODE){
+            if(candidate_node->node_type[level] != PSEUDONODE){
 #ifdef __ENABLE_TRACE__                        
-                    sprintf(instance->traceopts->b, "Node : %s : Node = %s , predecossor Added = %s",
-                            spf_root->node_name,  nbr_node->node_name, candidate_node->node_name);
-                    trace(instance->traceopts, DIJKSTRA_BIT);
+                SPF_TRACE(DIJKSTRA_BIT, "Node : %s : Node = %s , predecossor Added = %s",
+                        spf_root->node_name,  nbr_node->node_name, candidate_node->node_name);
 #endif
-                    add_pred_info_to_spf_predecessors(&spf_root->spf_info, &nbr_node->pred_lst[level][nh], 
-                            candidate_node, &edge->from, 
-                            nbr_node->node_type[level] != PSEUDONODE ? \
-                            edge->to.prefix[level]->prefix : NULL, level); 
-                }
-                else{
-                    /*copy (do not move) all predecessors of PN into nbr node*/
+                add_pred_info_to_spf_predecessors(table, &nbr_node->pred_lst[level][nh], 
+                        candidate_node, &edge->from, 
+                        nbr_node->node_type[level] != PSEUDONODE ? \
+                        edge->to.prefix[level]->prefix : NULL, level); 
+            }
+            else{
+                /*copy (do not move) all predecessors of PN into nbr node*/
 #ifdef __ENABLE_TRACE__                            
-                    sprintf(instance->traceopts->b, "Node : %s : Candidate Node = %s (PN case), presecessor copied to %s",
-                            spf_root->node_name,  candidate_node->node_name, nbr_node->node_name);
-                    trace(instance->traceopts, DIJKSTRA_BIT);
+                SPF_TRACE(DIJKSTRA_BIT, "Node : %s : Candidate Node = %s (PN case), presecessor copied to %s",
+                        spf_root->node_name,  candidate_node->node_name, nbr_node->node_name);
 #endif
 
-                    ITERATE_GLTHREAD_BEGIN(&candidate_node->pred_lst[level][nh], curr){
+                ITERATE_GLTHREAD_BEGIN(&candidate_node->pred_lst[level][nh], curr){
 
-                        pred_info = glthread_to_pred_info(curr);  
-                        pred_info_copy = XCALLOC(1, pred_info_t);
-                        memcpy(pred_info_copy, pred_info, sizeof(pred_info_t));
+                    pred_info = glthread_to_pred_info(curr);  
+                    pred_info_copy = spf_path_result_table_pred_info_alloc(table);
+                    memcpy(pred_info_copy, pred_info, sizeof(pred_info_t));
 #ifdef __ENABLE_TRACE__                                
-                        sprintf(instance->traceopts->b, "Node : %s : Predecessor copied = %s", 
-                                spf_root->node_name, pred_info->node->node_name);
-                        trace(instance->traceopts, DIJKSTRA_BIT);
+                    SPF_TRACE(DIJKSTRA_BIT, "Node : %s : Predecessor copied = %s", 
+                            spf_root->node_name, pred_info->node->node_name);
 #endif
-                        init_glthread(&pred_info_copy->glue);
-                        strncpy(pred_info_copy->gw_prefix, edge->to.prefix[level]->prefix, PREFIX_LEN);
-                        glthread_add_next(&nbr_node->pred_lst[level][nh], &pred_info_copy->glue);   
-                    } ITERATE_GLTHREAD_END(&candidate_node->pred_lst[level][nh], curr);
-                }
-
-                if(nbr_node->is_node_on_heap == FALSE){
-                    SPF_INSERT_NODE_INTO_CANDIDATE_TREE(ctree, nbr_node, level);
+                    init_glthread(&pred_info_copy->glue);
+                    strncpy(pred_info_copy->gw_prefix, edge->to.prefix[level]->prefix, PREFIX_LEN);
+                    glthread_add_next(&nbr_node->pred_lst[level][nh], &pred_info_copy->glue);   
+                } ITERATE_GLTHREAD_END(&candidate_node->pred_lst[level][nh], curr);
+            }
+
+            if(nbr_node->is_node_on_heap == FALSE && !nbr_node->is_node_frozen){
+                SPF_INSERT_NODE_INTO_CANDIDATE_TREE(ctree, nbr_node, level);
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : Node %s Added to Candidate tree", 
-                            spf_root->node_name, nbr_node->node_name);
-                    trace(instance->traceopts, DIJKSTRA_BIT);
+                SPF_TRACE(DIJKSTRA_BIT, "Node : %s : Node %s Added to Candidate tree", 
+                        spf_root->node_name, nbr_node->node_name);
 #endif
-                    nbr_node->is_node_on_heap = TRUE;
-                }
+                nbr_node->is_node_on_heap = TRUE;
             }
         }
-        ITERATE_NODE_LOGICAL_NBRS_END;
+    }
+    ITERATE_NODE_LOGICAL_NBRS_END;
 
-        /*Delete the PN's predecessor list*/
-        if(candidate_node->node_type[level] == PSEUDONODE){
+    /*Delete the PN's predecessor list*/
+    if(candidate_node->node_type[level] == PSEUDONODE){
 #ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s : PN = %s, Clean up pred db",
-                    spf_root->node_name, candidate_node->node_name);
-            trace(instance->traceopts, DIJKSTRA_BIT); 
+        SPF_TRACE(DIJKSTRA_BIT, "Node : %s : PN = %s, Clean up pred db",
+                spf_root->node_name, candidate_node->node_name); 
 #endif
-            ITERATE_GLTHREAD_BEGIN(&candidate_node->pred_lst[level][nh], curr){
-
-                pred_info = glthread_to_pred_info(curr);
-                remove_glthread(&pred_info->glue);
-                XFREE(pred_info);
-            } ITERATE_GLTHREAD_END(&candidate_node->pred_lst[level][nh], curr);
-        }
+        clear_spf_predecessors(&candidate_node->pred_lst[level][nh]);
+    }
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Node : %s : Node = %s has been processed",
-                spf_root->node_name, candidate_node->node_name);
-        trace(instance->traceopts, DIJKSTRA_BIT);
+    SPF_TRACE(DIJKSTRA_BIT, "Node : %s : Node = %s has been processed",
+            spf_root->node_name, candidate_node->node_name);
 #endif
+}
+
+static void
+run_spf_paths_dijkastra(node_t *spf_root, 
+                        LEVEL level, 
+                        candidate_tree_t *ctree,
+                        spf_type_t spf_type){
+
+    node_t *candidate_node = NULL;
+
+    SPF_TRACE(DIJKSTRA_BIT, "Node : %s : Running %s() with spf_root = %s, at %s", 
+            spf_root->node_name, __FUNCTION__, spf_root->node_name, get_str_level(level));
+
+    while(!SPF_IS_CANDIDATE_TREE_EMPTY(ctree)){
+
+        /*Take the node with miminum spf_metric off the candidate tree*/
+        candidate_node = SPF_GET_CANDIDATE_TREE_TOP(ctree);
+        SPF_REMOVE_CANDIDATE_TREE_TOP(ctree);
+        candidate_node->is_node_on_heap = FALSE;
+
+        spf_paths_settle_node(spf_root, level, ctree, spf_type, candidate_node);
     } /* while loop ends*/
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "Node : %s : Running %s() with spf_root = %s, at %s Finished", 
+    SPF_TRACE(DIJKSTRA_BIT, "Node : %s : Running %s() with spf_root = %s, at %s Finished", 
             spf_root->node_name, __FUNCTION__, spf_root->node_name, get_str_level(level));
-    trace(instance->traceopts, DIJKSTRA_BIT);
 #endif
 }
 
@@ -681,25 +884,15 @@ void
 spf_clear_spf_path_result(node_t *spf_root, LEVEL level){
 
     nh_type_t nh;
-    glthread_t *curr = NULL, *curr1= NULL;
-    spf_path_result_t *spf_path_result = NULL;
-    pred_info_t *pred_info = NULL;
 
     ITERATE_NH_TYPE_BEGIN(nh){
 
-        ITERATE_GLTHREAD_BEGIN(&spf_root->spf_path_result[level][nh], curr){
-
-            spf_path_result = glthread_to_spf_path_result(curr);        
-            ITERATE_GLTHREAD_BEGIN(&spf_path_result->pred_db, curr1){
-
-                pred_info = glthread_to_pred_info(curr1);
-                remove_glthread(&pred_info->glue);
-                XFREE(pred_info);
-            } ITERATE_GLTHREAD_END(&spf_path_result->pred_db, curr1);
-            remove_glthread(&spf_path_result->glue);
-            XFREE(spf_path_result);
-        } ITERATE_GLTHREAD_END(&spf_root->spf_path_result[level][nh], curr);
-        init_glthread(&spf_root->spf_path_result[level][nh]);
+        if(!spf_root->spf_path_table[level][nh]){
+            spf_root->spf_path_table[level][nh] = XCALLOC(1, spf_path_result_table_t);
+            spf_path_result_table_init(spf_root->spf_path_table[level][nh],
+                &spf_root->spf_path_result[level][nh]);
+        }
+        spf_path_result_table_reset(spf_root->spf_path_table[level][nh]);
     }ITERATE_NH_TYPE_END;
 }
 
@@ -715,8 +908,7 @@ compute_spf_paths(node_t *spf_root, LEVEL level, spf_type_t spf_type){
         spf_clear_spf_path_result(spf_root, level);
     }
     else{
-        tilfa_clear_post_convergence_spf_path(
-            tilfa_get_post_convergence_spf_path_head(spf_root->tilfa_info, level));
+        tilfa_clear_post_convergence_spf_path(spf_root->tilfa_info, level);
     }
     
     SPF_RE_INIT_CANDIDATE_TREE(&instance->ctree);
@@ -727,6 +919,10 @@ compute_spf_paths(node_t *spf_root, LEVEL level, spf_type_t spf_type){
     spf_root->spf_metric[level] = 0;
     spf_root->lsp_metric[level] = 0;
 
+    /* Predecessor lists may still link predecessors left over from the
+     * arena of another run, drop them before this run relaxes any node*/
+    clear_spf_predecessors(&spf_root->pred_lst[level][IPNH]);
+
     Queue_t *q = initQ();
     init_instance_traversal(instance);
     spf_root->traversing_bit = 1;
@@ -743,6 +939,7 @@ compute_spf_paths(node_t *spf_root, LEVEL level, spf_type_t spf_type){
 
             nbr_node->spf_metric[level] = INFINITE_METRIC;
             nbr_node->lsp_metric[level] = INFINITE_METRIC;
+            clear_spf_predecessors(&nbr_node->pred_lst[level][IPNH]);
 
             nbr_node->traversing_bit = 1;
             enqueue(q, nbr_node);
@@ -755,3 +952,29 @@ compute_spf_paths(node_t *spf_root, LEVEL level, spf_type_t spf_type){
     q = NULL;
     SPF_RE_INIT_CANDIDATE_TREE(&instance->ctree);
 }
+
+/* Incremental post-convergence spf paths run. The caller has set the final
+ * metric on the nodes unaffected by the pruned resources, frozen them and
+ * passed them in settle order, and has reset the affected nodes to infinite
+ * metric. Frozen nodes are settled in that order without the candidate tree,
+ * which rebuilds their predecessors and leaves only the affected nodes
+ * reached from them on the candidate tree*/
+void
+compute_spf_paths_incremental(node_t *spf_root, LEVEL level,
+                              node_t **settled, unsigned int n_settled){
+
+    unsigned int i = 0;
+
+    tilfa_clear_post_convergence_spf_path(spf_root->tilfa_info, level);
+
+    SPF_RE_INIT_CANDIDATE_TREE(&instance->ctree);
+
+    for(i = 0; i < n_settled; i++){
+        assert(settled[i]->is_node_frozen);
+        spf_paths_settle_node(spf_root, level, &instance->ctree, 
+                              TILFA_RUN, settled[i]);
+    }
+
+    run_spf_paths_dijkastra(spf_root, level, &instance->ctree, TILFA_RUN);
+    SPF_RE_INIT_CANDIDATE_TREE(&instance->ctree);
+}
@@ -57,6 +57,57 @@ typedef struct spf_path_result_t_{
 
 GLTHREAD_TO_STRUCT(glthread_to_spf_path_result, spf_path_result_t, glue);
 
+/* Results of one spf paths run of a root, kept in the list at head for
+ * iteration and indexed by node->node_index for lookup. Results and all
+ * predecessors of the run are carved out of the table arenas, which are
+ * rewound, not freed, when the next run starts*/
+#define SPF_PATH_PRED_CHUNK_SIZE    128
+
+typedef struct spf_path_pred_chunk_{
+
+    struct spf_path_pred_chunk_ *next;
+    unsigned int n_used;
+    pred_info_t pred_info[SPF_PATH_PRED_CHUNK_SIZE];
+} spf_path_pred_chunk_t;
+
+struct spf_path_result_table_{
+
+    glthread_t *head;
+
+    spf_path_result_t *results;     /*in the order nodes are settled*/
+    unsigned int n_results;
+    unsigned int max_results;
+    unsigned int *slot;             /*slot[node_index] : index into results*/
+
+    spf_path_pred_chunk_t *pred_chunks;
+    spf_path_pred_chunk_t *curr_pred_chunk;
+};
+
+void
+spf_path_result_table_init(spf_path_result_table_t *table, glthread_t *head);
+
+void
+spf_path_result_table_reset(spf_path_result_table_t *table);
+
+spf_path_result_t *
+spf_path_result_table_add(spf_path_result_table_t *table, node_t *node);
+
+pred_info_t *
+spf_path_result_table_pred_info_alloc(spf_path_result_table_t *table);
+
+static inline spf_path_result_t *
+spf_path_result_table_lookup(spf_path_result_table_t *table, node_t *node){
+
+    unsigned int i;
+
+    if(!table || node->node_index >= table->max_results)
+        return NULL;
+    i = table->slot[node->node_index];
+    if(i < table->n_results && table->results[i].node == node)
+        return &table->results[i];
+    return NULL;
+}
+
 /*API to construct the SPF path from spf_root to dst_node*/
 
 typedef struct pred_info_wrapper_t_{
@@ -108,7 +159,7 @@ clear_spf_predecessors(glthread_t *spf_predecessors);
 typedef struct _glthread glthread_t;
 
 void
-add_pred_info_to_spf_predecessors(spf_info_t *spf_info, 
+add_pred_info_to_spf_predecessors(spf_path_result_table_t *table, 
                            glthread_t *spf_predecessors, 
                            node_t *pred_node, 
                            edge_end_t *oif, char *gw_prefix,
@@ -132,6 +183,60 @@ void
 union_spf_predecessorss(glthread_t *spf_predecessors1,
                      glthread_t *spf_predecessors2);
 
+/*Upper bound of spf paths enumerated to one destination*/
+#define SPF_PATH_ENUMERATION_LIMIT  4096
+
+/* Predecessor DAG of all spf paths from spf_root to dst_node, compacted
+ * into arrays. Node 0 is dst_node. Pred edges of node i are
+ * [pred_offset[i], pred_offset[i + 1]) in pred_db order, edge e leads
+ * to node pred_node[e] over pred_info[e]. dag_index maps node->node_index
+ * to the DAG index plus one, 0 if the node is not in the DAG*/
+typedef struct spf_path_dag_{
+
+    node_t *spf_root;
+    node_t *dst_node;
+    LEVEL level;
+    unsigned int root_index;
+
+    unsigned int n_nodes;
+    unsigned int node_alloc;
+    node_t **nodes;
+    unsigned int *pred_offset;
+    unsigned int *order;                     /*a node comes before its preds*/
+    unsigned int *dag_index;
+    unsigned int dag_index_alloc;
+    unsigned long long *n_paths_to_root;     /*saturating*/
+
+    unsigned int n_edges;
+    unsigned int edge_alloc;
+    unsigned int *pred_node;
+    pred_info_t **pred_info;
+
+    pred_info_wrapper_t *path;               /*enumeration stack*/
+    unsigned int *path_edge;
+    unsigned int *path_cursor;
+} spf_path_dag_t;
+
+boolean
+spf_path_dag_build(spf_path_dag_t *dag, node_t *spf_root, node_t *dst_node,
+                   LEVEL level, boolean is_post_conv_path);
+
+void
+spf_path_dag_free(spf_path_dag_t *dag);
+
+/*Sets *truncated if more than max_paths paths exist*/
+unsigned int
+spf_path_dag_enumerate(spf_path_dag_t *dag, spf_path_processing_fn_ptr fn_ptr, 
+                       void *fn_ptr_arg, unsigned int max_paths,
+                       boolean *truncated);
+
+/*Index of node in the DAG, -1 if no spf path goes through it*/
+int
+spf_path_dag_node_index(spf_path_dag_t *dag, node_t *node);
+
+unsigned long long
+spf_path_dag_n_paths(spf_path_dag_t *dag);
+
 void
 trace_spf_path_to_destination_node(node_t *spf_root, node_t *dst_node, LEVEL level, 
                 spf_path_processing_fn_ptr fn_ptr, void *fn_ptr_arg, boolean is_post_conv_path);
@@ -142,20 +247,16 @@ show_sr_tunnels(node_t *spf_root, char *prefix);
 static inline spf_path_result_t *
 GET_SPF_PATH_RESULT(node_t *node, node_t *node2, LEVEL level, nh_type_t nh){
 
-    glthread_t *curr = NULL;
-    ITERATE_GLTHREAD_BEGIN(&node->spf_path_result[level][nh], curr){
-
-        spf_path_result_t *spf_path_result = glthread_to_spf_path_result(curr);
-        if(spf_path_result->node == node2){
-            return spf_path_result; 
-        }
-    } ITERATE_GLTHREAD_END(&node->spf_path_result[level][nh], curr);
-    return NULL;
+    return spf_path_result_table_lookup(node->spf_path_table[level][nh], node2);
 }
 
 void
 compute_spf_paths(node_t *spf_root, LEVEL level, spf_type_t spf_type);
 
+void
+compute_spf_paths_incremental(node_t *spf_root, LEVEL level,
+                              node_t **settled, unsigned int n_settled);
+
 void
 spf_clear_spf_path_result(node_t *spf_root, LEVEL level);
 
@@ -116,7 +116,7 @@ is_un_nh_t_clones(internal_un_nh_t *nh1, internal_un_nh_t *nh2){
     if(nh1->flags != nh2->flags)
         return FALSE;
 
-    if(nh1->protected_link != nh1->protected_link)
+    if(nh1->protected_link != nh2->protected_link)
         return FALSE;
 
     if(nh1->lfa_type != nh2->lfa_type)
@@ -153,7 +153,7 @@ is_inet_3_un_nh_t_equal(internal_un_nh_t *nh1, internal_un_nh_t *nh2){
     if(strncmp(nh1->gw_prefix, nh2->gw_prefix, PREFIX_LEN))
         return FALSE;
 
-    if(memcmp(&nh1->nh.inet3_nh, &nh2->nh.inet3_nh, sizeof(internal_un_nh_t)))
+    if(memcmp(&nh1->nh.inet3_nh, &nh2->nh.inet3_nh, sizeof(struct inet_3_nh_t)))
         return FALSE;
 
     return TRUE;
@@ -169,7 +169,7 @@ is_mpls_0_un_nh_t_equal(internal_un_nh_t *nh1, internal_un_nh_t *nh2){
     if(strncmp(nh1->gw_prefix, nh2->gw_prefix, PREFIX_LEN))
         return FALSE;
 
-    if(memcmp(&nh1->nh.mpls0_nh, &nh2->nh.mpls0_nh, sizeof(internal_un_nh_t)))
+    if(memcmp(&nh1->nh.mpls0_nh, &nh2->nh.mpls0_nh, sizeof(struct mpls_0_nh_t)))
         return FALSE;
 
     return TRUE;
@@ -185,26 +185,320 @@ malloc_un_nexthop(){
     return XCALLOC(1, internal_un_nh_t);
 }
 
+/*Next-hop groups*/
+
+static unsigned int
+un_nh_t_hash(internal_un_nh_t *nh){
+
+    /*Hash the content compared by is_un_nh_t_clones()*/
+    struct {
+        PROTOCOL protocol;
+        edge_end_t *oif;
+        node_t *nh_node;
+        char gw_prefix[PREFIX_LEN + 1];
+        union u_t nh;
+        FLAG flags;
+        lfa_type_t lfa_type;
+        edge_end_t *protected_link;
+        unsigned int root_metric;
+        unsigned int dest_metric;
+    } key;
+
+    memset(&key, 0, sizeof(key));
+    key.protocol = nh->protocol;
+    key.oif = nh->oif;
+    key.nh_node = nh->nh_node;
+    strncpy(key.gw_prefix, nh->gw_prefix, PREFIX_LEN);
+    memcpy(&key.nh, &nh->nh, sizeof(key.nh));
+    key.flags = nh->flags;
+    key.lfa_type = nh->lfa_type;
+    key.protected_link = nh->protected_link;
+    key.root_metric = nh->root_metric;
+    key.dest_metric = nh->dest_metric;
+    return hash_code(&key, sizeof(key));
+}
+
+static nh_group_t *
+nh_group_malloc(){
+
+    nh_group_t *nh_group = XCALLOC(1, nh_group_t);
+    init_glthread(&nh_group->nh_list_head);
+    init_glthread(&nh_group->dep_list_head);
+    init_glthread(&nh_group->hash_glue);
+    return nh_group;
+}
+
+static void
+nh_group_free(nh_group_t *nh_group){
+
+    glthread_t *curr = NULL;
+    internal_un_nh_t *nxt_hop = NULL;
+
+    assert(!nh_group->ref_count);
+    ITERATE_GLTHREAD_BEGIN(&nh_group->nh_list_head, curr){
+        nxt_hop = glthread_to_unified_nh(curr);
+        remove_glthread(curr);
+        free_un_nexthop(nxt_hop);
+    } ITERATE_GLTHREAD_END(&nh_group->nh_list_head, curr);
+    XFREE(nh_group);
+}
+
+static void
+nh_group_add_nexthop(nh_group_t *nh_group, internal_un_nh_t *nexthop){
+
+    init_glthread(&nexthop->glthread);
+    if(IS_BIT_SET(nexthop->flags, PRIMARY_NH))
+        glthread_add_next(&nh_group->nh_list_head, &nexthop->glthread);
+    else
+        glthread_add_last(&nh_group->nh_list_head, &nexthop->glthread);
+    nh_group->nh_count++;
+}
+
+static void
+nh_group_delete_nexthop(nh_group_t *nh_group, internal_un_nh_t *nexthop){
+
+    remove_glthread(&nexthop->glthread);
+    free_un_nexthop(nexthop);
+    nh_group->nh_count--;
+}
+
+#define NH_GROUP_MAX_TRACKED_NH 63      /*Bits of rt_un_entry->refreshed_nh_mask, all ones stand for all*/
+#define NH_GROUP_ALL_NH         (~0ULL)
+
+static inline boolean
+nh_group_mask_has(unsigned long long igp_nh_mask, unsigned int pos){
+
+    if(igp_nh_mask == NH_GROUP_ALL_NH)
+        return TRUE;
+    return pos < NH_GROUP_MAX_TRACKED_NH && (igp_nh_mask & (1ULL << pos));
+}
+
+/*Returns private copy of nh_group. IGP owned nexthops are copied only if their
+ * position in the group is set in igp_nh_mask*/
+static nh_group_t *
+nh_group_clone(nh_group_t *nh_group, unsigned long long igp_nh_mask){
+
+    glthread_t *curr = NULL;
+    internal_un_nh_t *nxt_hop = NULL,
+                     *clone_nh = NULL;
+    nh_group_t *clone = nh_group_malloc();
+    unsigned int pos = 0;
+
+    ITERATE_GLTHREAD_BEGIN(&nh_group->nh_list_head, curr){
+
+        nxt_hop = glthread_to_unified_nh(curr);
+        if(IS_UN_NH_IGP_OWNED(nxt_hop) &&
+            !nh_group_mask_has(igp_nh_mask, pos++))
+            continue;
+        clone_nh = malloc_un_nexthop();
+        copy_un_next_hop_t(nxt_hop, clone_nh);
+        init_glthread(&clone_nh->glthread);
+        glthread_add_last(&clone->nh_list_head, &clone_nh->glthread);
+        clone->nh_count++;
+    } ITERATE_GLTHREAD_END(&nh_group->nh_list_head, curr);
+    return clone;
+}
+
+static unsigned int
+nh_group_hash(nh_group_t *nh_group){
+
+    glthread_t *curr = NULL;
+    unsigned int hash = 0;
+
+    /*Order independant*/
+    ITERATE_GLTHREAD_BEGIN(&nh_group->nh_list_head, curr){
+        hash += un_nh_t_hash(glthread_to_unified_nh(curr));
+    } ITERATE_GLTHREAD_END(&nh_group->nh_list_head, curr);
+    return hash;
+}
+
+/*Nexthops within a group are never clones of each other*/
+boolean
+is_nh_group_equal(nh_group_t *nh_group1, nh_group_t *nh_group2){
+
+    glthread_t *curr1 = NULL,
+               *curr2 = NULL;
+    boolean found = FALSE;
+
+    if(nh_group1 == nh_group2)
+        return TRUE;
+
+    if(nh_group1->nh_count != nh_group2->nh_count)
+        return FALSE;
+
+    ITERATE_GLTHREAD_BEGIN(&nh_group1->nh_list_head, curr1){
+
+        found = FALSE;
+        ITERATE_GLTHREAD_BEGIN(&nh_group2->nh_list_head, curr2){
+            if(is_un_nh_t_clones(glthread_to_unified_nh(curr1),
+                        glthread_to_unified_nh(curr2))){
+                found = TRUE;
+                break;
+            }
+        } ITERATE_GLTHREAD_END(&nh_group2->nh_list_head, curr2);
+        if(!found)
+            return FALSE;
+    } ITERATE_GLTHREAD_END(&nh_group1->nh_list_head, curr1);
+    return TRUE;
+}
+
+static void
+nh_group_release(rt_un_table_t *rib, nh_group_t *nh_group){
+
+    assert(nh_group->ref_count);
+    nh_group->ref_count--;
+    if(nh_group->ref_count)
+        return;
+    if(nh_group->is_interned){
+        remove_glthread(&nh_group->hash_glue);
+        rib->nh_group_count--;
+    }
+    nh_group_free(nh_group);
+}
+
+static void
+rt_un_entry_set_nh_group(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry,
+                         nh_group_t *nh_group){
+
+    nh_group_t *old_nh_group = rt_un_entry->nh_group;
+
+    if(old_nh_group == nh_group)
+        return;
+
+    if(old_nh_group){
+        remove_glthread(&rt_un_entry->nh_group_glue);
+        nh_group_release(rib, old_nh_group);
+    }
+
+    rt_un_entry->nh_group = nh_group;
+    if(nh_group){
+        nh_group->ref_count++;
+        glthread_add_next(&nh_group->dep_list_head, &rt_un_entry->nh_group_glue);
+    }
+}
+
+/*Copy on write of a route left on its interned group by rib_mark_stale() : the
+ * private copy holds nexthops not owned by IGP and the IGP nexthops refreshed by
+ * current route installation so far. The interned group is kept as old_nh_group,
+ * rib_sweep_stale() computes the delta against it*/
+static nh_group_t *
+rt_un_entry_unshare_nh_group(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry){
+
+    nh_group_t *old_nh_group = rt_un_entry->nh_group,
+               *nh_group = nh_group_clone(old_nh_group, rt_un_entry->refreshed_nh_mask);
+
+    old_nh_group->ref_count++;
+    rt_un_entry->old_nh_group = old_nh_group;
+    rt_un_entry_set_nh_group(rib, rt_un_entry, nh_group);
+    UNSET_BIT(rt_un_entry->flags, RT_UN_ENTRY_SHARED);
+    rt_un_entry->refreshed_nh_mask = 0;
+    return nh_group;
+}
+
+/*Returns the nh group of rt_un_entry which can be modified*/
+static nh_group_t *
+rt_un_entry_private_nh_group(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry){
+
+    nh_group_t *nh_group = rt_un_entry->nh_group;
+
+    if(IS_BIT_SET(rt_un_entry->flags, RT_UN_ENTRY_SHARED))
+        return rt_un_entry_unshare_nh_group(rib, rt_un_entry);
+
+    if(nh_group && !nh_group->is_interned)
+        return nh_group;
+
+    if(nh_group && nh_group->ref_count == 1){
+        /*Not shared, take it out of nh group table*/
+        remove_glthread(&nh_group->hash_glue);
+        nh_group->is_interned = FALSE;
+        rib->nh_group_count--;
+        return nh_group;
+    }
+
+    nh_group = nh_group ? nh_group_clone(nh_group, NH_GROUP_ALL_NH) : nh_group_malloc();
+    rt_un_entry_set_nh_group(rib, rt_un_entry, nh_group);
+    return nh_group;
+}
+
+/*Make the rt_un_entry share the interned group identical to its private group*/
+static void
+rt_un_entry_intern_nh_group(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry){
+
+    glthread_t *curr = NULL,
+               *bucket = NULL;
+    nh_group_t *interned_nh_group = NULL,
+               *nh_group = rt_un_entry->nh_group;
+    unsigned int hash = 0;
+
+    if(nh_group->is_interned)
+        return;
+
+    hash = nh_group_hash(nh_group);
+    bucket = &rib->nh_group_table[hash % NH_GROUP_TABLE_SIZE];
+
+    ITERATE_GLTHREAD_BEGIN(bucket, curr){
+
+        interned_nh_group = hash_glthread_to_nh_group(curr);
+        if(interned_nh_group->hash == hash &&
+            is_nh_group_equal(interned_nh_group, nh_group)){
+            rt_un_entry_set_nh_group(rib, rt_un_entry, interned_nh_group);
+            return;
+        }
+    } ITERATE_GLTHREAD_END(bucket, curr);
+
+    nh_group->hash = hash;
+    nh_group->is_interned = TRUE;
+    glthread_add_next(bucket, &nh_group->hash_glue);
+    rib->nh_group_count++;
+}
+
+static rt_un_entry_t *
+rt_un_entry_malloc(rt_un_table_t *rib, rt_key_t *rt_key, LEVEL level){
+
+    rt_un_entry_t *rt_un_entry = XCALLOC(1, rt_un_entry_t);
+    memcpy(&rt_un_entry->rt_key, rt_key, sizeof(rt_key_t));
+    time(&rt_un_entry->last_refresh_time);
+    rt_un_entry->level = level;
+    init_glthread(&rt_un_entry->nh_group_glue);
+    rt_un_entry_set_nh_group(rib, rt_un_entry, nh_group_malloc());
+    SET_BIT(rt_un_entry->flags, RT_UN_ENTRY_NEW);
+    glthread_add_next(&rib->head, &rt_un_entry->glthread);
+    rib->count++;
+    return rt_un_entry;
+}
+
+static void
+rt_un_entry_free(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry){
+
+    rt_un_entry_set_nh_group(rib, rt_un_entry, NULL);
+    if(rt_un_entry->old_nh_group)
+        nh_group_release(rib, rt_un_entry->old_nh_group);
+    remove_glthread(&rt_un_entry->glthread);
+    rib->count--;
+    XFREE(rt_un_entry);
+}
+
+/*Removes IGP owned nexthops of the route, and the route itself if no nexthops are left*/
 int
-free_rt_un_entry(rt_un_entry_t *rt_un_entry){
+free_rt_un_entry(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry){
 
     internal_un_nh_t *nxt_hop = NULL;
     glthread_t *curr = NULL;
+    nh_group_t *nh_group = rt_un_entry_private_nh_group(rib, rt_un_entry);
 
-    ITERATE_GLTHREAD_BEGIN(&rt_un_entry->nh_list_head, curr){
+    ITERATE_GLTHREAD_BEGIN(&nh_group->nh_list_head, curr){
         nxt_hop = glthread_to_unified_nh(curr);
-        if(nxt_hop->protocol == RSVP_PROTO ||
-            nxt_hop->protocol == LDP_PROTO)
+        if(!IS_UN_NH_IGP_OWNED(nxt_hop))
             continue;
-        remove_glthread(curr);
-        free_un_nexthop(nxt_hop);    
-    } ITERATE_GLTHREAD_END(&rt_un_entry->nh_list_head, curr);
+        nh_group_delete_nexthop(nh_group, nxt_hop);
+    } ITERATE_GLTHREAD_END(&nh_group->nh_list_head, curr);
     
-    if(IS_GLTHREAD_LIST_EMPTY((&rt_un_entry->glthread))){
-        remove_glthread(&rt_un_entry->glthread);
-        XFREE(rt_un_entry);
+    if(!nh_group->nh_count){
+        rt_un_entry_free(rib, rt_un_entry);
         return 0;
     }
+    if(!rib->in_batch)
+        rt_un_entry_intern_nh_group(rib, rt_un_entry);
     return -1;
 }
 
@@ -216,100 +510,169 @@ lookup_clone_next_hop(rt_un_table_t *rib,
     internal_un_nh_t *nxt_hop = NULL;
     glthread_t *curr = NULL;
 
-    ITERATE_GLTHREAD_BEGIN(&rt_un_entry->nh_list_head, curr){
+    ITERATE_GLTHREAD_BEGIN(RT_UN_ENTRY_NH_LIST(rt_un_entry), curr){
 
         nxt_hop = glthread_to_unified_nh(curr);
         if(rib->rt_un_nh_t_equal(nxt_hop, nexthop))
             return nxt_hop;
-    } ITERATE_GLTHREAD_END(&rt_un_entry->nh_list_head, curr);
+    } ITERATE_GLTHREAD_END(RT_UN_ENTRY_NH_LIST(rt_un_entry), curr);
     return NULL;
 }
 
+/* Route still on its interned group during route installation by SPF run : returns
+ * TRUE if nexthop is an IGP nexthop of the group, recorded as refreshed and freed,
+ * FALSE if the group has it already, -1 if the group has to change*/
+static int
+rt_un_entry_refresh_shared_nexthop(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry,
+                                   internal_un_nh_t *nexthop){
 
-/*Rib functions*/
-boolean
-inet_0_rt_un_route_install_nexthop(rt_un_table_t *rib, rt_key_t *rt_key, LEVEL level, 
-                            internal_un_nh_t *nexthop){
-   
     glthread_t *curr = NULL;
     internal_un_nh_t *nxt_hop = NULL;
-     
-#ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "RIB : %s : Adding route %s/%d to Routing table",
-            rib->rib_name, RT_ENTRY_PFX(rt_key), RT_ENTRY_MASK(rt_key));
-    trace(instance->traceopts, ROUTING_TABLE_BIT);
-#endif
-    
-    rt_un_entry_t *rt_un_entry = rib->rt_un_route_lookup(rib, rt_key);
-    internal_un_nh_t *existing_nh = NULL;
+    unsigned int pos = 0;
 
-    if(!rt_un_entry){
-        rt_un_entry = XCALLOC(1, rt_un_entry_t);
-        memcpy(&rt_un_entry->rt_key, rt_key, sizeof(rt_key_t));
-        time(&rt_un_entry->last_refresh_time);
-        rt_un_entry->level = level;
-        glthread_add_next(&rib->head, &rt_un_entry->glthread);
-        rib->count++;
+    ITERATE_GLTHREAD_BEGIN(RT_UN_ENTRY_NH_LIST(rt_un_entry), curr){
+
+        nxt_hop = glthread_to_unified_nh(curr);
+        if(!rib->rt_un_nh_t_equal(nxt_hop, nexthop)){
+            if(IS_UN_NH_IGP_OWNED(nxt_hop))
+                pos++;
+            continue;
+        }
+        if(!IS_UN_NH_IGP_OWNED(nxt_hop) ||
+            nh_group_mask_has(rt_un_entry->refreshed_nh_mask, pos))
+            return FALSE;
+        if(pos >= NH_GROUP_MAX_TRACKED_NH || !is_un_nh_t_clones(nxt_hop, nexthop))
+            return -1;
+        rt_un_entry->refreshed_nh_mask |= 1ULL << pos;
+        free_un_nexthop(nexthop);
+        return TRUE;
+    } ITERATE_GLTHREAD_END(RT_UN_ENTRY_NH_LIST(rt_un_entry), curr);
+    return -1;
+}
+
+/*TRUE if every IGP nexthop of the interned group of the route is refreshed*/
+static boolean
+rt_un_entry_shared_nh_group_refreshed(rt_un_entry_t *rt_un_entry){
+
+    glthread_t *curr = NULL;
+    unsigned int pos = 0;
+
+    ITERATE_GLTHREAD_BEGIN(RT_UN_ENTRY_NH_LIST(rt_un_entry), curr){
+
+        if(!IS_UN_NH_IGP_OWNED(glthread_to_unified_nh(curr)))
+            continue;
+        if(!nh_group_mask_has(rt_un_entry->refreshed_nh_mask, pos++))
+            return FALSE;
+    } ITERATE_GLTHREAD_END(RT_UN_ENTRY_NH_LIST(rt_un_entry), curr);
+    return TRUE;
+}
+
+/* Common part of rt_un_route_install_nexthop() of all RIBs. Nexthop is added to private
+ * nh group of the route. Outside of route installation by SPF run, the group is 
+ * interned immediately, otherwise it is interned by rib_sweep_stale(). During route
+ * installation, a route is copied out of its interned group on its first change only*/
+static boolean
+rt_un_entry_install_nexthop(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry, 
+                            LEVEL level, internal_un_nh_t *nexthop){
+
+    glthread_t *curr = NULL;
+    internal_un_nh_t *nxt_hop = NULL,
+                     *existing_nh = NULL;
+    nh_group_t *nh_group = NULL;
+    int rc = TRUE;
+
+    if(IS_BIT_SET(rt_un_entry->flags, RT_UN_ENTRY_SHARED) &&
+        rt_un_entry->level == level){
+        UNSET_BIT(rt_un_entry->flags, RT_UN_ENTRY_STALE);
+        if(!nexthop)
+            return TRUE;
+        time(&nexthop->last_refresh_time);
+        rc = rt_un_entry_refresh_shared_nexthop(rib, rt_un_entry, nexthop);
+        if(rc >= 0)
+            return rc;
+        rc = TRUE;
     }
 
+    nh_group = rt_un_entry_private_nh_group(rib, rt_un_entry);
+
     if(rt_un_entry->level != level){
         /*replace the route with incoming version*/
         rt_un_entry->flags = 0;
         rt_un_entry->level = level;
         time(&rt_un_entry->last_refresh_time);
         
-        ITERATE_GLTHREAD_BEGIN(&rt_un_entry->nh_list_head, curr){
+        ITERATE_GLTHREAD_BEGIN(&nh_group->nh_list_head, curr){
             nxt_hop = glthread_to_unified_nh(curr);
-            remove_glthread(curr);
-            free_un_nexthop(nxt_hop);
-        } ITERATE_GLTHREAD_END(&rt_un_entry->nh_list_head, curr);
-        
-        init_glthread(&rt_un_entry->nh_list_head);
+            nh_group_delete_nexthop(nh_group, nxt_hop);
+            rib->delta_stats[level].nh_delete++;
+        } ITERATE_GLTHREAD_END(&nh_group->nh_list_head, curr);
+        SET_BIT(rt_un_entry->flags, RT_UN_ENTRY_DIRTY);
     }
 
+    /*Route is refreshed by current installation*/
+    UNSET_BIT(rt_un_entry->flags, RT_UN_ENTRY_STALE);
+
     if(!nexthop){
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "RIB : %s : local route %s/%d added to Routing table",
-            rib->rib_name, RT_ENTRY_PFX(rt_key), RT_ENTRY_MASK(rt_key));
-        trace(instance->traceopts, ROUTING_TABLE_BIT);
+        SPF_TRACE(ROUTING_TABLE_BIT, "RIB : %s : local route %s/%d added to Routing table",
+            rib->rib_name, RT_ENTRY_PFX(&rt_un_entry->rt_key), RT_ENTRY_MASK(&rt_un_entry->rt_key));
 #endif
-        return TRUE;
+        goto done;
     }
-    
+
     /*Refresh time before adding an enntry*/
     time(&nexthop->last_refresh_time);
-
     existing_nh = lookup_clone_next_hop(rib, rt_un_entry, nexthop);
     
     if(existing_nh){
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Warning : RIB : %s : Nexthop (%s) --> (%s)%s already exists in %s/%d route",
+        SPF_TRACE(ROUTING_TABLE_BIT, "Warning : RIB : %s : Nexthop (%s) --> (%s)%s already exists in %s/%d route",
             rib->rib_name, existing_nh->oif->intf_name, existing_nh->gw_prefix, existing_nh->nh_node->node_name,
-            RT_ENTRY_PFX(rt_key), RT_ENTRY_MASK(rt_key));
-        trace(instance->traceopts, ROUTING_TABLE_BIT);
+            RT_ENTRY_PFX(&rt_un_entry->rt_key), RT_ENTRY_MASK(&rt_un_entry->rt_key));
 #endif
-        return FALSE;
+        rc = FALSE;
+        goto done;
     }
 
-    init_glthread(&nexthop->glthread);
-    if(IS_BIT_SET(nexthop->flags, PRIMARY_NH))
-        glthread_add_next(&rt_un_entry->nh_list_head, &nexthop->glthread);
-    else
-        glthread_add_last(&rt_un_entry->nh_list_head, &nexthop->glthread);
+    nh_group_add_nexthop(nh_group, nexthop);
+
+    done:
+    if(!rib->in_batch)
+        rt_un_entry_intern_nh_group(rib, rt_un_entry);
+    return rc;
+}
+
+/*Rib functions*/
+boolean
+inet_0_rt_un_route_install_nexthop(rt_un_table_t *rib, rt_key_t *rt_key, LEVEL level, 
+                            internal_un_nh_t *nexthop){
+   
+#ifdef __ENABLE_TRACE__    
+    SPF_TRACE(ROUTING_TABLE_BIT, "RIB : %s : Adding route %s/%d to Routing table",
+            rib->rib_name, RT_ENTRY_PFX(rt_key), RT_ENTRY_MASK(rt_key));
+#endif
     
-    return TRUE;
+    rt_un_entry_t *rt_un_entry = rib->rt_un_route_lookup(rib, rt_key);
+
+    if(!rt_un_entry)
+        rt_un_entry = rt_un_entry_malloc(rib, rt_key, level);
+
+    return rt_un_entry_install_nexthop(rib, rt_un_entry, level, nexthop);
 }
 
 static boolean
 inet_0_rt_un_route_install(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry){
     
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "RIB : %s : Added route %s/%d to Routing table",
+    SPF_TRACE(ROUTING_TABLE_BIT, "RIB : %s : Added route %s/%d to Routing table",
             rib->rib_name, RT_ENTRY_PFX(&rt_un_entry->rt_key), RT_ENTRY_MASK(&rt_un_entry->rt_key));
-    trace(instance->traceopts, ROUTING_TABLE_BIT);
 #endif
     /*Refresh time before adding an enntry*/
     time(&rt_un_entry->last_refresh_time);
+    if(!rt_un_entry->nh_group)
+        rt_un_entry_set_nh_group(rib, rt_un_entry, nh_group_malloc());
+    if(!rib->in_batch)
+        rt_un_entry_intern_nh_group(rib, rt_un_entry);
     glthread_add_next(&rib->head, &rt_un_entry->glthread);
     rib->count++;
     return TRUE;
@@ -345,10 +708,9 @@ inet_0_rt_un_route_update(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry){
     }
 
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "RIB : %s : Updated route %s/%d to Routing table",
+    SPF_TRACE(ROUTING_TABLE_BIT, "RIB : %s : Updated route %s/%d to Routing table",
             rib->rib_name, RT_ENTRY_PFX(&rt_un_entry->rt_key), 
             RT_ENTRY_MASK(&rt_un_entry->rt_key));
-    trace(instance->traceopts, ROUTING_TABLE_BIT);
 #endif
 
     rib->rt_un_route_delete(rib, &rt_un_entry1->rt_key);
@@ -374,16 +736,14 @@ inet_0_rt_un_route_delete(rt_un_table_t *rib, rt_key_t *rt_key){
     }
 
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "RIB : %s : Deleted route %s/%d from Routing table",
+    SPF_TRACE(ROUTING_TABLE_BIT, "RIB : %s : Deleted route %s/%d from Routing table",
             rib->rib_name, RT_ENTRY_PFX(&rt_un_entry->rt_key), RT_ENTRY_MASK(&rt_un_entry->rt_key));
-    trace(instance->traceopts, ROUTING_TABLE_BIT);
 #endif
 
     ITERATE_GLTHREAD_BEGIN(&rib->head, curr){
         temp = glthread_to_rt_un_entry(curr);
         if(UN_RTENTRY_PFX_MATCH(temp, rt_key)){
-            free_rt_un_entry(temp);
-            rib->count--;
+            free_rt_un_entry(rib, temp);
             return TRUE;
         }
     }ITERATE_GLTHREAD_END(&rib->head, curr);
@@ -392,87 +752,35 @@ inet_0_rt_un_route_delete(rt_un_table_t *rib, rt_key_t *rt_key){
 
 
 boolean
-inet_3_rt_un_route_install_nexthop(rt_un_table_t *rib, rt_key_t *rt_key, LEVEL level,
+inet_3_rt_un_route_install_nexthop(rt_un_table_t *rib, rt_key_t *rt_key, LEVEL level, 
                             internal_un_nh_t *nexthop){
    
-    glthread_t *curr = NULL;
-    internal_un_nh_t *nxt_hop = NULL;
-     
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "RIB : %s : Adding route %s/%d to Routing table",
+    SPF_TRACE(ROUTING_TABLE_BIT, "RIB : %s : Adding route %s/%d to Routing table",
             rib->rib_name, RT_ENTRY_PFX(rt_key), RT_ENTRY_MASK(rt_key));
-    trace(instance->traceopts, ROUTING_TABLE_BIT);
 #endif
-
-    rt_un_entry_t *rt_un_entry = rib->rt_un_route_lookup(rib, rt_key);
-    internal_un_nh_t *existing_nh = NULL;
-
-    if(!rt_un_entry){
-        rt_un_entry = XCALLOC(1, rt_un_entry_t);
-        memcpy(&rt_un_entry->rt_key, rt_key, sizeof(rt_key_t));
-        time(&rt_un_entry->last_refresh_time);
-        rt_un_entry->level = level;
-        glthread_add_next(&rib->head, &rt_un_entry->glthread);
-        rib->count++;
-    }
     
-    if(rt_un_entry->level != level){
-        /*replace the route with incoming version*/
-        rt_un_entry->flags = 0;
-        rt_un_entry->level = level;
-        time(&rt_un_entry->last_refresh_time);
-        
-        ITERATE_GLTHREAD_BEGIN(&rt_un_entry->nh_list_head, curr){
-            nxt_hop = glthread_to_unified_nh(curr);
-            remove_glthread(curr);
-            free_un_nexthop(nxt_hop);
-        } ITERATE_GLTHREAD_END(&rt_un_entry->nh_list_head, curr);
-        
-        init_glthread(&rt_un_entry->nh_list_head);
-    }
-
-    if(!nexthop){
-#ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "RIB : %s : local route %s/%d added to Routing table",
-            rib->rib_name, RT_ENTRY_PFX(rt_key), RT_ENTRY_MASK(rt_key));
-        trace(instance->traceopts, ROUTING_TABLE_BIT);
-#endif
-        return TRUE;
-    }
+    rt_un_entry_t *rt_un_entry = rib->rt_un_route_lookup(rib, rt_key);
 
-    /*Refresh time before adding an enntry*/
-    time(&nexthop->last_refresh_time);
-    existing_nh = lookup_clone_next_hop(rib, rt_un_entry, nexthop);
+    if(!rt_un_entry)
+        rt_un_entry = rt_un_entry_malloc(rib, rt_key, level);
 
-    if(existing_nh){
-#ifdef __ENABLE_TRACE__
-        sprintf(instance->traceopts->b, "Warning : RIB : %s : Nexthop (%s) --> (%s)%s already exists in %s/%d route",
-            rib->rib_name, existing_nh->oif->intf_name, existing_nh->gw_prefix, existing_nh->nh_node->node_name,
-            RT_ENTRY_PFX(rt_key), RT_ENTRY_MASK(rt_key));
-        trace(instance->traceopts, ROUTING_TABLE_BIT);
-#endif
-        return FALSE;
-    }
-
-    init_glthread(&nexthop->glthread);
-    if(IS_BIT_SET(nexthop->flags, PRIMARY_NH))
-        glthread_add_next(&rt_un_entry->nh_list_head, &nexthop->glthread);
-    else
-        glthread_add_last(&rt_un_entry->nh_list_head, &nexthop->glthread);
-    
-    return TRUE;
+    return rt_un_entry_install_nexthop(rib, rt_un_entry, level, nexthop);
 }
 
 static boolean
 inet_3_rt_un_route_install(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry){
     
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "RIB : %s : Added route %s/%d to Routing table",
+    SPF_TRACE(ROUTING_TABLE_BIT, "RIB : %s : Added route %s/%d to Routing table",
             rib->rib_name, RT_ENTRY_PFX(&rt_un_entry->rt_key), RT_ENTRY_MASK(&rt_un_entry->rt_key));
-    trace(instance->traceopts, ROUTING_TABLE_BIT);
 #endif
     /*Refresh time before adding an enntry*/
     time(&rt_un_entry->last_refresh_time);
+    if(!rt_un_entry->nh_group)
+        rt_un_entry_set_nh_group(rib, rt_un_entry, nh_group_malloc());
+    if(!rib->in_batch)
+        rt_un_entry_intern_nh_group(rib, rt_un_entry);
     glthread_add_next(&rib->head, &rt_un_entry->glthread);
     rib->count++;
     return TRUE;
@@ -508,10 +816,9 @@ inet_3_rt_un_route_update(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry){
     }
 
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "RIB : %s : Updated route %s/%d to Routing table",
+    SPF_TRACE(ROUTING_TABLE_BIT, "RIB : %s : Updated route %s/%d to Routing table",
             rib->rib_name, RT_ENTRY_PFX(&rt_un_entry->rt_key), 
             RT_ENTRY_MASK(&rt_un_entry->rt_key));
-    trace(instance->traceopts, ROUTING_TABLE_BIT);
 #endif
 
     rib->rt_un_route_delete(rib, &rt_un_entry1->rt_key);
@@ -537,16 +844,14 @@ inet_3_rt_un_route_delete(rt_un_table_t *rib, rt_key_t *rt_key){
     }
 
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "RIB : %s : Deleted route %s/%d from Routing table",
+    SPF_TRACE(ROUTING_TABLE_BIT, "RIB : %s : Deleted route %s/%d from Routing table",
             rib->rib_name, RT_ENTRY_PFX(&rt_un_entry->rt_key), RT_ENTRY_MASK(&rt_un_entry->rt_key));
-    trace(instance->traceopts, ROUTING_TABLE_BIT);
 #endif
 
     ITERATE_GLTHREAD_BEGIN(&rib->head, curr){
         temp = glthread_to_rt_un_entry(curr);
         if(UN_RTENTRY_PFX_MATCH(temp, rt_key)){
-            free_rt_un_entry(temp);
-            rib->count--;
+            free_rt_un_entry(rib, temp);
             return TRUE;
         }
     }ITERATE_GLTHREAD_END(&rib->head, curr);
@@ -558,13 +863,16 @@ static boolean
 mpls_0_rt_un_route_install(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry){
     
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "RIB : %s : Added route %s/%d(%u) to Routing table",
+    SPF_TRACE(ROUTING_TABLE_BIT, "RIB : %s : Added route %s/%d(%u) to Routing table",
             rib->rib_name, RT_ENTRY_PFX(&rt_un_entry->rt_key), RT_ENTRY_MASK(&rt_un_entry->rt_key),
             RT_ENTRY_LABEL(&rt_un_entry->rt_key));
-    trace(instance->traceopts, ROUTING_TABLE_BIT);
 #endif
     /*Refresh time before adding an enntry*/
     time(&rt_un_entry->last_refresh_time);
+    if(!rt_un_entry->nh_group)
+        rt_un_entry_set_nh_group(rib, rt_un_entry, nh_group_malloc());
+    if(!rib->in_batch)
+        rt_un_entry_intern_nh_group(rib, rt_un_entry);
     glthread_add_next(&rib->head, &rt_un_entry->glthread);
     rib->count++;
     return TRUE;
@@ -575,62 +883,17 @@ boolean
 mpls_0_rt_un_route_install_nexthop(rt_un_table_t *rib, rt_key_t *rt_key, LEVEL level,
                             internal_un_nh_t *nexthop){
     
-    glthread_t *curr = NULL;
-    internal_un_nh_t *nxt_hop = NULL;
-
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "RIB : %s : Adding route %s/%d to Routing table",
+    SPF_TRACE(ROUTING_TABLE_BIT, "RIB : %s : Adding route %s/%d to Routing table",
             rib->rib_name, RT_ENTRY_PFX(rt_key), RT_ENTRY_MASK(rt_key));
-    trace(instance->traceopts, ROUTING_TABLE_BIT);
 #endif
-    /*Refresh time before adding an enntry*/
-    time(&nexthop->last_refresh_time);
 
     rt_un_entry_t *rt_un_entry = rib->rt_un_route_lookup(rib, rt_key);
-    internal_un_nh_t *existing_nh = NULL;
-
-    if(!rt_un_entry){
-        rt_un_entry = XCALLOC(1, rt_un_entry_t);
-        memcpy(&rt_un_entry->rt_key, rt_key, sizeof(rt_key_t));
-        time(&rt_un_entry->last_refresh_time);
-        rt_un_entry->level = level;
-        glthread_add_next(&rib->head, &rt_un_entry->glthread);
-        rib->count++;
-    }
 
-    if(rt_un_entry->level != level){
-        /*replace the route with incoming version*/
-        rt_un_entry->flags = 0;
-        rt_un_entry->level = level;
-        time(&rt_un_entry->last_refresh_time);
-        
-        ITERATE_GLTHREAD_BEGIN(&rt_un_entry->nh_list_head, curr){
-            nxt_hop = glthread_to_unified_nh(curr);
-            remove_glthread(curr);
-            free_un_nexthop(nxt_hop);
-        } ITERATE_GLTHREAD_END(&rt_un_entry->nh_list_head, curr);
-        
-        init_glthread(&rt_un_entry->nh_list_head);
-    }
-
-    existing_nh = lookup_clone_next_hop(rib, rt_un_entry, nexthop);
-    if(existing_nh){
-#ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Warning : RIB : %s : Nexthop (%s) --> (%s)%s already exists in %s/%d route",
-            rib->rib_name, existing_nh->oif->intf_name, existing_nh->gw_prefix, existing_nh->nh_node->node_name,
-            RT_ENTRY_PFX(rt_key), RT_ENTRY_MASK(rt_key));
-        trace(instance->traceopts, ROUTING_TABLE_BIT);
-#endif
-        return FALSE;
-    }
+    if(!rt_un_entry)
+        rt_un_entry = rt_un_entry_malloc(rib, rt_key, level);
 
-    init_glthread(&nexthop->glthread);
-    
-    if(IS_BIT_SET(nexthop->flags, PRIMARY_NH))
-        glthread_add_next(&rt_un_entry->nh_list_head, &nexthop->glthread);
-    else
-        glthread_add_last(&rt_un_entry->nh_list_head, &nexthop->glthread);
-    return TRUE;
+    return rt_un_entry_install_nexthop(rib, rt_un_entry, level, nexthop);
 }
 
 static rt_un_entry_t *
@@ -663,10 +926,9 @@ mpls_0_rt_un_route_update(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry){
     }
 
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "RIB : %s : Updated route %s/%d(%u) to Routing table",
+    SPF_TRACE(ROUTING_TABLE_BIT, "RIB : %s : Updated route %s/%d(%u) to Routing table",
             rib->rib_name, RT_ENTRY_PFX(&rt_un_entry->rt_key), 
             RT_ENTRY_MASK(&rt_un_entry->rt_key), RT_ENTRY_LABEL(&rt_un_entry->rt_key));
-    trace(instance->traceopts, ROUTING_TABLE_BIT);
 #endif
 
     rib->rt_un_route_delete(rib, &rt_un_entry1->rt_key);
@@ -693,17 +955,15 @@ mpls_0_rt_un_route_delete(rt_un_table_t *rib, rt_key_t *rt_key){
     }
 
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "RIB : %s : Deleted route %s/%d(%u) from Routing table",
+    SPF_TRACE(ROUTING_TABLE_BIT, "RIB : %s : Deleted route %s/%d(%u) from Routing table",
             rib->rib_name, RT_ENTRY_PFX(&rt_un_entry->rt_key), 
             RT_ENTRY_MASK(&rt_un_entry->rt_key), RT_ENTRY_LABEL(&rt_un_entry->rt_key));
-    trace(instance->traceopts, ROUTING_TABLE_BIT);
 #endif
 
     ITERATE_GLTHREAD_BEGIN(&rib->head, curr){
         temp = glthread_to_rt_un_entry(curr);
         if(UN_RTENTRY_LABEL_MATCH(temp, rt_key)){
-            free_rt_un_entry(temp);
-            rib->count--;
+            free_rt_un_entry(rib, temp);
             return TRUE;
         }
     }ITERATE_GLTHREAD_END(&rib->head, curr);
@@ -856,9 +1116,12 @@ mpls_0_unifiy_nexthop(internal_nh_t *nexthop, PROTOCOL proto){
 rt_un_table_t *
 init_rib(rib_type_t rib_type){
 
+    unsigned int i = 0;
     rt_un_table_t * rib = XCALLOC(1, rt_un_table_t);
     rib->count = 0;
     init_glthread(&rib->head);
+    for(; i < NH_GROUP_TABLE_SIZE; i++)
+        init_glthread(&rib->nh_group_table[i]);
 
     switch (rib_type){
         case INET_0:
@@ -908,10 +1171,307 @@ flush_rib(rt_un_table_t *rib, LEVEL level){
         rt_un_entry = glthread_to_rt_un_entry(curr);
         if(rt_un_entry->level != level)
             continue;
-        rc = free_rt_un_entry(rt_un_entry);
+        rc = free_rt_un_entry(rib, rt_un_entry);
         if(rc == 0) count++;
     } ITERATE_GLTHREAD_END(&rib->head, curr);
-    rib->count -= count;
+}
+
+/* Incremental RIB installation : Instead of flushing the RIB and re-installing
+ * every route, every route of the level is marked stale before route installation
+ * and stays on its interned nh group. Installing a nexthop the group already has
+ * only records it as refreshed, the route is copied out of the group on its first
+ * actual change (rt_un_entry_unshare_nh_group()). After installation,
+ * rib_sweep_stale() drops IGP nexthops not refreshed, compares the new group with
+ * the old one : if identical, the route keeps the old group untouched, else the new
+ * group is interned. Routes not refreshed by installation are deleted. Thus only the
+ * delta is applied to forwarding state, and routes which do not change never leave
+ * their group*/
+void
+rib_mark_stale(rt_un_table_t *rib, LEVEL level){
+
+    glthread_t *curr = NULL;
+    rt_un_entry_t *rt_un_entry = NULL;
+
+    memset(&rib->delta_stats[level], 0, sizeof(rib_delta_stats_t));
+    rib->in_batch = TRUE;
+
+    ITERATE_GLTHREAD_BEGIN(&rib->head, curr){
+
+        rt_un_entry = glthread_to_rt_un_entry(curr);
+        if(rt_un_entry->level != level)
+            continue;
+        SET_BIT(rt_un_entry->flags, RT_UN_ENTRY_STALE);
+        SET_BIT(rt_un_entry->flags, RT_UN_ENTRY_SHARED);
+        UNSET_BIT(rt_un_entry->flags, RT_UN_ENTRY_NEW);
+        UNSET_BIT(rt_un_entry->flags, RT_UN_ENTRY_DIRTY);
+        rt_un_entry->refreshed_nh_mask = 0;
+    } ITERATE_GLTHREAD_END(&rib->head, curr);
+}
+
+/*Count nexthop operations needed to move a route from old_nh_group to nh_group*/
+static boolean
+rib_nh_group_delta(rt_un_table_t *rib, nh_group_t *old_nh_group,
+                   nh_group_t *nh_group, rib_delta_stats_t *delta_stats){
+
+    glthread_t *curr = NULL,
+               *curr1 = NULL;
+    internal_un_nh_t *nxt_hop = NULL,
+                     *old_nxt_hop = NULL,
+                     *match = NULL;
+    boolean is_changed = FALSE;
+
+    ITERATE_GLTHREAD_BEGIN(&nh_group->nh_list_head, curr){
+
+        nxt_hop = glthread_to_unified_nh(curr);
+        if(!IS_UN_NH_IGP_OWNED(nxt_hop))
+            continue;
+        match = NULL;
+        if(old_nh_group){
+            ITERATE_GLTHREAD_BEGIN(&old_nh_group->nh_list_head, curr1){
+                old_nxt_hop = glthread_to_unified_nh(curr1);
+                if(rib->rt_un_nh_t_equal(old_nxt_hop, nxt_hop)){
+                    match = old_nxt_hop;
+                    break;
+                }
+            } ITERATE_GLTHREAD_END(&old_nh_group->nh_list_head, curr1);
+        }
+        if(!match){
+            delta_stats->nh_add++;
+            is_changed = TRUE;
+        }
+        else if(is_un_nh_t_clones(match, nxt_hop))
+            delta_stats->nh_unchanged++;
+        else{
+            delta_stats->nh_modify++;
+            is_changed = TRUE;
+        }
+    } ITERATE_GLTHREAD_END(&nh_group->nh_list_head, curr);
+
+    if(!old_nh_group)
+        return is_changed;
+
+    ITERATE_GLTHREAD_BEGIN(&old_nh_group->nh_list_head, curr1){
+
+        old_nxt_hop = glthread_to_unified_nh(curr1);
+        if(!IS_UN_NH_IGP_OWNED(old_nxt_hop))
+            continue;
+        match = NULL;
+        ITERATE_GLTHREAD_BEGIN(&nh_group->nh_list_head, curr){
+            nxt_hop = glthread_to_unified_nh(curr);
+            if(rib->rt_un_nh_t_equal(old_nxt_hop, nxt_hop)){
+                match = nxt_hop;
+                break;
+            }
+        } ITERATE_GLTHREAD_END(&nh_group->nh_list_head, curr);
+        if(!match){
+            delta_stats->nh_delete++;
+            is_changed = TRUE;
+        }
+    } ITERATE_GLTHREAD_END(&old_nh_group->nh_list_head, curr1);
+    return is_changed;
+}
+
+void
+rib_sweep_stale(rt_un_table_t *rib, LEVEL level){
+
+    glthread_t *curr = NULL;
+    rt_un_entry_t *rt_un_entry = NULL;
+    nh_group_t *old_nh_group = NULL;
+    rib_delta_stats_t *delta_stats = &rib->delta_stats[level];
+
+    ITERATE_GLTHREAD_BEGIN(&rib->head, curr){
+
+        rt_un_entry = glthread_to_rt_un_entry(curr);
+        if(rt_un_entry->level != level)
+            continue;
+
+        /*Route still on its interned group changes only if IGP nexthops are gone*/
+        if(IS_BIT_SET(rt_un_entry->flags, RT_UN_ENTRY_SHARED) &&
+            !rt_un_entry_shared_nh_group_refreshed(rt_un_entry))
+            rt_un_entry_unshare_nh_group(rib, rt_un_entry);
+
+        old_nh_group = rt_un_entry->old_nh_group;
+        rt_un_entry->old_nh_group = NULL;
+
+        if(rib_nh_group_delta(rib,
+                IS_BIT_SET(rt_un_entry->flags, RT_UN_ENTRY_SHARED) ?
+                rt_un_entry->nh_group : old_nh_group,
+                rt_un_entry->nh_group, delta_stats))
+            SET_BIT(rt_un_entry->flags, RT_UN_ENTRY_DIRTY);
+
+        if(IS_BIT_SET(rt_un_entry->flags, RT_UN_ENTRY_STALE) &&
+            !rt_un_entry->nh_group->nh_count){
+#ifdef __ENABLE_TRACE__
+            SPF_TRACE(ROUTING_TABLE_BIT, "RIB : %s : Deleted stale route %s/%d from Routing table",
+                    rib->rib_name, RT_ENTRY_PFX(&rt_un_entry->rt_key), RT_ENTRY_MASK(&rt_un_entry->rt_key));
+#endif
+            if(old_nh_group)
+                nh_group_release(rib, old_nh_group);
+            rt_un_entry_free(rib, rt_un_entry);
+            delta_stats->rt_delete++;
+            continue;
+        }
+
+        if(old_nh_group && is_nh_group_equal(old_nh_group, rt_un_entry->nh_group))
+            rt_un_entry_set_nh_group(rib, rt_un_entry, old_nh_group); /*No change in forwarding state*/
+        else
+            rt_un_entry_intern_nh_group(rib, rt_un_entry);
+
+        if(old_nh_group)
+            nh_group_release(rib, old_nh_group);
+
+        if(IS_BIT_SET(rt_un_entry->flags, RT_UN_ENTRY_NEW))
+            delta_stats->rt_add++;
+        else if(IS_BIT_SET(rt_un_entry->flags, RT_UN_ENTRY_DIRTY))
+            delta_stats->rt_modify++;
+        else
+            delta_stats->rt_unchanged++;
+
+        rt_un_entry->flags = 0;
+        rt_un_entry->refreshed_nh_mask = 0;
+    } ITERATE_GLTHREAD_END(&rib->head, curr);
+
+    rib->in_batch = FALSE;
+}
+
+/*Returns 1 if nh_group is repaired, 0 if it does not use failed_oif, and -1
+ * if it has neither an ECMP primary nor a backup protecting failed_oif*/
+static int
+nh_group_local_repair(nh_group_t *nh_group, edge_end_t *failed_oif){
+
+    glthread_t *curr = NULL;
+    internal_un_nh_t *nxt_hop = NULL;
+    boolean impacted = FALSE;
+    unsigned int n_primary = 0,
+                 n_backup = 0;
+
+    ITERATE_GLTHREAD_BEGIN(&nh_group->nh_list_head, curr){
+
+        nxt_hop = glthread_to_unified_nh(curr);
+        if(nxt_hop->oif == failed_oif){
+            if(IS_BIT_SET(nxt_hop->flags, PRIMARY_NH) &&
+                IS_UN_NH_IGP_OWNED(nxt_hop))
+                impacted = TRUE;
+            continue;
+        }
+        if(IS_BIT_SET(nxt_hop->flags, PRIMARY_NH))
+            n_primary++;
+        /*Only IGP backups are promoted below, LSP backups wait for full SPF*/
+        else if(nxt_hop->protected_link == failed_oif &&
+                IS_UN_NH_IGP_OWNED(nxt_hop))
+            n_backup++;
+    } ITERATE_GLTHREAD_END(&nh_group->nh_list_head, curr);
+
+    if(!impacted)
+        return 0;
+
+    /*Nothing to switch to, leave the group to full SPF*/
+    if(!n_primary && !n_backup)
+        return -1;
+
+    ITERATE_GLTHREAD_BEGIN(&nh_group->nh_list_head, curr){
+
+        nxt_hop = glthread_to_unified_nh(curr);
+        if(!IS_UN_NH_IGP_OWNED(nxt_hop))
+            continue;
+        if(nxt_hop->oif == failed_oif){
+            nh_group_delete_nexthop(nh_group, nxt_hop);
+            continue;
+        }
+        /*Remaining ECMP primaries carry the traffic, else promote the backups*/
+        if(!n_primary && nxt_hop->protected_link == failed_oif){
+            SET_BIT(nxt_hop->flags, PRIMARY_NH);
+            nxt_hop->protected_link = NULL;
+            time(&nxt_hop->last_refresh_time);
+        }
+    } ITERATE_GLTHREAD_END(&nh_group->nh_list_head, curr);
+    return 1;
+}
+
+/* Prefix independent local repair : when failed_oif goes down, every nh group
+ * forwarding over it is switched in place to its remaining ECMP primaries or to
+ * its precomputed backups (LFA/RLFA). Since groups are shared, all dependent
+ * routes are repaired at once, in time proportional to the number of groups and not
+ * the number of prefixes. Full SPF later replaces the repaired groups through
+ * usual route installation*/
+void
+rib_local_repair(rt_un_table_t *rib, edge_end_t *failed_oif){
+
+    unsigned int i = 0;
+    int rc = 0;
+    glthread_t *curr = NULL,
+               *curr1 = NULL,
+               *bucket = NULL;
+    glthread_t repaired_list;
+    nh_group_t *nh_group = NULL,
+               *interned_nh_group = NULL;
+    struct timespec start_time, end_time;
+    rib_local_repair_stats_t *stats = &rib->local_repair_stats;
+
+    assert(!rib->in_batch);
+    memset(stats, 0, sizeof(rib_local_repair_stats_t));
+    strncpy(stats->failed_oif, failed_oif->intf_name, IF_NAME_SIZE);
+    stats->failed_oif[IF_NAME_SIZE - 1] = '\0';
+    init_glthread(&repaired_list);
+
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+    for(i = 0; i < NH_GROUP_TABLE_SIZE; i++){
+        ITERATE_GLTHREAD_BEGIN(&rib->nh_group_table[i], curr){
+
+            nh_group = hash_glthread_to_nh_group(curr);
+            stats->groups_scanned++;
+            rc = nh_group_local_repair(nh_group, failed_oif);
+            if(rc < 0)
+                stats->groups_unprotected++;
+            if(rc <= 0)
+                continue;
+            /*Group content changed, rehash it once the scan is over*/
+            remove_glthread(&nh_group->hash_glue);
+            glthread_add_next(&repaired_list, &nh_group->hash_glue);
+            stats->groups_repaired++;
+            stats->routes_repaired += nh_group->ref_count;
+        } ITERATE_GLTHREAD_END(&rib->nh_group_table[i], curr);
+    }
+
+    ITERATE_GLTHREAD_BEGIN(&repaired_list, curr){
+
+        nh_group = hash_glthread_to_nh_group(curr);
+        remove_glthread(&nh_group->hash_glue);
+        nh_group->hash = nh_group_hash(nh_group);
+        bucket = &rib->nh_group_table[nh_group->hash % NH_GROUP_TABLE_SIZE];
+
+        /*Repair may make the group identical to one interned already, merge them*/
+        interned_nh_group = NULL;
+        ITERATE_GLTHREAD_BEGIN(bucket, curr1){
+            interned_nh_group = hash_glthread_to_nh_group(curr1);
+            if(interned_nh_group->hash == nh_group->hash &&
+                is_nh_group_equal(interned_nh_group, nh_group))
+                break;
+            interned_nh_group = NULL;
+        } ITERATE_GLTHREAD_END(bucket, curr1);
+
+        if(!interned_nh_group){
+            glthread_add_next(bucket, &nh_group->hash_glue);
+            continue;
+        }
+
+        /*Last dependent moved releases the repaired group*/
+        ITERATE_GLTHREAD_BEGIN(&nh_group->dep_list_head, curr1){
+            rt_un_entry_set_nh_group(rib, nh_group_glthread_to_rt_un_entry(curr1),
+                    interned_nh_group);
+        } ITERATE_GLTHREAD_END(&nh_group->dep_list_head, curr1);
+        stats->groups_merged++;
+    } ITERATE_GLTHREAD_END(&repaired_list, curr);
+
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    stats->repair_time_nsec = (end_time.tv_sec - start_time.tv_sec) * 1000000000UL +
+                               end_time.tv_nsec - start_time.tv_nsec;
+#ifdef __ENABLE_TRACE__
+    SPF_TRACE(ROUTING_TABLE_BIT, "RIB : %s : local repair of oif %s : %u of %u nh groups repaired (%u routes), %u merged, %u unprotected",
+            rib->rib_name, stats->failed_oif, stats->groups_repaired, stats->groups_scanned,
+            stats->routes_repaired, stats->groups_merged, stats->groups_unprotected);
+#endif
 }
 
 void
@@ -937,14 +1497,14 @@ inet_0_display(rt_un_table_t *rib, char *prefix, char mask){
         printf("%s/%u(L%u)\n", RT_ENTRY_PFX(&rt_un_entry->rt_key), 
             RT_ENTRY_MASK(&rt_un_entry->rt_key), rt_un_entry->level);
 
-        ITERATE_GLTHREAD_BEGIN(&rt_un_entry->nh_list_head, curr1){
+        ITERATE_GLTHREAD_BEGIN(RT_UN_ENTRY_NH_LIST(rt_un_entry), curr1){
             nexthop = glthread_to_unified_nh(curr1);
             printf("\t%-12s %-16s %-16s   %s %-8si %s\n", protocol_name(nexthop->protocol),
                     nexthop->oif->intf_name, nexthop->gw_prefix,
                     IS_BIT_SET(nexthop->flags, PRIMARY_NH) ? "PRIMARY": "BACKUP",
                     get_str_nexthop_type(nexthop->flags),
                     hrs_min_sec_format((unsigned int)difftime(curr_time, nexthop->last_refresh_time)));
-        } ITERATE_GLTHREAD_END(&rt_un_entry->nh_list_head, curr1);
+        } ITERATE_GLTHREAD_END(RT_UN_ENTRY_NH_LIST(rt_un_entry), curr1);
         return;
     }
 
@@ -954,14 +1514,14 @@ inet_0_display(rt_un_table_t *rib, char *prefix, char mask){
         printf("%s/%u(L%u)\n", RT_ENTRY_PFX(&rt_un_entry->rt_key), RT_ENTRY_MASK(&rt_un_entry->rt_key),
             rt_un_entry->level);
 
-        ITERATE_GLTHREAD_BEGIN(&rt_un_entry->nh_list_head, curr1){
+        ITERATE_GLTHREAD_BEGIN(RT_UN_ENTRY_NH_LIST(rt_un_entry), curr1){
             nexthop = glthread_to_unified_nh(curr1);
             printf("\t%-12s %-16s %-16s   %s %-8s %s\n", protocol_name(nexthop->protocol),
                     nexthop->oif->intf_name, nexthop->gw_prefix,
                     IS_BIT_SET(nexthop->flags, PRIMARY_NH) ? "PRIMARY": "BACKUP",
                     get_str_nexthop_type(nexthop->flags),
                     hrs_min_sec_format((unsigned int)difftime(curr_time, nexthop->last_refresh_time)));
-        } ITERATE_GLTHREAD_END(&rt_un_entry->nh_list_head, curr1);
+        } ITERATE_GLTHREAD_END(RT_UN_ENTRY_NH_LIST(rt_un_entry), curr1);
     } ITERATE_GLTHREAD_END(&rib->head, curr);
 }
 
@@ -989,7 +1549,7 @@ inet_3_display(rt_un_table_t *rib, char *prefix, char mask){
         printf("%s/%u(L%u)\n", RT_ENTRY_PFX(&rt_un_entry->rt_key), RT_ENTRY_MASK(&rt_un_entry->rt_key),
                 rt_un_entry->level);
 
-        ITERATE_GLTHREAD_BEGIN(&rt_un_entry->nh_list_head, curr1){
+        ITERATE_GLTHREAD_BEGIN(RT_UN_ENTRY_NH_LIST(rt_un_entry), curr1){
             nexthop = glthread_to_unified_nh(curr1);
             printf("\t%-12s %-16s %-16s   %s %-8s %s\n", protocol_name(nexthop->protocol), 
                     nexthop->oif->intf_name, nexthop->gw_prefix,
@@ -1012,7 +1572,7 @@ inet_3_display(rt_un_table_t *rib, char *prefix, char mask){
                             nexthop->nh.inet3_nh.mpls_label_out[i]);
             }
             printf("\n");
-        } ITERATE_GLTHREAD_END(&rt_un_entry->nh_list_head, curr1);
+        } ITERATE_GLTHREAD_END(RT_UN_ENTRY_NH_LIST(rt_un_entry), curr1);
         return;
     }
 
@@ -1023,7 +1583,7 @@ inet_3_display(rt_un_table_t *rib, char *prefix, char mask){
         printf("%s/%u(L%u)\n", RT_ENTRY_PFX(&rt_un_entry->rt_key), RT_ENTRY_MASK(&rt_un_entry->rt_key),
                 rt_un_entry->level);
 
-        ITERATE_GLTHREAD_BEGIN(&rt_un_entry->nh_list_head, curr1){
+        ITERATE_GLTHREAD_BEGIN(RT_UN_ENTRY_NH_LIST(rt_un_entry), curr1){
             nexthop = glthread_to_unified_nh(curr1);
             printf("\t%-12s %-16s %-16s   %s %-8s %s\n", protocol_name(nexthop->protocol),
                     nexthop->oif->intf_name, nexthop->gw_prefix,
@@ -1046,7 +1606,7 @@ inet_3_display(rt_un_table_t *rib, char *prefix, char mask){
                             nexthop->nh.inet3_nh.mpls_label_out[i]);
             }
             printf("\n");
-        } ITERATE_GLTHREAD_END(&rt_un_entry->nh_list_head, curr1);
+        } ITERATE_GLTHREAD_END(RT_UN_ENTRY_NH_LIST(rt_un_entry), curr1);
     } ITERATE_GLTHREAD_END(&rib->head, curr);
 }
 
@@ -1074,7 +1634,7 @@ mpls_0_display(rt_un_table_t *rib, mpls_label_t in_label){
             RT_ENTRY_MASK(&rt_un_entry->rt_key), rt_un_entry->level, 
             RT_ENTRY_LABEL(&rt_un_entry->rt_key));
 
-        ITERATE_GLTHREAD_BEGIN(&rt_un_entry->nh_list_head, curr1){
+        ITERATE_GLTHREAD_BEGIN(RT_UN_ENTRY_NH_LIST(rt_un_entry), curr1){
             nexthop = glthread_to_unified_nh(curr1);
             printf("\tInLabel : %u, %-12s %-16s %-16s   %-8s %s %s\n", in_label, 
                     protocol_name(nexthop->protocol), 
@@ -1099,7 +1659,7 @@ mpls_0_display(rt_un_table_t *rib, mpls_label_t in_label){
                             nexthop->nh.inet3_nh.mpls_label_out[i]);
             }
             printf("\n");
-        } ITERATE_GLTHREAD_END(&rt_un_entry->nh_list_head, curr1);
+        } ITERATE_GLTHREAD_END(RT_UN_ENTRY_NH_LIST(rt_un_entry), curr1);
         return;
     }
 
@@ -1111,7 +1671,7 @@ mpls_0_display(rt_un_table_t *rib, mpls_label_t in_label){
             RT_ENTRY_MASK(&rt_un_entry->rt_key), rt_un_entry->level,
             RT_ENTRY_LABEL(&rt_un_entry->rt_key));
 
-        ITERATE_GLTHREAD_BEGIN(&rt_un_entry->nh_list_head, curr1){
+        ITERATE_GLTHREAD_BEGIN(RT_UN_ENTRY_NH_LIST(rt_un_entry), curr1){
             nexthop = glthread_to_unified_nh(curr1);
             printf("\t%-12s %-16s %-16s   %-8s %s %s\n", 
                     protocol_name(nexthop->protocol), 
@@ -1136,7 +1696,7 @@ mpls_0_display(rt_un_table_t *rib, mpls_label_t in_label){
                             nexthop->nh.inet3_nh.mpls_label_out[i]);
             }
             printf("\n");
-        } ITERATE_GLTHREAD_END(&rt_un_entry->nh_list_head, curr1);
+        } ITERATE_GLTHREAD_END(RT_UN_ENTRY_NH_LIST(rt_un_entry), curr1);
     } ITERATE_GLTHREAD_END(&rib->head, curr);
 }
 
@@ -184,6 +184,31 @@ typedef struct internal_un_nh_t_{
 
 GLTHREAD_TO_STRUCT(glthread_to_unified_nh, internal_un_nh_t, glthread);
 
+/*Nexthops which are not owned by IGP route installation*/
+#define IS_UN_NH_IGP_OWNED(internal_un_nh_t_ptr)        \
+    ((internal_un_nh_t_ptr)->protocol != RSVP_PROTO &&   \
+     (internal_un_nh_t_ptr)->protocol != LDP_PROTO)
+
+/* Next-hop group : the set of nexthops (primary and backups) of a RIB entry.
+ * Groups are interned per RIB, all RIB entries having identical set of
+ * nexthops share one group. An interned group is read-only, a RIB entry
+ * which needs to modify its nexthops works on a private copy which is
+ * interned again once modification is done*/
+typedef struct nh_group_{
+
+    glthread_t nh_list_head;    /*internal_un_nh_t, primary nexthops first*/
+    unsigned int nh_count;
+    unsigned int hash;
+    unsigned int ref_count;     /*No of RIB entries referring to this group*/
+    boolean is_interned;        /*Present in RIB nh group table*/
+    glthread_t dep_list_head;   /*RIB entries using this group*/
+    glthread_t hash_glue;
+} nh_group_t;
+
+GLTHREAD_TO_STRUCT(hash_glthread_to_nh_group, nh_group_t, hash_glue);
+
+#define NH_GROUP_TABLE_SIZE     256
+
 static inline char *
 get_str_nexthop_type(char flags){
 
@@ -214,14 +239,26 @@ get_str_nexthop_type(char flags){
 typedef struct rt_un_entry_{
 
     rt_key_t rt_key;
-    glthread_t nh_list_head;
+    nh_group_t *nh_group;       /*Nexthops of this route, shared with other routes*/
+    nh_group_t *old_nh_group;   /*Group installed by previous SPF run, valid during route installation only*/
+    glthread_t nh_group_glue;   /*Links the entry in nh_group->dep_list_head*/
+    /*Bits used by incremental RIB installation*/
+    #define RT_UN_ENTRY_STALE   0 /*Route not refreshed by current SPF run yet*/
+    #define RT_UN_ENTRY_NEW     1 /*Route added by current SPF run*/
+    #define RT_UN_ENTRY_DIRTY   2 /*Route nexthops added/modified/deleted by current SPF run*/
+    #define RT_UN_ENTRY_SHARED  3 /*Route still on its interned group during current SPF run*/
     FLAG flags; /*Flags for this routing entry*/
+    unsigned long long refreshed_nh_mask; /*IGP nexthops of the interned group refreshed by current SPF run, by position among IGP nexthops*/
     LEVEL level;
     time_t last_refresh_time;
     glthread_t glthread;
 } rt_un_entry_t;
 
 GLTHREAD_TO_STRUCT(glthread_to_rt_un_entry, rt_un_entry_t, glthread);
+GLTHREAD_TO_STRUCT(nh_group_glthread_to_rt_un_entry, rt_un_entry_t, nh_group_glue);
+
+#define RT_UN_ENTRY_NH_LIST(rt_un_entry_t_ptr)  \
+    (&(rt_un_entry_t_ptr)->nh_group->nh_list_head)
 
 static inline internal_un_nh_t *
 GET_FIRST_NH(rt_un_entry_t *rt_un_entry, FLAG nh_type, 
@@ -230,13 +267,13 @@ GET_FIRST_NH(rt_un_entry_t *rt_un_entry, FLAG nh_type,
     glthread_t *curr = NULL;
     internal_un_nh_t *nexthop = NULL;
 
-    ITERATE_GLTHREAD_BEGIN(&rt_un_entry->nh_list_head, curr){
+    ITERATE_GLTHREAD_BEGIN(RT_UN_ENTRY_NH_LIST(rt_un_entry), curr){
         
         nexthop = glthread_to_unified_nh(curr);
         if(IS_BIT_SET(nexthop->flags, is_primary) &&
             IS_BIT_SET(nexthop->flags, nh_type))
             return nexthop;
-    } ITERATE_GLTHREAD_END(&rt_un_entry->nh_list_head, curr);
+    } ITERATE_GLTHREAD_END(RT_UN_ENTRY_NH_LIST(rt_un_entry), curr);
     return NULL;
 }
 
@@ -247,18 +284,43 @@ GET_FIRST_BACKUP_NH(rt_un_entry_t *rt_un_entry, FLAG nh_type,
     glthread_t *curr = NULL;
     internal_un_nh_t *nexthop = NULL;
 
-    ITERATE_GLTHREAD_BEGIN(&rt_un_entry->nh_list_head, curr){
+    ITERATE_GLTHREAD_BEGIN(RT_UN_ENTRY_NH_LIST(rt_un_entry), curr){
         
         nexthop = glthread_to_unified_nh(curr);
         if(!IS_BIT_SET(nexthop->flags, is_primary) &&
             IS_BIT_SET(nexthop->flags, nh_type))
             return nexthop;
-    } ITERATE_GLTHREAD_END(&rt_un_entry->nh_list_head, curr);
+    } ITERATE_GLTHREAD_END(RT_UN_ENTRY_NH_LIST(rt_un_entry), curr);
     return NULL;
 }
 
 typedef struct internal_nh_t_ internal_nh_t;
 
+/*Operations performed on a RIB by the last route installation*/
+typedef struct rib_delta_stats_{
+
+    unsigned int rt_add;
+    unsigned int rt_modify;
+    unsigned int rt_delete;
+    unsigned int rt_unchanged;
+    unsigned int nh_add;
+    unsigned int nh_modify;
+    unsigned int nh_delete;
+    unsigned int nh_unchanged;
+} rib_delta_stats_t;
+
+/*Result of the last local repair performed on a RIB*/
+typedef struct rib_local_repair_stats_{
+
+    char failed_oif[IF_NAME_SIZE];
+    unsigned int groups_scanned;
+    unsigned int groups_repaired;
+    unsigned int groups_merged;     /*Repaired groups identical to a group interned already*/
+    unsigned int groups_unprotected;
+    unsigned int routes_repaired;
+    unsigned long repair_time_nsec;
+} rib_local_repair_stats_t;
+
 typedef struct rt_un_table_{
 
     unsigned int count;
@@ -271,20 +333,25 @@ typedef struct rt_un_table_{
     boolean (*rt_un_route_update)(struct rt_un_table_ *, rt_un_entry_t *);
     boolean (*rt_un_route_delete)(struct rt_un_table_ *, rt_key_t *);
     boolean (*rt_un_nh_t_equal)(internal_un_nh_t *, internal_un_nh_t *);
+    rib_delta_stats_t delta_stats[MAX_LEVEL];
+    boolean in_batch;   /*Route installation by SPF run in progress*/
+    glthread_t nh_group_table[NH_GROUP_TABLE_SIZE];
+    unsigned int nh_group_count;
+    rib_local_repair_stats_t local_repair_stats;
 } rt_un_table_t;
 
 rt_un_table_t *
 init_rib(rib_type_t rib);
 
 int
-free_rt_un_entry(rt_un_entry_t *rt_un_entry);
+free_rt_un_entry(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry);
 
 internal_un_nh_t *
 lookup_clone_next_hop(rt_un_table_t *rib, rt_un_entry_t *rt_un_entry, internal_un_nh_t *nexthop);
 
 #define UN_RTENTRY_PFX_MATCH(rt_un_entry_t_ptr, rt_key_ptr) \
-    (strncmp(RT_ENTRY_PFX(rt_key_ptr), RT_ENTRY_PFX(&rt_un_entry->rt_key), PREFIX_LEN) == 0 &&    \
-            RT_ENTRY_MASK(rt_key) == RT_ENTRY_MASK(&rt_un_entry->rt_key))
+    (strncmp(RT_ENTRY_PFX(rt_key_ptr), RT_ENTRY_PFX(&(rt_un_entry_t_ptr)->rt_key), PREFIX_LEN) == 0 &&    \
+            RT_ENTRY_MASK(rt_key_ptr) == RT_ENTRY_MASK(&(rt_un_entry_t_ptr)->rt_key))
 
 #define UN_RTENTRY_LABEL_MATCH(rt_un_entry_t_ptr, rt_key_ptr) \
     (RT_ENTRY_LABEL(&rt_un_entry_t_ptr->rt_key) == RT_ENTRY_LABEL(rt_key_ptr))
@@ -334,6 +401,18 @@ rt_un_route_delete(rt_un_table_t *rib, rt_key_t *rt_key);
 void
 flush_rib(rt_un_table_t *rib, LEVEL level);
 
+void
+rib_mark_stale(rt_un_table_t *rib, LEVEL level);
+
+void
+rib_sweep_stale(rt_un_table_t *rib, LEVEL level);
+
+boolean
+is_nh_group_equal(nh_group_t *nh_group1, nh_group_t *nh_group2);
+
+void
+rib_local_repair(rt_un_table_t *rib, edge_end_t *failed_oif);
+
 internal_un_nh_t *
 inet_0_unifiy_nexthop(internal_nh_t *nexthop, PROTOCOL proto);
 
@@ -142,7 +142,7 @@ spring_disable_cleanup(node_t *node){
     LEVEL level_it;
     prefix_sid_subtlv_t *prefix_sid = NULL;
     
-    free((SRGB_INDEX_ARRAY(node->srgb))->array);
+    free_bit_array(SRGB_INDEX_ARRAY(node->srgb));
     XFREE(node->srgb);
     node->use_spring_backups = FALSE;
 
@@ -211,20 +211,18 @@ springify_rlfa_nexthop(node_t *spf_root,
     
     if(!is_node_spring_enabled(nxthop->proxy_nbr, route->level)) {
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Node : %s : route %s/%u at %s, LDP proxy nexthop %s(%s) cannot be springified. SPRING not enabled",
+        SPF_TRACE(SPRING_ROUTE_CAL_BIT, "Node : %s : route %s/%u at %s, LDP proxy nexthop %s(%s) cannot be springified. SPRING not enabled",
                 spf_root->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask,
                 get_str_level(route->level), next_hop_oif_name(*nxthop), nxthop->node->node_name);
-        trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
 #endif
         return;
     }
 
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "Node : %s : route %s/%u at %s, springifying LDP backup nexthops %s(%s), RLFA : %s",
+    SPF_TRACE(SPRING_ROUTE_CAL_BIT, "Node : %s : route %s/%u at %s, springifying LDP backup nexthops %s(%s), RLFA : %s",
             spf_root->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask,
             get_str_level(route->level), next_hop_oif_name(*nxthop), nxthop->node->node_name,
             nxthop->rlfa->node_name);
-    trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
 #endif
 
     /* PLR should send the traffic to Destination via RLFA. There are two options to
@@ -253,24 +251,22 @@ springify_rlfa_nexthop(node_t *spf_root,
         nxthop->stack_op[1] = PUSH;
 
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Node : %s : After Springification : route %s/%u at %s InLabel : %u\n\tStack : %s:%u\t%s:%u, oif : %s, gw : %s, nexthop : %s", 
+        SPF_TRACE(SPRING_ROUTE_CAL_BIT, "Node : %s : After Springification : route %s/%u at %s InLabel : %u\n\tStack : %s:%u\t%s:%u, oif : %s, gw : %s, nexthop : %s", 
                 spf_root->node_name, route->rt_key.u.prefix.prefix,
                 route->rt_key.u.prefix.mask, get_str_level(route->level), route->rt_key.u.label,
                 get_str_stackops(nxthop->stack_op[1]) , nxthop->mpls_label_out[1],
                 get_str_stackops(nxthop->stack_op[0]) , nxthop->mpls_label_out[0], next_hop_oif_name(*nxthop),
                 next_hop_gateway_pfx(nxthop), nxthop->proxy_nbr->node_name);
-        trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
 #endif
         return;
     }
 
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "Node : %s : After Springification : route %s/%u at %s InLabel : %u\n\tStack : %s:%u, oif : %s, gw : %s, nexthop : %s", 
+    SPF_TRACE(SPRING_ROUTE_CAL_BIT, "Node : %s : After Springification : route %s/%u at %s InLabel : %u\n\tStack : %s:%u, oif : %s, gw : %s, nexthop : %s", 
         spf_root->node_name, route->rt_key.u.prefix.prefix,
         route->rt_key.u.prefix.mask, get_str_level(route->level), route->rt_key.u.label,
         get_str_stackops(nxthop->stack_op[0]) , nxthop->mpls_label_out[0], next_hop_oif_name(*nxthop),
         next_hop_gateway_pfx(nxthop), nxthop->proxy_nbr->node_name);
-    trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
 #endif
 }
 
@@ -286,19 +282,17 @@ springify_ipv4_nexthop(node_t *spf_root,
    
     if(!is_node_spring_enabled(nxthop->node, route->level)) {
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Node : %s : route %s/%u at %s, IPV4 nexthop %s(%s) cannot be springified. SPRING not enabled",
+        SPF_TRACE(SPRING_ROUTE_CAL_BIT, "Node : %s : route %s/%u at %s, IPV4 nexthop %s(%s) cannot be springified. SPRING not enabled",
                 spf_root->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask,
                 get_str_level(route->level), next_hop_oif_name(*nxthop), nxthop->node->node_name);
-        trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
 #endif
         return;
     }
 
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "Node : %s : route %s/%u at %s, springifying IPV4 nexthop %s(%s)",
+    SPF_TRACE(SPRING_ROUTE_CAL_BIT, "Node : %s : route %s/%u at %s, springifying IPV4 nexthop %s(%s)",
             spf_root->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask,
             get_str_level(route->level), next_hop_oif_name(*nxthop), nxthop->node->node_name);
-    trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
 #endif
 
     /*caluclate the SPRING Nexthop related information first*/
@@ -329,12 +323,11 @@ springify_ipv4_nexthop(node_t *spf_root,
     
 
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "Node : %s : After Springification : route %s/%u at %s InLabel : %u, OutLabel : %u," 
+    SPF_TRACE(SPRING_ROUTE_CAL_BIT, "Node : %s : After Springification : route %s/%u at %s InLabel : %u, OutLabel : %u," 
             " Stack Op : %s, oif : %s, gw : %s, nexthop : %s", spf_root->node_name, route->rt_key.u.prefix.prefix, 
             route->rt_key.u.prefix.mask, get_str_level(route->level), route->rt_key.u.label, 
             nxthop->mpls_label_out[0], get_str_stackops(nxthop->stack_op[0]), next_hop_oif_name(*nxthop),
             next_hop_gateway_pfx(nxthop), nxthop->node->node_name);
-    trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
 #endif
 }
 
@@ -350,10 +343,9 @@ springify_unicast_route(node_t *spf_root, routes_t *route,
     internal_nh_t *nxthop = NULL;
 
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "Node : %s : Springifying route %s/%u at %s", 
+    SPF_TRACE(SPRING_ROUTE_CAL_BIT, "Node : %s : Springifying route %s/%u at %s", 
         spf_root->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask,
         get_str_level(route->level));
-    trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
 #endif
 
     /*Now Do primary next hops*/
@@ -398,9 +398,6 @@ typedef struct _mpls_rt_entry mpls_rt_entry_t ;
 
 typedef struct spf_info_ spf_info_t;
 
-void
-update_node_segment_routes_for_remote(spf_info_t *spf_info, LEVEL level);
-
 void
 spring_disable_cleanup(node_t *node);
 
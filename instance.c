@@ -45,17 +45,14 @@ extern void init_memory_manager();
 
 static void
 add_node_to_owning_instance(instance_t *instance, node_t *node){
-    singly_ll_add_node_by_val(instance->instance_node_list, (void *)node);
+    /*node is new, skip the duplicate search of the list*/
+    singly_ll_add_node(instance->instance_node_list, singly_ll_init_node((void *)node));
 }
 
 extern void init_tilfa(node_t *node);
 
 node_t *
 create_new_node(instance_t *instance, char *node_name, AREA area, char *router_id){
-    
-    LEVEL level;
-    prefix_t *router_id_pfx = NULL;
-    nh_type_t nh;
 
     assert(node_name);
 
@@ -63,6 +60,17 @@ create_new_node(instance_t *instance, char *node_name, AREA area, char *router_i
         printf("Error : Node %s already exists\n", node_name);
         return NULL;
     }
+    return _create_new_node(instance, node_name, area, router_id);
+}
+
+/*Create the node without the search for a node of the same name in the
+ * instance, callers which keep their own index of node names use it*/
+node_t *
+_create_new_node(instance_t *instance, char *node_name, AREA area, char *router_id){
+    
+    LEVEL level;
+    prefix_t *router_id_pfx = NULL;
+    nh_type_t nh;
 
     node_t * node = calloc(1, sizeof(node_t));
     strncpy(node->node_name, node_name, NODE_NAME_SIZE);
@@ -71,7 +79,9 @@ create_new_node(instance_t *instance, char *node_name, AREA area, char *router_i
     node->router_id[PREFIX_LEN] = '\0';
 
     node->area = area;
+    node->node_index = instance->n_node_index++;
     node->is_node_on_heap = FALSE;
+    node->is_node_frozen = FALSE;
     SPF_CANDIDATE_TREE_NODE_INIT(&instance->ctree, node); 
 
     for(level = LEVEL1; level <= LEVEL2; level++){
@@ -112,15 +122,14 @@ create_new_node(instance_t *instance, char *node_name, AREA area, char *router_i
     rtttype_t rt_type;
 
     for(rt_type = UNICAST_T; rt_type < TOPO_MAX; rt_type++){
-        node->spf_info.routes_list[rt_type] = init_singly_ll();/*List of routes calculated, routes are not categorised under Levels*/
-        singly_ll_set_comparison_fn(node->spf_info.routes_list[rt_type], route_search_comparison_fn);
-
-        node->spf_info.priority_routes_list[rt_type] = init_singly_ll();
-        singly_ll_set_comparison_fn(node->spf_info.priority_routes_list[rt_type], route_search_comparison_fn);
-
-        node->spf_info.deferred_routes_list[rt_type] = init_singly_ll();
-        singly_ll_set_comparison_fn(node->spf_info.deferred_routes_list[rt_type], route_search_comparison_fn);
+        init_glthread(&node->spf_info.routes_list[rt_type]);/*List of routes calculated, routes are not categorised under Levels*/
+        init_glthread(&node->spf_info.priority_routes_list[rt_type]);
+        init_glthread(&node->spf_info.deferred_routes_list[rt_type]);
     }
+    init_glthread(&node->spf_info.reclaim_routes_list);
+    node->spf_info.priority_min_mask[ROUTE_PRIORITY_CRITICAL] = ROUTE_PRIORITY_CRITICAL_DEF_MASK;
+    node->spf_info.priority_min_mask[ROUTE_PRIORITY_HIGH] = ROUTE_PRIORITY_HIGH_DEF_MASK;
+    node->spf_info.priority_min_mask[ROUTE_PRIORITY_LOW] = 0;
 
     node->spf_info.rib[INET_0] = init_rib(INET_0);
     node->spf_info.rib[INET_3] = init_rib(INET_3);
@@ -128,7 +137,7 @@ create_new_node(instance_t *instance, char *node_name, AREA area, char *router_i
 
     node->attached = 1; /*By default attached bit is enabled*/
     node->traversing_bit = 0;
-    node->lsp_distribution_bit = 0;
+    node->lsp_proc_delay_usec = 0;
     node->backup_spf_options = 0;
     node->spring_enabled = FALSE;
     node->use_spring_backups = FALSE;
@@ -198,7 +207,6 @@ create_new_edge(char *from_ifname,
     edge->etype = UNICAST;
     edge->fa = NULL;
     edge->bandwidth = DEFAULT_LINK_BW;
-    edge->is_tilfa_pruned = FALSE;
     return edge;
 }
 
@@ -390,6 +398,17 @@ _spf_display_trace_options(unsigned long long bit_mask);
 
 extern void init_pfe();
 
+void
+instance_topology_changed(instance_t *instance, LEVEL level){
+
+    LEVEL level_it;
+
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+        if(IS_LEVEL_SET(level, level_it))
+            instance->topo_version[level_it]++;
+    }
+}
+
 instance_t *
 get_new_instance(){
 
@@ -404,6 +423,8 @@ get_new_instance(){
     register_display_trace_options(instance->traceopts, _spf_display_trace_options);
     enable_spf_trace(instance, SPF_EVENTS_BIT);
     instance->mapping_server = NULL;
+    spf_sched_init(&instance->spf_sched);
+    spf_sim_init(&instance->spf_sim);
     init_pfe();
     return instance;
 }
@@ -472,9 +493,8 @@ attach_prefix_on_node(node_t *node,
     _prefix->prefix_flags = prefix_flags;
 
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "Node : %s, prefix attached : %s/%u, prefix metric : %u",
+    SPF_TRACE(SPF_PREFIX_BIT, "Node : %s, prefix attached : %s/%u, prefix metric : %u",
         node->node_name, prefix, mask, metric);
-    trace(instance->traceopts, SPF_PREFIX_BIT);
 #endif
 
     if(add_prefix_to_prefix_list(GET_NODE_PREFIX_LIST(node, level), _prefix, 0))
@@ -504,9 +524,8 @@ deattach_prefix_on_node(node_t *node,
         return;
 
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "Node : %s, prefix deattached : %s/%u, prefix metric : %u",
-        node->node_name, prefix, mask, _prefix->metric); 
-    trace(instance->traceopts, SPF_PREFIX_BIT);
+    SPF_TRACE(SPF_PREFIX_BIT, "Node : %s, prefix deattached : %s/%u, prefix metric : %u",
+        node->node_name, prefix, mask, _prefix->metric);
 #endif
     singly_ll_remove_node_by_dataptr(GET_NODE_PREFIX_LIST(node, level), _prefix);
     free_prefix(_prefix);
@@ -542,7 +561,7 @@ get_interface_from_intf_name(node_t *node, char *intf_name){
             return NULL;
         }
 
-        if(strncmp(intf_name, interface->intf_name, strlen(interface->intf_name)))
+        if(strncmp(intf_name, interface->intf_name, IF_NAME_SIZE))
             continue;
 
         if(interface->dirn != OUTGOING)
@@ -46,10 +46,12 @@
 #include "rsvp.h"
 #include "Tree/candidate_tree.h"
 #include "spring_adjsid.h"
+#include "spfsim.h"
 
 
 typedef struct edge_end_ edge_end_t;
 typedef struct tilfa_info_ tilfa_info_t;
+typedef struct spf_path_result_table_ spf_path_result_table_t;
 
 typedef struct _node_t{
     char node_name[NODE_NAME_SIZE];
@@ -72,6 +74,7 @@ typedef struct _node_t{
 
     /*list of spf_path_result_t*/
     glthread_t spf_path_result[MAX_LEVEL][NH_MAX];
+    spf_path_result_table_t *spf_path_table[MAX_LEVEL][NH_MAX];
 
     /*Fields to handle pseudonode case*/
     edge_end_t *pn_intf[MAX_LEVEL];
@@ -87,10 +90,10 @@ typedef struct _node_t{
     spf_info_t spf_info;
     unsigned int instance_flags;                            /*Hope instance flags are not level specific, is there any ? If we come across later, we will have level specific flags*/
     boolean is_node_on_heap;
+    boolean is_node_frozen;                                 /*Settled by an incremental SPF run, never queued into candidate tree*/
 
     char attributes[MAX_LEVEL];                             /*1 Bytes of router attributes*/
     char traversing_bit;                                    /*This bit is only used to traverse the instance, otherwise it is not specification requirement. 1 if the node has been visited, zero otherwise*/
-    char lsp_distribution_bit;
     internal_nh_t pq_nodes[MAX_LEVEL][MAX_NXT_HOPS];
     unsigned int backup_spf_options;
 
@@ -103,6 +106,15 @@ typedef struct _node_t{
     /*Our implementation specific*/
     char flags[MAX_LEVEL];
     glthread_t temp_thread; /*For temporary work*/
+    unsigned int nbr_spf_index[MAX_LEVEL]; /*Index of the node in batched nbr SPF distance rows*/
+    unsigned int rev_spf_index[MAX_LEVEL]; /*Index of the node in reverse SPF cache rows*/
+    unsigned int rev_spf_row[MAX_LEVEL];   /*Reverse SPF cache row holding DIST(*, node)*/
+    unsigned int tilfa_spt_index[MAX_LEVEL]; /*Index of the node in TILFA pre-convergence SPT snapshot*/
+    unsigned int tilfa_rspf_index[MAX_LEVEL];   /*Index of the node in TILFA remote SPF cache rows*/
+    int tilfa_rspf_row[MAX_LEVEL][2];           /*TILFA remote SPF cache row of forward and reverse run rooted at the node*/
+    unsigned int node_index;                    /*Dense index of the node in the instance, assigned at creation*/
+    unsigned int lsp_proc_delay_usec;           /*LSP processing delay in flooding simulation, 0 for the instance default*/
+    spf_sim_conv_t sim_conv;                    /*Convergence of the node in the current flooding epoch*/
 
     /*LDP related config*/
     ldp_config_t ldp_config;
@@ -166,7 +178,7 @@ typedef struct _edge_t{
     rsvp_tunnel_t *fa;      /*Forwarding adjacency*/
     char status;            /* 0 down, 1 up*/
     float bandwidth; /*bandwidth for WECMP in GIG*/
-    boolean is_tilfa_pruned;
+    unsigned int delay_usec; /*LSP propagation delay in flooding simulation, 0 for the instance default*/
 } edge_t;
 
 typedef struct instance_{
@@ -177,11 +189,21 @@ typedef struct instance_{
     /*SR mapping server. We support only one mapping
      * server per topology*/
     node_t *mapping_server;
+    /*Bumped on every change to the graph of a level SPF runs over :
+     * adjacency metric or state, node overload. Distances cached
+     * across SPF runs are valid for one version only*/
+    unsigned int topo_version[MAX_LEVEL];
+    unsigned int n_node_index;  /*Nodes created so far, bounds node->node_index*/
+    spf_sched_instance_t spf_sched;
+    spf_sim_t spf_sim;          /*LSP flooding and SPF runs in virtual time*/
 } instance_t;
 
 node_t *
 create_new_node(instance_t *instance, char *node_name, AREA area, char *router_id);
 
+node_t *
+_create_new_node(instance_t *instance, char *node_name, AREA area, char *router_id);
+
 
 edge_t *
 create_new_edge(char *from_ifname, 
@@ -199,6 +221,9 @@ insert_edge_between_2_nodes(edge_t *edge,
 void
 set_instance_root(instance_t *instance, node_t *root);
 
+void
+instance_topology_changed(instance_t *instance, LEVEL level);
+
 instance_t *
 get_new_instance();
 
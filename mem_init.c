@@ -62,10 +62,10 @@ init_memory_manager(){
     MM_REG_STRUCT(singly_ll_node_t);
     MM_REG_STRUCT(Queue_t);
     MM_REG_STRUCT(stack_t);
-    MM_REG_STRUCT(pred_info_t);
-    MM_REG_STRUCT(spf_path_result_t);
+    MM_REG_STRUCT(spf_path_result_table_t);
     MM_REG_STRUCT(internal_un_nh_t);
     MM_REG_STRUCT(rt_un_entry_t);
+    MM_REG_STRUCT(nh_group_t);
     MM_REG_STRUCT(rt_un_table_t);
     MM_REG_STRUCT(mpls_label_stack_t);
     //MM_REG_STRUCT(node_t);
@@ -86,7 +86,6 @@ init_memory_manager(){
     MM_REG_STRUCT(lan_adj_sid_subtlv_t);
     MM_REG_STRUCT(p2p_adj_sid_subtlv_t);
     MM_REG_STRUCT(prefix_sid_subtlv_t);
-    MM_REG_STRUCT(tilfa_remote_spf_result_t);
     MM_REG_STRUCT(tilfa_info_t);
     MM_REG_STRUCT(tilfa_lcl_config_t);
     MM_REG_STRUCT(protected_resource_t);     
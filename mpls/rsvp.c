@@ -264,7 +264,7 @@ create_targeted_rsvp_tunnel(node_t *ingress_lsr,                      /*Ingress
         /*Check if RSVP nexthop is already installed via proxy nbr in local inet.3 table*/
         rt_un_entry = inet_3_rib->rt_un_route_lookup(inet_3_rib, &inet_key);
 
-        ITERATE_GLTHREAD_BEGIN(&rt_un_entry->nh_list_head, curr){
+        ITERATE_GLTHREAD_BEGIN(RT_UN_ENTRY_NH_LIST(rt_un_entry), curr){
             nexthop = glthread_to_unified_nh(curr);
             if(nexthop->oif == oif && !strncmp(nexthop->gw_prefix, gw_ip, PREFIX_LEN) &&
                     nexthop->protocol == RSVP_PROTO){
@@ -272,7 +272,7 @@ create_targeted_rsvp_tunnel(node_t *ingress_lsr,                      /*Ingress
                 is_exist = TRUE;
                 break;
             }
-        }ITERATE_GLTHREAD_END(&rt_un_entry->nh_list_head, curr);
+        }ITERATE_GLTHREAD_END(RT_UN_ENTRY_NH_LIST(rt_un_entry), curr);
 
         if(is_exist){
             next_node = nexthop->nh_node;
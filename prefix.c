@@ -305,9 +305,8 @@ leak_prefix(char *node_name, char *_prefix, char mask,
                         to_level, prefix->metric, prefix->prefix_flags);
         if(!leaked_prefix){
 #ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s, equal best prefix : %s already leaked/present in %s\n",
+            SPF_TRACE(SPF_PREFIX_BIT, "Node : %s, equal best prefix : %s already leaked/present in %s\n",
                 node->node_name, STR_PREFIX(prefix), get_str_level(to_level));
-            trace(instance->traceopts, SPF_PREFIX_BIT);
 #endif
             return NULL;
         }
@@ -317,9 +316,8 @@ leak_prefix(char *node_name, char *_prefix, char mask,
             SET_BIT(leaked_prefix->prefix_flags, PREFIX_DOWNBIT_FLAG);
 
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Node : %s : prefix %s/%u leaked from %s to %s", 
+        SPF_TRACE(SPF_PREFIX_BIT, "Node : %s : prefix %s/%u leaked from %s to %s", 
                 node->node_name, STR_PREFIX(prefix), PREFIX_MASK(prefix), get_str_level(from_level), get_str_level(to_level));
-        trace(instance->traceopts, SPF_PREFIX_BIT);
 #endif
 
         return leaked_prefix;
@@ -350,9 +348,8 @@ leak_prefix(char *node_name, char *_prefix, char mask,
 
         if(!leaked_prefix){
 #ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s, equal best prefix : %s already leaked/present in %s\n",
+            SPF_TRACE(SPF_PREFIX_BIT, "Node : %s, equal best prefix : %s already leaked/present in %s\n",
                 node->node_name, STR_PREFIX(prefix), get_str_level(to_level));
-            trace(instance->traceopts, SPF_PREFIX_BIT);
 #endif
             return NULL;
         }
@@ -364,11 +361,10 @@ leak_prefix(char *node_name, char *_prefix, char mask,
             SET_BIT(leaked_prefix->prefix_flags, PREFIX_DOWNBIT_FLAG);
 
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Node : %s : prefix %s/%u leaked from %s to %s", 
+        SPF_TRACE(SPF_PREFIX_BIT, "Node : %s : prefix %s/%u leaked from %s to %s", 
                 node->node_name, route_to_be_leaked->rt_key.u.prefix.prefix, 
                 route_to_be_leaked->rt_key.u.prefix.mask, get_str_level(from_level), 
                 get_str_level(to_level)); 
-        trace(instance->traceopts, SPF_PREFIX_BIT); 
 #endif
 
         return leaked_prefix;
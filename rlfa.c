@@ -32,6 +32,12 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <assert.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 #include "rlfa.h"
 #include "instance.h"
 #include "spfutil.h"
@@ -216,6 +222,705 @@ Compute_LOGICAL_Neighbor_SPFs(node_t *spf_root, LEVEL level){
     } ITERATE_NODE_LOGICAL_NBRS_END;
 }
 
+/*Batched nbr SPFs*/
+
+static nbr_spf_batch_t nbr_spf_batch[MAX_LEVEL];
+
+typedef struct nbr_spf_heap_entry_{
+
+    unsigned int dist;
+    unsigned int row;
+    unsigned int node_index;
+} nbr_spf_heap_entry_t;
+
+static nbr_spf_heap_entry_t *nbr_spf_heap = NULL;
+static unsigned int nbr_spf_heap_alloc = 0;
+
+static unsigned int
+nbr_spf_batch_alloc_size(unsigned int alloc, unsigned int required){
+
+    if(!alloc) alloc = 64;
+    while(alloc < required)
+        alloc <<= 1;
+    return alloc;
+}
+
+#define NBR_SPF_BATCH_REALLOC(_array, _alloc)                           \
+    do{                                                                 \
+        _array = realloc(_array, (size_t)(_alloc) * sizeof(*(_array))); \
+        assert(_array);                                                 \
+    } while(0)
+
+static inline boolean
+is_nbr_spf_batch_indexed(nbr_spf_batch_t *batch, node_t *node){
+
+    unsigned int index = node->nbr_spf_index[batch->level];
+    return (index < batch->node_count && batch->nodes[index] == node);
+}
+
+static void
+nbr_spf_batch_index_node(nbr_spf_batch_t *batch, node_t *node){
+
+    /*adj_offset needs one extra slot to terminate the last node's adjacency*/
+    if(batch->node_count + 2 > batch->node_alloc){
+        batch->node_alloc = nbr_spf_batch_alloc_size(batch->node_alloc, batch->node_count + 2);
+        NBR_SPF_BATCH_REALLOC(batch->nodes, batch->node_alloc);
+        NBR_SPF_BATCH_REALLOC(batch->src_row, batch->node_alloc);
+        NBR_SPF_BATCH_REALLOC(batch->overloaded, batch->node_alloc);
+        NBR_SPF_BATCH_REALLOC(batch->root_index, batch->node_alloc);
+        NBR_SPF_BATCH_REALLOC(batch->adj_offset, batch->node_alloc);
+    }
+
+    node->nbr_spf_index[batch->level] = batch->node_count;
+    batch->nodes[batch->node_count] = node;
+    batch->src_row[batch->node_count] = -1;
+    batch->overloaded[batch->node_count] = IS_OVERLOADED(node, batch->level) ? 1 : 0;
+    batch->node_count++;
+}
+
+/*Walk the level graph from spf root once, indexing the nodes in BFS order
+ * and recording every usable adjacency with its metric. The checks are the
+ * same run_dijkastra() applies on every relaxation, overload is applied at
+ * relaxation*/
+static void
+nbr_spf_batch_build_graph(nbr_spf_batch_t *batch){
+
+    unsigned int i = 0;
+    node_t *node = NULL,
+           *nbr_node = NULL;
+    edge_t *edge = NULL;
+    LEVEL level = batch->level;
+
+    batch->node_count = 0;
+    batch->adj_count = 0;
+    nbr_spf_batch_index_node(batch, batch->spf_root);
+
+    for(i = 0; i < batch->node_count; i++){
+
+        node = batch->nodes[i];
+        batch->adj_offset[i] = batch->adj_count;
+
+        ITERATE_NODE_LOGICAL_NBRS_BEGIN(node, nbr_node, edge, level){
+
+            if(!is_nbr_spf_batch_indexed(batch, nbr_node))
+                nbr_spf_batch_index_node(batch, nbr_node);
+
+            if(!is_two_way_nbrship(node, nbr_node, level) ||
+                    edge->status == 0)
+                continue;
+
+            if(batch->adj_count == batch->adj_alloc){
+                batch->adj_alloc = nbr_spf_batch_alloc_size(batch->adj_alloc, batch->adj_count + 1);
+                NBR_SPF_BATCH_REALLOC(batch->adj_node, batch->adj_alloc);
+                NBR_SPF_BATCH_REALLOC(batch->adj_metric, batch->adj_alloc);
+            }
+
+            batch->adj_node[batch->adj_count] = nbr_node->nbr_spf_index[level];
+            batch->adj_metric[batch->adj_count] = edge->metric[level];
+            batch->adj_count++;
+        } ITERATE_NODE_LOGICAL_NBRS_END;
+    }
+    batch->adj_offset[batch->node_count] = batch->adj_count;
+}
+
+/*Dense level graph as walked by spf_dense_run(), adjacencies of node i are
+ * [offset[i], offset[i + 1])*/
+typedef struct spf_dense_graph_{
+
+    unsigned int node_count;
+    unsigned int *offset;
+    unsigned int *adj_node;
+    unsigned int *adj_metric;
+    unsigned char *overloaded;
+} spf_dense_graph_t;
+
+/*Regroup the adjacencies by their far end (counting sort), so that
+ * DIST(*, X) can be computed by walking them backwards from X. radj_offset
+ * must hold node_count + 1 entries, radj_node and radj_metric adj_count*/
+static void
+spf_dense_reverse_adjacencies(unsigned int node_count, unsigned int *adj_offset,
+                              unsigned int *adj_node, unsigned int *adj_metric,
+                              unsigned int *radj_offset, unsigned int *radj_node,
+                              unsigned int *radj_metric){
+
+    unsigned int i = 0, j = 0, pos = 0;
+
+    memset(radj_offset, 0, (node_count + 1) * sizeof(unsigned int));
+    for(i = 0; i < adj_offset[node_count]; i++)
+        radj_offset[adj_node[i] + 1]++;
+    for(i = 0; i < node_count; i++)
+        radj_offset[i + 1] += radj_offset[i];
+
+    for(i = 0; i < node_count; i++){
+        for(j = adj_offset[i]; j < adj_offset[i + 1]; j++){
+            pos = radj_offset[adj_node[j]]++;
+            radj_node[pos] = i;
+            radj_metric[pos] = adj_metric[j];
+        }
+    }
+    /*Each offset now points to the end of its group, shift them back*/
+    for(i = node_count; i > 0; i--)
+        radj_offset[i] = radj_offset[i - 1];
+    radj_offset[0] = 0;
+}
+
+static void
+nbr_spf_heap_push(unsigned int *heap_size, unsigned int dist,
+                  unsigned int row, unsigned int node_index){
+
+    unsigned int i = *heap_size,
+                 parent = 0;
+    nbr_spf_heap_entry_t entry;
+
+    if(*heap_size == nbr_spf_heap_alloc){
+        nbr_spf_heap_alloc = nbr_spf_batch_alloc_size(nbr_spf_heap_alloc, *heap_size + 1);
+        NBR_SPF_BATCH_REALLOC(nbr_spf_heap, nbr_spf_heap_alloc);
+    }
+
+    entry.dist = dist;
+    entry.row = row;
+    entry.node_index = node_index;
+
+    while(i){
+        parent = (i - 1) >> 1;
+        if(nbr_spf_heap[parent].dist <= dist)
+            break;
+        nbr_spf_heap[i] = nbr_spf_heap[parent];
+        i = parent;
+    }
+    nbr_spf_heap[i] = entry;
+    (*heap_size)++;
+}
+
+static nbr_spf_heap_entry_t
+nbr_spf_heap_pop(unsigned int *heap_size){
+
+    unsigned int i = 0, child = 0;
+    nbr_spf_heap_entry_t top = nbr_spf_heap[0],
+                         last = nbr_spf_heap[--(*heap_size)];
+
+    while((child = (i << 1) + 1) < *heap_size){
+        if(child + 1 < *heap_size &&
+                nbr_spf_heap[child + 1].dist < nbr_spf_heap[child].dist)
+            child++;
+        if(last.dist <= nbr_spf_heap[child].dist)
+            break;
+        nbr_spf_heap[i] = nbr_spf_heap[child];
+        i = child;
+    }
+    nbr_spf_heap[i] = last;
+    return top;
+}
+
+/*Multi source dijkastra over a dense graph, with one distance row of
+ * node_count entries for each root in root_index. Labels of all roots share
+ * one heap. A reverse graph is walked backwards, and so yields DIST(*, root)
+ * instead of DIST(root, *). Returns the no of labels settled*/
+static unsigned int
+spf_dense_run(spf_dense_graph_t *graph, boolean reverse,
+              unsigned int *root_index, unsigned int root_count,
+              unsigned int *rows){
+
+    unsigned int i = 0,
+                 heap_size = 0,
+                 heap_pops = 0,
+                 new_dist = 0,
+                 metric = 0,
+                 from = 0,
+                 node_count = graph->node_count;
+    unsigned int *row = NULL;
+    nbr_spf_heap_entry_t top;
+
+    for(i = 0; i < root_count * node_count; i++)
+        rows[i] = INFINITE_METRIC;
+
+    for(i = 0; i < root_count; i++){
+        rows[i * node_count + root_index[i]] = 0;
+        nbr_spf_heap_push(&heap_size, 0, i, root_index[i]);
+    }
+
+    while(heap_size){
+
+        top = nbr_spf_heap_pop(&heap_size);
+        row = &rows[top.row * node_count];
+        if(top.dist != row[top.node_index])
+            continue; /*stale label*/
+        heap_pops++;
+
+        for(i = graph->offset[top.node_index]; i < graph->offset[top.node_index + 1]; i++){
+
+            /*Adjacencies going out of an overloaded node are at infinite metric*/
+            from = reverse ? graph->adj_node[i] : top.node_index;
+            metric = graph->overloaded[from] ? INFINITE_METRIC : graph->adj_metric[i];
+
+            if((unsigned long long)top.dist + (unsigned long long)metric >=
+                    (unsigned long long)row[graph->adj_node[i]])
+                continue;
+            new_dist = top.dist + metric;
+            row[graph->adj_node[i]] = new_dist;
+            nbr_spf_heap_push(&heap_size, new_dist, top.row, graph->adj_node[i]);
+        }
+    }
+    return heap_pops;
+}
+
+static unsigned int
+nbr_spf_batch_run(nbr_spf_batch_t *batch, unsigned int *rows, unsigned int root_count){
+
+    spf_dense_graph_t graph;
+
+    graph.node_count = batch->node_count;
+    graph.offset = batch->adj_offset;
+    graph.adj_node = batch->adj_node;
+    graph.adj_metric = batch->adj_metric;
+    graph.overloaded = batch->overloaded;
+    return spf_dense_run(&graph, FALSE, batch->root_index, root_count, rows);
+}
+
+/* Inequality 1 : DIST(N,D) < DIST(N,S) + DIST(S,D), for every nbr row against
+ * every destination column. Each row is compared over contiguous distances
+ * into a bit per destination, four destinations per SSE2 compare where
+ * available, and only the set bits are then scattered into the per destination
+ * bitmasks, so that LFA selection only visits the surviving (nbr, destination)
+ * pairs. The sum is deliberately kept in unsigned int arithmetic as in the per
+ * destination evaluation. Downstream and node protection inequalities depend
+ * on the primary nexthops of each destination, LFA selection still evaluates
+ * them on the survivors*/
+static void
+nbr_spf_batch_compare_row(unsigned int *row, unsigned int *root_row,
+                          unsigned int node_count, unsigned long long *row_bits){
+
+    unsigned int d = 0,
+                 dist_N_S = row[0];
+#ifdef __SSE2__
+    /*SSE2 has signed compares only, flipping the sign bit of both sides
+     * orders unsigned values the same way*/
+    __m128i sign_bit = _mm_set1_epi32((int)0x80000000),
+            v_dist_N_S = _mm_set1_epi32((int)dist_N_S),
+            lhs, rhs;
+    unsigned long long lt_mask = 0;
+
+    for(; d + 4 <= node_count; d += 4){
+        lhs = _mm_xor_si128(_mm_loadu_si128((__m128i *)&row[d]), sign_bit);
+        rhs = _mm_add_epi32(_mm_loadu_si128((__m128i *)&root_row[d]), v_dist_N_S);
+        rhs = _mm_xor_si128(rhs, sign_bit);
+        lt_mask = (unsigned long long)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(lhs, rhs)));
+        /*d is a multiple of 4, the 4 bits never straddle two words*/
+        row_bits[d >> 6] |= lt_mask << (d & 63);
+    }
+#endif
+    for(; d < node_count; d++){
+        if(row[d] < dist_N_S + root_row[d])
+            row_bits[d >> 6] |= 1ULL << (d & 63);
+    }
+}
+
+static void
+nbr_spf_batch_compute_lfa_cand_masks(nbr_spf_batch_t *batch){
+
+    unsigned int r = 0, d = 0, w = 0,
+                 node_count = batch->node_count,
+                 row_words = (node_count + 63) >> 6,
+                 mask_size = 0;
+    unsigned int *row = NULL,
+                 *root_row = &batch->dist[batch->src_count * node_count];
+    unsigned long long bit = 0,
+                       row_bits = 0;
+
+    batch->mask_words = (batch->src_count + 63) >> 6;
+    mask_size = batch->mask_words * node_count;
+    if(mask_size > batch->mask_alloc){
+        batch->mask_alloc = nbr_spf_batch_alloc_size(batch->mask_alloc, mask_size);
+        NBR_SPF_BATCH_REALLOC(batch->lfa_cand_mask, batch->mask_alloc);
+    }
+    memset(batch->lfa_cand_mask, 0, mask_size * sizeof(unsigned long long));
+    batch->lfa_candidates = 0;
+
+    if(row_words > batch->row_bits_alloc){
+        batch->row_bits_alloc = nbr_spf_batch_alloc_size(batch->row_bits_alloc, row_words);
+        NBR_SPF_BATCH_REALLOC(batch->lfa_row_bits, batch->row_bits_alloc);
+    }
+
+    for(r = 0; r < batch->src_count; r++){
+
+        row = &batch->dist[r * node_count];
+        memset(batch->lfa_row_bits, 0, row_words * sizeof(unsigned long long));
+        nbr_spf_batch_compare_row(row, root_row, node_count, batch->lfa_row_bits);
+
+        bit = 1ULL << (r & 63);
+        for(w = 0; w < row_words; w++){
+            row_bits = batch->lfa_row_bits[w];
+            while(row_bits){
+                d = (w << 6) + __builtin_ctzll(row_bits);
+                row_bits &= row_bits - 1;
+                batch->lfa_cand_mask[d * batch->mask_words + (r >> 6)] |= bit;
+                batch->lfa_candidates++;
+            }
+        }
+    }
+}
+
+/* Compute DIST(N, *) for all physical nbrs N of spf_root in one pass. Labels of
+ * all sources share one heap, so the topology is walked once to build the dense
+ * graph instead of once per nbr, and no per nbr spf_init(), next hop copy or
+ * result list bookkeeping is done. Only distances are produced, which is all LFA
+ * and RLFA inequalities need from nbr SPF runs*/
+void
+Compute_Batched_PHYSICAL_Neighbor_SPFs(node_t *spf_root, LEVEL level){
+
+    unsigned int i = 0,
+                 dist_size = 0;
+    node_t *nbr_node = NULL,
+           *pn_node = NULL;
+    edge_t *edge1 = NULL, *edge2 = NULL;
+    struct timespec start_time, end_time;
+    nbr_spf_batch_t *batch = &nbr_spf_batch[level];
+
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+    batch->spf_root = spf_root;
+    batch->level = level;
+    batch->src_count = 0;
+    batch->heap_pops = 0;
+    batch->rlfa_links = 0;
+    batch->ext_p_count = 0;
+    batch->q_count = 0;
+    batch->pq_count = 0;
+    nbr_spf_batch_build_graph(batch);
+
+    ITERATE_NODE_PHYSICAL_NBRS_BEGIN(spf_root, nbr_node, pn_node, edge1, edge2, level){
+        if(batch->src_row[nbr_node->nbr_spf_index[level]] == -1)
+            batch->src_row[nbr_node->nbr_spf_index[level]] = batch->src_count++;
+    } ITERATE_NODE_PHYSICAL_NBRS_END(spf_root, nbr_node, pn_node, level);
+
+    dist_size = (batch->src_count + 1) * batch->node_count;
+    if(dist_size > batch->dist_alloc){
+        batch->dist_alloc = nbr_spf_batch_alloc_size(batch->dist_alloc, dist_size);
+        NBR_SPF_BATCH_REALLOC(batch->dist, batch->dist_alloc);
+    }
+
+    for(i = 0; i < batch->node_count; i++){
+        if(batch->src_row[i] != -1)
+            batch->root_index[batch->src_row[i]] = i;
+    }
+    /*spf root is always indexed first*/
+    batch->root_index[batch->src_count] = 0;
+    batch->heap_pops += nbr_spf_batch_run(batch, batch->dist, batch->src_count + 1);
+
+    nbr_spf_batch_compute_lfa_cand_masks(batch);
+    batch->active = TRUE;
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    batch->run_time_nsec = (end_time.tv_sec - start_time.tv_sec) * 1000000000UL +
+                           end_time.tv_nsec - start_time.tv_nsec;
+#ifdef __ENABLE_TRACE__
+    SPF_TRACE(DIJKSTRA_BIT, "Node : %s : Batched nbr SPF at %s, %u nbrs, %u nodes, %u labels settled, "
+            "%u LFA candidates, %lu ns", spf_root->node_name, get_str_level(level), batch->src_count,
+            batch->node_count, batch->heap_pops, batch->lfa_candidates, batch->run_time_nsec);
+#endif
+}
+
+/*Stop serving DIST_X_Y() out of the batch, distances computed afterwards
+ * through regular SPF runs take over. Buffers are kept for the next batch*/
+void
+nbr_spf_batch_release(LEVEL level){
+
+    nbr_spf_batch[level].active = FALSE;
+}
+
+boolean
+nbr_spf_batch_dist(node_t *X, node_t *Y, LEVEL level, unsigned int *dist){
+
+    nbr_spf_batch_t *batch = &nbr_spf_batch[level];
+    int src_row = -1;
+
+    if(!batch->active)
+        return FALSE;
+    if(!is_nbr_spf_batch_indexed(batch, X))
+        return FALSE;
+    src_row = batch->src_row[X->nbr_spf_index[level]];
+    if(src_row == -1)
+        return FALSE;
+    /*Nodes not indexed are not reachable from spf root, hence not from its nbrs either*/
+    *dist = is_nbr_spf_batch_indexed(batch, Y) ?
+        batch->dist[src_row * batch->node_count + Y->nbr_spf_index[level]] :
+        INFINITE_METRIC;
+    return TRUE;
+}
+
+nbr_spf_batch_t *
+nbr_spf_batch_get(LEVEL level){
+
+    return &nbr_spf_batch[level];
+}
+
+/*LFA candidate mask of destination D computed by the active batch of S,
+ * NULL if there is none, in which case callers evaluate inequality 1 themselves*/
+unsigned long long *
+nbr_spf_batch_lfa_candidates(node_t *S, node_t *D, LEVEL level){
+
+    nbr_spf_batch_t *batch = &nbr_spf_batch[level];
+
+    if(!batch->active || batch->spf_root != S)
+        return NULL;
+    if(!is_nbr_spf_batch_indexed(batch, D))
+        return NULL;
+    return &batch->lfa_cand_mask[D->nbr_spf_index[level] * batch->mask_words];
+}
+
+/*Test the bit of nbr N in a destination's LFA candidate mask. NULL N
+ * asks if any nbr is a candidate at all*/
+boolean
+nbr_spf_batch_is_lfa_candidate(unsigned long long *lfa_cand_mask, node_t *N, LEVEL level){
+
+    nbr_spf_batch_t *batch = &nbr_spf_batch[level];
+    unsigned int i = 0;
+    int src_row = -1;
+
+    if(!N){
+        for(i = 0; i < batch->mask_words; i++){
+            if(lfa_cand_mask[i]) return TRUE;
+        }
+        return FALSE;
+    }
+    if(!is_nbr_spf_batch_indexed(batch, N))
+        return TRUE;
+    src_row = batch->src_row[N->nbr_spf_index[level]];
+    if(src_row == -1)
+        return TRUE;
+    return (lfa_cand_mask[src_row >> 6] & (1ULL << (src_row & 63))) != 0;
+}
+
+/*Batch of S to evaluate RLFA spaces on. Callers outside the backup
+ * computation window of S get a batch of their own, which they release
+ * once done*/
+static nbr_spf_batch_t *
+nbr_spf_batch_acquire(node_t *S, LEVEL level, boolean *own_batch){
+
+    nbr_spf_batch_t *batch = &nbr_spf_batch[level];
+
+    *own_batch = FALSE;
+    if(batch->active && batch->spf_root == S)
+        return batch;
+    Compute_Batched_PHYSICAL_Neighbor_SPFs(S, level);
+    *own_batch = TRUE;
+    return batch;
+}
+
+/*DIST(X, *) row of source X, NULL if X is not a physical nbr of spf root*/
+static unsigned int *
+nbr_spf_batch_src_dist(nbr_spf_batch_t *batch, node_t *X){
+
+    int src_row = -1;
+
+    if(!is_nbr_spf_batch_indexed(batch, X))
+        return NULL;
+    src_row = batch->src_row[X->nbr_spf_index[batch->level]];
+    if(src_row == -1)
+        return NULL;
+    return &batch->dist[src_row * batch->node_count];
+}
+
+/*DIST(roots[r], *) in row r for arbitrary indexed roots. Rows stay valid
+ * till the next call*/
+static unsigned int *
+nbr_spf_batch_rows(nbr_spf_batch_t *batch, node_t **roots,
+                   unsigned int root_count){
+
+    unsigned int i = 0,
+                 rows_size = root_count * batch->node_count;
+
+    assert(root_count <= batch->node_alloc);
+    for(i = 0; i < root_count; i++){
+        assert(is_nbr_spf_batch_indexed(batch, roots[i]));
+        batch->root_index[i] = roots[i]->nbr_spf_index[batch->level];
+    }
+
+    if(rows_size > batch->aux_alloc){
+        batch->aux_alloc = nbr_spf_batch_alloc_size(batch->aux_alloc, rows_size);
+        NBR_SPF_BATCH_REALLOC(batch->aux_dist, batch->aux_alloc);
+    }
+    batch->heap_pops += nbr_spf_batch_run(batch, batch->aux_dist, root_count);
+    return batch->aux_dist;
+}
+
+/*Reverse SPF cache*/
+
+static rev_spf_cache_t rev_spf_cache[MAX_LEVEL];
+
+static inline boolean
+is_rev_spf_cache_indexed(rev_spf_cache_t *cache, node_t *node){
+
+    unsigned int index = node->rev_spf_index[cache->level];
+    return (index < cache->node_count && cache->nodes[index] == node);
+}
+
+/*Index every node of the instance and record the usable adjacencies of the
+ * level, grouped by their far end. Unlike the nbr SPF batch the graph does
+ * not depend on any spf root, so rows are shared by all PLRs*/
+static void
+rev_spf_cache_build_graph(rev_spf_cache_t *cache){
+
+    unsigned int i = 0,
+                 adj_count = 0,
+                 adj_alloc = 0,
+                 *adj_offset = NULL,
+                 *adj_node = NULL,
+                 *adj_metric = NULL;
+    node_t *node = NULL,
+           *nbr_node = NULL;
+    edge_t *edge = NULL;
+    singly_ll_node_t *list_node = NULL;
+    LEVEL level = cache->level;
+
+    cache->node_count = 0;
+    ITERATE_LIST_BEGIN(instance->instance_node_list, list_node){
+        node = list_node->data;
+        if(cache->node_count + 2 > cache->node_alloc){
+            cache->node_alloc = nbr_spf_batch_alloc_size(cache->node_alloc, cache->node_count + 2);
+            NBR_SPF_BATCH_REALLOC(cache->nodes, cache->node_alloc);
+            NBR_SPF_BATCH_REALLOC(cache->overloaded, cache->node_alloc);
+            NBR_SPF_BATCH_REALLOC(cache->root_index, cache->node_alloc);
+            NBR_SPF_BATCH_REALLOC(cache->radj_offset, cache->node_alloc);
+        }
+        node->rev_spf_index[level] = cache->node_count;
+        cache->nodes[cache->node_count] = node;
+        cache->overloaded[cache->node_count] = IS_OVERLOADED(node, level) ? 1 : 0;
+        cache->node_count++;
+    } ITERATE_LIST_END;
+
+    /*Forward adjacencies are only needed to regroup them*/
+    adj_offset = calloc(cache->node_count + 1, sizeof(unsigned int));
+    assert(adj_offset);
+
+    for(i = 0; i < cache->node_count; i++){
+
+        node = cache->nodes[i];
+        adj_offset[i] = adj_count;
+
+        ITERATE_NODE_LOGICAL_NBRS_BEGIN(node, nbr_node, edge, level){
+
+            if(!is_rev_spf_cache_indexed(cache, nbr_node))
+                continue;
+            if(!is_two_way_nbrship(node, nbr_node, level) ||
+                    edge->status == 0)
+                continue;
+
+            if(adj_count == adj_alloc){
+                adj_alloc = nbr_spf_batch_alloc_size(adj_alloc, adj_count + 1);
+                NBR_SPF_BATCH_REALLOC(adj_node, adj_alloc);
+                NBR_SPF_BATCH_REALLOC(adj_metric, adj_alloc);
+            }
+
+            adj_node[adj_count] = nbr_node->rev_spf_index[level];
+            adj_metric[adj_count] = edge->metric[level];
+            adj_count++;
+        } ITERATE_NODE_LOGICAL_NBRS_END;
+    }
+    adj_offset[cache->node_count] = adj_count;
+    cache->adj_count = adj_count;
+
+    if(adj_count > cache->adj_alloc){
+        cache->adj_alloc = nbr_spf_batch_alloc_size(cache->adj_alloc, adj_count);
+        NBR_SPF_BATCH_REALLOC(cache->radj_node, cache->adj_alloc);
+        NBR_SPF_BATCH_REALLOC(cache->radj_metric, cache->adj_alloc);
+    }
+
+    spf_dense_reverse_adjacencies(cache->node_count, adj_offset, adj_node, adj_metric,
+        cache->radj_offset, cache->radj_node, cache->radj_metric);
+
+    free(adj_offset);
+    free(adj_node);
+    free(adj_metric);
+}
+
+/* Fill rows[r] with DIST(*, roots[r]), a row of cache->node_count entries
+ * indexed by node->rev_spf_index[level], see rev_spf_cache_dist(). Rows of
+ * roots seen before at the current topology version are served from the
+ * cache, the missing ones are computed together in one reverse run. Rows
+ * stay valid till the next lookup*/
+void
+rev_spf_cache_lookup(LEVEL level, node_t **roots, 
+                     unsigned int root_count, unsigned int **rows){
+
+    unsigned int i = 0,
+                 row = 0,
+                 first_new_row = 0,
+                 rows_size = 0;
+    node_t *root = NULL;
+    spf_dense_graph_t graph;
+    rev_spf_cache_t *cache = &rev_spf_cache[level];
+
+    if(!cache->valid || cache->instance != instance ||
+            cache->topo_version != instance->topo_version[level]){
+
+        cache->level = level;
+        cache->instance = instance;
+        cache->topo_version = instance->topo_version[level];
+        rev_spf_cache_build_graph(cache);
+        cache->row_count = 0;
+        cache->valid = TRUE;
+        cache->rebuilds++;
+    }
+
+    first_new_row = cache->row_count;
+    for(i = 0; i < root_count; i++){
+
+        root = roots[i];
+        assert(is_rev_spf_cache_indexed(cache, root));
+        row = root->rev_spf_row[level];
+        if(row < cache->row_count && cache->row_roots[row] == root){
+            if(row < first_new_row)
+                cache->hits++;
+            continue;
+        }
+        if(cache->row_count == cache->row_alloc){
+            cache->row_alloc = nbr_spf_batch_alloc_size(cache->row_alloc, cache->row_count + 1);
+            NBR_SPF_BATCH_REALLOC(cache->row_roots, cache->row_alloc);
+        }
+        root->rev_spf_row[level] = cache->row_count;
+        cache->row_roots[cache->row_count++] = root;
+        cache->misses++;
+    }
+
+    if(cache->row_count > first_new_row){
+
+        rows_size = cache->row_count * cache->node_count;
+        if(rows_size > cache->dist_alloc){
+            cache->dist_alloc = nbr_spf_batch_alloc_size(cache->dist_alloc, rows_size);
+            NBR_SPF_BATCH_REALLOC(cache->dist, cache->dist_alloc);
+        }
+        for(row = first_new_row; row < cache->row_count; row++)
+            cache->root_index[row - first_new_row] = cache->row_roots[row]->rev_spf_index[level];
+
+        graph.node_count = cache->node_count;
+        graph.offset = cache->radj_offset;
+        graph.adj_node = cache->radj_node;
+        graph.adj_metric = cache->radj_metric;
+        graph.overloaded = cache->overloaded;
+        spf_dense_run(&graph, TRUE, cache->root_index, cache->row_count - first_new_row,
+            &cache->dist[first_new_row * cache->node_count]);
+    }
+
+    for(i = 0; i < root_count; i++)
+        rows[i] = &cache->dist[roots[i]->rev_spf_row[level] * cache->node_count];
+}
+
+/*DIST(X, root) out of the row of root*/
+unsigned int
+rev_spf_cache_dist(unsigned int *row, node_t *X, LEVEL level){
+
+    rev_spf_cache_t *cache = &rev_spf_cache[level];
+
+    return is_rev_spf_cache_indexed(cache, X) ?
+        row[X->rev_spf_index[level]] : INFINITE_METRIC;
+}
+
+rev_spf_cache_t *
+rev_spf_cache_get(LEVEL level){
+
+    return &rev_spf_cache[level];
+}
+
 static boolean
 broadcast_node_protection_critera(node_t *S, 
                                   LEVEL level, edge_t *protected_link, 
@@ -321,8 +1026,8 @@ broadcast_compute_link_node_protecting_extended_p_space(node_t *S,
         d_S_to_p_node = spf_result_p_node->spf_metric;
         d_PN_to_p_node = DIST_X_Y(PN, P_node, level);
 #ifdef __ENABLE_TRACE__
-        sprintf(instance->traceopts->b, "Node : %s : Begin ext-pspace computation for S=%s, protected-link = %s, LEVEL = %s",
-                S->node_name, S->node_name, protected_link->from.intf_name, get_str_level(level)); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+        SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Begin ext-pspace computation for S=%s, protected-link = %s, LEVEL = %s",
+                S->node_name, S->node_name, protected_link->from.intf_name, get_str_level(level));
 #endif
 
         ITERATE_NODE_PHYSICAL_NBRS_BEGIN(S, nbr_node, pn_node, edge1, edge2, level){
@@ -347,9 +1052,8 @@ broadcast_compute_link_node_protecting_extended_p_space(node_t *S,
 
             if(!(d_S_to_nbr <  d_S_to_PN + d_PN_to_nbr)){
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Nbr %s will not be considered for computing P-space," 
-                        "nbr traverses protected link", S->node_name, nbr_node->node_name); 
-                trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Nbr %s will not be considered for computing P-space," 
+                        "nbr traverses protected link", S->node_name, nbr_node->node_name);
 #endif
                 ITERATE_NODE_PHYSICAL_NBRS_CONTINUE(S, nbr_node, pn_node, level);
             }   
@@ -362,64 +1066,63 @@ broadcast_compute_link_node_protecting_extended_p_space(node_t *S,
 
                 /*Loop free inequality 1 : N should be Loop free wrt S and PN*/
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Testing inequality 1 : checking loop free wrt S = %s, Nbr = %s(oif = %s), P_node = %s",
-                        S->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name, P_node->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT); 
+                SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Testing inequality 1 : checking loop free wrt S = %s, Nbr = %s(oif = %s), P_node = %s",
+                        S->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name, P_node->node_name); 
 #endif
 
                 d_nbr_to_S = DIST_X_Y(nbr_node, S, level);
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : d_nbr_to_p_node(%u) < d_nbr_to_S(%u) + d_S_to_p_node(%u)",
-                        S->node_name, d_nbr_to_p_node, d_nbr_to_S, d_S_to_p_node); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : d_nbr_to_p_node(%u) < d_nbr_to_S(%u) + d_S_to_p_node(%u)",
+                        S->node_name, d_nbr_to_p_node, d_nbr_to_S, d_S_to_p_node);
 #endif
 
                 if(!(d_nbr_to_p_node < d_nbr_to_S + d_S_to_p_node)){
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : inequality 1 failed, Nbr = %s(oif = %s) is not loop free wrt S", 
-                            S->node_name, nbr_node->node_name, edge1->from.intf_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                    SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : inequality 1 failed, Nbr = %s(oif = %s) is not loop free wrt S", 
+                            S->node_name, nbr_node->node_name, edge1->from.intf_name);
 #endif
                     continue;
                 }
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : above inequality 1 passed", S->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : above inequality 1 passed", S->node_name);
 #endif
                 /*Testing Downstream condition : P-node must be downstream node*/
                 if(!(d_nbr_to_p_node < d_S_to_p_node)){
 #ifdef __ENABLE_TRACE__
-                    sprintf(instance->traceopts->b, "Node : %s : Down Stream Inqequality failed : Nbr = %s(oif = %s), P_node = %s",
-                        S->node_name, nbr_node->node_name, edge1->from.intf_name, P_node->node_name); 
-                    trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                    SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Down Stream Inqequality failed : Nbr = %s(oif = %s), P_node = %s",
+                        S->node_name, nbr_node->node_name, edge1->from.intf_name, P_node->node_name);
 #endif
                     ITERATE_NODE_PHYSICAL_NBRS_CONTINUE(S, nbr_node, pn_node, level);
                 }
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Testing node protection inequality for Broadcast link: S = %s, nbr = %s, P_node = %s, PN = %s",
-                        S->node_name, S->node_name, nbr_node->node_name, P_node->node_name, PN->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Testing node protection inequality for Broadcast link: S = %s, nbr = %s, P_node = %s, PN = %s",
+                        S->node_name, S->node_name, nbr_node->node_name, P_node->node_name, PN->node_name);
 #endif
                 /*Node protection criteria for broadcast link should be : Nbr should be able to send traffic to P_node wihout 
                  * passing through any node attached to broadcast segment*/
 
                 if(broadcast_node_protection_critera(S, level, protected_link, P_node, nbr_node) == TRUE){
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : Above node protection inequality passed", S->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                    SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Above node protection inequality passed", S->node_name);
 #endif
 
                     rlfa = get_next_hop_empty_slot(S->pq_nodes[level]);
                     rlfa->lfa_type = BROADCAST_NODE_PROTECTION_RLFA;
                     /*Check for link protection, nbr_node should be loop free wrt to PN*/
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : Checking if potential P_node = %s provide broadcast link protection to S = %s, Nbr = %s(oif=%s)",
-                            S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                    SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Checking if potential P_node = %s provide broadcast link protection to S = %s, Nbr = %s(oif=%s)",
+                            S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name);
 #endif
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : Checking if Nbr  = %s(oif=%s) is  loop free wrt to PN = %s", 
-                            S->node_name, nbr_node->node_name, edge1->from.intf_name, PN->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                    SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Checking if Nbr  = %s(oif=%s) is  loop free wrt to PN = %s", 
+                            S->node_name, nbr_node->node_name, edge1->from.intf_name, PN->node_name);
 #endif
                     /*For link protection, Nbr should be loop free wrt to PN*/
                     if(d_nbr_to_p_node < (d_nbr_to_PN + d_PN_to_p_node)){
                         rlfa->lfa_type = BROADCAST_LINK_AND_NODE_PROTECTION_RLFA;
 #ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "Node : %s : P_node = %s provide node-link protection to S = %s, Nbr = %s(oif=%s)",
-                                S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                        SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : P_node = %s provide node-link protection to S = %s, Nbr = %s(oif=%s)",
+                                S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name);
 #endif
                     }
                     rlfa->level = level;     
@@ -439,33 +1142,33 @@ broadcast_compute_link_node_protecting_extended_p_space(node_t *S,
                 }
 
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Above node protection inequality failed", S->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Above node protection inequality failed", S->node_name);
 #endif
 
                 if(is_link_protection_enabled == FALSE){
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s :  Link degradation is disabled, candidate P_node = %s"
+                    SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s :  Link degradation is disabled, candidate P_node = %s"
                             " rejected to qualify as p-node for S = %s, Nbr = %s(oif=%s)", 
-                            S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                            S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name);
 #endif
                     ITERATE_NODE_PHYSICAL_NBRS_CONTINUE(S, nbr_node, pn_node, level);
                 }
                 /*P_node could not provide node protection, check for link protection*/
                 if(is_link_protection_enabled == TRUE){
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : Checking if potential P_node = %s provide broadcast link protection to S = %s, Nbr = %s(oif=%s)",
-                            S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                    SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Checking if potential P_node = %s provide broadcast link protection to S = %s, Nbr = %s(oif=%s)",
+                            S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name);
 #endif
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : Checking if Nbr  = %s(oif=%s) is  loop free wrt to PN = %s", 
-                            S->node_name, nbr_node->node_name, edge1->from.intf_name, PN->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                    SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Checking if Nbr  = %s(oif=%s) is  loop free wrt to PN = %s", 
+                            S->node_name, nbr_node->node_name, edge1->from.intf_name, PN->node_name);
 #endif
 
                     /*For link protection, Nbr should be loop free wrt to PN*/
                     if(d_nbr_to_p_node < (d_nbr_to_PN + d_PN_to_p_node)){
 #ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "Node : %s : P_node = %s provide link protection to S = %s, Nbr = %s(oif=%s)",
-                                S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                        SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : P_node = %s provide link protection to S = %s, Nbr = %s(oif=%s)",
+                                S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name);
 #endif
                         rlfa = get_next_hop_empty_slot(S->pq_nodes[level]);
                         rlfa->level = level;     
@@ -485,16 +1188,16 @@ broadcast_compute_link_node_protecting_extended_p_space(node_t *S,
                         ITERATE_NODE_PHYSICAL_NBRS_BREAK(S, nbr_node, pn_node, level);
                     }
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : candidate P_node = %s do not provide link protection" 
+                    SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : candidate P_node = %s do not provide link protection" 
                             " rejected to qualify as p-node for S = %s, Nbr = %s(oif=%s)",
-                            S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                            S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name);
 #endif
                 }
             }else if(is_link_protection_enabled == TRUE){
                 if(d_nbr_to_p_node < (d_nbr_to_PN + d_PN_to_p_node)){
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : P_node = %s provide link protection to S = %s, Nbr = %s(oif=%s)",
-                            S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                    SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : P_node = %s provide link protection to S = %s, Nbr = %s(oif=%s)",
+                            S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name);
 #endif
                     rlfa = get_next_hop_empty_slot(S->pq_nodes[level]);
                     rlfa->level = level;     
@@ -520,37 +1223,81 @@ broadcast_compute_link_node_protecting_extended_p_space(node_t *S,
     } ITERATE_LIST_END;
 }   
 
+/*Physical nbr of S eligible to be the proxy nbr of P nodes, with the P nodes
+ * it can reach node protecting and (only) link protecting*/
+typedef struct rlfa_proxy_nbr_{
+
+    node_t *nbr_node;
+    edge_t *edge1;
+    edge_t *edge2;
+    unsigned int *dist;
+    bit_array_t node_protecting;
+    bit_array_t link_protecting;
+} rlfa_proxy_nbr_t;
+
+static void
+p2p_add_p_node(node_t *S, edge_t *protected_link, LEVEL level,
+               rlfa_proxy_nbr_t *proxy, node_t *P_node,
+               unsigned int d_S_to_p_node, lfa_type_t lfa_type){
+
+    internal_nh_t *rlfa = get_next_hop_empty_slot(S->pq_nodes[level]);
+
+    rlfa->level = level;
+    rlfa->oif = &proxy->edge1->from;
+    rlfa->protected_link = &protected_link->from;
+    rlfa->node = NULL;
+    if(proxy->edge1->etype == UNICAST)
+        set_next_hop_gw_pfx(*rlfa, proxy->edge2->to.prefix[level]->prefix);
+    rlfa->nh_type = LSPNH;
+    rlfa->lfa_type = lfa_type;
+    rlfa->proxy_nbr = proxy->nbr_node;
+    rlfa->rlfa = P_node;
+    //rlfa->mpls_label_in = 1;
+    rlfa->root_metric = d_S_to_p_node;
+    rlfa->dest_metric = 0; /*Not known yet*/
+    rlfa->is_eligible = TRUE; /*Not known yet*/
+}
+
 /*-----------------------------------------------------------------------------
  *  This routine returns the set of routers in the extended p-space of 'node' wrt to
  *  'edge'. Note that, 'edge' need not be directly connected edge of 'node'.
+ *  The inequalities are evaluated for every (nbr, P node) pair in one sweep
+ *  over the rows of the nbr SPF batch, giving per nbr bitsets of P nodes. The
+ *  P nodes are then picked in the order of S's spf result as before
  *-----------------------------------------------------------------------------*/
 void
 p2p_compute_link_node_protecting_extended_p_space(node_t *S, 
                                                   edge_t *protected_link, 
                                                   LEVEL level){
 
-    /*Compute p space of all nbrs of node except protected_link->to.node
-     * and union it. Remove duplicates from union*/
-
     node_t *nbr_node = NULL,
-    *E = NULL,
-    *pn_node = NULL,
-    *P_node = NULL;
+           *E = NULL,
+           *pn_node = NULL,
+           *P_node = NULL,
+           *last_nbr = NULL,
+           *skip_nbr = NULL;
 
     edge_t *edge1 = NULL, *edge2 = NULL;
     singly_ll_node_t *list_node1 = NULL;
-    internal_nh_t *rlfa = NULL;
-
-    unsigned int d_nbr_to_p_node = 0,
+    spf_result_t *spf_result_p_node = NULL;
+    nbr_spf_batch_t *batch = NULL;
+    rlfa_proxy_nbr_t *proxy_nbrs = NULL,
+                     *proxy = NULL;
+    bit_array_t candidates;
+
+    unsigned int *root_dist = NULL,
+                 *E_dist = NULL,
+                 *nbr_dist = NULL,
+                 i = 0, p = 0,
+                 node_count = 0,
+                 proxy_count = 0,
+                 E_index = 0,
+                 nbr_index = 0,
+                 d_nbr_to_p_node = 0,
                  d_nbr_to_S = 0,
                  d_nbr_to_E = 0,
-                 d_E_to_nbr =0,
-                 d_E_to_p_node = 0,
-                 d_S_to_p_node = 0,
-                 d_S_to_nbr = 0,
                  d_S_to_E = 0;
-
-    spf_result_t *spf_result_p_node = NULL;
+    boolean own_batch = FALSE;
 
     if(!IS_LEVEL_SET(protected_link->level, level))
         return;
@@ -562,201 +1309,179 @@ p2p_compute_link_node_protecting_extended_p_space(node_t *S,
     boolean is_link_protection_enabled = 
         IS_LINK_PROTECTION_ENABLED(protected_link);
 
-
-#if 0 /*Caller suppose to run these SPF runs*/
-    /*run spf on self*/
-    Compute_and_Store_Forward_SPF(S, level); 
-    /*Run SPF on all logical nbrs of S*/
-    Compute_PHYSICAL_Neighbor_SPFs(S, level);
-#endif
-    /*iterate over entire network. Note that node->spf_run_result list
-     * carries all nodes of the network reachable from source at level l.
-     * We deem this list as the "entire network"*/ 
+    /*Distances come from the nbr SPF batch of S, S's own spf result is
+     * used only to visit P nodes in SPF order. Note that node->spf_run_result
+     * list carries all nodes of the network reachable from source at level l.
+     * We deem this list as the "entire network"*/
     E = protected_link->to.node;
-    d_S_to_E = DIST_X_Y(S, E, level);
+    batch = nbr_spf_batch_acquire(S, level, &own_batch);
+    node_count = batch->node_count;
+    root_dist = &batch->dist[batch->src_count * node_count];
+    E_dist = nbr_spf_batch_src_dist(batch, E);
+    init_bit_array(&batch->ext_p_space, node_count);
+    batch->rlfa_links++;
 
-    ITERATE_LIST_BEGIN(S->spf_run_result[level], list_node1){
-        spf_result_p_node = (spf_result_t *)list_node1->data;
-        P_node = spf_result_p_node->node;
-
-        if(P_node == S || IS_OVERLOADED(P_node, level) || 
-                P_node == nbr_node || 
-                P_node == E) /*RFC 7490, section 4.2*/
-            continue;
+#ifdef __ENABLE_TRACE__        
+    SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Begin ext-pspace computation for S=%s, protected-link = %s, LEVEL = %s",
+            S->node_name, S->node_name, protected_link->from.intf_name, get_str_level(level));
+#endif
 
-        /* ToDo : RFC : Remote-LFA Node Protection and Manageability
-         * draft-ietf-rtgwg-rlfa-node-protection-13 - section 2.2.1*/
-        /* Testing ECMP equality : Nbr N should not have ECMP path to P_node 
-         * which traverses the S----E link -- wonder criteria of selecting the
-         * P node via N automatically subsume this */
+    /*P nodes are only selected with node protection enabled, E must be
+     * reachable for the node protection inequality*/
+    if(is_node_protection_enabled == FALSE || !E_dist){
+        if(own_batch)
+            nbr_spf_batch_release(level);
+        return;
+    }
 
-        d_S_to_p_node = spf_result_p_node->spf_metric;
+    E_index = E->nbr_spf_index[level];
+    d_S_to_E = root_dist[E_index];
 
-#ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Node : %s : Begin ext-pspace computation for S=%s, protected-link = %s, LEVEL = %s",
-                S->node_name, S->node_name, protected_link->from.intf_name, get_str_level(level)); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+    ITERATE_NODE_PHYSICAL_NBRS_BEGIN(S, nbr_node, pn_node, edge1, edge2, level){
+        proxy_count++;
+    } ITERATE_NODE_PHYSICAL_NBRS_END(S, nbr_node, pn_node, level);
 
-        ITERATE_NODE_PHYSICAL_NBRS_BEGIN(S, nbr_node, pn_node, edge1, edge2, level){
+    proxy_nbrs = calloc(proxy_count ? proxy_count : 1, sizeof(rlfa_proxy_nbr_t));
+    proxy_count = 0;
 
-            /*skip protected link itself */
-            if(edge1 == protected_link){
-                ITERATE_NODE_PHYSICAL_NBRS_CONTINUE(S, nbr_node, pn_node, level);
-            }
+    ITERATE_NODE_PHYSICAL_NBRS_BEGIN(S, nbr_node, pn_node, edge1, edge2, level){
 
-            /*RFC 7490 section 5.4 : skip neighbors in computation of PQ nodes(extended p space) 
-             * which are either overloaded or reachable through infinite metric*/
-            if(edge1->metric[level] >= INFINITE_METRIC){
-                ITERATE_NODE_PHYSICAL_NBRS_CONTINUE(S, nbr_node, pn_node, level);
-            }
-            if(IS_OVERLOADED(nbr_node, level)){
-                ITERATE_NODE_PHYSICAL_NBRS_CONTINUE(S, nbr_node, pn_node, level);
-            }
+        /*skip protected link itself */
+        if(edge1 == protected_link){
+            ITERATE_NODE_PHYSICAL_NBRS_CONTINUE(S, nbr_node, pn_node, level);
+        }
 
-            d_nbr_to_E = DIST_X_Y(nbr_node, E, level);
-            d_S_to_nbr = DIST_X_Y(S, nbr_node, level);
-            d_E_to_nbr = DIST_X_Y(E, nbr_node, level);
+        /*RFC 7490 section 5.4 : skip neighbors in computation of PQ nodes(extended p space) 
+         * which are either overloaded or reachable through infinite metric*/
+        if(edge1->metric[level] >= INFINITE_METRIC){
+            ITERATE_NODE_PHYSICAL_NBRS_CONTINUE(S, nbr_node, pn_node, level);
+        }
+        if(IS_OVERLOADED(nbr_node, level)){
+            ITERATE_NODE_PHYSICAL_NBRS_CONTINUE(S, nbr_node, pn_node, level);
+        }
 
-            /*  skip nbrs which are reachable from S from protected link*/
-            /* nbr should not be reachable via E. Examine
-             * only the node protecting nbrs since S need to establish the
-             * tunnel to P node and this tunnel should reach P via shortest path
-             * not passing through protected-link*/
+        nbr_dist = nbr_spf_batch_src_dist(batch, nbr_node);
+        if(!nbr_dist){
+            ITERATE_NODE_PHYSICAL_NBRS_CONTINUE(S, nbr_node, pn_node, level);
+        }
 
-            if(!(d_S_to_nbr <  d_S_to_E + d_E_to_nbr)){
+        /* nbr should not be reachable via E. Examine
+         * only the node protecting nbrs since S need to establish the
+         * tunnel to P node and this tunnel should reach P via shortest path
+         * not passing through protected-link*/
+        nbr_index = nbr_node->nbr_spf_index[level];
+        if(!(root_dist[nbr_index] < d_S_to_E + E_dist[nbr_index])){
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Nbr %s will not be considered for computing P-space," 
-                        "nbr traverses protected link", S->node_name, nbr_node->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+            SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Nbr %s will not be considered for computing P-space," 
+                    "nbr traverses protected link", S->node_name, nbr_node->node_name);
 #endif
-                ITERATE_NODE_PHYSICAL_NBRS_CONTINUE(S, nbr_node, pn_node, level);
-            }
+            ITERATE_NODE_PHYSICAL_NBRS_CONTINUE(S, nbr_node, pn_node, level);
+        }
 
-            d_nbr_to_p_node = DIST_X_Y(nbr_node, P_node, level);
-            if(is_node_protection_enabled == TRUE){
+        proxy = &proxy_nbrs[proxy_count++];
+        proxy->nbr_node = nbr_node;
+        proxy->edge1 = edge1;
+        proxy->edge2 = edge2;
+        proxy->dist = nbr_dist;
+    } ITERATE_NODE_PHYSICAL_NBRS_END(S, nbr_node, pn_node, level);
 
-                /*If node protection is enabled*/
-                d_E_to_p_node = DIST_X_Y(E, P_node, level);
+    /*nbr the walk over S's nbrs ends at when no proxy nbr is picked*/
+    last_nbr = nbr_node;
 
-                /*Loop free inequality 1 : N should be Loop free wrt S*/
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Testing inequality 1 : S = %s, Nbr = %s(oif = %s), P_node = %s",
-                        S->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name, P_node->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT); 
-#endif
+    memset(&candidates, 0, sizeof(bit_array_t));
+    init_bit_array(&candidates, node_count);
 
-                d_nbr_to_S = DIST_X_Y(nbr_node, S, level);
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : d_nbr_to_p_node(%u) < d_nbr_to_S(%u) + d_S_to_p_node(%u)",
-                        S->node_name, d_nbr_to_p_node, d_nbr_to_S, d_S_to_p_node); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+    for(i = 0; i < proxy_count; i++){
 
-                if(!(d_nbr_to_p_node < d_nbr_to_S + d_S_to_p_node)){
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : inequality 1 failed", S->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
-                    ITERATE_NODE_PHYSICAL_NBRS_CONTINUE(S, nbr_node, pn_node, level);
-                }
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : above inequality 1 passed", S->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+        proxy = &proxy_nbrs[i];
+        init_bit_array(&proxy->node_protecting, node_count);
+        init_bit_array(&proxy->link_protecting, node_count);
+        d_nbr_to_S = proxy->dist[0];
+        d_nbr_to_E = proxy->dist[E_index];
 
-                /*Testing Downstream condition : P-node must be downstream node*/
-                if(!(d_nbr_to_p_node < d_S_to_p_node)){
-#ifdef __ENABLE_TRACE__
-                    sprintf(instance->traceopts->b, "Node : %s : Down Stream Inqequality failed : Nbr = %s(oif = %s), P_node = %s",
-                        S->node_name, nbr_node->node_name, edge1->from.intf_name, P_node->node_name); 
-                    trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
-                    ITERATE_NODE_PHYSICAL_NBRS_CONTINUE(S, nbr_node, pn_node, level);
-                }
-                /*condition for node protection RLFA - RFC : 
-                 * draft-ietf-rtgwg-rlfa-node-protection-13 - section 2.2.6.2*/
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Testing node protection inequality : S = %s, nbr = %s, P_node = %s, E = %s",
-                        S->node_name, S->node_name, nbr_node->node_name, P_node->node_name, E->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : d_nbr_to_p_node(%u) < d_nbr_to_E(%u) + d_E_to_p_node(%u)", 
-                        S->node_name, d_nbr_to_p_node, d_nbr_to_E, d_E_to_p_node); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+        for(p = 0; p < node_count; p++){
 
-                if(d_nbr_to_p_node < (d_nbr_to_E + d_E_to_p_node)){
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : Above node protection inequality passed", S->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
-                    /*Node has been added to extended p-space, no need to check for link protection
-                     * as node-protecting node in extended pspace is automatically link protecting node for P2P links*/
-                    {
-                        rlfa = get_next_hop_empty_slot(S->pq_nodes[level]);
-                        rlfa->level = level;     
-                        rlfa->oif = &edge1->from;
-                        rlfa->protected_link = &protected_link->from;
-                        rlfa->node = NULL;
-                        if(edge1->etype == UNICAST)
-                            set_next_hop_gw_pfx(*rlfa, edge2->to.prefix[level]->prefix);
-                        rlfa->nh_type = LSPNH;
-                        rlfa->lfa_type = LINK_AND_NODE_PROTECTION_RLFA;
-                        rlfa->proxy_nbr = nbr_node;
-                        rlfa->rlfa = P_node;
-                        //rlfa->mpls_label_in = 1;
-                        rlfa->root_metric = d_S_to_p_node;
-                        rlfa->dest_metric = 0; /*Not known yet*/ 
-                        rlfa->is_eligible = TRUE; /*Not known yet*/
-                    }
-                    ITERATE_NODE_PHYSICAL_NBRS_BREAK(S, nbr_node, pn_node, level);
-                }
-#ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Above node protection inequality failed", S->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
-                if(is_link_protection_enabled == FALSE){
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s :  Link degradation is disabled, candidate P_node = %s"
-                            " rejected to qualify as p-node for S = %s, Nbr = %s(oif=%s)", 
-                            S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
-                    ITERATE_NODE_PHYSICAL_NBRS_CONTINUE(S, nbr_node, pn_node, level);
-                }
-                /*P_node could not provide node protection, check for link protection*/
-                if(is_link_protection_enabled == TRUE){
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : Checking if potential P_node = %s provide link protection to S = %s, Nbr = %s(oif=%s)",
-                            S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
-
-                    if(d_nbr_to_p_node < (d_nbr_to_S + protected_link->metric[level])){
-                        {
-                            rlfa = get_next_hop_empty_slot(S->pq_nodes[level]);
-                            rlfa->level = level;     
-                            rlfa->oif = &edge1->from;
-                            rlfa->protected_link = &protected_link->from;
-                            rlfa->node = NULL;
-                            if(edge1->etype == UNICAST)
-                                set_next_hop_gw_pfx(*rlfa, edge2->to.prefix[level]->prefix);
-                            rlfa->nh_type = LSPNH;
-                            rlfa->lfa_type = LINK_PROTECTION_RLFA;
-                            rlfa->proxy_nbr = nbr_node;
-                            rlfa->rlfa = P_node;
-                            //rlfa->mpls_label_in = 1;
-                            rlfa->root_metric = d_S_to_p_node;
-                            rlfa->dest_metric = 0; /*Not known yet*/ 
-                            rlfa->is_eligible = TRUE; /*Not known yet*/
-                        }
+            d_nbr_to_p_node = proxy->dist[p];
+
+            /*Loop free inequality 1 : N should be Loop free wrt S*/
+            if(!(d_nbr_to_p_node < d_nbr_to_S + root_dist[p]))
+                continue;
+            /*Testing Downstream condition : P-node must be downstream node*/
+            if(!(d_nbr_to_p_node < root_dist[p]))
+                continue;
+            /*condition for node protection RLFA - RFC : 
+             * draft-ietf-rtgwg-rlfa-node-protection-13 - section 2.2.6.2*/
+            if(d_nbr_to_p_node < d_nbr_to_E + E_dist[p]){
+                set_bit(&proxy->node_protecting, p);
+                continue;
+            }
+            /*P_node could not provide node protection, check for link protection*/
+            if(is_link_protection_enabled == TRUE &&
+                    d_nbr_to_p_node < d_nbr_to_S + protected_link->metric[level]){
+                set_bit(&proxy->link_protecting, p);
+            }
+        }
+        bit_array_or(&candidates, &proxy->node_protecting);
+        bit_array_or(&candidates, &proxy->link_protecting);
+    }
+
+    ITERATE_LIST_BEGIN(S->spf_run_result[level], list_node1){
+        spf_result_p_node = (spf_result_t *)list_node1->data;
+        P_node = spf_result_p_node->node;
+
+        /*As with the per P node walk over nbrs, a P node equal to the
+         * nbr that walk stopped at for the previous P node is skipped*/
+        if(P_node == S || IS_OVERLOADED(P_node, level) || 
+                P_node == skip_nbr || 
+                P_node == E) /*RFC 7490, section 4.2*/
+            continue;
+
+        skip_nbr = last_nbr;
+        if(!is_nbr_spf_batch_indexed(batch, P_node))
+            continue;
+        p = P_node->nbr_spf_index[level];
+        if(!is_bit_set(&candidates, p))
+            continue;
+
+        /* ToDo : RFC : Remote-LFA Node Protection and Manageability
+         * draft-ietf-rtgwg-rlfa-node-protection-13 - section 2.2.1*/
+        /*Node protecting P node is automatically link protecting for P2P links,
+         * the first nbr which qualifies P_node either way is its proxy nbr*/
+        for(i = 0; i < proxy_count; i++){
+
+            proxy = &proxy_nbrs[i];
+            if(is_bit_set(&proxy->node_protecting, p)){
+                p2p_add_p_node(S, protected_link, level, proxy, P_node,
+                    spf_result_p_node->spf_metric, LINK_AND_NODE_PROTECTION_RLFA);
+            }
+            else if(is_bit_set(&proxy->link_protecting, p)){
+                p2p_add_p_node(S, protected_link, level, proxy, P_node,
+                    spf_result_p_node->spf_metric, LINK_PROTECTION_RLFA);
+            }
+            else
+                continue;
 #ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "Node : %s : P_node = %s provide link protection to S = %s, Nbr = %s(oif=%s)",
-                                S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name); 
-                        trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
-                        ITERATE_NODE_PHYSICAL_NBRS_BREAK(S, nbr_node, pn_node, level);
-                    }
-#ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : candidate P_node = %s do not provide link protection" 
-                            " rejected to qualify as p-node for S = %s, Nbr = %s(oif=%s)",
-                            S->node_name, P_node->node_name, S->node_name, nbr_node->node_name, edge1->from.intf_name); 
-                    trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+            SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : P_node = %s provide %s protection to S = %s, Nbr = %s(oif=%s)",
+                    S->node_name, P_node->node_name, 
+                    is_bit_set(&proxy->node_protecting, p) ? "node" : "link",
+                    S->node_name, proxy->nbr_node->node_name, proxy->edge1->from.intf_name);
 #endif
-                }
-            }
-        } ITERATE_NODE_PHYSICAL_NBRS_END(S, nbr_node, pn_node, level);
+            set_bit(&batch->ext_p_space, p);
+            skip_nbr = proxy->nbr_node;
+            break;
+        }
     } ITERATE_LIST_END;
+
+    batch->ext_p_count += bit_array_count(&batch->ext_p_space);
+
+    for(i = 0; i < proxy_count; i++){
+        free_bit_array(&proxy_nbrs[i].node_protecting);
+        free_bit_array(&proxy_nbrs[i].link_protecting);
+    }
+    free(proxy_nbrs);
+    free_bit_array(&candidates);
+    if(own_batch)
+        nbr_spf_batch_release(level);
 }   
 
 void
@@ -820,8 +1545,8 @@ broadcast_filter_select_pq_nodes_from_ex_pspace(node_t *S, edge_t *protected_lin
             is_dest_impacted = is_destination_impacted(S, protected_link, D_res->node, 
                         level, impact_reason, &mandatory_node_protection);
 #ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Dest = %s Impact result = %s\n    reason : %s", D_res->node->node_name, 
-                    is_dest_impacted ? "IMPACTED" : "NOT-IMPCATED", impact_reason); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+            SPF_TRACE(BACKUP_COMPUTATION_BIT, "Dest = %s Impact result = %s\n    reason : %s", D_res->node->node_name, 
+                    is_dest_impacted ? "IMPACTED" : "NOT-IMPCATED", impact_reason);
 #endif
 
             if(is_dest_impacted == FALSE) continue;
@@ -832,8 +1557,8 @@ broadcast_filter_select_pq_nodes_from_ex_pspace(node_t *S, edge_t *protected_lin
                  * p_node should be loop free wrt to PN*/
                 if(mandatory_node_protection == TRUE){
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : Pnode  %s not considered for link protection RLFA as Dest %s has ECMP, failed to qualify as PQ node",
-                            S->node_name, p_node->rlfa->node_name, D_res->node->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                    SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Pnode  %s not considered for link protection RLFA as Dest %s has ECMP, failed to qualify as PQ node",
+                            S->node_name, p_node->rlfa->node_name, D_res->node->node_name);
 #endif
                     continue;
                 }
@@ -842,16 +1567,16 @@ broadcast_filter_select_pq_nodes_from_ex_pspace(node_t *S, edge_t *protected_lin
                 d_E_to_D = DIST_X_Y(E, D_res->node, level);
                 if(!(d_p_to_D < d_p_to_E + d_E_to_D)){
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : Link protected p-node %s failed to qualify as link protection Q node",
-                            S->node_name, p_node->rlfa->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                    SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Link protected p-node %s failed to qualify as link protection Q node",
+                            S->node_name, p_node->rlfa->node_name);
 #endif
                     /*p node fails to provide link protection, this do not qualifies to be pq node*/
                     continue;    
                 }
                 /*Doesnt matter if p_node qualifies node protection criteria, it will be link protecting only*/
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Link protected p-node %s qualify as link protection Q node",
-                        S->node_name, p_node->rlfa->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Link protected p-node %s qualify as link protection Q node",
+                        S->node_name, p_node->rlfa->node_name);
 #endif
                 rlfa = get_next_hop_empty_slot(D_res->node->backup_next_hop[level][LSPNH]);
                 //(*(p_node->ref_count))++;
@@ -864,8 +1589,8 @@ broadcast_filter_select_pq_nodes_from_ex_pspace(node_t *S, edge_t *protected_lin
             if(broadcast_node_protection_critera(S, level, protected_link, D_res->node, p_node->rlfa) == TRUE){
                 /*This node provides node protection to Destination D*/
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Node protected p-node %s qualify as node protection Q node for for Dest %s",
-                        S->node_name, p_node->rlfa->node_name, D_res->node->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Node protected p-node %s qualify as node protection Q node for for Dest %s",
+                        S->node_name, p_node->rlfa->node_name, D_res->node->node_name);
 #endif
                 
                 /*When tested for P nodes, node protecting p-nodes are automatically link protecting 
@@ -877,24 +1602,22 @@ broadcast_filter_select_pq_nodes_from_ex_pspace(node_t *S, edge_t *protected_lin
             }
 
 #ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s : Node protected p-node %s failed to qualify as node protection Q node for Dest %s",
-                S->node_name, p_node->rlfa->node_name, D_res->node->node_name); 
-            trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+            SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Node protected p-node %s failed to qualify as node protection Q node for Dest %s",
+                S->node_name, p_node->rlfa->node_name, D_res->node->node_name);
 #endif
             /*p_node fails to provide node protection, demote the p_node to LINK_PROTECTION
              * if it provides atleast link protection to Destination D*/
             if(mandatory_node_protection == TRUE){
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Pnode  %s not considered for link protection RLFA as Dest %s has ECMP, failed to qualify as PQ node",
-                        S->node_name, p_node->rlfa->node_name, D_res->node->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Pnode  %s not considered for link protection RLFA as Dest %s has ECMP, failed to qualify as PQ node",
+                        S->node_name, p_node->rlfa->node_name, D_res->node->node_name);
 #endif
                 continue;
             }
 
             if(!IS_LINK_PROTECTION_ENABLED(protected_link)){
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : node link degradation is not enabled", S->node_name);
-                trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : node link degradation is not enabled", S->node_name);
 #endif
                 continue;
             }
@@ -904,15 +1627,15 @@ broadcast_filter_select_pq_nodes_from_ex_pspace(node_t *S, edge_t *protected_lin
             d_E_to_D = DIST_X_Y(E, D_res->node, level);
             if(!(d_p_to_D < d_p_to_E + d_E_to_D)){
 #ifdef __ENABLE_TRACE__
-                sprintf(instance->traceopts->b, "Node : %s : Node protected p-node %s failed to qualify as link protection Q node for Dest %s",
-                            S->node_name, p_node->rlfa->node_name, D_res->node->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Node protected p-node %s failed to qualify as link protection Q node for Dest %s",
+                            S->node_name, p_node->rlfa->node_name, D_res->node->node_name);
 #endif
                 continue;
             }
 #ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s : Node protected p-node %s qualify as link protection Q node"
+            SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Node protected p-node %s qualify as link protection Q node"
                     "Demoted from LINK_NODE_PROTECTION to LINK_PROTECTION PQ node for Dest %s", 
-                     S->node_name, p_node->rlfa->node_name, D_res->node->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                     S->node_name, p_node->rlfa->node_name, D_res->node->node_name);
 #endif
             rlfa = get_next_hop_empty_slot(D_res->node->backup_next_hop[level][LSPNH]);
             //(*(p_node->ref_count))++;
@@ -932,62 +1655,114 @@ p2p_filter_select_pq_nodes_from_ex_pspace(node_t *S,
                  d_p_to_E = 0,
                  d_p_to_D = 0,
                  d_E_to_D = 0,
-                 i = 0;
+                 i = 0, p = 0,
+                 node_count = 0,
+                 pq_count = 0;
+
+    unsigned int *rev_rows[2],
+                 *p_to_S = NULL,
+                 *p_to_E = NULL,
+                 *pq_dist = NULL,
+                 *p_dist = NULL;
 
     char impact_reason[STRING_REASON_LEN];
-    node_t *E = protected_link->to.node;
+    node_t *E = protected_link->to.node,
+           *roots[MAX_NXT_HOPS];
     internal_nh_t *p_node = NULL,
                   *rlfa = NULL;
 
     spf_result_t *D_res = NULL;
     singly_ll_node_t *list_node1 = NULL;
-    assert(!is_broadcast_link(protected_link, level));
+    nbr_spf_batch_t *batch = NULL;
+    boolean own_batch = FALSE;
 
-    /*Compute reverse SPF for nodes S and E as roots*/
-    inverse_topology(instance, level);
-    Compute_and_Store_Forward_SPF(S, level);
-    Compute_and_Store_Forward_SPF(E, level);
-    inverse_topology(instance, level);
+    assert(!is_broadcast_link(protected_link, level));
 
-    d_S_to_E = DIST_X_Y(E, S, level);
+    batch = nbr_spf_batch_acquire(S, level, &own_batch);
+    node_count = batch->node_count;
+
+    /*Reverse SPF for nodes S and E as roots : DIST(*, S) and DIST(*, E),
+     * shared with other protected links and PLRs till the topology changes*/
+    roots[0] = S;
+    roots[1] = E;
+    rev_spf_cache_lookup(level, roots, 2, rev_rows);
+    p_to_S = rev_rows[0];
+    p_to_E = rev_rows[1];
+
+    d_S_to_E = rev_spf_cache_dist(p_to_E, S, level);
+
+    /*Link protecting Q space : DIST(p, E) < DIST(p, S) + DIST(S, E)*/
+    init_bit_array(&batch->q_space, node_count);
+    for(p = 0; p < node_count; p++){
+        if(rev_spf_cache_dist(p_to_E, batch->nodes[p], level) <
+                rev_spf_cache_dist(p_to_S, batch->nodes[p], level) + d_S_to_E)
+            set_bit(&batch->q_space, p);
+    }
 
-    for( ; i < MAX_NXT_HOPS; i++){
+    /*PQ space = extended P space AND Q space*/
+    init_bit_array(&batch->pq_space, node_count);
+    for(i = 0; i < MAX_NXT_HOPS; i++){
         p_node = &S->pq_nodes[level][i];
         if(is_empty_internal_nh(p_node))
             break;
-        /*This node cannot provide node protection, check only link protection*/
-        d_p_to_S = DIST_X_Y(S, p_node->rlfa, level); 
-        d_p_to_E = DIST_X_Y(E, p_node->rlfa, level);
-        if(!(d_p_to_E < d_p_to_S + d_S_to_E)){
-#ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s : p-node %s failed to qualify as link protection Q node",
-                    S->node_name, p_node->rlfa->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+        if(is_nbr_spf_batch_indexed(batch, p_node->rlfa))
+            set_bit(&batch->pq_space, p_node->rlfa->nbr_spf_index[level]);
+    }
+    bit_array_and(&batch->pq_space, &batch->q_space);
+    pq_count = bit_array_count(&batch->pq_space);
+    batch->q_count += bit_array_count(&batch->q_space);
+    batch->pq_count += pq_count;
+#ifdef __ENABLE_TRACE__
+    SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : protected-link = %s, %u ext-pspace nodes, %u Q nodes, %u PQ nodes",
+            S->node_name, protected_link->from.intf_name, bit_array_count(&batch->ext_p_space),
+            bit_array_count(&batch->q_space), pq_count);
 #endif
-            /*p node fails to provide link protection, this do not qualifies to be pq node*/
-            p_node->is_eligible = FALSE;
+
+    for(i = 0; i < MAX_NXT_HOPS; i++){
+        p_node = &S->pq_nodes[level][i];
+        if(is_empty_internal_nh(p_node))
+            break;
+        if(is_nbr_spf_batch_indexed(batch, p_node->rlfa) &&
+            is_bit_set(&batch->pq_space, p_node->rlfa->nbr_spf_index[level]))
             continue;
-        }
-#if 0
-        /*Doesnt matter if p_node qualifies node protection criteria, it will be link protecting only*/
-#ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Node : %s : p-node %s qualify as link protection Q node",
-                S->node_name, p_node->rlfa->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
-#endif
+#ifdef __ENABLE_TRACE__            
+        SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : p-node %s failed to qualify as link protection Q node",
+                S->node_name, p_node->rlfa->node_name);
 #endif
+        /*p node fails to provide link protection, this do not qualifies to be pq node*/
+        p_node->is_eligible = FALSE;
     }
+
+    if(!pq_count){
+        if(own_batch)
+            nbr_spf_batch_release(level);
+        return;
+    }
+
+    /*For node protection, DIST(pq node, *) of all PQ nodes in one forward run*/
+    pq_count = 0;
+    for(i = 0; i < MAX_NXT_HOPS; i++){
+        p_node = &S->pq_nodes[level][i];
+        if(is_nh_list_empty2(p_node)) break;
+        if(p_node->is_eligible == FALSE) continue;
+        roots[pq_count++] = p_node->rlfa;
+    }
+    pq_dist = nbr_spf_batch_rows(batch, roots, pq_count);
+
+    pq_count = 0;
     for( i = 0; i < MAX_NXT_HOPS; i++){
         p_node = &S->pq_nodes[level][i];
         if(is_nh_list_empty2(p_node)) break;
         if(p_node->is_eligible == FALSE) continue;
 
-        /*For node protection, Run the Forward SPF run on PQ nodes*/
-        Compute_and_Store_Forward_SPF(p_node->rlfa, level);
+        d_p_to_E = rev_spf_cache_dist(p_to_E, p_node->rlfa, level);
+        d_p_to_S = rev_spf_cache_dist(p_to_S, p_node->rlfa, level);
+        p_dist = &pq_dist[pq_count++ * node_count];
+
         /*Now inspect all Destinations which are impacted by the link*/
         boolean is_dest_impacted = FALSE,
                 mandatory_node_protection = FALSE;
 
-        d_p_to_E = DIST_X_Y(E, p_node->rlfa, level); 
-        d_p_to_S = DIST_X_Y(S, p_node->rlfa, level);
         ITERATE_LIST_BEGIN(S->spf_run_result[level], list_node1){
             is_dest_impacted = FALSE;
             D_res = list_node1->data;
@@ -1011,29 +1786,30 @@ p2p_filter_select_pq_nodes_from_ex_pspace(node_t *S,
             is_dest_impacted = is_destination_impacted(S, protected_link, D_res->node, 
                     level, impact_reason, &mandatory_node_protection);
 #ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Dest = %s Impact result = %s\n    reason : %s", D_res->node->node_name, 
-                    is_dest_impacted ? "IMPACTED" : "NOT-IMPCATED", impact_reason); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+            SPF_TRACE(BACKUP_COMPUTATION_BIT, "Dest = %s Impact result = %s\n    reason : %s", D_res->node->node_name, 
+                    is_dest_impacted ? "IMPACTED" : "NOT-IMPCATED", impact_reason);
 #endif
 
             if(is_dest_impacted == FALSE) continue;
 
             /*Check if p_node provides node protection*/
             if(p_node->lfa_type == LINK_AND_NODE_PROTECTION_RLFA){
-                d_p_to_D = DIST_X_Y(p_node->rlfa, D_res->node, level);
+                d_p_to_D = is_nbr_spf_batch_indexed(batch, D_res->node) ?
+                    p_dist[D_res->node->nbr_spf_index[level]] : INFINITE_METRIC;
                 d_E_to_D = DIST_X_Y(E, D_res->node, level);
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Cheking if Node-protected p-node %s  qualify as node protection Q node for Dest %s",
-                            S->node_name, p_node->rlfa->node_name, D_res->node->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Cheking if Node-protected p-node %s  qualify as node protection Q node for Dest %s",
+                            S->node_name, p_node->rlfa->node_name, D_res->node->node_name);
 #endif
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : d_p_to_D(%u) < d_p_to_E(%u) + d_E_to_D(%u)", 
-                            S->node_name, d_p_to_D, d_p_to_E, d_E_to_D); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : d_p_to_D(%u) < d_p_to_E(%u) + d_E_to_D(%u)", 
+                            S->node_name, d_p_to_D, d_p_to_E, d_E_to_D);
 #endif
                 if(d_p_to_D < d_p_to_E + d_E_to_D){
                     /*This node provides node protection to Destination D*/
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : Node protected p-node %s qualify as node protection Q node for Dest %s",
-                            S->node_name, p_node->rlfa->node_name, D_res->node->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                    SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Node protected p-node %s qualify as node protection Q node for Dest %s",
+                            S->node_name, p_node->rlfa->node_name, D_res->node->node_name);
 #endif
                     p_node->dest_metric = d_p_to_D;
                     rlfa = get_next_hop_empty_slot(D_res->node->backup_next_hop[level][LSPNH]);
@@ -1043,30 +1819,29 @@ p2p_filter_select_pq_nodes_from_ex_pspace(node_t *S,
                 }
 
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Node protected p-node %s failed to qualify as node protection Q node for Dest %s",
-                        S->node_name, p_node->rlfa->node_name, D_res->node->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Node protected p-node %s failed to qualify as node protection Q node for Dest %s",
+                        S->node_name, p_node->rlfa->node_name, D_res->node->node_name);
 #endif
                 /*p_node fails to provide node protection, demote the p_node to LINK_PROTECTION
                  * if it provides atleast link protection to Destination D*/
                 if(!IS_LINK_PROTECTION_ENABLED(protected_link)){
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : node link degradation is not enabled", S->node_name);
-                    trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                    SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : node link degradation is not enabled", S->node_name);
 #endif
                     continue;
                 }
 
                 if(mandatory_node_protection == TRUE){
 #ifdef __ENABLE_TRACE__
-                    sprintf(instance->traceopts->b, "Node : %s : Pnode  %s not considered for link protection RLFA as Dest %s has ECMP, failed to qualify as PQ node",
-                            S->node_name, p_node->rlfa->node_name, D_res->node->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                    SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Pnode  %s not considered for link protection RLFA as Dest %s has ECMP, failed to qualify as PQ node",
+                            S->node_name, p_node->rlfa->node_name, D_res->node->node_name);
 #endif
                     continue;
                 }
                 if(!(d_p_to_D < d_p_to_S + protected_link->metric[level])){
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : Node protected p-node %s failed to qualify as link protection Q node for Dest %s",
-                            S->node_name, p_node->rlfa->node_name, D_res->node->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                    SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Node protected p-node %s failed to qualify as link protection Q node for Dest %s",
+                            S->node_name, p_node->rlfa->node_name, D_res->node->node_name);
 #endif
                     continue;
                 }
@@ -1076,9 +1851,9 @@ p2p_filter_select_pq_nodes_from_ex_pspace(node_t *S,
                 copy_internal_nh_t(*p_node, *rlfa);
                 rlfa->lfa_type = LINK_PROTECTION_RLFA;
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Node protected p-node %s qualify as link protection Q node"
+                SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Node protected p-node %s qualify as link protection Q node"
                         "Demoted from LINK_AND_NODE_PROTECTION_RLFA to LINK_PROTECTION_RLFA PQ node for Dest %s", 
-                        S->node_name, p_node->rlfa->node_name, D_res->node->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                        S->node_name, p_node->rlfa->node_name, D_res->node->node_name);
 #endif
             }else if(p_node->lfa_type == LINK_PROTECTION_RLFA ||
                     p_node->lfa_type == LINK_PROTECTION_RLFA_DOWNSTREAM){
@@ -1087,17 +1862,18 @@ p2p_filter_select_pq_nodes_from_ex_pspace(node_t *S,
                 }
                 if(mandatory_node_protection == TRUE){
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : Pnode  %s not considered for link protection RLFA as Dest %s has ECMP, failed to qualify as PQ node",
-                            S->node_name, p_node->rlfa->node_name, D_res->node->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                    SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Pnode  %s not considered for link protection RLFA as Dest %s has ECMP, failed to qualify as PQ node",
+                            S->node_name, p_node->rlfa->node_name, D_res->node->node_name);
 #endif
                     continue;
                 }
 
-                d_p_to_D = DIST_X_Y(p_node->rlfa, D_res->node, level);
+                d_p_to_D = is_nbr_spf_batch_indexed(batch, D_res->node) ?
+                    p_dist[D_res->node->nbr_spf_index[level]] : INFINITE_METRIC;
                 if(!(d_p_to_D < d_p_to_S + protected_link->metric[level])){
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : Link protected p-node %s failed to qualify as link protection Q node for Dest %s",
-                            S->node_name, p_node->rlfa->node_name, D_res->node->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                    SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Link protected p-node %s failed to qualify as link protection Q node for Dest %s",
+                            S->node_name, p_node->rlfa->node_name, D_res->node->node_name);
 #endif
                     continue;
                 }
@@ -1107,14 +1883,16 @@ p2p_filter_select_pq_nodes_from_ex_pspace(node_t *S,
                 copy_internal_nh_t(*p_node, *rlfa);
                 rlfa->lfa_type = LINK_PROTECTION_RLFA;
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : link protected p-node %s qualify as link protection Q node for Dest %s",
-                        S->node_name, p_node->rlfa->node_name, D_res->node->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : link protected p-node %s qualify as link protection Q node for Dest %s",
+                        S->node_name, p_node->rlfa->node_name, D_res->node->node_name);
 #endif
             }else{
                 assert(0);
             }
         }ITERATE_LIST_END;
     }
+    if(own_batch)
+        nbr_spf_batch_release(level);
 }
 
 char *
@@ -1203,11 +1981,12 @@ broadcast_compute_link_node_protection_lfas(node_t * S, edge_t *protected_link,
     singly_ll_node_t *list_node = NULL;
 
     lfa_type_t lfa_type = UNKNOWN_LFA_TYPE;
-    boolean all_next_hops_node_protecting;
+    boolean all_next_hops_node_protecting = FALSE;
 
 
     nh_type_t nh = NH_MAX, backup_nh_type = NH_MAX;
     internal_nh_t *backup_nh = NULL;
+    unsigned long long *lfa_cand_mask = NULL;
 
     char impact_reason[STRING_REASON_LEN];
 
@@ -1236,19 +2015,27 @@ broadcast_compute_link_node_protection_lfas(node_t * S, edge_t *protected_link,
         memset(impact_reason, 0, STRING_REASON_LEN);
 
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Node : %s : LFA computation for Destination %s begin", S->node_name, D->node_name); 
-        trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+        SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : LFA computation for Destination %s begin", S->node_name, D->node_name);
 #endif
         
         mandatory_node_protection = FALSE;
         is_dest_impacted = is_destination_impacted(S, protected_link, D, level, impact_reason,
                             &mandatory_node_protection);
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Dest = %s Impact result = %s\n    reason : %s", D->node_name, 
-                    is_dest_impacted ? "IMPACTED" : "NOT-IMPCATED", impact_reason); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+        SPF_TRACE(BACKUP_COMPUTATION_BIT, "Dest = %s Impact result = %s\n    reason : %s", D->node_name, 
+                    is_dest_impacted ? "IMPACTED" : "NOT-IMPCATED", impact_reason);
 #endif
 
         if(is_dest_impacted == FALSE) continue;
+
+        lfa_cand_mask = nbr_spf_batch_lfa_candidates(S, D, level);
+        if(lfa_cand_mask && !nbr_spf_batch_is_lfa_candidate(lfa_cand_mask, NULL, level)){
+#ifdef __ENABLE_TRACE__        
+            SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : No nbr qualifies inequality 1 for Dest %s",
+                    S->node_name, D->node_name);
+#endif
+            continue;
+        }
         
         dist_S_D = D_res->spf_metric;
         dist_PN_D = DIST_X_Y(PN, D, level);
@@ -1257,55 +2044,55 @@ broadcast_compute_link_node_protection_lfas(node_t * S, edge_t *protected_link,
             
             lfa_type = UNKNOWN_LFA_TYPE;
 #ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s : Testing nbr %s via edge1 = %s, edge2 = %s for LFA candidature",
-                    S->node_name, N->node_name, edge1->from.intf_name, edge2->from.intf_name); 
-            trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+            SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Testing nbr %s via edge1 = %s, edge2 = %s for LFA candidature",
+                    S->node_name, N->node_name, edge1->from.intf_name, edge2->from.intf_name);
 #endif
 
             /*Do not consider the link being protected to find LFA*/
             if(edge1 == protected_link){
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Nbr %s with OIF %s is same as protected link %s, skipping this nbr from LFA candidature", 
-                        S->node_name, N->node_name, edge1->from.intf_name, protected_link->from.intf_name); 
-                trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Nbr %s with OIF %s is same as protected link %s, skipping this nbr from LFA candidature", 
+                        S->node_name, N->node_name, edge1->from.intf_name, protected_link->from.intf_name);
 #endif
                 goto NBR_PROCESSING_DONE;
             }
 
             if(IS_OVERLOADED(N, level)){
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Nbr %s failed for LFA candidature, reason - Overloaded", S->node_name, N->node_name); 
-                trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Nbr %s failed for LFA candidature, reason - Overloaded", S->node_name, N->node_name);
+#endif
+                goto NBR_PROCESSING_DONE;
+            }
+
+            if(lfa_cand_mask && !nbr_spf_batch_is_lfa_candidate(lfa_cand_mask, N, level)){
+#ifdef __ENABLE_TRACE__                
+                SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Inequality 1 failed", S->node_name);
 #endif
                 goto NBR_PROCESSING_DONE;
             }
 
             dist_N_S = DIST_X_Y(N, S, level);
 #ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s : Source(S) = %s, probable LFA(N) = %s, DEST(D) = %s", 
-                    S->node_name, S->node_name, N->node_name, D->node_name); 
-            trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+            SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Source(S) = %s, probable LFA(N) = %s, DEST(D) = %s", 
+                    S->node_name, S->node_name, N->node_name, D->node_name);
 #endif
 
             dist_N_D = DIST_X_Y(N, D, level);
 #ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s : Testing inequality 1 : dist_N_D(%u) < dist_N_S(%u) + dist_S_D(%u)",
-                    S->node_name, dist_N_D, dist_N_S, dist_S_D); 
-            trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+            SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Testing inequality 1 : dist_N_D(%u) < dist_N_S(%u) + dist_S_D(%u)",
+                    S->node_name, dist_N_D, dist_N_S, dist_S_D);
 #endif
 
             /* Apply inequality 1*/
             if(!(dist_N_D < dist_N_S + dist_S_D)){
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Inequality 1 failed", S->node_name); 
-                trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Inequality 1 failed", S->node_name);
 #endif
                 goto NBR_PROCESSING_DONE;
             }
 
 #ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s : Inequality 1 passed", S->node_name); 
-            trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+            SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Inequality 1 passed", S->node_name);
 #endif
             lfa_type = BROADCAST_LINK_PROTECTION_LFA;
              
@@ -1314,9 +2101,8 @@ broadcast_compute_link_node_protection_lfas(node_t * S, edge_t *protected_link,
             if(IS_LINK_NODE_PROTECTION_ENABLED(protected_link)){
 
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Testing node protecting inequality 3 with primary nexthops of %s through potential LFA %s",
-                        S->node_name, D->node_name, N->node_name); 
-                trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Testing node protecting inequality 3 with primary nexthops of %s through potential LFA %s",
+                        S->node_name, D->node_name, N->node_name);
 #endif
 
                 all_next_hops_node_protecting = TRUE;
@@ -1333,17 +2119,15 @@ broadcast_compute_link_node_protection_lfas(node_t * S, edge_t *protected_link,
                         if(dist_N_D < dist_N_E + dist_E_D){
                             //lfa_type = BROADCAST_ONLY_NODE_PROTECTION_LFA;  
 #ifdef __ENABLE_TRACE__                            
-                            sprintf(instance->traceopts->b, "Node : %s : inequality 3 Passed with #%u next hop %s(%s)",
-                                    S->node_name, i, prim_nh->node_name, nh == IPNH ? "IPNH" : "LSPNH"); 
-                            trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                            SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : inequality 3 Passed with #%u next hop %s(%s)",
+                                    S->node_name, i, prim_nh->node_name, nh == IPNH ? "IPNH" : "LSPNH");
 #endif
                         }else{
                             all_next_hops_node_protecting = FALSE;
                             //lfa_type = UNKNOWN_LFA_TYPE;
 #ifdef __ENABLE_TRACE__                            
-                            sprintf(instance->traceopts->b, "Node : %s : inequality 3 Failed with #%u next hop %s(%s), ", 
-                                    S->node_name, i, prim_nh->node_name, nh == IPNH ? "IPNH" : "LSPNH"); 
-                            trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                            SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : inequality 3 Failed with #%u next hop %s(%s), ", 
+                                    S->node_name, i, prim_nh->node_name, nh == IPNH ? "IPNH" : "LSPNH");
 #endif
                             break;
                         }
@@ -1375,34 +2159,31 @@ broadcast_compute_link_node_protection_lfas(node_t * S, edge_t *protected_link,
                 backup_nh->is_eligible = TRUE;
 
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "lfa pair computed : %s(OIF = %s),%s, lfa_type = %s," 
+                SPF_TRACE(BACKUP_COMPUTATION_BIT, "lfa pair computed : %s(OIF = %s),%s, lfa_type = %s," 
                               "looking to promote it to BROADCAST_LINK_AND_NODE_PROTECTION_LFA", N->node_name, 
                         backup_nh->oif->intf_name, backup_nh->node->node_name, 
-                        get_str_lfa_type(backup_nh->lfa_type)); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                        get_str_lfa_type(backup_nh->lfa_type));
 #endif
 
                 /*Check for Link protection criteria*/
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Testing inequality 4 : dist_N_D(%u) < dist_N_PN(%u) + dist_PN_D(%u)",
-                        S->node_name, dist_N_D, dist_N_PN, dist_PN_D); 
-                trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Testing inequality 4 : dist_N_D(%u) < dist_N_PN(%u) + dist_PN_D(%u)",
+                        S->node_name, dist_N_D, dist_N_PN, dist_PN_D);
 #endif
 
                 /*Apply inequality 4*/
                 dist_N_PN = DIST_X_Y(N, PN, level);
                 if(!(dist_N_D < dist_N_PN + dist_PN_D)){
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : Inequality 4 failed, LFA not promoted to BROADCAST_LINK_AND_NODE_PROTECTION_LFA", S->node_name); 
-                    trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                    SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Inequality 4 failed, LFA not promoted to BROADCAST_LINK_AND_NODE_PROTECTION_LFA", S->node_name);
 #endif
                     goto NBR_PROCESSING_DONE;
                 }
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Inequality 4 passed, LFA %s(OIF = %s) , Dest = %s promoted from %s to %s", 
+                SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Inequality 4 passed, LFA %s(OIF = %s) , Dest = %s promoted from %s to %s", 
                         S->node_name, N->node_name, backup_nh->oif->intf_name, backup_nh->node->node_name,
                         get_str_lfa_type(backup_nh->lfa_type),
-                        get_str_lfa_type(BROADCAST_LINK_AND_NODE_PROTECTION_LFA)); 
-                trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                        get_str_lfa_type(BROADCAST_LINK_AND_NODE_PROTECTION_LFA));
 #endif
 
                 backup_nh->lfa_type = BROADCAST_LINK_AND_NODE_PROTECTION_LFA;
@@ -1412,16 +2193,16 @@ broadcast_compute_link_node_protection_lfas(node_t * S, edge_t *protected_link,
             /*We are here because LFA is not node protecting, try for link protection LFA only*/
             if(!IS_LINK_PROTECTION_ENABLED(protected_link)){
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Node-link-degradation Disabled, Nbr %s not considered for link protection LFA", 
-                        S->node_name, N->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Node-link-degradation Disabled, Nbr %s not considered for link protection LFA", 
+                        S->node_name, N->node_name);
 #endif
                 goto NBR_PROCESSING_DONE;
             }
            
             if(mandatory_node_protection == TRUE){
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Nbr %s not considered for link protection LFA as it has ECMP",
-                            S->node_name, N->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Nbr %s not considered for link protection LFA as it has ECMP",
+                            S->node_name, N->node_name);
 #endif
                 goto NBR_PROCESSING_DONE;
             }
@@ -1429,44 +2210,42 @@ broadcast_compute_link_node_protection_lfas(node_t * S, edge_t *protected_link,
             if(strict_down_stream_lfa){
                 /* 4. Narrow down the subset further using inequality 2 */
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Testing inequality 2 : dist_N_D(%u) < dist_S_D(%u)", 
-                        S->node_name, dist_N_D, dist_S_D); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Testing inequality 2 : dist_N_D(%u) < dist_S_D(%u)", 
+                        S->node_name, dist_N_D, dist_S_D);
 #endif
 
                 if(!(dist_N_D < dist_S_D)){
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : Inequality 2 failed", S->node_name); 
-                    trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                    SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Inequality 2 failed", S->node_name);
 #endif
                     goto NBR_PROCESSING_DONE;
                 }
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Inequality 2 passed, lfa promoted from %s to %s", S->node_name, 
+                SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Inequality 2 passed, lfa promoted from %s to %s", S->node_name, 
                                 get_str_lfa_type(lfa_type), get_str_lfa_type(LINK_PROTECTION_LFA_DOWNSTREAM)); 
-                lfa_type = LINK_PROTECTION_LFA_DOWNSTREAM;
-                trace(instance->traceopts, BACKUP_COMPUTATION_BIT); 
 #endif
+                lfa_type = LINK_PROTECTION_LFA_DOWNSTREAM;
             }
 
             /*Now check inequality 4*/ 
             dist_N_PN = DIST_X_Y(N, PN, level);
 #ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s : Testing inequality 4 : dist_N_D(%u) < dist_N_PN(%u) + dist_PN_D(%u)",
-                    S->node_name, dist_N_D, dist_N_PN, dist_PN_D); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+            SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Testing inequality 4 : dist_N_D(%u) < dist_N_PN(%u) + dist_PN_D(%u)",
+                    S->node_name, dist_N_D, dist_N_PN, dist_PN_D);
 #endif
 
             /*Apply inequality 4*/
             if(!(dist_N_D < dist_N_PN + dist_PN_D)){
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Inequality 4 failed, LFA candidature failed for nbr %s, Dest = %s",
-                              S->node_name, N->node_name, D->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Inequality 4 failed, LFA candidature failed for nbr %s, Dest = %s",
+                              S->node_name, N->node_name, D->node_name);
 #endif
                 goto NBR_PROCESSING_DONE;
             }
 
 #ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s : Inequality 4 passed for Nbr %s is LFA for Dest =  %s",
-                        S->node_name, N->node_name, D->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+            SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Inequality 4 passed for Nbr %s is LFA for Dest =  %s",
+                        S->node_name, N->node_name, D->node_name);
 #endif
 
             /*Record the LFA*/
@@ -1488,17 +2267,15 @@ broadcast_compute_link_node_protection_lfas(node_t * S, edge_t *protected_link,
             backup_nh->is_eligible = TRUE;
 
 #ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "lfa pair computed : %s(OIF = %s),%s, lfa_type = %s", N->node_name, 
+            SPF_TRACE(BACKUP_COMPUTATION_BIT, "lfa pair computed : %s(OIF = %s),%s, lfa_type = %s", N->node_name, 
                     backup_nh->oif->intf_name, backup_nh->node->node_name, 
-                    get_str_lfa_type(backup_nh->lfa_type)); 
-            trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                    get_str_lfa_type(backup_nh->lfa_type));
 #endif
 
 NBR_PROCESSING_DONE:
 #ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s : Testing nbr %s via edge1 = %s edge2 = %s for LFA candidature Done", 
-                S->node_name, N->node_name, edge1->from.intf_name, edge2->from.intf_name); 
-            trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+            SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Testing nbr %s via edge1 = %s edge2 = %s for LFA candidature Done", 
+                S->node_name, N->node_name, edge1->from.intf_name, edge2->from.intf_name);
 #endif
         } ITERATE_NODE_PHYSICAL_NBRS_END(S, N, pn_node, level);
         
@@ -1527,7 +2304,7 @@ p2p_compute_link_node_protection_lfas(node_t * S, edge_t *protected_link,
 
     spf_result_t *D_res = NULL;
     singly_ll_node_t *list_node = NULL;
-    boolean all_next_hops_node_protecting;
+    boolean all_next_hops_node_protecting = FALSE;
 
     unsigned int dist_N_D = 0, 
                  dist_N_S = 0, 
@@ -1538,6 +2315,7 @@ p2p_compute_link_node_protection_lfas(node_t * S, edge_t *protected_link,
 
     nh_type_t nh = NH_MAX;
     lfa_type_t lfa_type = UNKNOWN_LFA_TYPE;
+    unsigned long long *lfa_cand_mask = NULL;
 
     /* 3. Filter nbrs of S using inequality 1 */
     E = protected_link->to.node;
@@ -1551,70 +2329,84 @@ p2p_compute_link_node_protection_lfas(node_t * S, edge_t *protected_link,
         memset(impact_reason, 0, STRING_REASON_LEN);
 
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Node : %s : LFA computation for Destination %s begin for protected link (%s)", 
-            S->node_name, D->node_name, protected_link->from.intf_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+        SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : LFA computation for Destination %s begin for protected link (%s)", 
+            S->node_name, D->node_name, protected_link->from.intf_name);
 #endif
         
         mandatory_node_protection = FALSE;
         is_dest_impacted = is_destination_impacted(S, protected_link, D, level, impact_reason, 
                              &mandatory_node_protection);
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Dest = %s Impact result = %s\n    reason : %s", D->node_name, 
-                    is_dest_impacted ? "IMPACTED" : "NOT-IMPCATED", impact_reason); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+        SPF_TRACE(BACKUP_COMPUTATION_BIT, "Dest = %s Impact result = %s\n    reason : %s", D->node_name, 
+                    is_dest_impacted ? "IMPACTED" : "NOT-IMPCATED", impact_reason);
 #endif
                     
         if(is_dest_impacted == FALSE) continue;
 
+        lfa_cand_mask = nbr_spf_batch_lfa_candidates(S, D, level);
+        if(lfa_cand_mask && !nbr_spf_batch_is_lfa_candidate(lfa_cand_mask, NULL, level)){
+#ifdef __ENABLE_TRACE__        
+            SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : No nbr qualifies inequality 1 for Dest %s",
+                    S->node_name, D->node_name);
+#endif
+            continue;
+        }
+
         dist_S_D = D_res->spf_metric;
         ITERATE_NODE_PHYSICAL_NBRS_BEGIN(S, N, pn_node, edge1, edge2, level){
 
 #ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s : Testing nbr %s via edge1(%s) = %s, edge2(%s) = %s for LFA candidature",
+            SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Testing nbr %s via edge1(%s) = %s, edge2(%s) = %s for LFA candidature",
                     S->node_name, N->node_name, edge1->status == 1 ? "UP" : "DOWN", 
                     edge1->from.intf_name,
                     edge2->status == 1 ? "UP" : "DOWN", 
-                    edge2->from.intf_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                    edge2->from.intf_name);
 #endif
             
             /*Do not consider the link being protected to find LFA*/
             if(edge1 == protected_link){
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Nbr %s with OIF %s is same as protected link %s, skipping this nbr from LFA candidature", 
-                        S->node_name, N->node_name, edge1->from.intf_name, protected_link->from.intf_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Nbr %s with OIF %s is same as protected link %s, skipping this nbr from LFA candidature", 
+                        S->node_name, N->node_name, edge1->from.intf_name, protected_link->from.intf_name);
 #endif
                 goto NBR_PROCESSING_DONE;
             }
 
             if(IS_OVERLOADED(N, level)){
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Nbr %s failed for LFA candidature, reason - Overloaded", 
-                S->node_name, N->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Nbr %s failed for LFA candidature, reason - Overloaded", 
+                S->node_name, N->node_name);
 #endif
                 goto NBR_PROCESSING_DONE;
             }
 
-            dist_N_S = DIST_X_Y(N, S, level);
-#ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s : Source(S) = %s, probable LFA(N) = %s, DEST(D) = %s, Primary NH(E) = %s", 
-                    S->node_name, S->node_name, N->node_name, D->node_name, E->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+            if(lfa_cand_mask && !nbr_spf_batch_is_lfa_candidate(lfa_cand_mask, N, level)){
+#ifdef __ENABLE_TRACE__                
+                SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Inequality 1 failed", S->node_name);
 #endif
+                goto NBR_PROCESSING_DONE;
+            }
+
+            dist_N_S = DIST_X_Y(N, S, level);
+            SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Source(S) = %s, probable LFA(N) = %s, DEST(D) = %s, Primary NH(E) = %s", 
+                    S->node_name, S->node_name, N->node_name, D->node_name, E->node_name);
 
             dist_N_D = DIST_X_Y(N, D, level);
 #ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s : Testing inequality 1 : dist_N_D(%u) < dist_N_S(%u) + dist_S_D(%u)",
-                    S->node_name, dist_N_D, dist_N_S, dist_S_D); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+            SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Testing inequality 1 : dist_N_D(%u) < dist_N_S(%u) + dist_S_D(%u)",
+                    S->node_name, dist_N_D, dist_N_S, dist_S_D);
 #endif
 
             /* Apply inequality 1*/
             if(!(dist_N_D < dist_N_S + dist_S_D)){
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Inequality 1 failed", S->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Inequality 1 failed", S->node_name);
 #endif
                 goto NBR_PROCESSING_DONE;
             }
 
 #ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s : Inequality 1 passed", S->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+            SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Inequality 1 passed", S->node_name);
 #endif
             lfa_type = LINK_PROTECTION_LFA;             
             /* Inequality 3 : Node protecting LFA 
@@ -1622,9 +2414,8 @@ p2p_compute_link_node_protection_lfas(node_t * S, edge_t *protected_link,
             if(IS_LINK_NODE_PROTECTION_ENABLED(protected_link)){
 
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Testing node protecting inequality 3 with primary nexthops of %s through potential LFA %s",
-                        S->node_name, D->node_name, N->node_name); 
-                trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Testing node protecting inequality 3 with primary nexthops of %s through potential LFA %s",
+                        S->node_name, D->node_name, N->node_name);
 #endif
 
                 /*N is node protecting LFA if it could send traffic to D without passing
@@ -1641,16 +2432,14 @@ p2p_compute_link_node_protection_lfas(node_t * S, edge_t *protected_link,
                         if(dist_N_D < dist_N_E + dist_E_D){
                             //lfa_type = LINK_AND_NODE_PROTECTION_LFA;  
 #ifdef __ENABLE_TRACE__                            
-                            sprintf(instance->traceopts->b, "Node : %s : inequality 3 Passed with #%u next hop %s(%s), lfa_type = %s",
-                                    S->node_name, i, prim_nh->node_name, nh == IPNH ? "IPNH" : "LSPNH", get_str_lfa_type(lfa_type)); 
-                            trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                            SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : inequality 3 Passed with #%u next hop %s(%s), lfa_type = %s",
+                                    S->node_name, i, prim_nh->node_name, nh == IPNH ? "IPNH" : "LSPNH", get_str_lfa_type(lfa_type));
 #endif
                         }else{
                             all_next_hops_node_protecting = FALSE;
 #ifdef __ENABLE_TRACE__                            
-                            sprintf(instance->traceopts->b, "Node : %s : inequality 3 Failed with #%u next hop %s(%s), lfa_type = %s", 
-                                    S->node_name, i, prim_nh->node_name, nh == IPNH ? "IPNH" : "LSPNH", get_str_lfa_type(lfa_type)); 
-                            trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                            SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : inequality 3 Failed with #%u next hop %s(%s), lfa_type = %s", 
+                                    S->node_name, i, prim_nh->node_name, nh == IPNH ? "IPNH" : "LSPNH", get_str_lfa_type(lfa_type));
 #endif
                             break;
                         }
@@ -1665,9 +2454,9 @@ p2p_compute_link_node_protection_lfas(node_t * S, edge_t *protected_link,
             if(lfa_type == LINK_AND_NODE_PROTECTION_LFA){
                 /*Record the LFA*/ 
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "lfa pair computed : %s(OIF = %s), Dest = %s, lfa_type = %s", N->node_name, 
+                SPF_TRACE(BACKUP_COMPUTATION_BIT, "lfa pair computed : %s(OIF = %s), Dest = %s, lfa_type = %s", N->node_name, 
                         edge1->from.intf_name, D->node_name, 
-                        get_str_lfa_type(lfa_type)); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                        get_str_lfa_type(lfa_type));
 #endif
 
                 {
@@ -1696,8 +2485,8 @@ p2p_compute_link_node_protection_lfas(node_t * S, edge_t *protected_link,
 
             if(!IS_LINK_PROTECTION_ENABLED(protected_link)){
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Node-link-degradation Disabled, Nbr %s not considered for link protection LFA", 
-                        S->node_name, N->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Node-link-degradation Disabled, Nbr %s not considered for link protection LFA", 
+                        S->node_name, N->node_name);
 #endif
                 goto NBR_PROCESSING_DONE;
             }
@@ -1715,8 +2504,8 @@ p2p_compute_link_node_protection_lfas(node_t * S, edge_t *protected_link,
              * */
             if(mandatory_node_protection == TRUE){
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Nbr %s not considered for link protection LFA as it has ECMP",
-                            S->node_name, N->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Nbr %s not considered for link protection LFA as it has ECMP",
+                            S->node_name, N->node_name);
 #endif
                 goto NBR_PROCESSING_DONE;
             }
@@ -1724,13 +2513,13 @@ p2p_compute_link_node_protection_lfas(node_t * S, edge_t *protected_link,
             if(strict_down_stream_lfa){
                 /* 4. Narrow down the subset further using inequality 2 */
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Testing inequality 2 : dist_N_D(%u) < dist_S_D(%u)", 
-                        S->node_name, dist_N_D, dist_S_D); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Testing inequality 2 : dist_N_D(%u) < dist_S_D(%u)", 
+                        S->node_name, dist_N_D, dist_S_D);
 #endif
 
                 if(!(dist_N_D < dist_S_D)){
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : Inequality 2 failed", S->node_name); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+                    SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Inequality 2 failed", S->node_name);
 #endif
                     /*We are here because inequality 1 is passed, but 2 and 3 fails*/ 
                     /*Record the LFA*/ 
@@ -1758,8 +2547,8 @@ p2p_compute_link_node_protection_lfas(node_t * S, edge_t *protected_link,
                     ITERATE_NODE_PHYSICAL_NBRS_CONTINUE(S, N, pn_node, level);
                 }
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Inequality 2 passed, lfa promoted from %s to %s", S->node_name, 
-                                get_str_lfa_type(lfa_type), get_str_lfa_type(LINK_PROTECTION_LFA_DOWNSTREAM)); trace(instance->traceopts, BACKUP_COMPUTATION_BIT); 
+                SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Inequality 2 passed, lfa promoted from %s to %s", S->node_name, 
+                                get_str_lfa_type(lfa_type), get_str_lfa_type(LINK_PROTECTION_LFA_DOWNSTREAM)); 
 #endif
                 lfa_type = LINK_PROTECTION_LFA_DOWNSTREAM;
             }
@@ -1788,15 +2577,14 @@ p2p_compute_link_node_protection_lfas(node_t * S, edge_t *protected_link,
                 backup_nh->is_eligible = TRUE;
             }
 #ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "lfa pair computed : %s(OIF = %s),%s, lfa_type = %s", N->node_name, 
-                    edge1->from.intf_name, D->node_name, get_str_lfa_type(lfa_type)); trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+            SPF_TRACE(BACKUP_COMPUTATION_BIT, "lfa pair computed : %s(OIF = %s),%s, lfa_type = %s", N->node_name, 
+                    edge1->from.intf_name, D->node_name, get_str_lfa_type(lfa_type));
 #endif
 
 NBR_PROCESSING_DONE:
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Node : %s : Testing nbr %s via edge1 = %s edge2 = %s for LFA candidature Done", 
-                S->node_name, N->node_name, edge1->from.intf_name, edge2->from.intf_name); 
-        trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
+        SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Testing nbr %s via edge1 = %s edge2 = %s for LFA candidature Done", 
+                S->node_name, N->node_name, edge1->from.intf_name, edge2->from.intf_name);
 #endif
 
         } ITERATE_NODE_PHYSICAL_NBRS_END(S, N, pn_node, level);
@@ -36,9 +36,11 @@
 #include "LinkedListApi.h"
 #include "instanceconst.h"
 #include "spfcomputation.h"
+#include "bitarr.h"
 
 typedef struct _node_t node_t;
 typedef struct _edge_t edge_t;
+typedef struct instance_ instance_t;
 
 /*Flags to enable the type of protection enabled on protected link*/
 #define LINK_PROTECTION         0
@@ -79,6 +81,129 @@ Compute_PHYSICAL_Neighbor_SPFs(node_t *spf_root, LEVEL level);
 void
 Compute_LOGICAL_Neighbor_SPFs(node_t *spf_root, LEVEL level);
 
+/*DIST(N, *) of all physical nbrs N of spf root, computed together in a single
+ * multi source dijkastra run over a dense copy of the level graph. Distance
+ * rows are consulted by DIST_X_Y() while the batch is active, i.e. from
+ * the backup computation of spf root till its route building is done*/
+typedef struct nbr_spf_batch_{
+
+    node_t *spf_root;
+    LEVEL level;
+    boolean active;
+
+    /*Dense copy of the level graph reachable from spf root, nodes are
+     * indexed by node->nbr_spf_index[level]*/
+    unsigned int node_count;
+    unsigned int node_alloc;
+    node_t **nodes;
+    int *src_row;               /*node index -> distance row, -1 if node is not a source*/
+    unsigned char *overloaded;  /*node index -> IS_OVERLOADED(), applied at relaxation*/
+    unsigned int *root_index;   /*distance row -> node index of its root, per run scratch*/
+    unsigned int *adj_offset;   /*node_count + 1 entries*/
+    unsigned int adj_count;
+    unsigned int adj_alloc;
+    unsigned int *adj_node;
+    unsigned int *adj_metric;
+
+    /*One distance row of node_count entries per source, followed by
+     * DIST(spf root, *) in row src_count*/
+    unsigned int src_count;
+    unsigned int dist_alloc;
+    unsigned int *dist;
+
+    /*LFA inequality 1 evaluated for all destinations at once : bit r of
+     * the mask words of destination d is set if the source of row r
+     * is loop free wrt spf root for d*/
+    unsigned int mask_words;
+    unsigned int mask_alloc;
+    unsigned long long *lfa_cand_mask;
+    /*Per row scratch of the above, bit d set if inequality 1 holds for destination d*/
+    unsigned int row_bits_alloc;
+    unsigned long long *lfa_row_bits;
+
+    /*DIST(X, *) rows of the last extra run, X being its roots*/
+    unsigned int aux_alloc;
+    unsigned int *aux_dist;
+
+    /*RLFA spaces of spf root wrt the protected link last evaluated, bit i
+     * stands for the node of index i*/
+    bit_array_t ext_p_space;
+    bit_array_t q_space;
+    bit_array_t pq_space;
+
+    /*Stats of last batch run*/
+    unsigned int heap_pops;
+    unsigned int lfa_candidates;
+    unsigned int rlfa_links;
+    unsigned int ext_p_count;
+    unsigned int q_count;
+    unsigned int pq_count;
+    unsigned long run_time_nsec;
+} nbr_spf_batch_t;
+
+void
+Compute_Batched_PHYSICAL_Neighbor_SPFs(node_t *spf_root, LEVEL level);
+
+/*DIST(*, X) over the whole level graph for the nodes X asked for so far,
+ * shared by the RLFA computations of all PLRs and protected links. It is
+ * dropped as soon as the topology version of the level moves on*/
+typedef struct rev_spf_cache_{
+
+    instance_t *instance;
+    LEVEL level;
+    boolean valid;
+    unsigned int topo_version;
+
+    /*All nodes of the instance, indexed by node->rev_spf_index[level],
+     * with their usable adjacencies grouped by far end*/
+    unsigned int node_count;
+    unsigned int node_alloc;
+    node_t **nodes;
+    unsigned char *overloaded;
+    unsigned int *root_index;
+    unsigned int *radj_offset;
+    unsigned int adj_count;
+    unsigned int adj_alloc;
+    unsigned int *radj_node;
+    unsigned int *radj_metric;
+
+    /*Row r holds DIST(*, row_roots[r])*/
+    unsigned int row_count;
+    unsigned int row_alloc;
+    node_t **row_roots;
+    unsigned int dist_alloc;
+    unsigned int *dist;
+
+    unsigned int hits;
+    unsigned int misses;
+    unsigned int rebuilds;
+} rev_spf_cache_t;
+
+void
+rev_spf_cache_lookup(LEVEL level, node_t **roots,
+                     unsigned int root_count, unsigned int **rows);
+
+unsigned int
+rev_spf_cache_dist(unsigned int *row, node_t *X, LEVEL level);
+
+rev_spf_cache_t *
+rev_spf_cache_get(LEVEL level);
+
+void
+nbr_spf_batch_release(LEVEL level);
+
+boolean
+nbr_spf_batch_dist(node_t *X, node_t *Y, LEVEL level, unsigned int *dist);
+
+nbr_spf_batch_t *
+nbr_spf_batch_get(LEVEL level);
+
+unsigned long long *
+nbr_spf_batch_lfa_candidates(node_t *S, node_t *D, LEVEL level);
+
+boolean
+nbr_spf_batch_is_lfa_candidate(unsigned long long *lfa_cand_mask, node_t *N, LEVEL level);
+
 void 
 p2p_compute_link_node_protecting_extended_p_space(node_t *node, edge_t *failed_edge, LEVEL level);
 
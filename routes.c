@@ -38,6 +38,7 @@
 #include "igp_sr_ext.h"
 #include "sr_tlv_api.h"
 #include "no_warn.h"
+#include "spfcounters.h"
 
 extern instance_t *instance;
 
@@ -74,9 +75,6 @@ delete_route(spf_info_t *spf_info, routes_t *route,
              boolean del_from_igp,
              boolean del_from_rib){
 
-    singly_ll_node_t *list_node1 = NULL,
-                     *list_node2 = NULL;
-    
     rt_key_t rt_key;
     boolean is_found = FALSE;
     rtttype_t rt_type = route->rt_type;
@@ -88,14 +86,8 @@ delete_route(spf_info_t *spf_info, routes_t *route,
     RT_ENTRY_MASK(&rt_key) = route->rt_key.u.prefix.mask;
     
     if(del_from_igp){           
-        ITERATE_LIST_BEGIN2(spf_info->routes_list[rt_type], list_node1, list_node2){
-
-            if(list_node1->data == route){
-                ITERATIVE_LIST_NODE_DELETE2(spf_info->routes_list[rt_type], list_node1, list_node2);
-                is_found = TRUE;
-                ITERATE_LIST_BREAK2(spf_info->routes_list[rt_type], list_node1, list_node2);
-            }
-        }ITERATE_LIST_END2(spf_info->routes_list[rt_type], list_node1, list_node2);
+        ROUTE_DEL_FROM_ROUTE_LIST(spf_info, route, rt_type);
+        is_found = TRUE;
     }
 
     if(del_from_rib){
@@ -140,6 +132,7 @@ route_malloc(){
     route->like_prefix_list = init_singly_ll();
     singly_ll_set_comparison_fn(route->like_prefix_list, get_prefix_comparison_fn());
     singly_ll_set_order_comparison_fn(route->like_prefix_list, get_prefix_order_comparison_fn());
+    route->priority = ROUTE_PRIORITY_MAX;
     return route;
 }
 
@@ -160,10 +153,9 @@ merge_route_primary_nexthops(routes_t *route, spf_result_t *result, nh_type_t nh
         copy_internal_nh_t(result->next_hop[nh][i], *int_nxt_hop);
         singly_ll_add_node_by_val(route->primary_nh_list[nh], int_nxt_hop);
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "route : %s/%u primary next hop is merged with %s's next hop node %s", 
+        SPF_TRACE(ROUTE_CALCULATION_BIT, "route : %s/%u primary next hop is merged with %s's next hop node %s", 
                      route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, result->node->node_name, 
-                     result->next_hop[nh][i].node->node_name); 
-        trace(instance->traceopts, ROUTE_CALCULATION_BIT);
+                     result->next_hop[nh][i].node->node_name);
 #endif
     }
 
@@ -186,6 +178,9 @@ merge_route_backup_nexthops(routes_t *route,
         
         backup = &result->node->backup_next_hop[route->level][nh][i];
         if(is_internal_nh_t_empty(*backup)) break;
+        /*Prefix advertised by many nodes, keep the backups merged first*/
+        if(GET_NODE_COUNT_SINGLY_LL(route->backup_nh_list[nh]) == MAX_NXT_HOPS)
+            break;
         if(is_internal_nh_exist(route->backup_nh_list[nh], backup))
             continue;
 
@@ -199,14 +194,13 @@ merge_route_backup_nexthops(routes_t *route,
                     backup->lfa_type == BROADCAST_LINK_PROTECTION_RLFA           ||
                     backup->lfa_type == BROADCAST_LINK_PROTECTION_RLFA_DOWNSTREAM){
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "\t ECMP : only link-protecting backup dropped : %s----%s---->%-s(%s(%s)) protecting link: %s", 
+                    SPF_TRACE(ROUTE_CALCULATION_BIT, "\t ECMP : only link-protecting backup dropped : %s----%s---->%-s(%s(%s)) protecting link: %s", 
                             backup->oif->intf_name,
                             next_hop_type(*backup) == IPNH ? "IPNH" : "LSPNH",
                             next_hop_type(*backup) == IPNH ? next_hop_gateway_pfx(backup) : "",
                             backup->node ? backup->node->node_name : backup->rlfa->node_name,
                             backup->node ? backup->node->router_id : backup->rlfa->router_id, 
-                            backup->protected_link->intf_name); 
-                    trace(instance->traceopts, ROUTE_CALCULATION_BIT);
+                            backup->protected_link->intf_name);
 #endif
                 continue;
             }
@@ -216,10 +210,9 @@ merge_route_backup_nexthops(routes_t *route,
         copy_internal_nh_t(result->node->backup_next_hop[route->level][nh][i], *int_nxt_hop);
         singly_ll_add_node_by_val(route->backup_nh_list[nh], int_nxt_hop);
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "route : %s/%u backup next hop is merged with %s's next hop node %s", 
+        SPF_TRACE(ROUTE_CALCULATION_BIT, "route : %s/%u backup next hop is merged with %s's next hop node %s", 
                      route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, result->node->node_name, 
-                     result->node->backup_next_hop[route->level][nh][i].node->node_name); 
-        trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                     result->node->backup_next_hop[route->level][nh][i].node->node_name);;
 #endif
     }
     assert(GET_NODE_COUNT_SINGLY_LL(route->backup_nh_list[nh]) <= MAX_NXT_HOPS);
@@ -263,27 +256,27 @@ search_route_in_spf_route_list(spf_info_t *spf_info,
                                rtttype_t rt_type){
 
     routes_t *route = NULL;
-    singly_ll_node_t* list_node = NULL;
+    glthread_t *curr = NULL;
     char prefix_with_mask[PREFIX_LEN + 1];
 
     switch(rt_type){
         case UNICAST_T:
             apply_mask(common_pfx->u.prefix.prefix, common_pfx->u.prefix.mask, prefix_with_mask);
             prefix_with_mask[PREFIX_LEN] = '\0';
-            ITERATE_LIST_BEGIN(spf_info->routes_list[rt_type], list_node){
-                route = list_node->data;
+            ITERATE_GLTHREAD_BEGIN(&spf_info->routes_list[rt_type], curr){
+                route = glthread_to_route(curr);
                 if(strncmp(route->rt_key.u.prefix.prefix, prefix_with_mask, PREFIX_LEN) == 0 &&
                         (route->rt_key.u.prefix.mask == common_pfx->u.prefix.mask))
                     return route;    
-            }ITERATE_LIST_END;
+            } ITERATE_GLTHREAD_END(&spf_info->routes_list[rt_type], curr);
             break;
         case SPRING_T:
-            ITERATE_LIST_BEGIN(spf_info->routes_list[rt_type], list_node){
-                route = list_node->data;
+            ITERATE_GLTHREAD_BEGIN(&spf_info->routes_list[rt_type], curr){
+                route = glthread_to_route(curr);
                 if(route->rt_key.u.label == common_pfx->u.label){
                     return route;
                 }
-            }ITERATE_LIST_END;
+            } ITERATE_GLTHREAD_END(&spf_info->routes_list[rt_type], curr);
             break;
         default:
             assert(0);
@@ -291,42 +284,57 @@ search_route_in_spf_route_list(spf_info_t *spf_info,
     return NULL;
 }
 
+/* Sweep phase of route mark-and-sweep : every route refreshed by current SPF
+ * run carries the current spf_level_info version, rest are stale. Stale routes
+ * are unlinked in O(1) from all route lists in a single pass and parked in
+ * reclaim list; they are freed by reclaim_stale_routes() once route installation
+ * is done, off the convergence path*/
 static unsigned int
 delete_stale_routes(spf_info_t *spf_info, LEVEL level, rtttype_t rt_type){
 
-    singly_ll_node_t *list_node1 = NULL, 
-                     *list_node2 = NULL;
-
+    glthread_t *curr = NULL;
     routes_t *route = NULL;
     unsigned int i = 0;
 
 #ifdef __ENABLE_TRACE__
-    sprintf(instance->traceopts->b, "Deleting Stale Routes");
-    trace(instance->traceopts, ROUTE_CALCULATION_BIT);
+    SPF_TRACE(ROUTE_CALCULATION_BIT, "Deleting Stale Routes");
 #endif
 
-    ITERATE_LIST_BEGIN2(spf_info->routes_list[rt_type], list_node1, list_node2){
+    ITERATE_GLTHREAD_BEGIN(&spf_info->routes_list[rt_type], curr){
 
-        route = list_node1->data;
-        if(route->level != level){
-            ITERATE_LIST_CONTINUE2(spf_info->routes_list[rt_type], list_node1, list_node2);   
-        }
+        route = glthread_to_route(curr);
+        if(route->level != level)
+            continue;
 
         if(route->version != spf_info->spf_level_info[level].version){
 #ifdef __ENABLE_TRACE__
-            sprintf(instance->traceopts->b, "route : %s/%u is STALE for Level%d, deleted", route->rt_key.u.prefix.prefix,
-                    route->rt_key.u.prefix.mask, level); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+            SPF_TRACE(ROUTE_CALCULATION_BIT, "route : %s/%u is STALE for Level%d, deleted", route->rt_key.u.prefix.prefix,
+                    route->rt_key.u.prefix.mask, level);;
 #endif
             i++;
-            singly_ll_delete_node_by_data_ptr(spf_info->priority_routes_list[rt_type], route);
-            ITERATIVE_LIST_NODE_DELETE2(spf_info->priority_routes_list[rt_type], list_node1, list_node2);
-            free_route(route);
-            route = NULL;
+            SPF_COUNTER_INC(SPF_CTR_ROUTES_STALE);
+            ROUTE_DEL_FROM_ROUTE_LIST(spf_info, route, rt_type);
+            glthread_add_next(&spf_info->reclaim_routes_list, &route->glue);
         }
-    }ITERATE_LIST_END2(spf_info->routes_list[rt_type], list_node1, list_node2);
+    } ITERATE_GLTHREAD_END(&spf_info->routes_list[rt_type], curr);
     return i;
 }
 
+/*Free the stale routes unlinked by delete_stale_routes()*/
+void
+reclaim_stale_routes(spf_info_t *spf_info){
+
+    glthread_t *curr = NULL;
+    routes_t *route = NULL;
+
+    ITERATE_GLTHREAD_BEGIN(&spf_info->reclaim_routes_list, curr){
+
+        route = glthread_to_route(curr);
+        remove_glthread(curr);
+        free_route(route);
+    } ITERATE_GLTHREAD_END(&spf_info->reclaim_routes_list, curr);
+}
+
 /*Search internal route using longest prefix
  *  * match*/
 routes_t *
@@ -338,11 +346,11 @@ search_route_in_spf_route_list_by_lpm(spf_info_t *spf_info,
              *lpm_route = NULL;
 
     char longest_mask = 0;
-    singly_ll_node_t* list_node = NULL;
+    glthread_t *curr = NULL;
 
-    ITERATE_LIST_BEGIN(spf_info->routes_list[rt_type], list_node){
+    ITERATE_GLTHREAD_BEGIN(&spf_info->routes_list[rt_type], curr){
 
-        route = list_node->data;
+        route = glthread_to_route(curr);
         if(strncmp("0.0.0.0", route->rt_key.u.prefix.prefix, strlen("0.0.0.0")) == 0 &&
                 route->rt_key.u.prefix.mask == 0){
             default_route = route;
@@ -353,7 +361,7 @@ search_route_in_spf_route_list_by_lpm(spf_info_t *spf_info,
                 lpm_route = route;   
             }
         }
-    } ITERATE_LIST_END;
+    } ITERATE_GLTHREAD_END(&spf_info->routes_list[rt_type], curr);
     return lpm_route ? lpm_route : default_route;
 }
 
@@ -366,16 +374,13 @@ overwrite_route(spf_info_t *spf_info, routes_t *route,
     internal_nh_t *int_nxt_hop = NULL,
                   *backup = NULL;
 
-    /*Once we implement the proper route installation between IGP and RIB,
-     * we dont need to delete route from here anymore*/
+    /*RIB entry changes level in place when the route is installed again*/
     if(route->level != level){
 #ifdef __ENABLE_TRACE__
-        sprintf(instance->traceopts->b, "Node : %s : IGP route %s/%u at %s will be transformed into %s route, hence deleting it from RIB",
+        SPF_TRACE(ROUTE_CALCULATION_BIT, "Node : %s : IGP route %s/%u at %s will be transformed into %s route",
                 GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, 
                 route->rt_key.u.prefix.mask, get_str_level(route->level), get_str_level(level));
-        trace(instance->traceopts, ROUTE_CALCULATION_BIT);
 #endif
-        delete_route(spf_info, route, FALSE, TRUE);   
     }
     else{
         delete_singly_ll(route->like_prefix_list);
@@ -384,9 +389,8 @@ overwrite_route(spf_info_t *spf_info, routes_t *route,
     //route_set_key(route, prefix->prefix, prefix->mask); 
 
 #ifdef __ENABLE_TRACE__        
-    sprintf(instance->traceopts->b, "route : %s/%u being over written for %s", route->rt_key.u.prefix.prefix, 
-            route->rt_key.u.prefix.mask, get_str_level(level)); 
-    trace(instance->traceopts, ROUTE_CALCULATION_BIT);
+    SPF_TRACE(ROUTE_CALCULATION_BIT, "route : %s/%u being over written for %s", route->rt_key.u.prefix.prefix, 
+            route->rt_key.u.prefix.mask, get_str_level(level));
 #endif
 
     route->version = spf_info->spf_level_info[level].version;
@@ -422,9 +426,9 @@ overwrite_route(spf_info_t *spf_info, routes_t *route,
                 copy_internal_nh_t(result->next_hop[nh][i], *int_nxt_hop);
                 ROUTE_ADD_NH(route->primary_nh_list[nh], int_nxt_hop);   
 #ifdef __ENABLE_TRACE__                    
-                sprintf(instance->traceopts->b, "route : %s/%u primary next hop is merged with %s's next hop node %s", 
+                SPF_TRACE(ROUTE_CALCULATION_BIT, "route : %s/%u primary next hop is merged with %s's next hop node %s", 
                         route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, result->node->node_name, 
-                        result->next_hop[nh][i].node->node_name); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                        result->next_hop[nh][i].node->node_name);;
 #endif
             }
             else
@@ -443,14 +447,13 @@ overwrite_route(spf_info_t *spf_info, routes_t *route,
                             backup->lfa_type == BROADCAST_LINK_PROTECTION_RLFA           ||
                             backup->lfa_type == BROADCAST_LINK_PROTECTION_RLFA_DOWNSTREAM){
 #ifdef __ENABLE_TRACE__                            
-                        sprintf(instance->traceopts->b, "\t ECMP : only link-protecting backup dropped : %s----%s---->%-s(%s(%s)) protecting link: %s", 
+                        SPF_TRACE(ROUTE_CALCULATION_BIT, "\t ECMP : only link-protecting backup dropped : %s----%s---->%-s(%s(%s)) protecting link: %s", 
                                 backup->oif->intf_name,
                                 next_hop_type(*backup) == IPNH ? "IPNH" : "LSPNH",
                                 next_hop_type(*backup) == IPNH ? next_hop_gateway_pfx(backup) : "",
                                 backup->node ? backup->node->node_name : backup->rlfa->node_name,
                                 backup->node ? backup->node->router_id : backup->rlfa->router_id, 
-                                backup->protected_link->intf_name); 
-                        trace(instance->traceopts, ROUTE_CALCULATION_BIT);
+                                backup->protected_link->intf_name);
 #endif
                         continue;
                     }
@@ -460,9 +463,9 @@ overwrite_route(spf_info_t *spf_info, routes_t *route,
                 copy_internal_nh_t((result->node->backup_next_hop[level][nh][i]), *int_nxt_hop);
                 ROUTE_ADD_NH(route->backup_nh_list[nh], int_nxt_hop);   
 #ifdef __ENABLE_TRACE__                    
-                sprintf(instance->traceopts->b, "route : %s/%u backup next hop is merged with %s's backup next hop node %s", 
+                SPF_TRACE(ROUTE_CALCULATION_BIT, "route : %s/%u backup next hop is merged with %s's backup next hop node %s", 
                         route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, result->node->node_name, 
-                        result->node->backup_next_hop[level][nh][i].node->node_name); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                        result->node->backup_next_hop[level][nh][i].node->node_name);;
 #endif
             }
             else
@@ -492,9 +495,9 @@ link_prefix_to_route(routes_t *route, prefix_t *new_prefix,
     new_prefix_pref = route_preference(new_prefix->prefix_flags, new_prefix->level);
 
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "To Route : %s/%u, %s, Appending prefix : %s/%u to Route prefix list",
+    SPF_TRACE(ROUTE_CALCULATION_BIT, "To Route : %s/%u, %s, Appending prefix : %s/%u to Route prefix list",
                  route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, get_str_level(route->level),
-                 new_prefix->prefix, new_prefix->mask); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                 new_prefix->prefix, new_prefix->mask);;
 #endif
 
     if(is_singly_ll_empty(route->like_prefix_list)){
@@ -599,18 +602,18 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
     prefix_pref_data_t prefix_pref = {ROUTE_UNKNOWN_PREFERENCE, "ROUTE_UNKNOWN_PREFERENCE"},
                        route_pref = {ROUTE_UNKNOWN_PREFERENCE, "ROUTE_UNKNOWN_PREFERENCE"};
 
-
+    SPF_COUNTER_INC(SPF_CTR_UPDATE_ROUTE_CALLS);
 
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "Node : %s : result node %s, topo = %s, prefix %s, level %s, prefix metric : %u",
+    SPF_TRACE(ROUTE_CALCULATION_BIT, "Node : %s : result node %s, topo = %s, prefix %s, level %s, prefix metric : %u",
             GET_SPF_INFO_NODE(spf_info, level)->node_name, result->node->node_name, get_topology_name(rt_type),
-            prefix->prefix, get_str_level(level), prefix->metric); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+            prefix->prefix, get_str_level(level), prefix->metric);;
 #endif
 
     if(prefix->metric == INFINITE_METRIC){
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "prefix : %s/%u discarded because of infinite metric", 
-        prefix->prefix, prefix->mask); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+        SPF_TRACE(ROUTE_CALCULATION_BIT, "prefix : %s/%u discarded because of infinite metric", 
+        prefix->prefix, prefix->mask);;
 #endif
         return;
     }
@@ -620,11 +623,11 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
 
     if(!route){
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "prefix : %s/%u is a New route (malloc'd) in %s, hosting_node %s", 
-                prefix->prefix, prefix->mask, get_str_level(level), prefix->hosting_node->node_name); 
-        trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+        SPF_TRACE(ROUTE_CALCULATION_BIT, "prefix : %s/%u is a New route (malloc'd) in %s, hosting_node %s", 
+                prefix->prefix, prefix->mask, get_str_level(level), prefix->hosting_node->node_name);;
 #endif
 
+        SPF_COUNTER_INC(SPF_CTR_ROUTES_NEW);
         route = route_malloc();
         route_set_key(route, prefix->prefix, prefix->mask); 
         route->version = spf_info->spf_level_info[level].version;
@@ -661,9 +664,9 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
                     copy_internal_nh_t(result->next_hop[nh][i], *int_nxt_hop);
                     ROUTE_ADD_NH(route->primary_nh_list[nh], int_nxt_hop);   
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : route : %s/%u Next hop added : %s|%s at %s", 
+                    SPF_TRACE(ROUTE_CALCULATION_BIT, "Node : %s : route : %s/%u Next hop added : %s|%s at %s", 
                             GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask ,
-                            result->next_hop[nh][i].node->node_name, nh == IPNH ? "IPNH":"LSPNH", get_str_level(level)); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                            result->next_hop[nh][i].node->node_name, nh == IPNH ? "IPNH":"LSPNH", get_str_level(level));;
 #endif
                 }
                 else
@@ -675,9 +678,9 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
                     copy_internal_nh_t((result->node->backup_next_hop[level][nh][i]), *int_nxt_hop);
                     ROUTE_ADD_NH(route->backup_nh_list[nh], int_nxt_hop);   
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "route : %s/%u backup next hop is copied with with %s's next hop node %s", 
+                    SPF_TRACE(ROUTE_CALCULATION_BIT, "route : %s/%u backup next hop is copied with with %s's next hop node %s", 
                             route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, result->node->node_name, 
-                            result->node->backup_next_hop[level][nh][i].node->node_name); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                            result->node->backup_next_hop[level][nh][i].node->node_name);;
 #endif
                 }
                 else
@@ -693,17 +696,18 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
 
         ROUTE_ADD_TO_ROUTE_LIST(spf_info, route, rt_type);
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Node : %s : route : %s/%u, spf_metric = %u, lsp_metric = %u, level = %u",  
+        SPF_TRACE(ROUTE_CALCULATION_BIT, "Node : %s : route : %s/%u, spf_metric = %u, lsp_metric = %u, level = %u",  
                 GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, 
-                route->spf_metric, route->lsp_metric, route->level); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                route->spf_metric, route->lsp_metric, route->level);;
 #endif
     }
     else{
+        SPF_COUNTER_INC(SPF_CTR_ROUTES_UPDATED);
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Node : %s : route : %s/%u existing route. route verion : %u," 
+        SPF_TRACE(ROUTE_CALCULATION_BIT, "Node : %s : route : %s/%u existing route. route verion : %u," 
                 "spf version : %u, route level : %s, spf level : %s", 
                 GET_SPF_INFO_NODE(spf_info, level)->node_name, prefix->prefix, prefix->mask, route->version, 
-                spf_info->spf_level_info[level].version, get_str_level(route->level), get_str_level(level)); trace(instance->traceopts, ROUTE_CALCULATION_BIT);
+                spf_info->spf_level_info[level].version, get_str_level(route->level), get_str_level(level));
 #endif
         if((route->level == level && route->version == spf_info->spf_level_info[level].version)
                 || (route->level != level)){
@@ -711,17 +715,16 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
                Comparison Block Start*/
             
 #ifdef __ENABLE_TRACE__
-            sprintf(instance->traceopts->b, "Node : %s : route : %s/%u Trying over-writing route based on preference",
+            SPF_TRACE(ROUTE_CALCULATION_BIT, "Node : %s : route : %s/%u Trying over-writing route based on preference",
                 GET_SPF_INFO_NODE(spf_info, level)->node_name, prefix->prefix, prefix->mask);
-            trace(instance->traceopts, ROUTE_CALCULATION_BIT);
 #endif
             prefix_pref = route_preference(prefix->prefix_flags, prefix->level);
             route_pref  = route_preference(route->flags, route->level);
 
             if(prefix_pref.pref == ROUTE_UNKNOWN_PREFERENCE){
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : Prefix : %s/%u pref = %s, ignoring prefix",  GET_SPF_INFO_NODE(spf_info, level)->node_name,
-                        prefix->prefix, prefix->mask, prefix_pref.pref_str); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                SPF_TRACE(ROUTE_CALCULATION_BIT, "Node : %s : Prefix : %s/%u pref = %s, ignoring prefix",  GET_SPF_INFO_NODE(spf_info, level)->node_name,
+                        prefix->prefix, prefix->mask, prefix_pref.pref_str);;
 #endif
                 return;
             }
@@ -730,9 +733,9 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
 
                 /* if existing route is better*/ 
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : route : %s/%u preference = %s, prefix  pref = %s, Not overwritten",
+                SPF_TRACE(ROUTE_CALCULATION_BIT, "Node : %s : route : %s/%u preference = %s, prefix  pref = %s, Not overwritten",
                         GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask,
-                        route_pref.pref_str, prefix_pref.pref_str); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                        route_pref.pref_str, prefix_pref.pref_str);;
 #endif
                 /*Linkage*/
                 if(linkage){
@@ -744,9 +747,9 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
             else if(prefix_pref.pref < route_pref.pref){
 
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : route : %s/%u preference = %s, prefix  pref = %s, will be overwritten",
+                SPF_TRACE(ROUTE_CALCULATION_BIT, "Node : %s : route : %s/%u preference = %s, prefix  pref = %s, will be overwritten",
                         GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask,
-                        route_pref.pref_str, prefix_pref.pref_str); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                        route_pref.pref_str, prefix_pref.pref_str);;
 #endif
 
                 overwrite_route(spf_info, route, prefix, result, level);
@@ -760,9 +763,9 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
             else{
                 /* If route pref = prefix pref, then decide based on metric*/
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : route : %s/%u preference = %s, prefix  pref = %s, Same preference, Trying based on metric",
+                SPF_TRACE(ROUTE_CALCULATION_BIT, "Node : %s : route : %s/%u preference = %s, prefix  pref = %s, Same preference, Trying based on metric",
                         GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask,
-                        route_pref.pref_str, prefix_pref.pref_str); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                        route_pref.pref_str, prefix_pref.pref_str);;
 #endif
 
                 /* If the prefix and route are of same pref, both will have internal metric Or both will have external metric*/
@@ -778,30 +781,27 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
                 if(IS_BIT_SET(prefix->prefix_flags, PREFIX_METRIC_TYPE_EXT)){
                     /*Decide pref based on external metric*/
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : route : %s/%u Deciding based on External metric",
-                            GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask); 
-                    trace(instance->traceopts, ROUTE_CALCULATION_BIT);; 
+                    SPF_TRACE(ROUTE_CALCULATION_BIT, "Node : %s : route : %s/%u Deciding based on External metric",
+                            GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask);; 
 #endif
 
                     if(prefix->metric < route->ext_metric){
 #ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "Node : %s : prefix external metric ( = %u) is better than routes external metric( = %u), will overwrite",
-                                GET_SPF_INFO_NODE(spf_info, level)->node_name, prefix->metric, route->ext_metric); 
-                        trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                        SPF_TRACE(ROUTE_CALCULATION_BIT, "Node : %s : prefix external metric ( = %u) is better than routes external metric( = %u), will overwrite",
+                                GET_SPF_INFO_NODE(spf_info, level)->node_name, prefix->metric, route->ext_metric);;
 #endif
                         overwrite_route(spf_info, route, prefix, result, level);
                     }
                     else if(prefix->metric > route->ext_metric){
 #ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "Node : %s : prefix external metric ( = %u) is no better than routes external metric( = %u), will not overwrite",
-                                GET_SPF_INFO_NODE(spf_info, level)->node_name, prefix->metric, route->ext_metric); 
-                        trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                        SPF_TRACE(ROUTE_CALCULATION_BIT, "Node : %s : prefix external metric ( = %u) is no better than routes external metric( = %u), will not overwrite",
+                                GET_SPF_INFO_NODE(spf_info, level)->node_name, prefix->metric, route->ext_metric);;
 #endif
                     }
                     else{
 #ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "Node : %s : route : %s/%u hits ecmp case", GET_SPF_INFO_NODE(spf_info, level)->node_name,
-                                route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                        SPF_TRACE(ROUTE_CALCULATION_BIT, "Node : %s : route : %s/%u hits ecmp case", GET_SPF_INFO_NODE(spf_info, level)->node_name,
+                                route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask);;
 #endif
                         /* Union LFA,s RLFA,s Primary nexthops*/
                         ITERATE_NH_TYPE_BEGIN(nh){
@@ -818,25 +818,22 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
                 }else{
                     /*Decide pref based on internal metric*/
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Node : %s : route : %s/%u Deciding based on Internal metric",
-                            GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask); 
-                    trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                    SPF_TRACE(ROUTE_CALCULATION_BIT, "Node : %s : route : %s/%u Deciding based on Internal metric",
+                            GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask);;
 #endif
                     if(result->spf_metric + prefix->metric < route->spf_metric){
 #ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "Node : %s : route : %s/%u is over-written because better metric on node %s is found with metric = %u, old route metric = %u", 
+                        SPF_TRACE(ROUTE_CALCULATION_BIT, "Node : %s : route : %s/%u is over-written because better metric on node %s is found with metric = %u, old route metric = %u", 
                                 GET_SPF_INFO_NODE(spf_info, level)->node_name, 
                                 route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, result->node->node_name, 
-                                result->spf_metric + prefix->metric, route->spf_metric); 
-                        trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                                result->spf_metric + prefix->metric, route->spf_metric);;
 #endif
                         overwrite_route(spf_info, route, prefix, result, level);
                     }
                     else if(result->spf_metric + prefix->metric == route->spf_metric){
 #ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "Node : %s : route : %s/%u hits ecmp case", GET_SPF_INFO_NODE(spf_info, level)->node_name,
-                                route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask); 
-                        trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                        SPF_TRACE(ROUTE_CALCULATION_BIT, "Node : %s : route : %s/%u hits ecmp case", GET_SPF_INFO_NODE(spf_info, level)->node_name,
+                                route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask);;
 #endif
                         /* Union LFA,s RLFA,s Primary nexthops*/ 
                         ITERATE_NH_TYPE_BEGIN(nh){
@@ -846,10 +843,10 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
                     }
                     else{
 #ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "Node : %s : route : %s/%u is not over-written because no better metric on node %s is found with metric = %u, old route metric = %u", 
+                        SPF_TRACE(ROUTE_CALCULATION_BIT, "Node : %s : route : %s/%u is not over-written because no better metric on node %s is found with metric = %u, old route metric = %u", 
                                 GET_SPF_INFO_NODE(spf_info, level)->node_name, 
                                 route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, result->node->node_name, 
-                                result->spf_metric + prefix->metric, route->spf_metric); trace(instance->traceopts, ROUTE_CALCULATION_BIT);;
+                                result->spf_metric + prefix->metric, route->spf_metric);;
 #endif
                     }
                     /*Linkage*/
@@ -863,9 +860,8 @@ update_route(spf_info_t *spf_info,          /*spf_info of computing node*/
         }
         else if(route->level == level && route->version != spf_info->spf_level_info[level].version){
 #ifdef __ENABLE_TRACE__
-            sprintf(instance->traceopts->b, "Node : %s : route : %s/%u %s is mandatorily over-written because of version mismatch",
-                    GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, get_str_level(level)); 
-            trace(instance->traceopts, ROUTE_CALCULATION_BIT);
+            SPF_TRACE(ROUTE_CALCULATION_BIT, "Node : %s : route : %s/%u %s is mandatorily over-written because of version mismatch",
+                    GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, get_str_level(level));
 #endif
             overwrite_route(spf_info, route, prefix, result, level);
             /*Linkage*/
@@ -915,9 +911,8 @@ is_independant_primary_next_hop_list_for_nodes(node_t *S, node_t *dst_node, LEVE
     D_res->backup_requirement[level] = BACKUPS_REQUIRED;
 
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "Node : %s : Testing for Independant primary nexthops at %s for Dest %s",
+    SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Testing for Independant primary nexthops at %s for Dest %s",
             S->node_name, get_str_level(level), dst_node->node_name);
-    trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
 #endif
     check_next_outer_nh = FALSE;
 
@@ -968,9 +963,8 @@ is_independant_primary_next_hop_list_for_nodes(node_t *S, node_t *dst_node, LEVE
         D_res->backup_requirement[level] = NO_BACKUP_REQUIRED;
 
 #ifdef __ENABLE_TRACE__                        
-        sprintf(instance->traceopts->b, "Node : %s : Dest %s has independent Primary nexthops at %s",
+        SPF_TRACE(BACKUP_COMPUTATION_BIT, "Node : %s : Dest %s has independent Primary nexthops at %s",
                 S->node_name, dst_node->node_name, get_str_level(level));
-        trace(instance->traceopts, BACKUP_COMPUTATION_BIT);
 #endif
         return TRUE;
     }
@@ -1068,10 +1062,9 @@ refine_route_backups(routes_t *route){
     if(is_independant_primary_next_hop_list(route)){
 
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "route %s/%u at %s has independant "
+        SPF_TRACE(ROUTE_CALCULATION_BIT, "route %s/%u at %s has independant "
                 "Primary Nexthops, All backup nexthops deleted", 
-                route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, get_str_level(level));
-        trace(instance->traceopts, ROUTE_CALCULATION_BIT);   
+                route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, get_str_level(level));   
 #endif
         ITERATE_NH_TYPE_BEGIN(nh){
             ROUTE_FLUSH_BACKUP_NH_LIST(route, nh);
@@ -1101,14 +1094,13 @@ refine_route_backups(routes_t *route){
                             backup->lfa_type == BROADCAST_LINK_PROTECTION_RLFA           ||
                             backup->lfa_type == BROADCAST_LINK_PROTECTION_RLFA_DOWNSTREAM){
 #ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "\t ECMP : only link-protecting backup deleted : %s----%s---->%-s(%s(%s)) protecting link: %s", 
+                        SPF_TRACE(ROUTE_CALCULATION_BIT, "\t ECMP : only link-protecting backup deleted : %s----%s---->%-s(%s(%s)) protecting link: %s", 
                                 backup->oif->intf_name,
                                 next_hop_type(*backup) == IPNH ? "IPNH" : "LSPNH",
                                 next_hop_type(*backup) == IPNH ? next_hop_gateway_pfx(backup) : "",
                                 backup->node ? backup->node->node_name : backup->rlfa->node_name,
                                 backup->node ? backup->node->router_id : backup->rlfa->router_id, 
-                                backup->protected_link->intf_name); 
-                        trace(instance->traceopts, ROUTE_CALCULATION_BIT);
+                                backup->protected_link->intf_name);
 #endif
                         XFREE(backup);
                         ITERATIVE_LIST_NODE_DELETE2(route->backup_nh_list[nh], list_node1, prev_list_node);
@@ -1119,12 +1111,50 @@ refine_route_backups(routes_t *route){
     }
 }
 
+/*Priority classes : routes of the level are calculated and installed class by
+ * class, critical routes first, lower classes being installed in batches. A route
+ * belongs to the class of the prefix it is first calculated from*/
+
+#define ROUTE_PRIORITY_BATCH_SIZE   64
+
+static unsigned long
+route_priority_elapsed_nsec(struct timespec *start_time){
+
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start_time->tv_sec) * 1000000000UL +
+            now.tv_nsec - start_time->tv_nsec;
+}
+
+static route_priority_t
+prefix_priority_class(spf_info_t *spf_info, prefix_t *prefix){
+
+    prefix_sid_subtlv_t *prefix_sid = NULL;
+
+    if(prefix->mask >= spf_info->priority_min_mask[ROUTE_PRIORITY_CRITICAL])
+        return ROUTE_PRIORITY_CRITICAL;
+
+    if(prefix->psid_thread_ptr && IS_PREFIX_SR_ACTIVE(prefix)){
+        prefix_sid = glthread_to_prefix_sid(prefix->psid_thread_ptr);
+        if(IS_BIT_SET(prefix_sid->flags, NODE_SID_N_FLAG))
+            return ROUTE_PRIORITY_CRITICAL;
+    }
+
+    if(prefix->mask >= spf_info->priority_min_mask[ROUTE_PRIORITY_HIGH])
+        return ROUTE_PRIORITY_HIGH;
+    return ROUTE_PRIORITY_LOW;
+}
+
+/*Calculate the routes of the level for prefixes of class priority only*/
 void
 build_routing_table(spf_info_t *spf_info,
-                    node_t *spf_root, LEVEL level){
+                    node_t *spf_root, LEVEL level,
+                    route_priority_t priority){
 
     singly_ll_node_t *list_node = NULL,
                      *prefix_list_node = NULL;
+    glthread_t *curr = NULL;
 
     routes_t *route = NULL;
     prefix_t *prefix = NULL;
@@ -1132,8 +1162,8 @@ build_routing_table(spf_info_t *spf_info,
                  *L1L2_result = NULL;
 
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "Entered ... spf_root : %s, Level : %s", spf_root->node_name, get_str_level(level));
-    trace(instance->traceopts, ROUTE_INSTALLATION_BIT);
+    SPF_TRACE(ROUTE_INSTALLATION_BIT, "Entered ... spf_root : %s, Level : %s, %s priority", spf_root->node_name,
+            get_str_level(level), get_str_route_priority(priority));
 #endif
     
     /*Walk over the SPF result list computed in spf run
@@ -1144,9 +1174,8 @@ build_routing_table(spf_info_t *spf_info,
 
         result = (spf_result_t *)list_node->data;
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Node %s : processing result of %s, at level %s", 
-            spf_root->node_name, result->node->node_name, get_str_level(level)); 
-        trace(instance->traceopts, ROUTE_INSTALLATION_BIT);
+        SPF_TRACE(ROUTE_INSTALLATION_BIT, "Node %s : processing result of %s, at level %s", 
+            spf_root->node_name, result->node->node_name, get_str_level(level));
 #endif
 
         /*Iterate over all the prefixes of result->node for level 'level'*/
@@ -1159,9 +1188,8 @@ build_routing_table(spf_info_t *spf_info,
 
             L1L2_result = result;                                    /* Record the L1L2 router result*/
 #ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node %s : L1L2_result recorded - %s", 
+            SPF_TRACE(ROUTE_INSTALLATION_BIT, "Node %s : L1L2_result recorded - %s", 
                             spf_root->node_name, L1L2_result->node->node_name); 
-            trace(instance->traceopts, ROUTE_INSTALLATION_BIT); 
 #endif
 
             prefix_t default_prefix;
@@ -1173,31 +1201,138 @@ build_routing_table(spf_info_t *spf_info,
             default_prefix.metric = 0;
             default_prefix.mask = 0;
             default_prefix.level = LEVEL1;
-            update_route(spf_info, L1L2_result, &default_prefix, LEVEL1, UNICAST_T, FALSE);
+            if(prefix_priority_class(spf_info, &default_prefix) == priority)
+                update_route(spf_info, L1L2_result, &default_prefix, LEVEL1, UNICAST_T, FALSE);
         }
 
 
         ITERATE_LIST_BEGIN(GET_NODE_PREFIX_LIST(result->node, level), prefix_list_node){
 
             prefix = (prefix_t *)prefix_list_node->data;  
+            if(prefix_priority_class(spf_info, prefix) != priority)
+                continue;
             update_route(spf_info, result, prefix, level, UNICAST_T, TRUE);
         }ITERATE_LIST_END;
 
     } ITERATE_LIST_END;
 
-    /*Iterate over all UPDATED routes and figured out which one needs to be updated
-     * in RIB*/
-    ITERATE_LIST_BEGIN(spf_info->routes_list[UNICAST_T], list_node){
+    /*Iterate over all routes UPDATED by this class and figured out which one needs to be updated
+     * in RIB. Routes calculated by a more critical class are installed already*/
+    ITERATE_GLTHREAD_BEGIN(&spf_info->routes_list[UNICAST_T], curr){
 
-        route = list_node->data;
+        route = glthread_to_route(curr);
         
         if(route->level != level)
             continue;
 
-        if(route->version == spf_info->spf_level_info[level].version)
+        if(route->version == spf_info->spf_level_info[level].version &&
+                route->priority == ROUTE_PRIORITY_MAX){
             refine_route_backups(route);
+            route->priority = priority;
+        }
 
-    } ITERATE_LIST_END;
+    } ITERATE_GLTHREAD_END(&spf_info->routes_list[UNICAST_T], curr);
+}
+
+/*Forget the classes of last run, routes of the level are unclassified until calculated again*/
+static void
+route_priority_reset(spf_info_t *spf_info, LEVEL level, rtttype_t rt_type){
+
+    glthread_t *curr = NULL;
+    routes_t *route = NULL;
+
+    ITERATE_GLTHREAD_BEGIN(&spf_info->routes_list[rt_type], curr){
+
+        route = glthread_to_route(curr);
+        if(route->level == level)
+            route->priority = ROUTE_PRIORITY_MAX;
+    } ITERATE_GLTHREAD_END(&spf_info->routes_list[rt_type], curr);
+}
+
+/*Queue the routes of the level calculated for class priority, critical routes
+ * are staged in priority_routes_list right away, lower classes are deferred*/
+static void
+route_priority_queue(spf_info_t *spf_info, LEVEL level, rtttype_t rt_type,
+                     route_priority_t priority){
+
+    glthread_t *curr = NULL;
+    routes_t *route = NULL;
+    glthread_t *tail = (priority == ROUTE_PRIORITY_CRITICAL) ?
+                        &spf_info->priority_routes_list[rt_type] :
+                        &spf_info->deferred_routes_list[rt_type];
+
+    ITERATE_GLTHREAD_BEGIN(&spf_info->routes_list[rt_type], curr){
+
+        route = glthread_to_route(curr);
+        if(route->level != level ||
+                route->version != spf_info->spf_level_info[level].version ||
+                route->priority != priority)
+            continue;
+
+        spf_info->priority_stats[level].routes[priority]++;
+        remove_glthread(&route->priority_glue);
+        glthread_add_next(tail, &route->priority_glue);
+        tail = &route->priority_glue;
+    } ITERATE_GLTHREAD_END(&spf_info->routes_list[rt_type], curr);
+}
+
+/*Move next batch of deferred routes of class priority in priority_routes_list*/
+static unsigned int
+route_priority_stage_batch(spf_info_t *spf_info, rtttype_t rt_type,
+                           route_priority_t priority){
+
+    glthread_t *curr = NULL;
+    routes_t *route = NULL;
+    unsigned int count = 0;
+    glthread_t *priority_tail = &spf_info->priority_routes_list[rt_type];
+
+    ITERATE_GLTHREAD_BEGIN(&spf_info->deferred_routes_list[rt_type], curr){
+
+        route = priority_glthread_to_route(curr);
+        if(route->priority != priority)
+            break;
+        remove_glthread(&route->priority_glue);
+        glthread_add_next(priority_tail, &route->priority_glue);
+        priority_tail = &route->priority_glue;
+        if(++count == ROUTE_PRIORITY_BATCH_SIZE)
+            break;
+    } ITERATE_GLTHREAD_END(&spf_info->deferred_routes_list[rt_type], curr);
+    return count;
+}
+
+/*Install the routes staged in priority_routes_list, and unstage them*/
+static void
+route_priority_install_staged(spf_info_t *spf_info, LEVEL level, rtttype_t rt_type){
+
+    glthread_t *curr = NULL;
+    struct timespec phase_start_time;
+
+    clock_gettime(CLOCK_MONOTONIC, &phase_start_time);
+    enhanced_start_route_installation(spf_info, level, rt_type);
+    spf_phase_lap(spf_info, level, SPF_PHASE_ROUTE_INSTALL, &phase_start_time);
+
+    ITERATE_GLTHREAD_BEGIN(&spf_info->priority_routes_list[rt_type], curr){
+        remove_glthread(curr);
+    } ITERATE_GLTHREAD_END(&spf_info->priority_routes_list[rt_type], curr);
+}
+
+/*Install the routes of the level calculated for class priority*/
+static void
+route_priority_install_class(spf_info_t *spf_info, LEVEL level, rtttype_t rt_type,
+                             route_priority_t priority){
+
+    route_priority_stats_t *priority_stats = &spf_info->priority_stats[level];
+
+    route_priority_queue(spf_info, level, rt_type, priority);
+    if(priority == ROUTE_PRIORITY_CRITICAL){
+        route_priority_install_staged(spf_info, level, rt_type);
+        priority_stats->batches[priority] = 1;
+        return;
+    }
+    while(route_priority_stage_batch(spf_info, rt_type, priority)){
+        route_priority_install_staged(spf_info, level, rt_type);
+        priority_stats->batches[priority]++;
+    }
 }
 
 void
@@ -1206,13 +1341,21 @@ spf_postprocessing(spf_info_t *spf_info, /* routes are stored globally*/
                    LEVEL level){         /*Level of spf run*/
 
     unsigned int rc = 0; 
+    rtttype_t rt_type;
+    route_priority_t priority;
+    struct timespec start_time,
+                    phase_start_time;
+    route_priority_stats_t *priority_stats = &spf_info->priority_stats[level];
+    boolean spring_enabled = is_node_spring_enabled(spf_root, level);
+
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+    memset(priority_stats, 0, sizeof(route_priority_stats_t));
     /*-----------------------------------------------------------------------------
      *  If this is L2 run, then set my spf_info_t->spff_multi_area bit, and schedule
      *  SPF L1 run to ensure L1 routes are uptodate before updating L2 routes
      *-----------------------------------------------------------------------------*/
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "Entered ... ");
-    trace(instance->traceopts, ROUTE_CALCULATION_BIT);
+    SPF_TRACE(ROUTE_CALCULATION_BIT, "Entered ... ");
 #endif
        
     if(level == LEVEL2 && spf_info->spf_level_info[LEVEL1].version){
@@ -1227,30 +1370,59 @@ spf_postprocessing(spf_info_t *spf_info, /* routes are stored globally*/
         //spf_computation(spf_root, spf_info, LEVEL1, FULL_RUN);
     }
 
-    build_routing_table(spf_info, spf_root, level);
+    /*Mark all Ribs stale before route installation, only the delta
+     * between installed and newly computed routes is applied*/ 
+    rib_mark_stale(spf_info->rib[INET_0], level);
+    rib_mark_stale(spf_info->rib[INET_3], level);
+    rib_mark_stale(spf_info->rib[MPLS_0], level);
+
+    for(rt_type = UNICAST_T; rt_type < TOPO_MAX; rt_type++)
+        route_priority_reset(spf_info, level, rt_type);
+
+    /*Routes are calculated and installed class by class, critical routes are
+     * installed before lower classes are even calculated. Unicast routes of a
+     * class are installed before SPRING routes of the class are calculated*/
+    for(priority = ROUTE_PRIORITY_CRITICAL; priority < ROUTE_PRIORITY_MAX; priority++){
+        clock_gettime(CLOCK_MONOTONIC, &phase_start_time);
+        build_routing_table(spf_info, spf_root, level, priority);
+        spf_phase_lap(spf_info, level, SPF_PHASE_BUILD_ROUTES, &phase_start_time);
+        route_priority_install_class(spf_info, level, UNICAST_T, priority);
+
+        if(spring_enabled){
+            clock_gettime(CLOCK_MONOTONIC, &phase_start_time);
+            update_node_segment_routes_for_remote(spf_info, level, priority);
+            spf_phase_lap(spf_info, level, SPF_PHASE_BUILD_ROUTES, &phase_start_time);
+            route_priority_install_class(spf_info, level, SPRING_T, priority);
+        }
+        priority_stats->convergence_time_nsec[priority] =
+            route_priority_elapsed_nsec(&start_time);
+#ifdef __ENABLE_TRACE__
+        SPF_TRACE(ROUTE_INSTALLATION_BIT, "%u %s priority routes installed in %u batches",
+                priority_stats->routes[priority], get_str_route_priority(priority),
+                priority_stats->batches[priority]);
+#endif
+    }
+
+    /*Routes not calculated again by any class are stale*/
+    clock_gettime(CLOCK_MONOTONIC, &phase_start_time);
     rc = delete_stale_routes(spf_info, level, UNICAST_T);
 #ifdef __ENABLE_TRACE__
-    sprintf(instance->traceopts->b, "No of Unicast stale routes deleted = %u", rc);
-    trace(instance->traceopts, ROUTE_CALCULATION_BIT);
+    SPF_TRACE(ROUTE_CALCULATION_BIT, "No of Unicast stale routes deleted = %u", rc);
 #endif
-    if(is_node_spring_enabled(spf_root, level)){
-        update_node_segment_routes_for_remote(spf_info, level);
+    if(spring_enabled){
         rc = delete_stale_routes(spf_info, level, SPRING_T);
 #ifdef __ENABLE_TRACE__
-        sprintf(instance->traceopts->b, "No of SPRING stale routes deleted = %u", rc);
-        trace(instance->traceopts, ROUTE_CALCULATION_BIT);
+        SPF_TRACE(ROUTE_CALCULATION_BIT, "No of SPRING stale routes deleted = %u", rc);
 #endif
     }
-  
-    /*Flush all Ribs before route installation*/ 
-    flush_rib(spf_info->rib[INET_0], level);
-    flush_rib(spf_info->rib[INET_3], level);
-    flush_rib(spf_info->rib[MPLS_0], level);
-
-    enhanced_start_route_installation(spf_info, level, UNICAST_T);
-    if(is_node_spring_enabled(spf_root, level)){
-        enhanced_start_route_installation(spf_info, level, SPRING_T);   
-    }
+    spf_phase_lap(spf_info, level, SPF_PHASE_DELETE_STALE, &phase_start_time);
+
+    rib_sweep_stale(spf_info->rib[INET_0], level);
+    rib_sweep_stale(spf_info->rib[INET_3], level);
+    rib_sweep_stale(spf_info->rib[MPLS_0], level);
+
+    /*Forwarding state is programmed, now release memory of stale routes*/
+    reclaim_stale_routes(spf_info);
 }
 
 internal_nh_t *
@@ -1275,7 +1447,7 @@ backup_selection_policy(routes_t *route){
 void
 show_internal_routing_tree(node_t *node, char *prefix, char mask, rtttype_t rt_type){
 
-        singly_ll_node_t *list_node = NULL;
+        glthread_t *curr = NULL;
         routes_t *route = NULL;
         char subnet[PREFIX_LEN_WITH_MASK + 1];
         nh_type_t nh;
@@ -1286,9 +1458,9 @@ show_internal_routing_tree(node_t *node, char *prefix, char mask, rtttype_t rt_t
         printf("Destination           Version        Metric       Level   Gateway            Nxt-Hop                     OIF           protection    Backup Score\n");
         printf("--------------------------------------------------------------------------------------------------------------------------------------------------\n");
 
-        ITERATE_LIST_BEGIN(node->spf_info.routes_list[rt_type], list_node){
+        ITERATE_GLTHREAD_BEGIN(&node->spf_info.routes_list[rt_type], curr){
 
-            route = list_node->data;
+            route = glthread_to_route(curr);
 
             /*filter*/
             if(prefix){
@@ -1377,14 +1549,16 @@ show_internal_routing_tree(node_t *node, char *prefix, char mask, rtttype_t rt_t
             } ITERATE_NH_TYPE_END;
                 if(prefix)
                     return;
-        }ITERATE_LIST_END;
+        } ITERATE_GLTHREAD_END(&node->spf_info.routes_list[rt_type], curr);
 }
 
 
 /*SR related APIs*/
 /*It is essentially a routing table building routine for SR node/prefix segment routes*/
+/*Calculate the SPRING routes of the level for prefix SIDs of class priority only*/
 void
-update_node_segment_routes_for_remote(spf_info_t *spf_info, LEVEL level){
+update_node_segment_routes_for_remote(spf_info_t *spf_info, LEVEL level,
+                                      route_priority_t priority){
 
     singly_ll_node_t *list_node = NULL;
     spf_result_t *result = NULL;
@@ -1399,9 +1573,8 @@ update_node_segment_routes_for_remote(spf_info_t *spf_info, LEVEL level){
            *D_res = NULL;
 
 #ifdef __ENABLE_TRACE__
-    sprintf(instance->traceopts->b, "Entered ... spf_root : %s, Level : %s", 
+    SPF_TRACE(SPRING_ROUTE_CAL_BIT, "Entered ... spf_root : %s, Level : %s", 
         spf_root->node_name, get_str_level(level));
-    trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
 #endif
 
     ITERATE_LIST_BEGIN(spf_root->spf_run_result[level], list_node){
@@ -1410,9 +1583,8 @@ update_node_segment_routes_for_remote(spf_info_t *spf_info, LEVEL level){
         
         if(!is_node_spring_enabled(D_res, level)){
 #ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Node : %s : skipping Dest %s at %s, not SPRING enabled",
+            SPF_TRACE(SPRING_ROUTE_CAL_BIT, "Node : %s : skipping Dest %s at %s, not SPRING enabled",
                 spf_root->node_name, D_res->node_name, get_str_level(level));
-            trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
 #endif
             continue;
         }
@@ -1424,13 +1596,15 @@ update_node_segment_routes_for_remote(spf_info_t *spf_info, LEVEL level){
             assert(prefix_sid->prefix);
             if(!IS_PREFIX_SR_ACTIVE(prefix_sid->prefix)){
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Node : %s : skipping prefix %s/%u, hosting node : %s at %s, conflicting prefix",
+                SPF_TRACE(SPRING_ROUTE_CAL_BIT, "Node : %s : skipping prefix %s/%u, hosting node : %s at %s, conflicting prefix",
                         spf_root->node_name, STR_PREFIX(prefix_sid->prefix), PREFIX_MASK(prefix_sid->prefix), 
-                        D_res->node_name, get_str_level(level)); 
-                trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
+                        D_res->node_name, get_str_level(level));
 #endif
                 continue;
             }
+
+            if(prefix_priority_class(spf_info, prefix_sid->prefix) != priority)
+                continue;
             
             /*Get IGP Native route for this prefix*/
             init_prefix_key(&comm_pfx_key, prefix_sid->prefix->prefix, prefix_sid->prefix->mask);
@@ -1438,9 +1612,8 @@ update_node_segment_routes_for_remote(spf_info_t *spf_info, LEVEL level){
 
             if(!igp_route || igp_route->level != level){ 
 #ifdef __ENABLE_TRACE__
-                sprintf(instance->traceopts->b, "Node : %s : IGP route for prefix %s/%u do not exist, Skipping calculation of Spring Route", 
+                SPF_TRACE(SPRING_ROUTE_CAL_BIT, "Node : %s : IGP route for prefix %s/%u do not exist, Skipping calculation of Spring Route", 
                         spf_root->node_name, STR_PREFIX(prefix_sid->prefix), PREFIX_MASK(prefix_sid->prefix));
-                trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
 #endif
                 continue;   
             }
@@ -1452,20 +1625,18 @@ update_node_segment_routes_for_remote(spf_info_t *spf_info, LEVEL level){
                 sr_route = route_malloc();
                 ROUTE_ADD_TO_ROUTE_LIST(spf_info, sr_route, SPRING_T);
 #ifdef __ENABLE_TRACE__
-                sprintf(instance->traceopts->b, "Node : %s : New SR route malloc'd for prefix %s/%u",
-                        spf_root->node_name, comm_pfx_key.u.prefix.prefix, comm_pfx_key.u.prefix.mask);
-                trace(instance->traceopts, SPRING_ROUTE_CAL_BIT); 
+                SPF_TRACE(SPRING_ROUTE_CAL_BIT, "Node : %s : New SR route malloc'd for prefix %s/%u",
+                        spf_root->node_name, comm_pfx_key.u.prefix.prefix, comm_pfx_key.u.prefix.mask); 
 #endif
             }
             else if(sr_route->level != level){
 #ifdef __ENABLE_TRACE__
-                sprintf(instance->traceopts->b, "Node : %s : SR route %s/%u at %s will be transformed into %s route, hence deleting it from RIB",
+                SPF_TRACE(SPRING_ROUTE_CAL_BIT, "Node : %s : SR route %s/%u at %s will be transformed into %s route, hence deleting it from RIB",
                         spf_root->node_name, sr_route->rt_key.u.prefix.prefix,  sr_route->rt_key.u.prefix.mask,
                         get_str_level(sr_route->level), get_str_level(level));
-                trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
+#endif
                 /*Delete this SR route from RIB here*/
                 delete_route(spf_info, sr_route, FALSE, TRUE);
-#endif
             }
 
             /*Over write SR properties*/
@@ -1477,6 +1648,7 @@ update_node_segment_routes_for_remote(spf_info_t *spf_info, LEVEL level){
             sr_route->flags = igp_route->flags;
             sr_route->level = igp_route->level;
             sr_route->rt_type = SPRING_T;
+            sr_route->priority = priority;
             sr_route->hosting_node = igp_route->hosting_node;
             sr_route->spf_metric = igp_route->spf_metric;
             sr_route->lsp_metric = igp_route->lsp_metric;
@@ -1537,8 +1709,8 @@ enhanced_start_route_installation_unicast(spf_info_t *spf_info, LEVEL level){
     /*Unicast (IGPs) protocols installs the routes in inet.0 and inet.3 tables
      * only. Flush both the tables first*/
 
-    singly_ll_node_t *list_node = NULL,
-    *list_node2 = NULL;
+    singly_ll_node_t *list_node2 = NULL;
+    glthread_t *curr = NULL;
 
     routes_t *route = NULL;
     nh_type_t nh;
@@ -1548,9 +1720,9 @@ enhanced_start_route_installation_unicast(spf_info_t *spf_info, LEVEL level){
     rt_key_t rt_key;
     boolean is_local_route = FALSE;
 
-    ITERATE_LIST_BEGIN(spf_info->routes_list[UNICAST_T], list_node){
+    ITERATE_GLTHREAD_BEGIN(&spf_info->priority_routes_list[UNICAST_T], curr){
 
-        route = list_node->data;
+        route = priority_glthread_to_route(curr);
         if(route->level != level) continue;
 
         assert(route->version == spf_info->spf_level_info[level].version);
@@ -1623,7 +1795,11 @@ enhanced_start_route_installation_unicast(spf_info_t *spf_info, LEVEL level){
 
                     }else{
                         /*LDP backup nexthop(RLFAs)*/
-                        prefix_t *prefix = ROUTE_GET_BEST_PREFIX(route);
+                        prefix_t *prefix = NULL;
+                        /*L1 default route towards L1L2 routers has no prefix of its own*/
+                        if(is_singly_ll_empty(route->like_prefix_list))
+                            continue;
+                        prefix = ROUTE_GET_BEST_PREFIX(route);
                         ldpify_rlfa_nexthop(nxthop, prefix->prefix, prefix->mask);
                         /*Could not get LDP label, skip installation of this LDP nexthop*/
                         if(IS_INTERNAL_NH_MPLS_STACK_EMPTY(nxthop))
@@ -1640,7 +1816,7 @@ enhanced_start_route_installation_unicast(spf_info_t *spf_info, LEVEL level){
                 }
             } ITERATE_LIST_END;
         } ITERATE_NH_TYPE_END;
-    } ITERATE_LIST_END;
+    } ITERATE_GLTHREAD_END(&spf_info->priority_routes_list[UNICAST_T], curr);
 }
 
 static void
@@ -1649,8 +1825,8 @@ enhanced_start_route_installation_spring(spf_info_t *spf_info, LEVEL level){
     /* (L-IGP) protocol installs the routes in inet.3 and mpls.0 tables
      * only. Flush both the tables first*/
 
-    singly_ll_node_t *list_node = NULL,
-                     *list_node2 = NULL;
+    singly_ll_node_t *list_node2 = NULL;
+    glthread_t *curr = NULL;
 
     routes_t *route = NULL;
     nh_type_t nh;
@@ -1659,9 +1835,9 @@ enhanced_start_route_installation_spring(spf_info_t *spf_info, LEVEL level){
     boolean rc = FALSE;
     rt_key_t rt_key;
 
-    ITERATE_LIST_BEGIN(spf_info->routes_list[SPRING_T], list_node){
-        
-        route = list_node->data;
+    ITERATE_GLTHREAD_BEGIN(&spf_info->priority_routes_list[SPRING_T], curr){
+
+        route = priority_glthread_to_route(curr);
         if(route->level != level) continue;
        
         assert(route->version == spf_info->spf_level_info[level].version);
@@ -1677,11 +1853,10 @@ enhanced_start_route_installation_spring(spf_info_t *spf_info, LEVEL level){
             nxthop = list_node2->data;
             if(!IS_INTERNAL_NH_SPRINGIFIED(nxthop)){
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "node : %s : route %s/%u, at %s nexthop (%s)%s not installed, not spring capable", 
+                SPF_TRACE(SPRING_ROUTE_CAL_BIT, "node : %s : route %s/%u, at %s nexthop (%s)%s not installed, not spring capable", 
                 GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, 
                 get_str_level(level), next_hop_oif_name(*nxthop), nxthop->node ? nxthop->node->node_name :
                 nxthop->proxy_nbr->node_name);
-                trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
 #endif
                 continue;
             }
@@ -1705,11 +1880,10 @@ enhanced_start_route_installation_spring(spf_info_t *spf_info, LEVEL level){
             nxthop = list_node2->data;
             if(!IS_INTERNAL_NH_SPRINGIFIED(nxthop)){
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "node : %s : route %s/%u, at %s backup nexthop (%s)%s not installed not spring capable", 
+                SPF_TRACE(SPRING_ROUTE_CAL_BIT, "node : %s : route %s/%u, at %s backup nexthop (%s)%s not installed not spring capable", 
                 GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, 
                 get_str_level(level), next_hop_oif_name(*nxthop), nxthop->node ? nxthop->node->node_name :
                 nxthop->proxy_nbr->node_name);
-                trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
 #endif
                 continue;
             }
@@ -1731,11 +1905,10 @@ enhanced_start_route_installation_spring(spf_info_t *spf_info, LEVEL level){
                 continue; /*ToDo : Support RSVP later . . . */
             if(!IS_INTERNAL_NH_SPRINGIFIED(nxthop) || !is_node_spring_enabled(nxthop->rlfa, level) || nxthop->lfa_type == TILFA){
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "node : %s : route %s/%u, at %s backup nexthop (%s)%s not installed not spring capable", 
+                SPF_TRACE(SPRING_ROUTE_CAL_BIT, "node : %s : route %s/%u, at %s backup nexthop (%s)%s not installed not spring capable", 
                 GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, 
                 get_str_level(level), next_hop_oif_name(*nxthop), nxthop->node ? nxthop->node->node_name :
                 nxthop->proxy_nbr->node_name);
-                trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
 #endif
                 continue;
             }
@@ -1760,11 +1933,10 @@ enhanced_start_route_installation_spring(spf_info_t *spf_info, LEVEL level){
                 nxthop = list_node2->data;
                 if(!IS_INTERNAL_NH_SPRINGIFIED(nxthop)){
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "node : %s : route %s/%u, at %s primarynexthop (%s)%s not installed, not spring capable", 
+                    SPF_TRACE(SPRING_ROUTE_CAL_BIT, "node : %s : route %s/%u, at %s primarynexthop (%s)%s not installed, not spring capable", 
                     GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, 
                             get_str_level(level), next_hop_oif_name(*nxthop), nxthop->node ? nxthop->node->node_name :
                             nxthop->proxy_nbr->node_name);
-                    trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
 #endif
                     continue;
                 }
@@ -1784,11 +1956,10 @@ enhanced_start_route_installation_spring(spf_info_t *spf_info, LEVEL level){
                     continue;
                 if(!IS_INTERNAL_NH_SPRINGIFIED(nxthop) || (nxthop->rlfa && !is_node_spring_enabled(nxthop->rlfa, level))){
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "node : %s : route %s/%u, at %s backup nexthop (%s)%s not installed, not spring capable", 
+                    SPF_TRACE(SPRING_ROUTE_CAL_BIT, "node : %s : route %s/%u, at %s backup nexthop (%s)%s not installed, not spring capable", 
                     GET_SPF_INFO_NODE(spf_info, level)->node_name, route->rt_key.u.prefix.prefix, route->rt_key.u.prefix.mask, 
                             get_str_level(level), next_hop_oif_name(*nxthop), nxthop->node ? nxthop->node->node_name :
                             nxthop->proxy_nbr->node_name);
-                    trace(instance->traceopts, SPRING_ROUTE_CAL_BIT);
 #endif
                     continue;
                 }
@@ -1814,7 +1985,7 @@ enhanced_start_route_installation_spring(spf_info_t *spf_info, LEVEL level){
                 }
             } ITERATE_LIST_END;
         } ITERATE_NH_TYPE_END;
-    } ITERATE_LIST_END;
+    } ITERATE_GLTHREAD_END(&spf_info->priority_routes_list[SPRING_T], curr);
 }
 
 static void
@@ -50,8 +50,14 @@ typedef struct routes_{
     ll_t *primary_nh_list[NH_MAX];/*Taking it as a list to accomodate ECMP*/
     ll_t *backup_nh_list[NH_MAX]; /*List of node_t pointers*/
     ll_t *like_prefix_list; 
+    glthread_t glue;          /*Links the route in spf_info->routes_list, Or in reclaim list once stale*/
+    glthread_t priority_glue; /*Links the route in spf_info->priority_routes_list Or deferred_routes_list*/
+    route_priority_t priority;
 } routes_t;
 
+GLTHREAD_TO_STRUCT(glthread_to_route, routes_t, glue);
+GLTHREAD_TO_STRUCT(priority_glthread_to_route, routes_t, priority_glue);
+
 routes_t *route_malloc();
 
 routes_t *
@@ -112,13 +118,14 @@ ROUTE_FLUSH_BACKUP_NH_LIST(routes_t *route, nh_type_t nh){
     delete_singly_ll(route->backup_nh_list[nh]);
 }
 
-#define ROUTE_ADD_TO_ROUTE_LIST(spfinfo_ptr, routeptr, topo)               \
-    singly_ll_add_node_by_val(spfinfo_ptr->routes_list[topo], routeptr);   \
-    singly_ll_add_node_by_val(spfinfo_ptr->priority_routes_list[topo], routeptr)
+/*Route lists are intrusive, a route is linked/unlinked in O(1). A route
+ * joins priority_routes_list Or deferred_routes_list only while being installed*/
+#define ROUTE_ADD_TO_ROUTE_LIST(spfinfo_ptr, routeptr, topo)                          \
+    glthread_add_next(&spfinfo_ptr->routes_list[topo], &routeptr->glue)
 
 #define ROUTE_DEL_FROM_ROUTE_LIST(spfinfo_ptr, routeptr, topo)    \
-    singly_ll_delete_node_by_data_ptr(spfinfo_ptr->routes_list[topo], routeptr);  \
-    singly_ll_delete_node_by_data_ptr(spfinfo_ptr->priority_routes_list[topo], routeptr)
+    remove_glthread(&routeptr->glue);                             \
+    remove_glthread(&routeptr->priority_glue)
 
 #define ROUTE_GET_PR_NH_CNT(routeptr, _nh)   \
     GET_NODE_COUNT_SINGLY_LL(routeptr->primary_nh_list[_nh])
@@ -137,11 +144,19 @@ spf_postprocessing(spf_info_t *spf_info,      /* routes are stored globally*/
 
 void
 build_routing_table(spf_info_t *spf_info,
-                    node_t *spf_root, LEVEL level);
+                    node_t *spf_root, LEVEL level,
+                    route_priority_t priority);
+
+void
+update_node_segment_routes_for_remote(spf_info_t *spf_info, LEVEL level,
+                                      route_priority_t priority);
 
 void
 delete_all_routes(node_t *node, LEVEL level);
 
+void
+reclaim_stale_routes(spf_info_t *spf_info);
+
 void
 start_route_installation(spf_info_t *spf_info, 
                          LEVEL level);
@@ -0,0 +1,486 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  spfbench.c
+ *
+ *    Description:  SPF benchmark harness, times the phases of SPF computation over
+ *                  a loaded or generated topology and reports them as JSON
+ *
+ *        Version:  1.0
+ *        Created:  Sunday 18 October 2026 19:58:41  UTC
+ *       Revision:  1.0
+ *       Compiler:  gcc
+ *
+ *         Author:  agent, agent@local
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        Copyright (c) 2026 agent.
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/resource.h>
+#include "instance.h"
+#include "spfclihandler.h"
+#include "spfutil.h"
+#include "topo_loader.h"
+#include "topo_gen.h"
+#include "rlfa.h"
+#include "tilfa.h"
+#include "LinuxMemoryManager/uapi_mm.h"
+#include "spfcounters.h"
+
+/* spfbench [-f <topology-file> | -g <clos|geometric|waxman|isp>:<size>]
+ *          [-S <seed>] [-l <level>] [-r <roots>] [-i <iterations>]
+ *          [-y <sync-iterations>] [-b] [-t] [-o <json-file>]
+ *
+ * Per root and iteration, the phases below are timed one after the other :
+ *
+ *  dijkstra            spf_computation() FORWARD_RUN, spf_init and run_dijkastra only
+ *  spf_full_run        spf_computation() FULL_RUN, everything below included
+ *  route_build         build_routing_table() and SPRING route calculation of the FULL_RUN
+ *  rib_install         enhanced_start_route_installation() of the FULL_RUN
+ *  lfa_rlfa            compute_backup_routine(), with -b only
+ *  tilfa               compute_tilfa(), with -t only
+ *
+ * Before that, "run instance sync" (sync) is timed sync-iterations times,
+ * the first one computes the routes of every router from scratch. Sync
+ * keeps the routes of all routers in memory, -y 0 skips it on large
+ * topologies, L1 routes of the roots are then computed without the
+ * attached bit of L1L2 routers (set by their L2 run). -b
+ * enables LFA and RLFA, -t TI-LFA, with link protection of all interfaces.
+ * -r picks that many roots spread over the node list, 0 for all nodes.
+ * Phases timed as a whole also report the MM allocations and the hot path
+ * event counters (spfcounters.h) per run.
+ * The JSON report goes to stdout unless -o is given, anything else the
+ * library prints goes to stderr*/
+
+#define SPFBENCH_DEF_ROOTS          64
+#define SPFBENCH_DEF_ITERATIONS     3
+
+/*Globals */
+instance_t *instance = NULL;
+
+typedef enum{
+
+    SPFBENCH_DIJKSTRA,
+    SPFBENCH_FULL_RUN,
+    SPFBENCH_ROUTE_BUILD,
+    SPFBENCH_RIB_INSTALL,
+    SPFBENCH_LFA_RLFA,
+    SPFBENCH_TILFA,
+    SPFBENCH_SYNC,
+    SPFBENCH_PHASE_MAX
+} spfbench_phase_t;
+
+static const char *spfbench_phase_str[SPFBENCH_PHASE_MAX] = {
+
+    "dijkstra",
+    "spf_full_run",
+    "route_build",
+    "rib_install",
+    "lfa_rlfa",
+    "tilfa",
+    "sync"
+};
+
+typedef struct spfbench_samples_{
+
+    uint64_t *nsec;
+    unsigned int n;
+    unsigned int alloc;
+    boolean mm_counted;     /*allocations and spf counters are counted by the phase*/
+    uint64_t mm_allocs;
+    uint64_t mm_frees;
+    uint64_t counters[SPF_CTR_MAX];
+} spfbench_samples_t;
+
+typedef struct spfbench_clock_{
+
+    struct timespec start;
+    mm_stats_t mm_start;
+    spf_counters_t counters_start;
+} spfbench_clock_t;
+
+static spfbench_samples_t samples[SPFBENCH_PHASE_MAX];
+
+static void
+spfbench_add_sample(spfbench_phase_t phase, uint64_t nsec){
+
+    spfbench_samples_t *s = &samples[phase];
+
+    if(s->n == s->alloc){
+        s->alloc = s->alloc ? s->alloc * 2 : 256;
+        s->nsec = realloc(s->nsec, s->alloc * sizeof(uint64_t));
+        assert(s->nsec);
+    }
+    s->nsec[s->n++] = nsec;
+}
+
+static void
+spfbench_clock_start(spfbench_clock_t *clock){
+
+    mm_get_stats(&clock->mm_start);
+    clock->counters_start = spf_counters;
+    clock_gettime(CLOCK_MONOTONIC, &clock->start);
+}
+
+/*Record the time, MM allocations and spf counters since spfbench_clock_start()*/
+static void
+spfbench_clock_stop(spfbench_clock_t *clock, spfbench_phase_t phase){
+
+    struct timespec now;
+    mm_stats_t mm_now;
+    spf_counter_t counter;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    mm_get_stats(&mm_now);
+
+    spfbench_add_sample(phase, (uint64_t)(now.tv_sec - clock->start.tv_sec) * 1000000000ULL +
+                               now.tv_nsec - clock->start.tv_nsec);
+    samples[phase].mm_counted = TRUE;
+    samples[phase].mm_allocs += mm_now.n_allocs - clock->mm_start.n_allocs;
+    samples[phase].mm_frees += mm_now.n_frees - clock->mm_start.n_frees;
+    for(counter = SPF_CTR_CANDIDATE_POPS; counter < SPF_CTR_MAX; counter++){
+        samples[phase].counters[counter] += spf_counters.counter[counter] -
+                                            clock->counters_start.counter[counter];
+    }
+}
+
+static int
+spfbench_nsec_cmp(const void *a, const void *b){
+
+    uint64_t x = *(const uint64_t *)a,
+             y = *(const uint64_t *)b;
+
+    return x < y ? -1 : x > y;
+}
+
+/*Nearest rank percentile of sorted samples*/
+static uint64_t
+spfbench_percentile(spfbench_samples_t *s, unsigned int percent){
+
+    unsigned int rank = (s->n * percent + 99) / 100;
+
+    return s->nsec[rank ? rank - 1 : 0];
+}
+
+static boolean
+spfbench_node_has_level(node_t *node, LEVEL level){
+
+    unsigned int i = 0;
+    edge_end_t *edge_end = NULL;
+    edge_t *edge = NULL;
+
+    if(node->node_type[level] == PSEUDONODE)
+        return FALSE;
+
+    for(i = 0; i < MAX_NODE_INTF_SLOTS; i++){
+        edge_end = node->edges[i];
+        if(!edge_end) break;
+        if(edge_end->dirn != OUTGOING)
+            continue;
+        edge = GET_EGDE_PTR_FROM_EDGE_END(edge_end);
+        if(IS_LEVEL_SET(edge->level, level))
+            return TRUE;
+    }
+    return FALSE;
+}
+
+/*Link protection on all interfaces of all routers, -b adds LFA and
+ * RLFA computation, -t TI-LFA computation*/
+static void
+spfbench_enable_protection(boolean lfa_rlfa, boolean tilfa){
+
+    unsigned int i = 0;
+    singly_ll_node_t *list_node = NULL;
+    node_t *node = NULL;
+    edge_end_t *edge_end = NULL;
+    edge_t *edge = NULL;
+
+    ITERATE_LIST_BEGIN(instance->instance_node_list, list_node){
+
+        node = list_node->data;
+
+        if(lfa_rlfa){
+            SET_BIT(node->backup_spf_options, SPF_BACKUP_OPTIONS_ENABLED);
+            SET_BIT(node->backup_spf_options, SPF_BACKUP_OPTIONS_REMOTE_BACKUP_CALCULATION);
+        }
+
+        for(i = 0; i < MAX_NODE_INTF_SLOTS; i++){
+            edge_end = node->edges[i];
+            if(!edge_end) break;
+            if(edge_end->dirn != OUTGOING)
+                continue;
+            edge = GET_EGDE_PTR_FROM_EDGE_END(edge_end);
+            if(lfa_rlfa)
+                SET_LINK_PROTECTION_TYPE(edge, LINK_PROTECTION);
+            if(tilfa && node->node_type[LEVEL1] != PSEUDONODE &&
+                node->node_type[LEVEL2] != PSEUDONODE)
+                tilfa_update_config(node, edge_end->intf_name, TRUE, DONT_KNOW);
+        }
+    } ITERATE_LIST_END;
+}
+
+static void
+spfbench_run_root(node_t *root, LEVEL level, unsigned int iterations,
+                  boolean lfa_rlfa, boolean tilfa){
+
+    unsigned int i = 0;
+    spfbench_clock_t clock;
+    spf_phase_timing_t *timing = &root->spf_info.phase_timing[level];
+
+    for(i = 0; i < iterations; i++){
+
+        spfbench_clock_start(&clock);
+        spf_computation(root, &root->spf_info, level, FORWARD_RUN, NULL);
+        spfbench_clock_stop(&clock, SPFBENCH_DIJKSTRA);
+
+        spfbench_clock_start(&clock);
+        spf_computation(root, &root->spf_info, level, FULL_RUN, NULL);
+        spfbench_clock_stop(&clock, SPFBENCH_FULL_RUN);
+
+        spfbench_add_sample(SPFBENCH_ROUTE_BUILD, timing->run_nsec[SPF_PHASE_BUILD_ROUTES]);
+        spfbench_add_sample(SPFBENCH_RIB_INSTALL, timing->run_nsec[SPF_PHASE_ROUTE_INSTALL]);
+
+        /*Rerun over the primary SPF result of the FULL_RUN, as FULL_RUN does*/
+        if(lfa_rlfa){
+            spfbench_clock_start(&clock);
+            compute_backup_routine(root, level);
+            spfbench_clock_stop(&clock, SPFBENCH_LFA_RLFA);
+        }
+
+        if(tilfa){
+            spfbench_clock_start(&clock);
+            compute_tilfa(root, level);
+            spfbench_clock_stop(&clock, SPFBENCH_TILFA);
+        }
+    }
+}
+
+static void
+spfbench_report(FILE *fp, char *source, LEVEL level, unsigned int n_roots,
+                unsigned int iterations, boolean lfa_rlfa, boolean tilfa,
+                unsigned int seed){
+
+    spfbench_phase_t phase;
+    spf_counter_t counter;
+    spfbench_samples_t *s = NULL;
+    uint64_t total_nsec = 0;
+    unsigned int i = 0;
+    boolean first = TRUE;
+    mm_stats_t mm_stats;
+    struct rusage usage;
+
+    mm_get_stats(&mm_stats);
+    getrusage(RUSAGE_SELF, &usage);
+
+    fprintf(fp, "{\n");
+    fprintf(fp, "  \"topology\": {\"source\": \"%s\", \"nodes\": %u, \"level\": %u, \"roots\": %u},\n",
+        source, GET_NODE_COUNT_SINGLY_LL(instance->instance_node_list), level, n_roots);
+    fprintf(fp, "  \"config\": {\"iterations\": %u, \"lfa_rlfa\": %s, \"tilfa\": %s, \"seed\": %u},\n",
+        iterations, lfa_rlfa ? "true" : "false", tilfa ? "true" : "false", seed);
+    fprintf(fp, "  \"phases\": {");
+
+    for(phase = 0; phase < SPFBENCH_PHASE_MAX; phase++){
+
+        s = &samples[phase];
+        if(!s->n) continue;
+
+        qsort(s->nsec, s->n, sizeof(uint64_t), spfbench_nsec_cmp);
+        for(i = 0, total_nsec = 0; i < s->n; i++)
+            total_nsec += s->nsec[i];
+
+        fprintf(fp, "%s\n    \"%s\": {\"runs\": %u, \"p50_ns\": %llu, \"p99_ns\": %llu, "
+            "\"max_ns\": %llu, \"mean_ns\": %llu, \"runs_per_sec\": %.2f",
+            first ? "" : ",", spfbench_phase_str[phase], s->n,
+            (unsigned long long)spfbench_percentile(s, 50),
+            (unsigned long long)spfbench_percentile(s, 99),
+            (unsigned long long)s->nsec[s->n - 1],
+            (unsigned long long)(total_nsec / s->n),
+            total_nsec ? s->n * 1e9 / total_nsec : 0.0);
+        if(s->mm_counted){
+            fprintf(fp, ", \"allocs_per_run\": %.1f, \"frees_per_run\": %.1f",
+                (double)s->mm_allocs / s->n, (double)s->mm_frees / s->n);
+#ifdef __ENABLE_SPF_COUNTERS__
+            fprintf(fp, ",\n      \"counters_per_run\": {");
+            for(counter = SPF_CTR_CANDIDATE_POPS; counter < SPF_CTR_MAX; counter++){
+                fprintf(fp, "%s\"%s\": %.1f", counter == SPF_CTR_CANDIDATE_POPS ? "" : ", ",
+                    get_str_spf_counter(counter), (double)s->counters[counter] / s->n);
+            }
+            fprintf(fp, "}");
+#endif
+        }
+        fprintf(fp, "}");
+        first = FALSE;
+    }
+
+    fprintf(fp, "\n  },\n");
+    fprintf(fp, "  \"memory\": {\"mm_bytes_in_use\": %llu, \"mm_peak_bytes\": %llu, "
+        "\"mm_vm_pages_in_use\": %u, \"mm_peak_vm_pages\": %u, \"mm_allocs\": %llu, "
+        "\"mm_frees\": %llu, \"peak_rss_kb\": %ld}\n",
+        (unsigned long long)mm_stats.bytes_in_use,
+        (unsigned long long)mm_stats.peak_bytes_in_use,
+        mm_stats.vm_pages_in_use, mm_stats.peak_vm_pages_in_use,
+        (unsigned long long)mm_stats.n_allocs,
+        (unsigned long long)mm_stats.n_frees,
+        usage.ru_maxrss);
+    fprintf(fp, "}\n");
+}
+
+static void
+spfbench_usage(char *prog){
+
+    fprintf(stderr, "Usage : %s [-f <topology-file> | -g <clos|geometric|waxman|isp>:<size>]\n"
+        "\t[-S <seed>] [-l <level>] [-r <roots, 0 for all>] [-i <iterations>]\n"
+        "\t[-y <sync-iterations>] [-b (lfa, rlfa)] [-t (ti-lfa)] [-o <json-file>]\n", prog);
+}
+
+int
+main(int argc, char **argv){
+
+    int opt;
+    char *topo_file_name = NULL,
+         *gen_spec = NULL,
+         *json_file_name = NULL,
+         *size_str = NULL;
+    char source[128];
+    LEVEL level = LEVEL1;
+    unsigned int n_roots = SPFBENCH_DEF_ROOTS,
+                 iterations = SPFBENCH_DEF_ITERATIONS,
+                 sync_iterations = 1,
+                 n_candidates = 0,
+                 i = 0, stride = 0;
+    boolean lfa_rlfa = FALSE,
+            tilfa = FALSE;
+    topo_gen_type_t gen_type;
+    node_t **roots = NULL;
+    singly_ll_node_t *list_node = NULL;
+    spfbench_clock_t clock;
+    FILE *json_fp = NULL;
+
+    while((opt = getopt(argc, argv, "f:g:S:l:r:i:y:bto:")) != -1){
+        switch(opt){
+            case 'f':
+                topo_file_name = optarg;
+                break;
+            case 'g':
+                gen_spec = optarg;
+                break;
+            case 'S':
+                topo_gen_params.seed = strtoul(optarg, NULL, 10);
+                break;
+            case 'l':
+                level = atoi(optarg);
+                break;
+            case 'r':
+                n_roots = atoi(optarg);
+                break;
+            case 'i':
+                iterations = atoi(optarg);
+                break;
+            case 'y':
+                sync_iterations = atoi(optarg);
+                break;
+            case 'b':
+                lfa_rlfa = TRUE;
+                break;
+            case 't':
+                tilfa = TRUE;
+                break;
+            case 'o':
+                json_file_name = optarg;
+                break;
+            default:
+                spfbench_usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if((!topo_file_name == !gen_spec) || (level != LEVEL1 && level != LEVEL2)){
+        spfbench_usage(argv[0]);
+        return 1;
+    }
+
+    /*Keep stdout for the report, library messages go to stderr*/
+    if(json_file_name){
+        json_fp = fopen(json_file_name, "w");
+    }
+    else{
+        json_fp = fdopen(dup(STDOUT_FILENO), "w");
+        fflush(stdout);
+        dup2(STDERR_FILENO, STDOUT_FILENO);
+    }
+
+    if(!json_fp){
+        fprintf(stderr, "Error : Could not open the report file\n");
+        return 1;
+    }
+
+    if(topo_file_name){
+        snprintf(source, sizeof(source), "%s", topo_file_name);
+        instance = topo_load_file(topo_file_name);
+    }
+    else{
+        size_str = strchr(gen_spec, ':');
+        if(size_str) *size_str++ = '\0';
+        for(gen_type = 0; gen_type < TOPO_GEN_MAX; gen_type++){
+            if(strcmp(gen_spec, topo_gen_type_str(gen_type)) == 0)
+                break;
+        }
+        if(gen_type == TOPO_GEN_MAX || !size_str){
+            spfbench_usage(argv[0]);
+            return 1;
+        }
+        snprintf(source, sizeof(source), "%s:%s", gen_spec, size_str);
+        instance = topo_gen_instance(gen_type, atoi(size_str), &topo_gen_params);
+    }
+
+    if(!instance)
+        return 1;
+
+    spfbench_enable_protection(lfa_rlfa, tilfa);
+
+    /*Roots spread evenly over the routers of the level*/
+    roots = calloc(GET_NODE_COUNT_SINGLY_LL(instance->instance_node_list), sizeof(node_t *));
+    ITERATE_LIST_BEGIN(instance->instance_node_list, list_node){
+        if(spfbench_node_has_level(list_node->data, level))
+            roots[n_candidates++] = list_node->data;
+    } ITERATE_LIST_END;
+
+    if(!n_roots || n_roots > n_candidates)
+        n_roots = n_candidates;
+    stride = n_roots ? n_candidates / n_roots : 1;
+
+    for(i = 0; i < sync_iterations; i++){
+        spfbench_clock_start(&clock);
+        run_spf_run_all_nodes(NULL, NULL, CONFIG_ENABLE);
+        spfbench_clock_stop(&clock, SPFBENCH_SYNC);
+    }
+
+    for(i = 0; i < n_roots; i++)
+        spfbench_run_root(roots[i * stride], level, iterations, lfa_rlfa, tilfa);
+
+    spfbench_report(json_fp, source, level, n_roots, iterations,
+        lfa_rlfa, tilfa, topo_gen_params.seed);
+    fclose(json_fp);
+    free(roots);
+    return 0;
+}
@@ -46,6 +46,9 @@
 #include "no_warn.h"
 #include "complete_spf_path.h"
 #include "spring_adjsid.h"
+#include "topo_loader.h"
+#include "topo_snapshot.h"
+#include "topo_gen.h"
 #include "LinuxMemoryManager/uapi_mm.h"
 
 extern instance_t * instance;
@@ -119,6 +122,27 @@ run_spf_run_all_nodes(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_dis
     return 0;
 }
 
+static void
+spf_node_local_repair(node_t *node, edge_end_t *failed_oif){
+
+    rib_type_t rib_type;
+    rt_un_table_t *rib = NULL;
+    rib_local_repair_stats_t *stats = NULL;
+
+    for(rib_type = INET_0; rib_type < RIB_COUNT; rib_type++){
+        rib = node->spf_info.rib[rib_type];
+        if(!rib) continue;
+        rib_local_repair(rib, failed_oif);
+        stats = &rib->local_repair_stats;
+        if(!stats->groups_repaired && !stats->groups_unprotected)
+            continue;
+        printf("Node : %s, %s local repair of %s : %u/%u nh groups repaired (%u routes), %u merged, %u unprotected, %lu ns\n",
+                node->node_name, rib->rib_name, stats->failed_oif, stats->groups_repaired,
+                stats->groups_scanned, stats->routes_repaired, stats->groups_merged,
+                stats->groups_unprotected, stats->repair_time_nsec);
+    }
+}
+
 void
 spf_node_slot_enable_disable(node_t *node, char *slot_name,
                                 op_mode enable_or_disable){
@@ -142,9 +166,12 @@ spf_node_slot_enable_disable(node_t *node, char *slot_name,
           
             edge = GET_EGDE_PTR_FROM_EDGE_END(edge_end);
             edge->status = (enable_or_disable == CONFIG_DISABLE) ? 0 : 1;
+            instance_topology_changed(instance, edge->level);
             if(edge->status == 0){
                 /*remove the edge_end prefixes from node*/
                 dettach_edge_end_prefix_on_node(edge->from.node, &edge->from);
+                /*Switch to backups right away, full SPF catches up later*/
+                spf_node_local_repair(node, &edge->from);
             }
             else{
                 /*Attach the edge end prefix to node.*/
@@ -252,6 +279,7 @@ spf_node_slot_metric_change(node_t *node, char *slot_name,
             return;
 
         edge->metric[level] = new_metric;
+        instance_topology_changed(instance, level);
         break;
    } 
 
@@ -435,7 +463,7 @@ show_route_tree_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_d
     routes_t *route = NULL;
     char *prefix = NULL;
     char mask = 0;
-    singly_ll_node_t *list_node = NULL;
+    glthread_t *curr = NULL;
     int cmd_code = -1;
     char masked_prefix[PREFIX_LEN + 1];
 
@@ -457,42 +485,42 @@ show_route_tree_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_d
      
     switch(cmd_code){
         case CMDCODE_DEBUG_INSTANCE_NODE_ALL_ROUTES:
-            ITERATE_LIST_BEGIN(node->spf_info.routes_list[UNICAST_T], list_node){
-                route = (routes_t *)list_node->data;
+            ITERATE_GLTHREAD_BEGIN(&node->spf_info.routes_list[UNICAST_T], curr){
+                route = glthread_to_route(curr);
                 dump_route_info(route);
                 printf("\n");
-            }ITERATE_LIST_END;
+            } ITERATE_GLTHREAD_END(&node->spf_info.routes_list[UNICAST_T], curr);
             break;
 
         case CMDCODE_DEBUG_INSTANCE_NODE_ROUTE:
             apply_mask(prefix, mask, masked_prefix);
             masked_prefix[PREFIX_LEN] = '\0';
-            ITERATE_LIST_BEGIN(node->spf_info.routes_list[UNICAST_T], list_node){
-                route = (routes_t *)list_node->data;
+            ITERATE_GLTHREAD_BEGIN(&node->spf_info.routes_list[UNICAST_T], curr){
+                route = glthread_to_route(curr);
                 if(strncmp(route->rt_key.u.prefix.prefix, masked_prefix, PREFIX_LEN) != 0)
                     continue;
                 dump_route_info(route);
                 break;
-            }ITERATE_LIST_END;
+            } ITERATE_GLTHREAD_END(&node->spf_info.routes_list[UNICAST_T], curr);
             break;
 
         case CMDCODE_DEBUG_INSTANCE_NODE_SPRING_ROUTE:
-            ITERATE_LIST_BEGIN(node->spf_info.routes_list[SPRING_T], list_node){
-                route = (routes_t *)list_node->data;
+            ITERATE_GLTHREAD_BEGIN(&node->spf_info.routes_list[SPRING_T], curr){
+                route = glthread_to_route(curr);
                 apply_mask(prefix, mask, masked_prefix);
                 if(strncmp(route->rt_key.u.prefix.prefix, masked_prefix, PREFIX_LEN) != 0)
                     continue;
                 dump_spring_route_info(route);
                 break;
-            }ITERATE_LIST_END;
+            } ITERATE_GLTHREAD_END(&node->spf_info.routes_list[SPRING_T], curr);
             break;
 
         case CMDCODE_DEBUG_INSTANCE_NODE_ALL_SPRING_ROUTES:
-            ITERATE_LIST_BEGIN(node->spf_info.routes_list[SPRING_T], list_node){
-                route = (routes_t *)list_node->data;
+            ITERATE_GLTHREAD_BEGIN(&node->spf_info.routes_list[SPRING_T], curr){
+                route = glthread_to_route(curr);
                 dump_spring_route_info(route);
                 printf("\n");
-            }ITERATE_LIST_END;
+            } ITERATE_GLTHREAD_END(&node->spf_info.routes_list[SPRING_T], curr);
             break;
         default:
             assert(0);
@@ -517,6 +545,7 @@ insert_lsp_as_forward_adjacency(node_t *ingress_lsr_node,
     edge_t *lsp = create_new_lsp_adj(lsp_name, metric, level);
     lsp->fa = rsvp_tunnel;
     insert_edge_between_2_nodes(lsp, ingress_lsr_node, lsp->fa->egress_lsr, UNIDIRECTIONAL);
+    instance_topology_changed(instance, level);
     /*RSVP label is to be treated as Adj sid for FAs*/
     set_adj_sid(ingress_lsr_node, lsp_name, level, 
                 rsvp_tunnel->rsvp_label, 
@@ -1253,6 +1282,131 @@ instance_node_rsvp_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode e
     return 0;
 }
 
+int
+instance_load_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_disable){
+
+    char *file_name = NULL;
+    unsigned int size = 0;
+    tlv_struct_t *tlv = NULL;
+    topo_gen_params_t params;
+    topo_gen_type_t gen_type = TOPO_GEN_MAX;
+
+    int cmd_code = EXTRACT_CMD_CODE(tlv_buf);
+
+    /*Options are validated by the generator, not stored until then*/
+    params = topo_gen_params;
+
+    TLV_LOOP_BEGIN(tlv_buf, tlv){
+        if(strncmp(tlv->leaf_id, "file-name", strlen("file-name")) ==0)
+            file_name = tlv->value;
+        else if(strncmp(tlv->leaf_id, "size", strlen("size")) ==0)
+            size = atoi(tlv->value);
+        else if(strncmp(tlv->leaf_id, "seed", strlen("seed")) ==0)
+            params.seed = strtoul(tlv->value, NULL, 10);
+        else if(strncmp(tlv->leaf_id, "ecmp", strlen("ecmp")) ==0)
+            params.ecmp = atoi(tlv->value);
+        else if(strncmp(tlv->leaf_id, "metric-min", strlen("metric-min")) ==0)
+            params.metric_min = atoi(tlv->value);
+        else if(strncmp(tlv->leaf_id, "metric-max", strlen("metric-max")) ==0)
+            params.metric_max = atoi(tlv->value);
+        else if(strncmp(tlv->leaf_id, "degree", strlen("degree")) ==0)
+            params.degree = atoi(tlv->value);
+        else if(strncmp(tlv->leaf_id, "lan-size", strlen("lan-size")) ==0)
+            params.lan_size = atoi(tlv->value);
+        else
+            assert(0);
+    } TLV_LOOP_END;
+
+    switch(cmd_code){
+        case CMDCODE_CONFIG_INSTANCE_LOAD:
+            if(enable_or_disable == CONFIG_DISABLE)
+                break;
+            if(topo_load_file(file_name))
+                printf("Topology loaded, run - \"run instance sync\"\n");
+            break;
+        case CMDCODE_CONFIG_INSTANCE_GENERATE_CLOS:
+            gen_type = TOPO_GEN_CLOS;
+            break;
+        case CMDCODE_CONFIG_INSTANCE_GENERATE_GEOMETRIC:
+            gen_type = TOPO_GEN_GEOMETRIC;
+            break;
+        case CMDCODE_CONFIG_INSTANCE_GENERATE_WAXMAN:
+            gen_type = TOPO_GEN_WAXMAN;
+            break;
+        case CMDCODE_CONFIG_INSTANCE_GENERATE_ISP:
+            gen_type = TOPO_GEN_ISP;
+            break;
+        case CMDCODE_CONFIG_INSTANCE_GENERATE_OPTION:
+            if(enable_or_disable == CONFIG_DISABLE){
+                printf("Error : Generator options cannot be negated\n");
+                break;
+            }
+            if(params.ecmp > 100 || params.metric_min == 0 ||
+                params.metric_min > params.metric_max ||
+                params.degree < 2 || params.degree > TOPO_GEN_MAX_DEGREE - 2 ||
+                params.lan_size == 1 || params.lan_size > TOPO_GEN_MAX_DEGREE){
+                printf("Error : Invalid generator option, degree [2, %u], lan-size 0 or [2, %u]\n",
+                    TOPO_GEN_MAX_DEGREE - 2, TOPO_GEN_MAX_DEGREE);
+                break;
+            }
+            topo_gen_params = params;
+            break;
+        default:
+            ;
+    }
+
+    if(gen_type != TOPO_GEN_MAX && enable_or_disable == CONFIG_ENABLE){
+        if(topo_gen_instance(gen_type, size, &topo_gen_params))
+            printf("Topology generated, run - \"run instance sync\"\n");
+    }
+    return 0;
+}
+
+int
+topo_snapshot_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_disable){
+
+    char *file_name = NULL,
+         *node_name = NULL;
+    LEVEL level = LEVEL1;
+    tlv_struct_t *tlv = NULL;
+
+    int cmd_code = EXTRACT_CMD_CODE(tlv_buf);
+
+    TLV_LOOP_BEGIN(tlv_buf, tlv){
+        if(strncmp(tlv->leaf_id, "file-name", strlen("file-name")) ==0)
+            file_name = tlv->value;
+        else if(strncmp(tlv->leaf_id, "node-name", strlen("node-name")) ==0)
+            node_name = tlv->value;
+        else if(strncmp(tlv->leaf_id, "level-no", strlen("level-no")) ==0)
+            level = atoi(tlv->value);
+        else
+            assert(0);
+    } TLV_LOOP_END;
+
+    switch(cmd_code){
+        case CMDCODE_RUN_INSTANCE_SNAPSHOT:
+            topo_snapshot_write(instance, file_name);
+            break;
+        case CMDCODE_CONFIG_SNAPSHOT_LOAD:
+            if(enable_or_disable == CONFIG_DISABLE){
+                topo_snapshot_unmap(curr_topo_snapshot);
+                curr_topo_snapshot = NULL;
+                break;
+            }
+            topo_snapshot_load(file_name);
+            break;
+        case CMDCODE_SHOW_SNAPSHOT:
+            topo_snapshot_show(curr_topo_snapshot);
+            break;
+        case CMDCODE_SHOW_SNAPSHOT_SPF:
+            topo_snapshot_show_spf(curr_topo_snapshot, node_name, level);
+            break;
+        default:
+            ;
+    }
+    return 0;
+}
+
 int
 clear_instance_node_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_disable){
 
@@ -1276,6 +1430,9 @@ clear_instance_node_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_
         case CMDCODE_CLEAR_NODE_ROUTE_DB:
             //flush_routes(node);
             break;        
+        case CMDCODE_CLEAR_NODE_SPF_STATS:
+            spf_phase_stats_reset(&node->spf_info, LEVEL1 | LEVEL2);
+            break;
         default:
             ;
     }
@@ -1322,3 +1479,149 @@ node_slot_adj_sid_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode en
     set_adj_sid(node, intf_name, level, label, router_id, cmd_code);
     return 0;
 }
+
+int
+instance_spf_sched_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_disable){
+
+    tlv_struct_t *tlv = NULL;
+    unsigned int max_wait = SPF_SCHED_DEF_MAX_WAIT,
+                 initial_wait = SPF_SCHED_DEF_INITIAL_WAIT,
+                 secondary_wait = SPF_SCHED_DEF_SECONDARY_WAIT;
+    unsigned long long msec = 0;
+    spf_sched_instance_t *sched_inst = &instance->spf_sched;
+
+    int cmd_code = EXTRACT_CMD_CODE(tlv_buf);
+
+    TLV_LOOP_BEGIN(tlv_buf, tlv){
+        if(strncmp(tlv->leaf_id, "max-wait", strlen("max-wait")) ==0)
+            max_wait = atoi(tlv->value);
+        else if(strncmp(tlv->leaf_id, "initial-wait", strlen("initial-wait")) ==0)
+            initial_wait = atoi(tlv->value);
+        else if(strncmp(tlv->leaf_id, "secondary-wait", strlen("secondary-wait")) ==0)
+            secondary_wait = atoi(tlv->value);
+        else if(strncmp(tlv->leaf_id, "msec", strlen("msec")) ==0)
+            msec = strtoull(tlv->value, NULL, 10);
+        else
+            assert(0);
+    } TLV_LOOP_END;
+
+    switch(cmd_code){
+        case CMDCODE_CONFIG_INSTANCE_SPF_INTERVAL:
+            if(enable_or_disable == CONFIG_DISABLE){
+                max_wait = SPF_SCHED_DEF_MAX_WAIT;
+                initial_wait = SPF_SCHED_DEF_INITIAL_WAIT;
+                secondary_wait = SPF_SCHED_DEF_SECONDARY_WAIT;
+            }
+            else if(max_wait == 0 || initial_wait > max_wait ||
+                    secondary_wait > max_wait){
+                printf("Error : initial-wait and secondary-wait must not exceed max-wait, max-wait must be non zero\n");
+                break;
+            }
+            /*Runs pending already keep their time*/
+            sched_inst->max_wait = max_wait;
+            sched_inst->initial_wait = initial_wait;
+            sched_inst->secondary_wait = secondary_wait;
+            break;
+        case CMDCODE_CONFIG_INSTANCE_SPF_CLOCK_MANUAL:
+            instance->spf_sim.manual_clock = (enable_or_disable == CONFIG_DISABLE) ? FALSE : TRUE;
+            spf_sim_settle(instance);
+            break;
+        case CMDCODE_RUN_INSTANCE_SPF_CLOCK_ADVANCE:
+            spf_sim_advance(instance, msec * 1000);
+            break;
+        case CMDCODE_SHOW_INSTANCE_SPF_SCHEDULER:
+            spf_sched_show(instance);
+            break;
+        default:
+            ;
+    }
+    return 0;
+}
+
+static void
+spf_node_slot_delay_change(node_t *node, char *slot_name, unsigned int delay_usec){
+
+    unsigned int i = 0;
+    edge_end_t *edge_end = NULL;
+    edge_t *edge = NULL;
+
+    for(; i < MAX_NODE_INTF_SLOTS; i++){
+        edge_end = node->edges[i];
+        if(!edge_end)
+            break;
+        if(edge_end->dirn != OUTGOING)
+            continue;
+        if(strcmp(edge_end->intf_name, slot_name))
+            continue;
+        edge = GET_EGDE_PTR_FROM_EDGE_END(edge_end);
+        edge->delay_usec = delay_usec;
+        return;
+    }
+    printf("Error : node %s, Interface %s not found\n", node->node_name, slot_name);
+}
+
+int
+instance_flood_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_disable){
+
+    tlv_struct_t *tlv = NULL;
+    char *node_name = NULL,
+         *slot_name = NULL;
+    unsigned int link_delay = SPF_SIM_DEF_LINK_DELAY,
+                 lsp_proc_delay = SPF_SIM_DEF_LSP_PROC_DELAY,
+                 delay = 0;
+    boolean link_delay_set = FALSE,
+            lsp_proc_delay_set = FALSE;
+    node_t *node = NULL;
+    spf_sim_t *sim = &instance->spf_sim;
+
+    int cmd_code = EXTRACT_CMD_CODE(tlv_buf);
+
+    TLV_LOOP_BEGIN(tlv_buf, tlv){
+        if(strncmp(tlv->leaf_id, "node-name", strlen("node-name")) ==0)
+            node_name = tlv->value;
+        else if(strncmp(tlv->leaf_id, "slot-no", strlen("slot-no")) ==0)
+            slot_name = tlv->value;
+        else if(strncmp(tlv->leaf_id, "link-delay", strlen("link-delay")) ==0){
+            link_delay = atoi(tlv->value);
+            link_delay_set = TRUE;
+        }
+        else if(strncmp(tlv->leaf_id, "lsp-processing-delay", strlen("lsp-processing-delay")) ==0){
+            lsp_proc_delay = atoi(tlv->value);
+            lsp_proc_delay_set = TRUE;
+        }
+        else if(strncmp(tlv->leaf_id, "delay", strlen("delay")) ==0)
+            delay = atoi(tlv->value);
+        else
+            assert(0);
+    } TLV_LOOP_END;
+
+    if(node_name)
+        node = (node_t *)singly_ll_search_by_key(instance->instance_node_list, node_name);
+
+    switch(cmd_code){
+        case CMDCODE_CONFIG_INSTANCE_FLOOD_DELAY:
+            /*Negation restores the default of the delay named*/
+            if(enable_or_disable == CONFIG_DISABLE){
+                link_delay = SPF_SIM_DEF_LINK_DELAY;
+                lsp_proc_delay = SPF_SIM_DEF_LSP_PROC_DELAY;
+            }
+            if(link_delay_set)
+                sim->link_delay_usec = link_delay;
+            if(lsp_proc_delay_set)
+                sim->lsp_proc_delay_usec = lsp_proc_delay;
+            break;
+        case CMDCODE_CONFIG_NODE_SLOT_DELAY:
+            spf_node_slot_delay_change(node, slot_name,
+                enable_or_disable == CONFIG_DISABLE ? 0 : delay);
+            break;
+        case CMDCODE_CONFIG_NODE_LSP_PROC_DELAY:
+            node->lsp_proc_delay_usec = (enable_or_disable == CONFIG_DISABLE) ? 0 : lsp_proc_delay;
+            break;
+        case CMDCODE_SHOW_INSTANCE_CONVERGENCE:
+            spf_sim_show_convergence(instance);
+            break;
+        default:
+            ;
+    }
+    return 0;
+}
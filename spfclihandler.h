@@ -77,6 +77,12 @@ validate_ipv4_mask(char *mask);
 int
 show_route_tree_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_disable);
 
+int
+instance_load_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_disable);
+
+int
+topo_snapshot_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_disable);
+
 int
 run_spf_run_all_nodes(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_disable);
 
@@ -128,4 +134,10 @@ node_slot_adj_sid_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode en
 
 int
 validate_static_adjsid_label_range(char *value);
+
+int
+instance_spf_sched_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_disable);
+
+int
+instance_flood_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_disable);
 #endif /* __SPFCLIHANDLER__ */
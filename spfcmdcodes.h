@@ -186,4 +186,32 @@
 #define CMDCODE_CONFIG_SRTE_POLICY_TO_ADDR                  117 /*config node <node-name> spring spring-path <path-name> to <ip-addr>*/
 #define CMDCODE_CONFIG_SRTE_TUNNEL_MEMBER_SEG_LST           118 /*config node <node-name> spring spring-path <path-name> primary <seg-lst-name>*/
 #define CMDCODE_CONFIG_SRTE_SEG_LST                         119 /*config node <node-name> spring segment-list <seg-lst-name> <hope-name> [label | ip-address] <value>*/
+
+/*Route priority classes*/
+#define CMDCODE_CONFIG_NODE_ROUTE_PRIORITY_CRITICAL         120 /*config node <node-name> route-priority critical mask <mask>*/
+#define CMDCODE_CONFIG_NODE_ROUTE_PRIORITY_HIGH             121 /*config node <node-name> route-priority high mask <mask>*/
+#define CMDCODE_CONFIG_NODE_TILFA_INCREMENTAL_SPF           122 /*config node <node-name> [no] backup-spf-options tilfa-incremental-spf*/
+#define CMDCODE_CONFIG_INSTANCE_LOAD                        123 /*config instance load <file-name>*/
+#define CMDCODE_RUN_INSTANCE_SNAPSHOT                       124 /*run instance snapshot <file-name>*/
+#define CMDCODE_CONFIG_SNAPSHOT_LOAD                        125 /*config snapshot load <file-name>*/
+#define CMDCODE_SHOW_SNAPSHOT                               126 /*show snapshot*/
+#define CMDCODE_SHOW_SNAPSHOT_SPF                           127 /*show snapshot spf level <level-no> [root <node-name>]*/
+#define CMDCODE_CONFIG_INSTANCE_GENERATE_CLOS               128 /*config instance generate clos k <k-value>*/
+#define CMDCODE_CONFIG_INSTANCE_GENERATE_GEOMETRIC          129 /*config instance generate geometric nodes <node-count>*/
+#define CMDCODE_CONFIG_INSTANCE_GENERATE_WAXMAN             130 /*config instance generate waxman nodes <node-count>*/
+#define CMDCODE_CONFIG_INSTANCE_GENERATE_ISP                131 /*config instance generate isp nodes <node-count>*/
+#define CMDCODE_CONFIG_INSTANCE_GENERATE_OPTION             132 /*config instance generate [seed <seed> | ecmp <percent> | metric <min> <max> | degree <degree> | lan-size <size>]*/
+#define CMDCODE_CLEAR_NODE_SPF_STATS                        133 /*clear instance node <node-name> spf statistics*/
+#define CMDCODE_SHOW_SPF_COUNTERS                           134 /*show spf counters*/
+#define CMDCODE_CLEAR_SPF_COUNTERS                          135 /*clear spf counters*/
+#define CMDCODE_DEBUG_LOG_BINARY_ENABLE_DISABLE             136 /*debug log enable|disable binary*/
+#define CMDCODE_DEBUG_LOG_FLUSH                             137 /*debug log flush*/
+#define CMDCODE_CONFIG_INSTANCE_SPF_INTERVAL                138 /*config instance spf-interval <max-wait> <initial-wait> <secondary-wait>*/
+#define CMDCODE_CONFIG_INSTANCE_SPF_CLOCK_MANUAL            139 /*config instance spf-clock manual*/
+#define CMDCODE_RUN_INSTANCE_SPF_CLOCK_ADVANCE              140 /*run instance spf-clock advance <msec>*/
+#define CMDCODE_SHOW_INSTANCE_SPF_SCHEDULER                 141 /*show instance spf-scheduler*/
+#define CMDCODE_CONFIG_INSTANCE_FLOOD_DELAY                 142 /*config instance flood link-delay|lsp-processing-delay <usec>*/
+#define CMDCODE_CONFIG_NODE_SLOT_DELAY                      143 /*config node <node-name> interface <slot-no> delay <usec>*/
+#define CMDCODE_CONFIG_NODE_LSP_PROC_DELAY                  144 /*config node <node-name> lsp-processing-delay <usec>*/
+#define CMDCODE_SHOW_INSTANCE_CONVERGENCE                   145 /*show instance convergence*/
 #endif /* __SPFCMDCODES__H */
@@ -43,14 +43,15 @@
 #include "complete_spf_path.h"
 #include "spf_candidate_tree.h"
 #include "LinuxMemoryManager/uapi_mm.h"
+#include "spfcounters.h"
 
 extern instance_t *instance;
 
 extern ll_t *
 tilfa_get_spf_result_list(node_t *node, LEVEL level);
 extern void compute_tilfa(node_t *spf_root, LEVEL level);
-extern boolean tilfa_is_link_pruned(edge_t *edge);
-extern boolean tilfa_is_node_pruned(node_t *node);
+extern boolean tilfa_is_link_pruned(node_t *spf_root, edge_t *edge);
+extern boolean tilfa_is_node_pruned(node_t *spf_root, node_t *node);
 int
 spf_run_result_comparison_fn(void *spf_result_ptr, void *node_ptr){
 
@@ -177,13 +178,11 @@ run_dijkastra(node_t *spf_root, LEVEL level, candidate_tree_t *ctree,
 
     /*Process untill candidate tree is not empty*/
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "Running Dijkastra with root node = %s, Level = %u", 
-            (SPF_GET_CANDIDATE_TREE_TOP(ctree))->node_name, level); 
-    trace(instance->traceopts, DIJKSTRA_BIT);
+    SPF_TRACE(DIJKSTRA_BIT, "Running Dijkastra with root node = %s, Level = %u", 
+            (SPF_GET_CANDIDATE_TREE_TOP(ctree))->node_name, level);
 #endif
     
     assert(res_lst);
-    assert(is_singly_ll_empty(res_lst));
 
     while(!SPF_IS_CANDIDATE_TREE_EMPTY(ctree)){
 
@@ -192,44 +191,56 @@ run_dijkastra(node_t *spf_root, LEVEL level, candidate_tree_t *ctree,
         candidate_node = SPF_GET_CANDIDATE_TREE_TOP(ctree);
         SPF_REMOVE_CANDIDATE_TREE_TOP(ctree);
         candidate_node->is_node_on_heap = FALSE;
+        SPF_COUNTER_INC(SPF_CTR_CANDIDATE_POPS);
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Candidate node %s Taken off candidate list", candidate_node->node_name); 
-        trace(instance->traceopts, DIJKSTRA_BIT);
+        SPF_TRACE(DIJKSTRA_BIT, "Candidate node %s Taken off candidate list", candidate_node->node_name);
 #endif
 
         /*Add the node just taken off the candidate tree into result list. pls note, we dont want PN in results list
-         * however we process it as ususal like other nodes*/
+         * however we process it as ususal like other nodes. Frozen nodes of incremental run already have their result*/
         if(candidate_node->node_type[level] != PSEUDONODE){
-            res = singly_ll_search_by_key(res_lst, candidate_node);
-            if(!res) {
-                res = XCALLOC(1, spf_result_t);
-                singly_ll_add_node_by_val(res_lst, (void *)res);
+            res = NULL;
+            if(!candidate_node->is_node_frozen){
+                SPF_COUNTER_INC(SPF_CTR_RESULT_SEARCHES);
+                res = singly_ll_search_by_key(res_lst, candidate_node);
+                if(!res) {
+                    res = XCALLOC(1, spf_result_t);
+                    singly_ll_add_node_by_val(res_lst, (void *)res);
+                }
             }
         }
-        res->node = candidate_node;
-        res->spf_metric = candidate_node->spf_metric[level];
-        res->lsp_metric = candidate_node->lsp_metric[level];
+        else if(spf_type == TILFA_RUN){
+            /*Do not let PN overwrite the result of the node settled before it*/
+            res = NULL;
+        }
 
-        ITERATE_NH_TYPE_BEGIN(nh){
-            
-            copy_nh_list2(&candidate_node->next_hop[level][nh][0], &res->next_hop[nh][0]); 
-        } ITERATE_NH_TYPE_END;
+        if(res){
+            res->node = candidate_node;
+            res->spf_metric = candidate_node->spf_metric[level];
+            res->lsp_metric = candidate_node->lsp_metric[level];
+
+            ITERATE_NH_TYPE_BEGIN(nh){
+
+                copy_nh_list2(&candidate_node->next_hop[level][nh][0], &res->next_hop[nh][0]); 
+            } ITERATE_NH_TYPE_END;
+        }
 
         if(spf_type != TILFA_RUN){
+            SPF_COUNTER_INC(SPF_CTR_RESULT_SEARCHES);
             self_res = singly_ll_search_by_key(candidate_node->self_spf_result[level], spf_root);
 
             if(self_res){
 #ifdef __ENABLE_TRACE__            
-                sprintf(instance->traceopts->b, "Curr node : %s, Overwriting self spf result with spf root %s", 
-                        candidate_node->node_name, spf_root->node_name); trace(instance->traceopts, DIJKSTRA_BIT);
+                SPF_TRACE(DIJKSTRA_BIT, "Curr node : %s, Overwriting self spf result with spf root %s", 
+                        candidate_node->node_name, spf_root->node_name);
 #endif
                 self_res->spf_root = spf_root;
                 self_res->res = res;
             }
             else{
 #ifdef __ENABLE_TRACE__            
-                sprintf(instance->traceopts->b, "Curr node : %s, Creating New self spf result with spf root %s",
-                        candidate_node->node_name, spf_root->node_name); trace(instance->traceopts, DIJKSTRA_BIT);
+                SPF_TRACE(DIJKSTRA_BIT, "Curr node : %s, Creating New self spf result with spf root %s",
+                        candidate_node->node_name, spf_root->node_name);
 #endif
                 self_res = XCALLOC(1, self_spf_result_t);
                 self_res->spf_root = spf_root;
@@ -241,8 +252,7 @@ run_dijkastra(node_t *spf_root, LEVEL level, candidate_tree_t *ctree,
 
           ITERATE_NODE_LOGICAL_NBRS_BEGIN(candidate_node, nbr_node, edge, level){
 #ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Processing Nbr : %s", nbr_node->node_name); 
-            trace(instance->traceopts, DIJKSTRA_BIT);
+            SPF_TRACE(DIJKSTRA_BIT, "Processing Nbr : %s", nbr_node->node_name);
 #endif
 
             /*Two way handshake check. Nbr-ship should be two way with nbr, even if nbr is PN. Do
@@ -250,31 +260,30 @@ run_dijkastra(node_t *spf_root, LEVEL level, candidate_tree_t *ctree,
             if(!is_two_way_nbrship(candidate_node, nbr_node, level) || 
                 edge->status == 0){
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Two Way nbrship broken with nbr %s", nbr_node->node_name); 
-                trace(instance->traceopts, DIJKSTRA_BIT);
+                SPF_TRACE(DIJKSTRA_BIT, "Two Way nbrship broken with nbr %s", nbr_node->node_name);
 #endif
                 continue;
             }
 
 #ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "Two Way nbrship verified with nbr %s",nbr_node->node_name); 
-            trace(instance->traceopts, DIJKSTRA_BIT);
+            SPF_TRACE(DIJKSTRA_BIT, "Two Way nbrship verified with nbr %s",nbr_node->node_name);
 #endif
+            SPF_COUNTER_INC(SPF_CTR_RELAXATIONS);
             if((unsigned long long)candidate_node->spf_metric[level] + (IS_OVERLOADED(candidate_node, level) 
                         ? (unsigned long long)INFINITE_METRIC : (unsigned long long)edge->metric[level]) < (unsigned long long)nbr_node->spf_metric[level]){
 
+                SPF_COUNTER_INC(SPF_CTR_RELAX_IMPROVING);
+
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Old Metric : %u, New Metric : %u, Better Next Hop", 
+                SPF_TRACE(DIJKSTRA_BIT, "Old Metric : %u, New Metric : %u, Better Next Hop", 
                         nbr_node->spf_metric[level], IS_OVERLOADED(candidate_node, level) 
                         ? INFINITE_METRIC : candidate_node->spf_metric[level] + edge->metric[level]);
-                trace(instance->traceopts, DIJKSTRA_BIT);
 #endif
 
                 /*case 1 : if My own List is empty, and nbr is Pseuodnode , do nothing*/
                 if(candidate_node == spf_root && nbr_node->node_type[level] == PSEUDONODE){
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "case 1 if I am root and and nbr is Pseuodnode , do nothing"); 
-                    trace(instance->traceopts, DIJKSTRA_BIT);
+                    SPF_TRACE(DIJKSTRA_BIT, "case 1 if I am root and and nbr is Pseuodnode , do nothing");
 #endif
                 }
                 /*case 2 : if My own List is empty, and nbr is Not a PN, then copy nbr's direct nh list to its own NH list*/
@@ -282,12 +291,9 @@ run_dijkastra(node_t *spf_root, LEVEL level, candidate_tree_t *ctree,
                         (candidate_node->node_type[level] == PSEUDONODE && is_all_nh_list_empty2(candidate_node, level))){
 
                     if(candidate_node == spf_root && nbr_node->node_type[level] == NON_PSEUDONODE)
-#ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "case 2 if i am root, and nbr is Not a PN, then copy nbr's direct nh list to its own NH list");
+                        SPF_TRACE(DIJKSTRA_BIT, "case 2 if i am root, and nbr is Not a PN, then copy nbr's direct nh list to its own NH list");
                     else
-                        sprintf(instance->traceopts->b, "case 2 if i am PN and all my nh list are empty");
-#endif
-                    trace(instance->traceopts, DIJKSTRA_BIT);
+                        SPF_TRACE(DIJKSTRA_BIT, "case 2 if i am PN and all my nh list are empty");
 
                     /*Drain all NH first*/
                     ITERATE_NH_TYPE_BEGIN(nh){
@@ -298,43 +304,43 @@ run_dijkastra(node_t *spf_root, LEVEL level, candidate_tree_t *ctree,
                     nh = edge->etype == LSP ? LSPNH : IPNH;
 
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Copying %s direct_next_hop %s %s to %s next_hop list", nbr_node->node_name, get_str_level(level), 
-                            nh == IPNH ? "IPNH" : "LSPNH", nbr_node->node_name); 
-                    trace(instance->traceopts, DIJKSTRA_BIT);
+                    SPF_TRACE(DIJKSTRA_BIT, "Copying %s direct_next_hop %s %s to %s next_hop list", nbr_node->node_name, get_str_level(level), 
+                            nh == IPNH ? "IPNH" : "LSPNH", nbr_node->node_name);
 #endif
 
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "printing %s direct_next_hop list at %s %s before copy", nbr_node->node_name, get_str_level(level),
-                            nh == IPNH ? "IPNH" : "LSPNH"); 
-                    trace(instance->traceopts, DIJKSTRA_BIT);
+                    SPF_TRACE(DIJKSTRA_BIT, "printing %s direct_next_hop list at %s %s before copy", nbr_node->node_name, get_str_level(level),
+                            nh == IPNH ? "IPNH" : "LSPNH");
 #endif
 
-                    print_nh_list2(&nbr_node->direct_next_hop[level][nh][0]);
+                    if(SPF_TRACE_ENABLED(DIJKSTRA_BIT))
+                        print_nh_list2(&nbr_node->direct_next_hop[level][nh][0]);
                     copy_nh_list2(&nbr_node->direct_next_hop[level][nh][0], &nbr_node->next_hop[level][nh][0]);
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "printing %s next_hop list at %s %s after copy", nbr_node->node_name, get_str_level(level),
-                            nh == IPNH ? "IPNH" : "LSPNH"); trace(instance->traceopts, DIJKSTRA_BIT);
+                    SPF_TRACE(DIJKSTRA_BIT, "printing %s next_hop list at %s %s after copy", nbr_node->node_name, get_str_level(level),
+                            nh == IPNH ? "IPNH" : "LSPNH");
 #endif
-                    print_nh_list2(&nbr_node->next_hop[level][nh][0]);
+                    if(SPF_TRACE_ENABLED(DIJKSTRA_BIT))
+                        print_nh_list2(&nbr_node->next_hop[level][nh][0]);
                 }
                 /*case 3 : if My own List is not empty, then nbr should inherit my next hop list*/
                 else if(!is_all_nh_list_empty2(candidate_node, level)){
 
                     ITERATE_NH_TYPE_BEGIN(nh){
 #ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "case 3 if My own List is not empty, then nbr should inherit my next hop list"); 
-                        trace(instance->traceopts, DIJKSTRA_BIT);
+                        SPF_TRACE(DIJKSTRA_BIT, "case 3 if My own List is not empty, then nbr should inherit my next hop list");
 #endif
 #ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "Copying %s next_hop list %s %s to %s next_hop list", candidate_node->node_name, get_str_level(level), 
-                                nh == IPNH ? "IPNH" : "LSPNH", nbr_node->node_name); trace(instance->traceopts, DIJKSTRA_BIT);
+                        SPF_TRACE(DIJKSTRA_BIT, "Copying %s next_hop list %s %s to %s next_hop list", candidate_node->node_name, get_str_level(level), 
+                                nh == IPNH ? "IPNH" : "LSPNH", nbr_node->node_name);
 #endif
                         copy_nh_list2(&candidate_node->next_hop[level][nh][0], &nbr_node->next_hop[level][nh][0]);
 #ifdef __ENABLE_TRACE__                        
-                        sprintf(instance->traceopts->b, "printing %s next_hop list at %s %s after copy", nbr_node->node_name, get_str_level(level),
-                                nh == IPNH ? "IPNH" : "LSPNH"); trace(instance->traceopts, DIJKSTRA_BIT);
+                        SPF_TRACE(DIJKSTRA_BIT, "printing %s next_hop list at %s %s after copy", nbr_node->node_name, get_str_level(level),
+                                nh == IPNH ? "IPNH" : "LSPNH");
 #endif
-                        print_nh_list2(&nbr_node->next_hop[level][nh][0]);
+                        if(SPF_TRACE_ENABLED(DIJKSTRA_BIT))
+                            print_nh_list2(&nbr_node->next_hop[level][nh][0]);
                         ITERATE_NH_TYPE_END;
                     }
                 }
@@ -345,16 +351,16 @@ run_dijkastra(node_t *spf_root, LEVEL level, candidate_tree_t *ctree,
                     INFINITE_METRIC : candidate_node->lsp_metric[level] + edge->metric[level];
 
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "%s's spf_metric has been updated to %u",  
-                        nbr_node->node_name, nbr_node->spf_metric[level]); trace(instance->traceopts, DIJKSTRA_BIT);
+                SPF_TRACE(DIJKSTRA_BIT, "%s's spf_metric has been updated to %u",  
+                        nbr_node->node_name, nbr_node->spf_metric[level]);
 #endif
 
                 if(nbr_node->is_node_on_heap == FALSE){
                     SPF_INSERT_NODE_INTO_CANDIDATE_TREE(ctree, nbr_node, level);
                     nbr_node->is_node_on_heap = TRUE;
+                    SPF_COUNTER_INC(SPF_CTR_HEAP_INSERTS);
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "%s inserted into candidate tree", nbr_node->node_name); 
-                    trace(instance->traceopts, DIJKSTRA_BIT);
+                    SPF_TRACE(DIJKSTRA_BIT, "%s inserted into candidate tree", nbr_node->node_name);
 #endif
                 }
                 else{
@@ -362,9 +368,9 @@ run_dijkastra(node_t *spf_root, LEVEL level, candidate_tree_t *ctree,
                      * But now i dont have brain cells to do this useless work. It has impact
                      * on performance, but not on output*/
                     SPF_CANDIDATE_TREE_NODE_REFRESH(ctree, nbr_node, level);
+                    SPF_COUNTER_INC(SPF_CTR_HEAP_REFRESHES);
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "%s is already present in candidate tree", nbr_node->node_name); 
-                    trace(instance->traceopts, DIJKSTRA_BIT);
+                    SPF_TRACE(DIJKSTRA_BIT, "%s is already present in candidate tree", nbr_node->node_name);
 #endif
                 }
             }
@@ -372,11 +378,12 @@ run_dijkastra(node_t *spf_root, LEVEL level, candidate_tree_t *ctree,
             else if((unsigned long long)candidate_node->spf_metric[level] + (IS_OVERLOADED(candidate_node, level) 
                         ? (unsigned long long)INFINITE_METRIC : (unsigned long long)edge->metric[level]) == (unsigned long long)nbr_node->spf_metric[level]){
 
+                SPF_COUNTER_INC(SPF_CTR_RELAX_ECMP);
+
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Old Metric : %u, New Metric : %u, ECMP path",
+                SPF_TRACE(DIJKSTRA_BIT, "Old Metric : %u, New Metric : %u, ECMP path",
                         nbr_node->spf_metric[level], IS_OVERLOADED(candidate_node, level) 
-                        ? INFINITE_METRIC : candidate_node->spf_metric[level] + edge->metric[level]); 
-                trace(instance->traceopts, DIJKSTRA_BIT);
+                        ? INFINITE_METRIC : candidate_node->spf_metric[level] + edge->metric[level]);
 #endif
 
                 /*We should do two things here :
@@ -387,24 +394,25 @@ run_dijkastra(node_t *spf_root, LEVEL level, candidate_tree_t *ctree,
                 ITERATE_NH_TYPE_BEGIN(nh){
 
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Union next_hop of %s %s at %s %s", candidate_node->node_name, 
+                    SPF_TRACE(DIJKSTRA_BIT, "Union next_hop of %s %s at %s %s", candidate_node->node_name, 
                             nbr_node->node_name, get_str_level(level), 
-                            nh == IPNH ? "IPNH" : "LSPNH"); trace(instance->traceopts, DIJKSTRA_BIT);
+                            nh == IPNH ? "IPNH" : "LSPNH");
 #endif
 
                     union_nh_list2(&candidate_node->next_hop[level][nh][0]  , &nbr_node->next_hop[level][nh][0]);
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "next_hop of %s at %s %s after Union", nbr_node->node_name,
-                            get_str_level(level), nh == IPNH ? "IPNH" : "LSPNH"); trace(instance->traceopts, DIJKSTRA_BIT);
+                    SPF_TRACE(DIJKSTRA_BIT, "next_hop of %s at %s %s after Union", nbr_node->node_name,
+                            get_str_level(level), nh == IPNH ? "IPNH" : "LSPNH");
 #endif
-                    print_nh_list2(&nbr_node->next_hop[level][nh][0]);
+                    if(SPF_TRACE_ENABLED(DIJKSTRA_BIT))
+                        print_nh_list2(&nbr_node->next_hop[level][nh][0]);
                     
-                    if(nbr_node->is_node_on_heap == FALSE){
+                    if(nbr_node->is_node_on_heap == FALSE && !nbr_node->is_node_frozen){
                         SPF_INSERT_NODE_INTO_CANDIDATE_TREE(ctree, nbr_node, level);
                         nbr_node->is_node_on_heap = TRUE;
+                        SPF_COUNTER_INC(SPF_CTR_HEAP_INSERTS);
 #ifdef __ENABLE_TRACE__                    
-                        sprintf(instance->traceopts->b, "%s inserted into candidate tree", nbr_node->node_name); 
-                        trace(instance->traceopts, DIJKSTRA_BIT);
+                        SPF_TRACE(DIJKSTRA_BIT, "%s inserted into candidate tree", nbr_node->node_name);
 #endif
                     }
                 } ITERATE_NH_TYPE_END;
@@ -415,24 +423,24 @@ run_dijkastra(node_t *spf_root, LEVEL level, candidate_tree_t *ctree,
 
                 if(is_nh_list_empty2(&candidate_node->next_hop[level][nh][0])){
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "Union direct_next_hop of %s with Next hop of %s at %s %s", nbr_node->node_name, 
+                    SPF_TRACE(DIJKSTRA_BIT, "Union direct_next_hop of %s with Next hop of %s at %s %s", nbr_node->node_name, 
                             nbr_node->node_name, get_str_level(level), 
-                            nh == IPNH ? "IPNH" : "LSPNH"); trace(instance->traceopts, DIJKSTRA_BIT);
+                            nh == IPNH ? "IPNH" : "LSPNH");
 #endif
                     union_direct_nh_list2(&nbr_node->direct_next_hop[level][nh][0] , &nbr_node->next_hop[level][nh][0] );
 #ifdef __ENABLE_TRACE__                    
-                    sprintf(instance->traceopts->b, "next_hop of %s at %s %s after Union", nbr_node->node_name,
-                            get_str_level(level), nh == IPNH ? "IPNH" : "LSPNH"); trace(instance->traceopts, DIJKSTRA_BIT);
+                    SPF_TRACE(DIJKSTRA_BIT, "next_hop of %s at %s %s after Union", nbr_node->node_name,
+                            get_str_level(level), nh == IPNH ? "IPNH" : "LSPNH");
 #endif
-                    print_nh_list2(&nbr_node->next_hop[level][nh][0]);
+                    if(SPF_TRACE_ENABLED(DIJKSTRA_BIT))
+                        print_nh_list2(&nbr_node->next_hop[level][nh][0]);
                 }
             }
             else{
 #ifdef __ENABLE_TRACE__                
-                sprintf(instance->traceopts->b, "Old Metric : %u, New Metric : %u, Not a Better Next Hop",
+                SPF_TRACE(DIJKSTRA_BIT, "Old Metric : %u, New Metric : %u, Not a Better Next Hop",
                         nbr_node->spf_metric[level], IS_OVERLOADED(candidate_node, level) 
                         ? INFINITE_METRIC : candidate_node->spf_metric[level] + edge->metric[level]);
-                trace(instance->traceopts, DIJKSTRA_BIT);
 #endif
             }
         }
@@ -479,94 +487,44 @@ spf_clear_result(node_t *spf_root, LEVEL level){
    delete_singly_ll(spf_root->spf_run_result[level]);
 }
 
-void
-spf_init(candidate_tree_t *ctree, 
-         node_t *spf_root, 
-         LEVEL level, spf_type_t spf_type){
+/* Initialize direct nexthops of the spf root.
+ * Iterate over real physical nbrs of root (that is skip PNs)
+ * and initialize their direct next hop list. Also, pls note that
+ * directly PN's nbrs are also direct next hops to root. In Production
+ * code, root has a separate list of directly connected physical real
+ * nbrs. In our case, we dont have such list, hence, altenative is treat
+ * nbrs of directly connected PN as own nbrs, which is infact the concept
+ * of pseudonode. Again, do not compute direct next hops of PN*/
 
-    /*step 1 : Purge NH list of all nodes in the topo*/
+void
+spf_init_direct_nexthops(node_t *spf_root, LEVEL level){
 
     unsigned int i = 0;
     node_t *nbr_node = NULL,
-           *curr_node = NULL,
            *pn_node = NULL;
 
     edge_t *edge = NULL, *pn_edge = NULL;
     nh_type_t nh;
-    /*Drain off results list for level */
-
-    if(spf_type != TILFA_RUN){
-        spf_clear_result(spf_root, level);
-    }
-
-    /* You should intialize the nxthops and direct nxthops only for 
-     * reachable routers to spf root in the same level, not the entire
-     * graph.*/
-
-    Queue_t *q = initQ();
-    init_instance_traversal(instance);
-    spf_root->traversing_bit = 1;
-
-    /*step 1 :Initialize spf root*/
-
-    ITERATE_NH_TYPE_BEGIN(nh){
-
-        for(i = 0; i < MAX_NXT_HOPS; i++){
-            init_internal_nh_t(spf_root->next_hop[level][nh][i]);
-            init_internal_nh_t(spf_root->direct_next_hop[level][nh][i]);
-        }
-    }ITERATE_NH_TYPE_END;
-
-    spf_root->spf_metric[level] = 0;
-    spf_root->lsp_metric[level] = 0;
-
-    /*step 2 : Initialize the entire level graph*/
-    enqueue(q, spf_root);
-
-    while(!is_queue_empty(q)){
-
-        curr_node = deque(q);
-        ITERATE_NODE_LOGICAL_NBRS_BEGIN(curr_node, nbr_node, edge, level){
-            
-            if(nbr_node->traversing_bit)
-                continue;
-
-            ITERATE_NH_TYPE_BEGIN(nh){
 
-                for(i = 0; i < MAX_NXT_HOPS; i++){
-                    init_internal_nh_t(nbr_node->next_hop[level][nh][i]);
-                    init_internal_nh_t(nbr_node->direct_next_hop[level][nh][i]);
-                }
-            } ITERATE_NH_TYPE_END;
-            
-            nbr_node->spf_metric[level] = INFINITE_METRIC;
-            nbr_node->lsp_metric[level] = INFINITE_METRIC;
+    /*Flush the direct nexthops computed by the previous run, incremental
+     * runs do not initialize the entire level graph before calling us*/
+    ITERATE_NODE_PHYSICAL_NBRS_BEGIN(spf_root, nbr_node, pn_node, edge, pn_edge, level){
 
-            nbr_node->traversing_bit = 1;
-            enqueue(q, nbr_node);
-        }
-        ITERATE_NODE_LOGICAL_NBRS_END;
-    }
-    assert(is_queue_empty(q));
-    XFREE(q);
-    q = NULL;
+        ITERATE_NH_TYPE_BEGIN(nh){
 
-    /* step 3 : Initialize direct nexthops.
-     * Iterate over real physical nbrs of root (that is skip PNs)
-     * and initialize their direct next hop list. Also, pls note that
-     * directly PN's nbrs are also direct next hops to root. In Production
-     * code, root has a separate list of directly connected physical real
-     * nbrs. In our case, we dont have such list, hence, altenative is treat
-     * nbrs of directly connected PN as own nbrs, which is infact the concept
-     * of pseudonode. Again, do not compute direct next hops of PN*/
+            for(i = 0; i < MAX_NXT_HOPS; i++){
+                init_internal_nh_t(nbr_node->direct_next_hop[level][nh][i]);
+            }
+        } ITERATE_NH_TYPE_END;
+    } ITERATE_NODE_PHYSICAL_NBRS_END(spf_root, nbr_node, pn_node, level);
 
     unsigned int direct_nh_min_metric = 0,
                  nh_index = 0;
 
     ITERATE_NODE_PHYSICAL_NBRS_BEGIN(spf_root, nbr_node, pn_node, edge, pn_edge, level){
 
-        if(tilfa_is_link_pruned(edge) || 
-           tilfa_is_node_pruned(pn_node)){
+        if(tilfa_is_link_pruned(spf_root, edge) || 
+           tilfa_is_node_pruned(spf_root, pn_node)){
             
             ITERATE_NODE_PHYSICAL_NBRS_CONTINUE(spf_root, nbr_node, pn_node, level);
         }
@@ -620,6 +578,81 @@ spf_init(candidate_tree_t *ctree,
             ITERATE_NODE_PHYSICAL_NBRS_CONTINUE(spf_root, nbr_node, pn_node, level);
         }
     } ITERATE_NODE_PHYSICAL_NBRS_END(spf_root, nbr_node, pn_node, level);
+}
+
+void
+spf_init(candidate_tree_t *ctree, 
+         node_t *spf_root, 
+         LEVEL level, spf_type_t spf_type){
+
+    /*step 1 : Purge NH list of all nodes in the topo*/
+
+    unsigned int i = 0;
+    node_t *nbr_node = NULL,
+           *curr_node = NULL;
+
+    edge_t *edge = NULL;
+    nh_type_t nh;
+    /*Drain off results list for level */
+
+    if(spf_type != TILFA_RUN){
+        spf_clear_result(spf_root, level);
+    }
+
+    /* You should intialize the nxthops and direct nxthops only for 
+     * reachable routers to spf root in the same level, not the entire
+     * graph.*/
+
+    Queue_t *q = initQ();
+    init_instance_traversal(instance);
+    spf_root->traversing_bit = 1;
+
+    /*step 1 :Initialize spf root*/
+
+    ITERATE_NH_TYPE_BEGIN(nh){
+
+        for(i = 0; i < MAX_NXT_HOPS; i++){
+            init_internal_nh_t(spf_root->next_hop[level][nh][i]);
+            init_internal_nh_t(spf_root->direct_next_hop[level][nh][i]);
+        }
+    }ITERATE_NH_TYPE_END;
+
+    spf_root->spf_metric[level] = 0;
+    spf_root->lsp_metric[level] = 0;
+
+    /*step 2 : Initialize the entire level graph*/
+    enqueue(q, spf_root);
+
+    while(!is_queue_empty(q)){
+
+        curr_node = deque(q);
+        ITERATE_NODE_LOGICAL_NBRS_BEGIN(curr_node, nbr_node, edge, level){
+            
+            if(nbr_node->traversing_bit)
+                continue;
+
+            ITERATE_NH_TYPE_BEGIN(nh){
+
+                for(i = 0; i < MAX_NXT_HOPS; i++){
+                    init_internal_nh_t(nbr_node->next_hop[level][nh][i]);
+                    init_internal_nh_t(nbr_node->direct_next_hop[level][nh][i]);
+                }
+            } ITERATE_NH_TYPE_END;
+            
+            nbr_node->spf_metric[level] = INFINITE_METRIC;
+            nbr_node->lsp_metric[level] = INFINITE_METRIC;
+
+            nbr_node->traversing_bit = 1;
+            enqueue(q, nbr_node);
+        }
+        ITERATE_NODE_LOGICAL_NBRS_END;
+    }
+    assert(is_queue_empty(q));
+    XFREE(q);
+    q = NULL;
+
+    /* step 3 : Initialize direct nexthops*/
+    spf_init_direct_nexthops(spf_root, level);
 
 
     /* Step 4 : Initialize candidate tree with root*/
@@ -650,7 +683,99 @@ spf_only_intitialization(node_t *spf_root, LEVEL level){
     spf_init(&instance->ctree, spf_root, level, FULL_RUN);
 }
 
+spf_counters_t spf_counters;
+
+void
+spf_counters_reset(void){
+
+    memset(&spf_counters, 0, sizeof(spf_counters_t));
+}
+
+/*Per phase timing of FULL_RUN and PRC_RUN*/
+
+void
+spf_phase_lap(spf_info_t *spf_info, LEVEL level,
+              spf_phase_t phase, struct timespec *start_time){
+
+    struct timespec now;
+    spf_phase_timing_t *timing = &spf_info->phase_timing[level];
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if(timing->run_active){
+        timing->run_nsec[phase] += (now.tv_sec - start_time->tv_sec) * 1000000000UL +
+                                    now.tv_nsec - start_time->tv_nsec;
+        timing->run_mask |= (1 << phase);
+    }
+    *start_time = now;
+}
+
 static void
+spf_phase_run_begin(spf_info_t *spf_info, LEVEL level,
+                    struct timespec *run_start_time){
+
+    spf_phase_timing_t *timing = &spf_info->phase_timing[level];
+
+    memset(timing->run_nsec, 0, sizeof(timing->run_nsec));
+    timing->run_mask = 0;
+    timing->run_active = TRUE;
+    clock_gettime(CLOCK_MONOTONIC, run_start_time);
+}
+
+static void
+spf_phase_stats_update(spf_phase_stats_t *stats, unsigned long nsec){
+
+    unsigned int bucket = 0;
+    unsigned long usec = nsec / 1000;
+
+    if(!stats->runs || nsec < stats->min_nsec)
+        stats->min_nsec = nsec;
+    if(nsec > stats->max_nsec)
+        stats->max_nsec = nsec;
+    if(!stats->runs)
+        stats->ewma_nsec = nsec;
+    else
+        stats->ewma_nsec = stats->ewma_nsec - (stats->ewma_nsec >> SPF_PHASE_EWMA_SHIFT) +
+                            (nsec >> SPF_PHASE_EWMA_SHIFT);
+    stats->runs++;
+    stats->total_nsec += nsec;
+    stats->last_nsec = nsec;
+
+    while(usec && bucket < SPF_PHASE_HIST_BUCKETS - 1){
+        usec >>= 1;
+        bucket++;
+    }
+    stats->hist[bucket]++;
+}
+
+/*Time the whole run, and account every phase timed by the run*/
+static void
+spf_phase_run_end(spf_info_t *spf_info, LEVEL level,
+                  struct timespec *run_start_time){
+
+    spf_phase_t phase;
+    spf_phase_timing_t *timing = &spf_info->phase_timing[level];
+
+    spf_phase_lap(spf_info, level, SPF_PHASE_TOTAL, run_start_time);
+    timing->run_active = FALSE;
+    for(phase = SPF_PHASE_INIT; phase < SPF_PHASE_MAX; phase++){
+        if(timing->run_mask & (1 << phase))
+            spf_phase_stats_update(&timing->stats[phase], timing->run_nsec[phase]);
+    }
+}
+
+void
+spf_phase_stats_reset(spf_info_t *spf_info, LEVEL level){
+
+    LEVEL level_it;
+
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+        if(!IS_LEVEL_SET(level, level_it))
+            continue;
+        memset(&spf_info->phase_timing[level_it], 0, sizeof(spf_phase_timing_t));
+    }
+}
+
+void
 compute_backup_routine(node_t *spf_root, LEVEL level){
 
     unsigned int i = 0;
@@ -658,13 +783,15 @@ compute_backup_routine(node_t *spf_root, LEVEL level){
     edge_t *edge = NULL;
     singly_ll_node_t *list_node = NULL;
     node_t *res_node = NULL;
+    struct timespec phase_start_time;
 
     if(!IS_BIT_SET(spf_root->backup_spf_options, SPF_BACKUP_OPTIONS_ENABLED))
         return;
 
+    clock_gettime(CLOCK_MONOTONIC, &phase_start_time);
+
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "Begin SPF back up calculation"); 
-    trace(instance->traceopts, SPF_EVENTS_BIT); 
+    SPF_TRACE(SPF_EVENTS_BIT, "Begin SPF back up calculation"); 
 #endif
     boolean strict_down_stream_lfa = FALSE;
     init_back_up_computation(spf_root, level); 
@@ -672,7 +799,7 @@ compute_backup_routine(node_t *spf_root, LEVEL level){
     /* 1. Run SPF on S to know DIST(S,D) */
     Compute_and_Store_Forward_SPF(spf_root, level);
     /* 2. Run SPF on all nbrs of S to know DIST(N,D) and DIST(N,S)*/
-    Compute_PHYSICAL_Neighbor_SPFs(spf_root, level);
+    Compute_Batched_PHYSICAL_Neighbor_SPFs(spf_root, level);
 
     /*Weed out the nodes which do not need any backup support because they
      * are blessed with independant ECMP primary nexthops*/
@@ -698,6 +825,7 @@ compute_backup_routine(node_t *spf_root, LEVEL level){
        strict_down_stream_lfa = TRUE;
 
        compute_lfa(spf_root, edge, level, strict_down_stream_lfa);
+       spf_phase_lap(&spf_root->spf_info, level, SPF_PHASE_LFA, &phase_start_time);
        
        if(!IS_BIT_SET(spf_root->backup_spf_options, 
             SPF_BACKUP_OPTIONS_REMOTE_BACKUP_CALCULATION))
@@ -714,28 +842,32 @@ compute_backup_routine(node_t *spf_root, LEVEL level){
            broadcast_compute_link_node_protecting_extended_p_space(spf_root, edge, level);
            broadcast_filter_select_pq_nodes_from_ex_pspace(spf_root, edge, level);
        }
+       spf_phase_lap(&spf_root->spf_info, level, SPF_PHASE_RLFA, &phase_start_time);
     }
+    spf_phase_lap(&spf_root->spf_info, level, SPF_PHASE_LFA, &phase_start_time);
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "END of SPF back up calculation"); 
-    trace(instance->traceopts, SPF_EVENTS_BIT);
+    SPF_TRACE(SPF_EVENTS_BIT, "END of SPF back up calculation");
 #endif
 }
 
-void
+boolean
 spf_computation(node_t *spf_root, 
                 spf_info_t *spf_info, 
                 LEVEL level, spf_type_t spf_type,
                 ll_t *res_lst/*output list*/){
 
+    struct timespec run_start_time,
+                    phase_start_time;
+
     if(level != LEVEL1 && level != LEVEL2){
         printf("%s() : Error : invalid level specified\n", __FUNCTION__);
-        return;
+        return FALSE;
     }
 
     if(IS_OVERLOADED(spf_root, level)){
         printf("%s(): INFO : Node %s is overloaded, SPF cannot be run\n", 
             __FUNCTION__, spf_root->node_name);
-        return;
+        return FALSE;
     }
 
     /*output list provided must be empty by the caller*/
@@ -752,59 +884,109 @@ spf_computation(node_t *spf_root,
 #if 0
     if(level == LEVEL2 && spf_root->spf_info.spf_level_info[LEVEL1].version == 0){
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Root : %s, Running first LEVEL1 full SPF run before LEVEL2 full SPF run", 
-                        spf_root->node_name); trace(instance->traceopts, DIJKSTRA_BIT);
+        SPF_TRACE(DIJKSTRA_BIT, "Root : %s, Running first LEVEL1 full SPF run before LEVEL2 full SPF run", 
+                        spf_root->node_name);
 #endif
         spf_computation(spf_root, &spf_root->spf_info, LEVEL1, FULL_RUN);      
     }
 #endif
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "Node : %s, Triggered SPF run : %s, %s", 
+    SPF_TRACE(DIJKSTRA_BIT, "Node : %s, Triggered SPF run : %s, %s", 
                 spf_root->node_name, spf_type == FULL_RUN ? "FULL_RUN" : "FORWARD_RUN",
-                get_str_level(level)); trace(instance->traceopts, DIJKSTRA_BIT);
+                get_str_level(level));
 #endif
                  
+    /*Nested runs of backup computation are accounted in the backup phases*/
+    if(spf_type == FULL_RUN){
+        spf_phase_run_begin(spf_info, level, &run_start_time);
+        phase_start_time = run_start_time;
+    }
+
     SPF_RE_INIT_CANDIDATE_TREE(&instance->ctree);
 
     spf_init(&instance->ctree, spf_root, level, spf_type);
 
     if(spf_type == FULL_RUN){
+        spf_phase_lap(spf_info, level, SPF_PHASE_INIT, &phase_start_time);
         spf_info->spf_level_info[level].version++;
         assert(!res_lst);
         res_lst = spf_root->spf_run_result[level];
+        assert(is_singly_ll_empty(res_lst));
         run_dijkastra(spf_root, level, &instance->ctree, spf_type, res_lst);
+        spf_phase_lap(spf_info, level, SPF_PHASE_DIJKSTRA, &phase_start_time);
     }
     else if(spf_type == FORWARD_RUN){
         assert(!res_lst);
         res_lst = spf_root->spf_run_result[level];
+        assert(is_singly_ll_empty(res_lst));
         run_dijkastra(spf_root, level, &instance->ctree, spf_type, res_lst);
-        return;
+        return TRUE;
     }
     else if(spf_type == TILFA_RUN){
         assert(res_lst);
         run_dijkastra(spf_root, level, &instance->ctree, spf_type, res_lst);
-        return;
+        return TRUE;
     }
 
     /* Flush off backups from all nodes unconditionally 
      * otherwise they will be reflected in routes computed.*/ 
     init_back_up_computation(spf_root, level); 
     compute_backup_routine(spf_root, level);
-    compute_tilfa(spf_root, level);
+    if(spf_root->tilfa_info){
+        clock_gettime(CLOCK_MONOTONIC, &phase_start_time);
+        compute_tilfa(spf_root, level);
+        spf_phase_lap(spf_info, level, SPF_PHASE_TILFA, &phase_start_time);
+    }
     /* Route Building After SPF computation*/
     /*We dont build routing table for reverse spf run*/
     if(spf_type == FULL_RUN){
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Route building starts After SPF FORWARD run"); 
-        trace(instance->traceopts, DIJKSTRA_BIT);
+        SPF_TRACE(DIJKSTRA_BIT, "Route building starts After SPF FORWARD run");
 #endif
         spf_postprocessing(spf_info, spf_root, level);
+        nbr_spf_batch_release(level);
+        spf_phase_run_end(spf_info, level, &run_start_time);
 #if 0
         /*backup routine must not impact main spf computation*/
         compute_backup_routine(spf_root, level);
         spf_backup_postprocessing(spf_info, spf_root, level);
 #endif
     }
+    return TRUE;
+}
+
+/* Incremental TILFA run over the nodes affected by the resources pruned
+ * on spf_root. The caller has restored the final state of all unaffected
+ * nodes, recorded their results in res_lst and frozen them, and has reset
+ * the affected nodes to infinite metric with empty nexthops. Only the
+ * frozen frontier nodes, which have adjacencies into the affected region,
+ * seed the candidate tree, so that just the affected nodes are re-settled*/
+void
+spf_incremental_computation(node_t *spf_root, LEVEL level,
+                            node_t **frontier, unsigned int n_frontier,
+                            ll_t *res_lst/*output list*/){
+
+    unsigned int i = 0;
+    node_t *node = NULL;
+
+    assert(res_lst);
+
+    SPF_RE_INIT_CANDIDATE_TREE(&instance->ctree);
+
+    /*Direct nexthops over the pruned resources must vanish*/
+    spf_init_direct_nexthops(spf_root, level);
+
+    for(i = 0; i < n_frontier; i++){
+        node = frontier[i];
+        assert(node->is_node_frozen);
+        SPF_INSERT_NODE_INTO_CANDIDATE_TREE(&instance->ctree, node, level);
+        node->is_node_on_heap = TRUE;
+    }
+
+    if(SPF_IS_CANDIDATE_TREE_EMPTY(&instance->ctree))
+        return;
+
+    run_dijkastra(spf_root, level, &instance->ctree, TILFA_RUN, res_lst);
 }
 
 static void
@@ -815,32 +997,36 @@ init_prc_run(node_t *spf_root, LEVEL level){
 }
 
 
-void
+boolean
 partial_spf_run(node_t *spf_root, LEVEL level){
 
+    struct timespec run_start_time;
+
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "Root : %s, %s", spf_root->node_name, get_str_level(level)); trace(instance->traceopts, DIJKSTRA_BIT);
+    SPF_TRACE(DIJKSTRA_BIT, "Root : %s, %s", spf_root->node_name, get_str_level(level));
 #endif
     
     if(spf_root->spf_info.spf_level_info[level].version == 0){
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "Root : %s, %s. No full SPF run till now. Runnig ...", 
-        spf_root->node_name, get_str_level(level)); 
-        trace(instance->traceopts, DIJKSTRA_BIT);
+        SPF_TRACE(DIJKSTRA_BIT, "Root : %s, %s. No full SPF run till now. Runnig ...", 
+        spf_root->node_name, get_str_level(level));
 #endif
-        spf_computation(spf_root, &spf_root->spf_info, level, FULL_RUN, 0); 
-        return;
+        return spf_computation(spf_root, &spf_root->spf_info, level, FULL_RUN, 0); 
     }
 
+    spf_phase_run_begin(&spf_root->spf_info, level, &run_start_time);
     init_prc_run(spf_root, level);
     compute_backup_routine(spf_root, level);
     spf_postprocessing(&spf_root->spf_info, spf_root, level);
+    nbr_spf_batch_release(level);
+    spf_phase_run_end(&spf_root->spf_info, level, &run_start_time);
     spf_root->spf_info.spf_level_info[level].spf_type = FULL_RUN;
     if(IS_BIT_SET(spf_root->backup_spf_options, SPF_BACKUP_OPTIONS_ENABLED)){
         /*Clean the result so that other nodes do not export these results into
          * their route calculation*/
         init_back_up_computation(spf_root, level);
     }
+    return TRUE;
 }
 
 /*This macro should work as follows :
@@ -857,6 +1043,11 @@ DIST_X_Y(node_t *X, node_t *Y, LEVEL _level){
     
     spf_result_t *res = NULL;
     self_spf_result_t *self_res = NULL;
+    unsigned int dist = 0;
+
+    /*X is a nbr of the node whose backups are being computed*/
+    if(nbr_spf_batch_dist(X, Y, _level, &dist))
+        return dist;
 
     if(X->node_type[_level] != PSEUDONODE &&
             Y->node_type[_level] != PSEUDONODE){
@@ -866,8 +1057,8 @@ DIST_X_Y(node_t *X, node_t *Y, LEVEL _level){
         return res->spf_metric;
     }
 
-    if(X->node_type[_level] == PSEUDONODE &&
-            Y->node_type[_level] != PSEUDONODE){
+    /*Y may be a pseudonode too, when two LANs share a router*/
+    if(X->node_type[_level] == PSEUDONODE){
         res =  (GET_SPF_RESULT((&(X->spf_info)), Y, _level));
         if(!res) 
             return INFINITE_METRIC;
@@ -876,9 +1067,10 @@ DIST_X_Y(node_t *X, node_t *Y, LEVEL _level){
 
     if(X->node_type[_level] != PSEUDONODE &&
             Y->node_type[_level] == PSEUDONODE){
+        SPF_COUNTER_INC(SPF_CTR_RESULT_SEARCHES);
         self_res = (self_spf_result_t *)(singly_ll_search_by_key(Y->self_spf_result[_level], X));
         if(!self_res) return INFINITE_METRIC;
-        res = ((self_spf_result_t *)(singly_ll_search_by_key(Y->self_spf_result[_level], X)))->res;
+        res = self_res->res;
         if(!res) return INFINITE_METRIC;
         return res->spf_metric;
     }
@@ -33,8 +33,11 @@
 #ifndef __SPFCOMPUTATION__
 #define __SPFCOMPUTATION__
 
+#include <time.h>
 #include "instanceconst.h"
 #include "data_plane.h"
+#include "spfcounters.h"
+#include "spfsched.h"
 
 /*-----------------------------------------------------------------------------
  *  Do not #include graph.h in this file, as it will create circular dependency.
@@ -313,15 +316,123 @@ get_topology_name(rtttype_t topo){
     }
 }
 
+/*Routes are calculated and installed class by class, most critical class first*/
+typedef enum{
+
+    ROUTE_PRIORITY_CRITICAL, /*Loopbacks and SR node SIDs*/
+    ROUTE_PRIORITY_HIGH,
+    ROUTE_PRIORITY_LOW,
+    ROUTE_PRIORITY_MAX
+} route_priority_t;
+
+/*Default smallest mask of a class, a route falls in the first class its mask qualifies for*/
+#define ROUTE_PRIORITY_CRITICAL_DEF_MASK    32
+#define ROUTE_PRIORITY_HIGH_DEF_MASK        24
+
+static inline char *
+get_str_route_priority(route_priority_t priority){
+
+    switch(priority){
+        case ROUTE_PRIORITY_CRITICAL:
+            return "critical";
+        case ROUTE_PRIORITY_HIGH:
+            return "high";
+        case ROUTE_PRIORITY_LOW:
+            return "low";
+        default:
+            assert(0);
+    }
+}
+
+/*Route installation by priority class, as done by last SPF run*/
+typedef struct route_priority_stats_{
+
+    unsigned int routes[ROUTE_PRIORITY_MAX];
+    unsigned int batches[ROUTE_PRIORITY_MAX];
+    unsigned long convergence_time_nsec[ROUTE_PRIORITY_MAX]; /*Since start of route calculation*/
+} route_priority_stats_t;
+
+/*Phases of a FULL_RUN or PRC_RUN, timed on every run*/
+typedef enum{
+
+    SPF_PHASE_INIT,             /*spf_init()*/
+    SPF_PHASE_DIJKSTRA,         /*run_dijkastra()*/
+    SPF_PHASE_LFA,              /*compute_backup_routine() : nbr SPFs and LFA selection*/
+    SPF_PHASE_RLFA,             /*compute_backup_routine() : extended P-space and PQ nodes*/
+    SPF_PHASE_TILFA,            /*compute_tilfa()*/
+    SPF_PHASE_BUILD_ROUTES,     /*build_routing_table() and SPRING route calculation*/
+    SPF_PHASE_DELETE_STALE,     /*delete_stale_routes()*/
+    SPF_PHASE_ROUTE_INSTALL,    /*enhanced_start_route_installation()*/
+    SPF_PHASE_TOTAL,            /*The whole run*/
+    SPF_PHASE_MAX
+} spf_phase_t;
+
+static inline char *
+get_str_spf_phase(spf_phase_t phase){
+
+    switch(phase){
+        case SPF_PHASE_INIT:
+            return "spf-init";
+        case SPF_PHASE_DIJKSTRA:
+            return "dijkstra";
+        case SPF_PHASE_LFA:
+            return "lfa";
+        case SPF_PHASE_RLFA:
+            return "rlfa";
+        case SPF_PHASE_TILFA:
+            return "tilfa";
+        case SPF_PHASE_BUILD_ROUTES:
+            return "build-routes";
+        case SPF_PHASE_DELETE_STALE:
+            return "delete-stale";
+        case SPF_PHASE_ROUTE_INSTALL:
+            return "route-install";
+        case SPF_PHASE_TOTAL:
+            return "total";
+        default:
+            assert(0);
+    }
+}
+
+/*Bucket 0 counts runs under 1 us, bucket b runs in [2^(b-1), 2^b) us,
+ * the last bucket everything longer*/
+#define SPF_PHASE_HIST_BUCKETS  24
+/*EWMA weight of the last run is 1/2^SPF_PHASE_EWMA_SHIFT*/
+#define SPF_PHASE_EWMA_SHIFT    3
+
+typedef struct spf_phase_stats_{
+
+    unsigned int runs;
+    unsigned long total_nsec;
+    unsigned long last_nsec;
+    unsigned long min_nsec;
+    unsigned long max_nsec;
+    unsigned long ewma_nsec;
+    unsigned int hist[SPF_PHASE_HIST_BUCKETS];
+} spf_phase_stats_t;
+
+typedef struct spf_phase_timing_{
+
+    unsigned long run_nsec[SPF_PHASE_MAX];  /*Phase times of the current or last run*/
+    unsigned int run_mask;                  /*Phases timed by the current or last run*/
+    boolean run_active;                     /*FULL_RUN or PRC_RUN in progress*/
+    spf_phase_stats_t stats[SPF_PHASE_MAX]; /*Since last reset*/
+} spf_phase_timing_t;
+
 typedef struct spf_info_{
 
     spf_level_info_t spf_level_info[MAX_LEVEL];
     char spff_multi_area; /* use not known : set to 1 if this node is Attached to other L2 node present in specifically other area*/
 
     /*spf info containers for routes*/
-    ll_t *routes_list[TOPO_MAX];/*Routes computed as a result of SPF run, routes computed are not level specific*/
-    ll_t *priority_routes_list[TOPO_MAX];/*Always add route in this list*/
-    ll_t *deferred_routes_list[TOPO_MAX];
+    glthread_t routes_list[TOPO_MAX];/*Routes computed as a result of SPF run, routes computed are not level specific*/
+    glthread_t priority_routes_list[TOPO_MAX];/*Routes staged for installation*/
+    glthread_t deferred_routes_list[TOPO_MAX];/*Routes of lower priority classes awaiting installation*/
+    unsigned char priority_min_mask[ROUTE_PRIORITY_MAX];
+    route_priority_stats_t priority_stats[MAX_LEVEL];
+    spf_phase_timing_t phase_timing[MAX_LEVEL];
+    spf_sched_t spf_sched[MAX_LEVEL];
+    glthread_t reclaim_routes_list;/*Stale routes unlinked by last SPF run, pending free*/
 
     /*Routing tables*/
     rt_un_table_t *rib[RIB_COUNT];
@@ -334,16 +445,34 @@ typedef struct spf_info_{
     (spfrootptr->spf_info.spf_level_info[_level].spf_type)
 
 #define GET_SPF_RESULT(_spf_info, _node_ptr, _level)    \
-        singly_ll_search_by_key(_spf_info->spf_level_info[_level].node->spf_run_result[_level], _node_ptr)
+        (SPF_COUNTER_INC(SPF_CTR_RESULT_SEARCHES),      \
+        singly_ll_search_by_key(_spf_info->spf_level_info[_level].node->spf_run_result[_level], _node_ptr))
 
 typedef struct _node_t node_t;
 
-void
+/*Returns FALSE if the run is refused, on invalid level or overloaded spf_root*/
+boolean
 spf_computation(node_t *spf_root,
         spf_info_t *spf_info,
         LEVEL level, spf_type_t spf_type,
         ll_t *res_lst);
 
+/*LFA and RLFA computation of spf_root, run by FULL_RUN after the primary SPF*/
+void
+compute_backup_routine(node_t *spf_root, LEVEL level);
+
+/*Add the time elapsed since *start_time to phase of the current run, and
+ * restart *start_time, so that consecutive phases are timed by one clock read.
+ * Outside a FULL_RUN or PRC_RUN (e.g. a standalone backup computation) only
+ * *start_time is restarted*/
+void
+spf_phase_lap(spf_info_t *spf_info, LEVEL level,
+              spf_phase_t phase, struct timespec *start_time);
+
+/*Reset the phase statistics of the level, both levels for LEVEL1 | LEVEL2*/
+void
+spf_phase_stats_reset(spf_info_t *spf_info, LEVEL level);
+
 int
 route_search_comparison_fn(void * route, void *key);
 
@@ -353,7 +482,8 @@ spf_run_result_comparison_fn(void *spf_result_ptr, void *node_ptr);
 int
 self_spf_run_result_comparison_fn(void *self_spf_result_ptr, void *node_ptr);
 
-void
+/*Returns FALSE if the run is refused, see spf_computation()*/
+boolean
 partial_spf_run(node_t *spf_root, LEVEL level);
 
 unsigned int 
@@ -362,6 +492,14 @@ DIST_X_Y(node_t *X, node_t *Y, LEVEL _level);
 void
 spf_only_intitialization(node_t *spf_root, LEVEL level);
 
+void
+spf_init_direct_nexthops(node_t *spf_root, LEVEL level);
+
+void
+spf_incremental_computation(node_t *spf_root, LEVEL level,
+                            node_t **frontier, unsigned int n_frontier,
+                            ll_t *res_lst);
+
 bool_t
 build_mpls_nexthop_from_lsp(spf_info_t *spf_info,
                             internal_nh_t *lspnh,
@@ -0,0 +1,112 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  spfcounters.h
+ *
+ *    Description:  Event counters of SPF hot paths
+ *
+ *        Version:  1.0
+ *        Created:  Sunday 18 October 2026 20:07:38  UTC
+ *       Revision:  1.0
+ *       Compiler:  gcc
+ *
+ *         Author:  agent, agent@local
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        Copyright (c) 2026 agent.
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#ifndef __SPF_COUNTERS__
+#define __SPF_COUNTERS__
+
+/*Comment out to compile the counters out*/
+#define __ENABLE_SPF_COUNTERS__
+
+/*Counters are cumulative across all SPF runs of all nodes and levels, till
+ * reset. SPF computation is single threaded, hence a single set of counters*/
+typedef enum{
+
+    /*run_dijkastra()*/
+    SPF_CTR_CANDIDATE_POPS,
+    SPF_CTR_RELAXATIONS,            /*adjacencies examined from a settled candidate*/
+    SPF_CTR_RELAX_IMPROVING,        /*adjacencies giving a shorter path*/
+    SPF_CTR_RELAX_ECMP,             /*adjacencies giving an equal cost path*/
+    SPF_CTR_HEAP_INSERTS,
+    SPF_CTR_HEAP_REFRESHES,
+    SPF_CTR_RESULT_SEARCHES,        /*spf result and self spf result list searches*/
+    /*Next hop lists, all callers*/
+    SPF_CTR_NH_LIST_COPIES,
+    SPF_CTR_NH_LIST_UNIONS,
+    /*Route building*/
+    SPF_CTR_UPDATE_ROUTE_CALLS,
+    SPF_CTR_ROUTES_NEW,
+    SPF_CTR_ROUTES_UPDATED,
+    SPF_CTR_ROUTES_STALE,
+    SPF_CTR_MAX
+} spf_counter_t;
+
+static inline char *
+get_str_spf_counter(spf_counter_t counter){
+
+    switch(counter){
+        case SPF_CTR_CANDIDATE_POPS:
+            return "candidate_pops";
+        case SPF_CTR_RELAXATIONS:
+            return "relaxations";
+        case SPF_CTR_RELAX_IMPROVING:
+            return "relax_improving";
+        case SPF_CTR_RELAX_ECMP:
+            return "relax_ecmp";
+        case SPF_CTR_HEAP_INSERTS:
+            return "heap_inserts";
+        case SPF_CTR_HEAP_REFRESHES:
+            return "heap_refreshes";
+        case SPF_CTR_RESULT_SEARCHES:
+            return "result_searches";
+        case SPF_CTR_NH_LIST_COPIES:
+            return "nh_list_copies";
+        case SPF_CTR_NH_LIST_UNIONS:
+            return "nh_list_unions";
+        case SPF_CTR_UPDATE_ROUTE_CALLS:
+            return "update_route_calls";
+        case SPF_CTR_ROUTES_NEW:
+            return "routes_new";
+        case SPF_CTR_ROUTES_UPDATED:
+            return "routes_updated";
+        case SPF_CTR_ROUTES_STALE:
+            return "routes_stale";
+        default:
+            return "unknown";
+    }
+}
+
+typedef struct spf_counters_{
+
+    unsigned long long counter[SPF_CTR_MAX];
+} spf_counters_t;
+
+extern spf_counters_t spf_counters;
+
+#ifdef __ENABLE_SPF_COUNTERS__
+#define SPF_COUNTER_INC(_counter)   (spf_counters.counter[_counter]++)
+#else
+#define SPF_COUNTER_INC(_counter)   ((void)0)
+#endif
+
+void
+spf_counters_reset(void);
+
+#endif /* __SPF_COUNTERS__ */
@@ -48,6 +48,7 @@
 #include "spf_candidate_tree.h"
 #include "complete_spf_path.h"
 #include "LinuxMemoryManager/uapi_mm.h"
+#include "spfcounters.h"
 
 extern
 instance_t *instance;
@@ -65,6 +66,9 @@ void config_topology_commands(param_t *config);
 extern int
 show_tilfa_handler(param_t *param, ser_buff_t *tlv_buf,
                     op_mode enable_or_disable);
+extern int
+config_tilfa_handler(param_t *param, ser_buff_t *tlv_buf,
+                    op_mode enable_or_disable);
 extern void srte_init_dcm(param_t *config_node_node_name);
 
 static void
@@ -650,6 +654,7 @@ instance_node_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable
                          ;
                  }
 
+                 instance_topology_changed(instance, level);
                  dist_info_hdr.lsp_generator = node;
                  dist_info_hdr.info_dist_level = level;
                  dist_info_hdr.add_or_remove = (enable_or_disable == CONFIG_ENABLE) ? AD_CONFIG_ADDED : AD_CONFIG_REMOVED;
@@ -659,6 +664,28 @@ instance_node_config_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable
              }
              break;
 
+        case CMDCODE_CONFIG_NODE_ROUTE_PRIORITY_CRITICAL:
+        case CMDCODE_CONFIG_NODE_ROUTE_PRIORITY_HIGH:
+        {
+            route_priority_t priority = (cmd_code == CMDCODE_CONFIG_NODE_ROUTE_PRIORITY_CRITICAL) ?
+                ROUTE_PRIORITY_CRITICAL : ROUTE_PRIORITY_HIGH;
+            unsigned char *min_mask = node->spf_info.priority_min_mask;
+
+            if(enable_or_disable == CONFIG_DISABLE)
+                mask = (priority == ROUTE_PRIORITY_CRITICAL) ?
+                    ROUTE_PRIORITY_CRITICAL_DEF_MASK : ROUTE_PRIORITY_HIGH_DEF_MASK;
+
+            if((priority == ROUTE_PRIORITY_CRITICAL && mask < min_mask[ROUTE_PRIORITY_HIGH]) ||
+               (priority == ROUTE_PRIORITY_HIGH && mask > min_mask[ROUTE_PRIORITY_CRITICAL])){
+                printf("Error : %s class mask must not be %s than %s class mask\n",
+                        get_str_route_priority(priority),
+                        priority == ROUTE_PRIORITY_CRITICAL ? "smaller" : "larger",
+                        priority == ROUTE_PRIORITY_CRITICAL ? "high" : "critical");
+                return 0;
+            }
+            min_mask[priority] = mask;
+        }
+            break;
         case CMDCODE_CONFIG_INSTANCE_IGNOREBIT_ENABLE:
             (enable_or_disable == CONFIG_ENABLE) ? SET_BIT(node->instance_flags, IGNOREATTACHED) :
                 UNSET_BIT(node->instance_flags, IGNOREATTACHED);
@@ -921,20 +948,179 @@ debug_log_enable_disable_handler(param_t *param, ser_buff_t *tlv_buf, op_mode en
                 trace_set_log_medium(instance->traceopts, CONSOLE);
             }
            break; 
+        case CMDCODE_DEBUG_LOG_BINARY_ENABLE_DISABLE:
+            if(strncmp(value, "enable", strlen(value)) ==0){
+                if(spf_trace_bin_start(SPF_TRACE_BIN_FILE) < 0)
+                    printf("Error : could not open binary trace file %s\n", SPF_TRACE_BIN_FILE);
+            }
+            else if(strncmp(value, "disable", strlen(value)) ==0){
+                spf_trace_bin_stop();
+            }
+           break; 
+        case CMDCODE_DEBUG_LOG_FLUSH:
+            spf_trace_bin_flush();
+            break;
         default:
             assert(0);
     } 
     return 0;
 }
 
+static void
+show_rib_delta_stats(node_t *node, LEVEL level){
+
+    rib_type_t rib_type;
+    rt_un_table_t *rib = NULL;
+    rib_delta_stats_t *delta_stats = NULL;
+
+    printf("RIB updates by last route installation :\n");
+    for(rib_type = INET_0; rib_type < RIB_COUNT; rib_type++){
+        rib = node->spf_info.rib[rib_type];
+        if(!rib) continue;
+        delta_stats = &rib->delta_stats[level];
+        printf("  %-7s routes   : add %-5u modify %-5u delete %-5u unchanged %u\n",
+                rib->rib_name, delta_stats->rt_add, delta_stats->rt_modify,
+                delta_stats->rt_delete, delta_stats->rt_unchanged);
+        printf("  %-7s nexthops : add %-5u modify %-5u delete %-5u unchanged %u\n",
+                "", delta_stats->nh_add, delta_stats->nh_modify,
+                delta_stats->nh_delete, delta_stats->nh_unchanged);
+        printf("  %-7s nh groups : %u shared by %u routes\n",
+                "", rib->nh_group_count, rib->count);
+        if(rib->local_repair_stats.failed_oif[0] != '\0'){
+            printf("  %-7s last local repair : oif %s, %u/%u nh groups repaired (%u routes), %u merged, %u unprotected, %lu ns\n",
+                    "", rib->local_repair_stats.failed_oif, rib->local_repair_stats.groups_repaired,
+                    rib->local_repair_stats.groups_scanned, rib->local_repair_stats.routes_repaired,
+                    rib->local_repair_stats.groups_merged, rib->local_repair_stats.groups_unprotected,
+                    rib->local_repair_stats.repair_time_nsec);
+        }
+    }
+}
+
+static void
+show_route_priority_stats(node_t *node, LEVEL level){
+
+    route_priority_t priority;
+    route_priority_stats_t *priority_stats = &node->spf_info.priority_stats[level];
+
+    printf("Route installation by priority class :\n");
+    for(priority = ROUTE_PRIORITY_CRITICAL; priority < ROUTE_PRIORITY_MAX; priority++){
+        printf("  %-8s (mask >= %-2u) : routes %-5u batches %-4u converged in %lu ns\n",
+                get_str_route_priority(priority), node->spf_info.priority_min_mask[priority],
+                priority_stats->routes[priority], priority_stats->batches[priority],
+                priority_stats->convergence_time_nsec[priority]);
+    }
+}
+
+static void
+show_nbr_spf_batch_stats(node_t *node, LEVEL level){
+
+    nbr_spf_batch_t *batch = nbr_spf_batch_get(level);
+
+    if(batch->spf_root != node)
+        return;
+    printf("Last batched nbr SPF : %u nbrs, %u nodes, %u adjacencies, %u labels settled, "
+            "%u/%u loop free (nbr, dest) pairs, %lu ns\n",
+            batch->src_count, batch->node_count, batch->adj_count, batch->heap_pops,
+            batch->lfa_candidates, batch->src_count * batch->node_count, batch->run_time_nsec);
+    if(batch->rlfa_links)
+        printf("RLFA spaces : %u protected links, %u extended P-space, %u Q-space, %u PQ nodes\n",
+                batch->rlfa_links, batch->ext_p_count, batch->q_count, batch->pq_count);
+}
+
+static void
+show_rev_spf_cache_stats(LEVEL level){
+
+    rev_spf_cache_t *cache = rev_spf_cache_get(level);
+
+    if(!cache->valid)
+        return;
+    printf("Reverse SPF cache : topology version %u, %u rows of %u nodes, "
+            "%u hits, %u misses, %u rebuilds\n",
+            cache->topo_version, cache->row_count, cache->node_count,
+            cache->hits, cache->misses, cache->rebuilds);
+}
+
+static void
+show_spf_phase_stats(node_t *node, LEVEL level){
+
+    spf_phase_t phase;
+    unsigned int bucket = 0;
+    spf_phase_stats_t *stats = NULL;
+    spf_phase_timing_t *timing = &node->spf_info.phase_timing[level];
+
+    if(!timing->stats[SPF_PHASE_TOTAL].runs)
+        return;
+
+    printf("SPF phase timing (ns) :\n");
+    printf("  %-13s %6s %12s %12s %12s %12s %12s\n",
+            "phase", "runs", "last", "min", "max", "ewma", "avg");
+    for(phase = SPF_PHASE_INIT; phase < SPF_PHASE_MAX; phase++){
+        stats = &timing->stats[phase];
+        if(!stats->runs) continue;
+        printf("  %-13s %6u %12lu %12lu %12lu %12lu %12lu\n",
+                get_str_spf_phase(phase), stats->runs, stats->last_nsec,
+                stats->min_nsec, stats->max_nsec, stats->ewma_nsec,
+                stats->total_nsec / stats->runs);
+    }
+
+    printf("SPF phase histogram (us : runs) :\n");
+    for(phase = SPF_PHASE_INIT; phase < SPF_PHASE_MAX; phase++){
+        stats = &timing->stats[phase];
+        if(!stats->runs) continue;
+        printf("  %-13s", get_str_spf_phase(phase));
+        for(bucket = 0; bucket < SPF_PHASE_HIST_BUCKETS; bucket++){
+            if(!stats->hist[bucket]) continue;
+            if(bucket == 0)
+                printf(" <1 : %u", stats->hist[bucket]);
+            else if(bucket == SPF_PHASE_HIST_BUCKETS - 1)
+                printf(" >=%u : %u", 1 << (bucket - 1), stats->hist[bucket]);
+            else
+                printf(" %u-%u : %u", 1 << (bucket - 1), 1 << bucket, stats->hist[bucket]);
+        }
+        printf("\n");
+    }
+}
+
 static void
 show_spf_run_stats(node_t *node, LEVEL level){
 
     printf("SPF Statistics - root : %s, LEVEL%u\n", node->node_name, level);
     printf("# SPF runs : %u\n", node->spf_info.spf_level_info[level].version);
+    show_spf_phase_stats(node, level);
+    show_rib_delta_stats(node, level);
+    show_route_priority_stats(node, level);
+    show_nbr_spf_batch_stats(node, level);
+    show_rev_spf_cache_stats(level);
 }
 
 
+static int
+spf_counters_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_disable){
+
+    spf_counter_t counter;
+    int cmd_code = EXTRACT_CMD_CODE(tlv_buf);
+
+    switch(cmd_code){
+        case CMDCODE_SHOW_SPF_COUNTERS:
+#ifndef __ENABLE_SPF_COUNTERS__
+            printf("SPF counters are compiled out\n");
+            break;
+#endif
+            printf("SPF counters :\n");
+            for(counter = SPF_CTR_CANDIDATE_POPS; counter < SPF_CTR_MAX; counter++){
+                printf("  %-20s : %llu\n", get_str_spf_counter(counter),
+                        spf_counters.counter[counter]);
+            }
+            break;
+        case CMDCODE_CLEAR_SPF_COUNTERS:
+            spf_counters_reset();
+            break;
+        default:
+            ;
+    }
+    return 0;
+}
+
 static int
 show_spf_run_handler(param_t *param, ser_buff_t *tlv_buf, op_mode enable_or_disable){
 
@@ -1080,6 +1266,19 @@ register_clear_commands(){
 
     param_t *clear = libcli_get_clear_hook(); 
 
+    /*clear spf counters*/
+    {
+        static param_t spf;
+        init_param(&spf, CMD, "spf", 0, 0, INVALID, 0, "SPF");
+        libcli_register_param(clear, &spf);
+        {
+            static param_t counters;
+            init_param(&counters, CMD, "counters", spf_counters_handler, 0, INVALID, 0, "SPF hot path event counters");
+            libcli_register_param(&spf, &counters);
+            set_param_cmd_code(&counters, CMDCODE_CLEAR_SPF_COUNTERS);
+        }
+    }
+
     {
         static param_t instance;
         init_param(&instance, CMD, "instance", 0, 0, INVALID, 0, "Network graph");
@@ -1100,6 +1299,18 @@ register_clear_commands(){
                     libcli_register_param(&instance_node_name, &routes);
                     set_param_cmd_code(&routes, CMDCODE_CLEAR_NODE_ROUTE_DB);    
                 }
+                {
+                    /*clear instance node <node-name> spf statistics*/
+                    static param_t spf;
+                    init_param(&spf, CMD, "spf", 0, 0, INVALID, 0, "SPF");
+                    libcli_register_param(&instance_node_name, &spf);
+                    {
+                        static param_t statistics;
+                        init_param(&statistics, CMD, "statistics", clear_instance_node_handler, 0, INVALID, 0, "SPF phase timing statistics");
+                        libcli_register_param(&spf, &statistics);
+                        set_param_cmd_code(&statistics, CMDCODE_CLEAR_NODE_SPF_STATS);
+                    }
+                }
             }
         }   
     }
@@ -1148,6 +1359,35 @@ spf_init_dcm(){
             libcli_register_param(&instance, &sync);
             set_param_cmd_code(&sync, CMDCODE_RUN_INSTANCE_SYNC);
         }
+        /*run instance spf-clock advance <msec>*/
+        {
+            static param_t spf_clock;
+            init_param(&spf_clock, CMD, "spf-clock", 0, 0, INVALID, 0, "SPF scheduler clock");
+            libcli_register_param(&instance, &spf_clock);
+            {
+                static param_t advance;
+                init_param(&advance, CMD, "advance", 0, 0, INVALID, 0, "Advance the clock, running SPFs due");
+                libcli_register_param(&spf_clock, &advance);
+                {
+                    static param_t msec;
+                    init_param(&msec, LEAF, 0, instance_spf_sched_handler, 0, INT, "msec", "msec");
+                    libcli_register_param(&advance, &msec);
+                    set_param_cmd_code(&msec, CMDCODE_RUN_INSTANCE_SPF_CLOCK_ADVANCE);
+                }
+            }
+        }
+        /*run instance snapshot <file-name>*/
+        {
+            static param_t snapshot;
+            init_param(&snapshot, CMD, "snapshot", 0, 0, INVALID, 0, "Write binary snapshot of Network graph");
+            libcli_register_param(&instance, &snapshot);
+            {
+                static param_t file_name;
+                init_param(&file_name, LEAF, 0, topo_snapshot_handler, 0, STRING, "file-name", "Snapshot file name");
+                libcli_register_param(&snapshot, &file_name);
+                set_param_cmd_code(&file_name, CMDCODE_RUN_INSTANCE_SNAPSHOT);
+            }
+        }
     }
 
     /*Show commands*/
@@ -1176,6 +1416,21 @@ spf_init_dcm(){
     init_param(&instance_node_name, LEAF, 0, show_instance_node_handler, validate_node_extistence, STRING, "node-name", "Node Name");
     libcli_register_param(&instance_node, &instance_node_name);
     set_param_cmd_code(&instance_node_name, CMDCODE_SHOW_INSTANCE_NODE); 
+
+    /*show instance spf-scheduler*/
+    {
+        static param_t spf_scheduler;
+        init_param(&spf_scheduler, CMD, "spf-scheduler", instance_spf_sched_handler, 0, INVALID, 0, "SPF scheduler state and statistics");
+        libcli_register_param(&instance, &spf_scheduler);
+        set_param_cmd_code(&spf_scheduler, CMDCODE_SHOW_INSTANCE_SPF_SCHEDULER);
+    }
+    /*show instance convergence*/
+    {
+        static param_t convergence;
+        init_param(&convergence, CMD, "convergence", instance_flood_config_handler, 0, INVALID, 0, "Convergence of the last flooding epoch");
+        libcli_register_param(&instance, &convergence);
+        set_param_cmd_code(&convergence, CMDCODE_SHOW_INSTANCE_CONVERGENCE);
+    }
     {
         static param_t interfaces;
         init_param(&interfaces, CMD, "interfaces", show_instance_node_handler, 0, INVALID, 0, "Interfaces");
@@ -1412,7 +1667,288 @@ spf_init_dcm(){
     libcli_register_param(&show_spf_run_level_N_root_root_name, &show_spf_statistics);
     set_param_cmd_code(&show_spf_statistics, CMDCODE_SHOW_SPF_STATS);
 
+    /*show spf counters*/
+    {
+        static param_t counters;
+        init_param(&counters, CMD, "counters", spf_counters_handler, 0, INVALID, 0, "SPF hot path event counters");
+        libcli_register_param(&show_spf, &counters);
+        set_param_cmd_code(&counters, CMDCODE_SHOW_SPF_COUNTERS);
+    }
+
+    /*show snapshot [spf level <level-no> [root <node-name>]]*/
+    {
+        static param_t snapshot;
+        init_param(&snapshot, CMD, "snapshot", topo_snapshot_handler, 0, INVALID, 0, "Mapped topology snapshot");
+        libcli_register_param(show, &snapshot);
+        set_param_cmd_code(&snapshot, CMDCODE_SHOW_SNAPSHOT);
+        {
+            static param_t spf;
+            init_param(&spf, CMD, "spf", 0, 0, INVALID, 0, "SPF run over the snapshot");
+            libcli_register_param(&snapshot, &spf);
+            {
+                static param_t level;
+                init_param(&level, CMD, "level", 0, 0, INVALID, 0, "level");
+                libcli_register_param(&spf, &level);
+                {
+                    static param_t level_no;
+                    init_param(&level_no, LEAF, 0, topo_snapshot_handler, validate_level_no, INT, "level-no", "level : 1 | 2");
+                    libcli_register_param(&level, &level_no);
+                    set_param_cmd_code(&level_no, CMDCODE_SHOW_SNAPSHOT_SPF);
+                    {
+                        static param_t root;
+                        init_param(&root, CMD, "root", 0, 0, INVALID, 0, "spf root");
+                        libcli_register_param(&level_no, &root);
+                        {
+                            static param_t node_name;
+                            init_param(&node_name, LEAF, 0, topo_snapshot_handler, 0, STRING, "node-name", "Node Name");
+                            libcli_register_param(&root, &node_name);
+                            set_param_cmd_code(&node_name, CMDCODE_SHOW_SNAPSHOT_SPF);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
     /*config commands */
+
+        /*config instance load <file-name>*/
+        {
+            static param_t config_instance;
+            init_param(&config_instance, CMD, "instance", 0, 0, INVALID, 0, "Network graph");
+            libcli_register_param(config, &config_instance);
+            {
+                static param_t load;
+                init_param(&load, CMD, "load", 0, 0, INVALID, 0, "Load topology file");
+                libcli_register_param(&config_instance, &load);
+                {
+                    static param_t file_name;
+                    init_param(&file_name, LEAF, 0, instance_load_config_handler, 0, STRING, "file-name", "Topology file name");
+                    libcli_register_param(&load, &file_name);
+                    set_param_cmd_code(&file_name, CMDCODE_CONFIG_INSTANCE_LOAD);
+                }
+            }
+            /*config instance spf-interval <max-wait> <initial-wait> <secondary-wait>*/
+            {
+                static param_t spf_interval;
+                init_param(&spf_interval, CMD, "spf-interval", 0, 0, INVALID, 0, "SPF throttling timers, msec");
+                libcli_register_param(&config_instance, &spf_interval);
+                {
+                    static param_t max_wait;
+                    init_param(&max_wait, LEAF, 0, 0, 0, INT, "max-wait", "Maximum wait between SPF runs, msec");
+                    libcli_register_param(&spf_interval, &max_wait);
+                    {
+                        static param_t initial_wait;
+                        init_param(&initial_wait, LEAF, 0, 0, 0, INT, "initial-wait", "Wait for the first SPF run after a quiet period, msec");
+                        libcli_register_param(&max_wait, &initial_wait);
+                        {
+                            static param_t secondary_wait;
+                            init_param(&secondary_wait, LEAF, 0, instance_spf_sched_handler, 0, INT, "secondary-wait", "Wait for the second SPF run, doubled for each next, msec");
+                            libcli_register_param(&initial_wait, &secondary_wait);
+                            set_param_cmd_code(&secondary_wait, CMDCODE_CONFIG_INSTANCE_SPF_INTERVAL);
+                        }
+                    }
+                }
+            }
+            /*config instance spf-clock manual*/
+            {
+                static param_t spf_clock;
+                init_param(&spf_clock, CMD, "spf-clock", 0, 0, INVALID, 0, "SPF scheduler clock");
+                libcli_register_param(&config_instance, &spf_clock);
+                {
+                    static param_t manual;
+                    init_param(&manual, CMD, "manual", instance_spf_sched_handler, 0, INVALID, 0, "Advance the clock by \"run instance spf-clock advance\" only");
+                    libcli_register_param(&spf_clock, &manual);
+                    set_param_cmd_code(&manual, CMDCODE_CONFIG_INSTANCE_SPF_CLOCK_MANUAL);
+                }
+            }
+            /*config instance flood link-delay|lsp-processing-delay <usec>*/
+            {
+                static param_t flood;
+                init_param(&flood, CMD, "flood", 0, 0, INVALID, 0, "LSP flooding simulation");
+                libcli_register_param(&config_instance, &flood);
+                {
+                    static param_t link_delay;
+                    init_param(&link_delay, CMD, "link-delay", 0, 0, INVALID, 0, "Default link propagation delay");
+                    libcli_register_param(&flood, &link_delay);
+                    {
+                        static param_t usec;
+                        init_param(&usec, LEAF, 0, instance_flood_config_handler, 0, INT, "link-delay", "usec");
+                        libcli_register_param(&link_delay, &usec);
+                        set_param_cmd_code(&usec, CMDCODE_CONFIG_INSTANCE_FLOOD_DELAY);
+                    }
+                }
+                {
+                    static param_t lsp_proc_delay;
+                    init_param(&lsp_proc_delay, CMD, "lsp-processing-delay", 0, 0, INVALID, 0, "Default LSP processing delay of a node");
+                    libcli_register_param(&flood, &lsp_proc_delay);
+                    {
+                        static param_t usec;
+                        init_param(&usec, LEAF, 0, instance_flood_config_handler, 0, INT, "lsp-processing-delay", "usec");
+                        libcli_register_param(&lsp_proc_delay, &usec);
+                        set_param_cmd_code(&usec, CMDCODE_CONFIG_INSTANCE_FLOOD_DELAY);
+                    }
+                }
+            }
+            /*config instance generate ...*/
+            {
+                static param_t generate;
+                init_param(&generate, CMD, "generate", 0, 0, INVALID, 0, "Generate synthetic topology");
+                libcli_register_param(&config_instance, &generate);
+                {
+                    /*config instance generate clos k <k-value>*/
+                    static param_t clos;
+                    init_param(&clos, CMD, "clos", 0, 0, INVALID, 0, "Fat tree of k pods");
+                    libcli_register_param(&generate, &clos);
+                    {
+                        static param_t k;
+                        init_param(&k, CMD, "k", 0, 0, INVALID, 0, "Pods (even, 2-32)");
+                        libcli_register_param(&clos, &k);
+                        {
+                            static param_t k_value;
+                            init_param(&k_value, LEAF, 0, instance_load_config_handler, 0, INT, "size", "k");
+                            libcli_register_param(&k, &k_value);
+                            set_param_cmd_code(&k_value, CMDCODE_CONFIG_INSTANCE_GENERATE_CLOS);
+                        }
+                    }
+                }
+                {
+                    /*config instance generate geometric nodes <node-count>*/
+                    static param_t geometric;
+                    init_param(&geometric, CMD, "geometric", 0, 0, INVALID, 0, "Random geometric graph");
+                    libcli_register_param(&generate, &geometric);
+                    {
+                        static param_t nodes;
+                        init_param(&nodes, CMD, "nodes", 0, 0, INVALID, 0, "No of nodes");
+                        libcli_register_param(&geometric, &nodes);
+                        {
+                            static param_t node_count;
+                            init_param(&node_count, LEAF, 0, instance_load_config_handler, 0, INT, "size", "No of nodes");
+                            libcli_register_param(&nodes, &node_count);
+                            set_param_cmd_code(&node_count, CMDCODE_CONFIG_INSTANCE_GENERATE_GEOMETRIC);
+                        }
+                    }
+                }
+                {
+                    /*config instance generate waxman nodes <node-count>*/
+                    static param_t waxman;
+                    init_param(&waxman, CMD, "waxman", 0, 0, INVALID, 0, "Waxman graph");
+                    libcli_register_param(&generate, &waxman);
+                    {
+                        static param_t nodes;
+                        init_param(&nodes, CMD, "nodes", 0, 0, INVALID, 0, "No of nodes");
+                        libcli_register_param(&waxman, &nodes);
+                        {
+                            static param_t node_count;
+                            init_param(&node_count, LEAF, 0, instance_load_config_handler, 0, INT, "size", "No of nodes");
+                            libcli_register_param(&nodes, &node_count);
+                            set_param_cmd_code(&node_count, CMDCODE_CONFIG_INSTANCE_GENERATE_WAXMAN);
+                        }
+                    }
+                }
+                {
+                    /*config instance generate isp nodes <node-count>*/
+                    static param_t isp;
+                    init_param(&isp, CMD, "isp", 0, 0, INVALID, 0, "Two level ISP with L1 areas and LANs");
+                    libcli_register_param(&generate, &isp);
+                    {
+                        static param_t nodes;
+                        init_param(&nodes, CMD, "nodes", 0, 0, INVALID, 0, "No of nodes");
+                        libcli_register_param(&isp, &nodes);
+                        {
+                            static param_t node_count;
+                            init_param(&node_count, LEAF, 0, instance_load_config_handler, 0, INT, "size", "No of nodes");
+                            libcli_register_param(&nodes, &node_count);
+                            set_param_cmd_code(&node_count, CMDCODE_CONFIG_INSTANCE_GENERATE_ISP);
+                        }
+                    }
+                }
+                {
+                    /*config instance generate seed <seed>*/
+                    static param_t seed;
+                    init_param(&seed, CMD, "seed", 0, 0, INVALID, 0, "Random seed of the generators");
+                    libcli_register_param(&generate, &seed);
+                    {
+                        static param_t seed_value;
+                        init_param(&seed_value, LEAF, 0, instance_load_config_handler, 0, INT, "seed", "seed");
+                        libcli_register_param(&seed, &seed_value);
+                        set_param_cmd_code(&seed_value, CMDCODE_CONFIG_INSTANCE_GENERATE_OPTION);
+                    }
+                }
+                {
+                    /*config instance generate ecmp <percent>*/
+                    static param_t ecmp;
+                    init_param(&ecmp, CMD, "ecmp", 0, 0, INVALID, 0, "Percent of links with the minimum metric");
+                    libcli_register_param(&generate, &ecmp);
+                    {
+                        static param_t percent;
+                        init_param(&percent, LEAF, 0, instance_load_config_handler, 0, INT, "ecmp", "percent (0-100)");
+                        libcli_register_param(&ecmp, &percent);
+                        set_param_cmd_code(&percent, CMDCODE_CONFIG_INSTANCE_GENERATE_OPTION);
+                    }
+                }
+                {
+                    /*config instance generate metric <min> <max>*/
+                    static param_t metric;
+                    init_param(&metric, CMD, "metric", 0, 0, INVALID, 0, "Link metric range");
+                    libcli_register_param(&generate, &metric);
+                    {
+                        static param_t metric_min;
+                        init_param(&metric_min, LEAF, 0, 0, 0, INT, "metric-min", "Minimum link metric");
+                        libcli_register_param(&metric, &metric_min);
+                        {
+                            static param_t metric_max;
+                            init_param(&metric_max, LEAF, 0, instance_load_config_handler, 0, INT, "metric-max", "Maximum link metric");
+                            libcli_register_param(&metric_min, &metric_max);
+                            set_param_cmd_code(&metric_max, CMDCODE_CONFIG_INSTANCE_GENERATE_OPTION);
+                        }
+                    }
+                }
+                {
+                    /*config instance generate degree <degree>*/
+                    static param_t degree;
+                    init_param(&degree, CMD, "degree", 0, 0, INVALID, 0, "Average node degree");
+                    libcli_register_param(&generate, &degree);
+                    {
+                        static param_t degree_value;
+                        init_param(&degree_value, LEAF, 0, instance_load_config_handler, 0, INT, "degree", "degree");
+                        libcli_register_param(&degree, &degree_value);
+                        set_param_cmd_code(&degree_value, CMDCODE_CONFIG_INSTANCE_GENERATE_OPTION);
+                    }
+                }
+                {
+                    /*config instance generate lan-size <size>*/
+                    static param_t lan_size;
+                    init_param(&lan_size, CMD, "lan-size", 0, 0, INVALID, 0, "Routers per broadcast LAN, 0 for none");
+                    libcli_register_param(&generate, &lan_size);
+                    {
+                        static param_t lan_size_value;
+                        init_param(&lan_size_value, LEAF, 0, instance_load_config_handler, 0, INT, "lan-size", "size");
+                        libcli_register_param(&lan_size, &lan_size_value);
+                        set_param_cmd_code(&lan_size_value, CMDCODE_CONFIG_INSTANCE_GENERATE_OPTION);
+                    }
+                }
+            }
+            support_cmd_negation(&config_instance);
+        }
+
+        /*config snapshot load <file-name>*/
+        {
+            static param_t config_snapshot;
+            init_param(&config_snapshot, CMD, "snapshot", 0, 0, INVALID, 0, "Topology snapshot");
+            libcli_register_param(config, &config_snapshot);
+            {
+                static param_t load;
+                init_param(&load, CMD, "load", 0, 0, INVALID, 0, "Map topology snapshot");
+                libcli_register_param(&config_snapshot, &load);
+                {
+                    static param_t file_name;
+                    init_param(&file_name, LEAF, 0, topo_snapshot_handler, 0, STRING, "file-name", "Snapshot file name");
+                    libcli_register_param(&load, &file_name);
+                    set_param_cmd_code(&file_name, CMDCODE_CONFIG_SNAPSHOT_LOAD);
+                }
+            }
+        }
     
         /*config node <node-name> [no] interface <slot-name> enable*/
         static param_t config_node;
@@ -1503,6 +2039,19 @@ spf_init_dcm(){
         init_param(&config_node_node_name, LEAF, 0, 0, validate_node_extistence, STRING, "node-name", "Node Name");
         libcli_register_param(&config_node, &config_node_node_name);
 
+        /*config node <node-name> [no] lsp-processing-delay <usec>*/
+        {
+            static param_t lsp_proc_delay;
+            init_param(&lsp_proc_delay, CMD, "lsp-processing-delay", 0, 0, INVALID, 0, "LSP processing delay in flooding simulation");
+            libcli_register_param(&config_node_node_name, &lsp_proc_delay);
+            {
+                static param_t usec;
+                init_param(&usec, LEAF, 0, instance_flood_config_handler, 0, INT, "lsp-processing-delay", "usec");
+                libcli_register_param(&lsp_proc_delay, &usec);
+                set_param_cmd_code(&usec, CMDCODE_CONFIG_NODE_LSP_PROC_DELAY);
+            }
+        }
+
         /*config node <node-name> ldp*/
         {
             static param_t ldp;
@@ -1573,6 +2122,52 @@ spf_init_dcm(){
                 libcli_register_param(&backup_spf_options, &use_spring_backups);
                 set_param_cmd_code(&use_spring_backups, CMDCODE_CONFIG_NODE_SPRING_BACKUPS);
             }
+            {
+                /*config node <node-name> backup-spf-options tilfa-incremental-spf*/
+                static param_t tilfa_incremental_spf;
+                init_param(&tilfa_incremental_spf, CMD, "tilfa-incremental-spf", config_tilfa_handler, 0, INVALID, 0, "Enable|Disable incremental TILFA post-convergence SPF");
+                libcli_register_param(&backup_spf_options, &tilfa_incremental_spf);
+                set_param_cmd_code(&tilfa_incremental_spf, CMDCODE_CONFIG_NODE_TILFA_INCREMENTAL_SPF);
+            }
+        }
+
+        /*config node <node-name> [no] route-priority <critical | high> mask <mask>*/
+        {
+            static param_t route_priority;
+            init_param(&route_priority, CMD, "route-priority", 0, 0, INVALID, 0, "Route installation priority classes");
+            libcli_register_param(&config_node_node_name, &route_priority);
+            {
+                static param_t critical;
+                init_param(&critical, CMD, "critical", 0, 0, INVALID, 0, "Critical class, installed first");
+                libcli_register_param(&route_priority, &critical);
+                {
+                    static param_t mask;
+                    init_param(&mask, CMD, "mask", 0, 0, INVALID, 0, "Smallest mask of the class");
+                    libcli_register_param(&critical, &mask);
+                    {
+                        static param_t mask_val;
+                        init_param(&mask_val, LEAF, 0, instance_node_config_handler, validate_ipv4_mask, INT, "mask", "mask (0-32)");
+                        libcli_register_param(&mask, &mask_val);
+                        set_param_cmd_code(&mask_val, CMDCODE_CONFIG_NODE_ROUTE_PRIORITY_CRITICAL);
+                    }
+                }
+            }
+            {
+                static param_t high;
+                init_param(&high, CMD, "high", 0, 0, INVALID, 0, "High class, installed after critical class");
+                libcli_register_param(&route_priority, &high);
+                {
+                    static param_t mask;
+                    init_param(&mask, CMD, "mask", 0, 0, INVALID, 0, "Smallest mask of the class");
+                    libcli_register_param(&high, &mask);
+                    {
+                        static param_t mask_val;
+                        init_param(&mask_val, LEAF, 0, instance_node_config_handler, validate_ipv4_mask, INT, "mask", "mask (0-32)");
+                        libcli_register_param(&mask, &mask_val);
+                        set_param_cmd_code(&mask_val, CMDCODE_CONFIG_NODE_ROUTE_PRIORITY_HIGH);
+                    }
+                }
+            }
         }
 
         /*SPRING config Commands*/
@@ -1643,6 +2238,19 @@ spf_init_dcm(){
             }
         }
 
+        /*config node <node-name> [no] interface <slot-no> delay <usec>*/
+        {
+            static param_t delay;
+            init_param(&delay, CMD, "delay", 0, 0, INVALID, 0, "LSP propagation delay in flooding simulation");
+            libcli_register_param(&config_node_node_name_slot_slotname, &delay);
+            {
+                static param_t usec;
+                init_param(&usec, LEAF, 0, instance_flood_config_handler, 0, INT, "delay", "usec");
+                libcli_register_param(&delay, &usec);
+                set_param_cmd_code(&usec, CMDCODE_CONFIG_NODE_SLOT_DELAY);
+            }
+        }
+
         {
             static param_t level;
             init_param(&level, CMD, "level", 0, 0, INVALID, 0, "level");
@@ -1991,6 +2599,22 @@ spf_init_dcm(){
         set_param_cmd_code(&debug_file, CMDCODE_DEBUG_LOG_FILE_ENABLE_DISABLE); 
     }
 
+    /*debug log enable binary*/
+    {
+        static param_t debug_binary;
+        init_param(&debug_binary, CMD, "binary", debug_log_enable_disable_handler, 0, INVALID, 0, "Enable|Disable binary trace records to " SPF_TRACE_BIN_FILE);
+        libcli_register_param(&debug_log_enable_disable, &debug_binary);
+        set_param_cmd_code(&debug_binary, CMDCODE_DEBUG_LOG_BINARY_ENABLE_DISABLE); 
+    }
+
+    /*debug log flush*/
+    {
+        static param_t debug_flush;
+        init_param(&debug_flush, CMD, "flush", debug_log_enable_disable_handler, 0, INVALID, 0, "Flush binary trace records");
+        libcli_register_param(&debug_log, &debug_flush);
+        set_param_cmd_code(&debug_flush, CMDCODE_DEBUG_LOG_FLUSH); 
+    }
+
     /* debug instance node <node-name> route-tree*/
     {
         static param_t instance;
@@ -0,0 +1,195 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  spfsched.c
+ *
+ *    Description:  SPF scheduler : SPF triggers of a node are throttled with
+ *                  exponential backoff and coalesced into one run
+ *
+ *        Version:  1.0
+ *        Created:  Sunday 18 October 2026 20:23:50  UTC
+ *       Revision:  1.0
+ *       Compiler:  gcc
+ *
+ *         Author:  agent, agent@local
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        Copyright (c) 2026 agent.
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#include <stdio.h>
+#include "instance.h"
+#include "spfsched.h"
+#include "spfsim.h"
+#include "spfcomputation.h"
+#include "spfutil.h"
+#include "spftrace.h"
+
+#define MSEC_TO_USEC(msec)  ((unsigned long long)(msec) * 1000ULL)
+
+void
+spf_sched_init(spf_sched_instance_t *sched_inst){
+
+    sched_inst->initial_wait = SPF_SCHED_DEF_INITIAL_WAIT;
+    sched_inst->secondary_wait = SPF_SCHED_DEF_SECONDARY_WAIT;
+    sched_inst->max_wait = SPF_SCHED_DEF_MAX_WAIT;
+}
+
+/*msec*/
+static unsigned int
+spf_sched_backoff_wait(spf_sched_instance_t *sched_inst, unsigned int backoff_step){
+
+    unsigned long long wait = 0;
+
+    if(backoff_step == 0)
+        return sched_inst->initial_wait;
+
+    wait = sched_inst->secondary_wait;
+    while(--backoff_step && wait < sched_inst->max_wait)
+        wait <<= 1;
+    return wait < sched_inst->max_wait ? wait : sched_inst->max_wait;
+}
+
+void
+spf_sched_trigger(instance_t *instance, node_t *spf_root, LEVEL level,
+                  spf_sched_event_t event){
+
+    spf_sched_instance_t *sched_inst = &instance->spf_sched;
+    spf_sched_t *sched = &spf_root->spf_info.spf_sched[level];
+    unsigned long long now = instance->spf_sim.clock_usec;
+    unsigned int wait = 0;
+
+    sched->stats.events++;
+
+    if(sched->pending){
+        /*Coalesced into the pending run, which turns full on a topology change*/
+        sched->n_pending_events++;
+        sched->stats.coalesced++;
+        if(event == SPF_SCHED_EVENT_TOPOLOGY)
+            sched->full_run = TRUE;
+        sched->last_event_usec = now;
+        SPF_TRACE(SPF_EVENTS_BIT, "Node : %s, %s : %s event coalesced into pending %s at %llu usec, %u events",
+            spf_root->node_name, get_str_level(level),
+            event == SPF_SCHED_EVENT_TOPOLOGY ? "topology" : "prefix",
+            sched->full_run ? "FULL_RUN" : "PRC_RUN", sched->run_at_usec,
+            sched->n_pending_events);
+        return;
+    }
+
+    /*Back to initial-wait after a quiet period*/
+    if(sched->stats.full_runs + sched->stats.prc_runs == 0 ||
+       now - sched->last_event_usec >= 2 * MSEC_TO_USEC(sched_inst->max_wait))
+        sched->backoff_step = 0;
+
+    wait = spf_sched_backoff_wait(sched_inst, sched->backoff_step);
+    if(wait < sched_inst->max_wait)
+        sched->backoff_step++;
+
+    sched->node = spf_root;
+    sched->level = level;
+    sched->pending = TRUE;
+    sched->full_run = (event == SPF_SCHED_EVENT_TOPOLOGY);
+    sched->n_pending_events = 1;
+    sched->first_event_usec = now;
+    sched->last_event_usec = now;
+    sched->run_at_usec = now + MSEC_TO_USEC(wait);
+    spf_sim_schedule_spf(instance, sched, sched->run_at_usec);
+
+    SPF_TRACE(SPF_EVENTS_BIT, "Node : %s, %s : %s event, %s scheduled at %llu usec, wait %u msec",
+        spf_root->node_name, get_str_level(level),
+        event == SPF_SCHED_EVENT_TOPOLOGY ? "topology" : "prefix",
+        sched->full_run ? "FULL_RUN" : "PRC_RUN", sched->run_at_usec, wait);
+}
+
+void
+spf_sched_run(instance_t *instance, spf_sched_t *sched){
+
+    node_t *spf_root = sched->node;
+    unsigned long long now = instance->spf_sim.clock_usec,
+                       delay = now - sched->first_event_usec;
+    spf_phase_timing_t *timing = &spf_root->spf_info.phase_timing[sched->level];
+    boolean ran = FALSE;
+
+    sched->pending = FALSE;
+    sched->last_run_usec = now;
+
+    SPF_TRACE(SPF_EVENTS_BIT, "Node : %s, %s : %s at %llu usec for %u events",
+        spf_root->node_name, get_str_level(sched->level),
+        sched->full_run ? "FULL_RUN" : "PRC_RUN", now, sched->n_pending_events);
+
+    if(sched->full_run)
+        ran = spf_computation(spf_root, &spf_root->spf_info, sched->level, FULL_RUN, 0);
+    else
+        ran = partial_spf_run(spf_root, sched->level);
+
+    /*A refused run (overloaded root) is neither counted nor converged*/
+    if(!ran)
+        return;
+    if(sched->full_run)
+        sched->stats.full_runs++;
+    else
+        sched->stats.prc_runs++;
+    if(sched->n_pending_events > sched->stats.max_coalesced)
+        sched->stats.max_coalesced = sched->n_pending_events;
+    sched->stats.total_delay_usec += delay;
+    if(delay > sched->stats.max_delay_usec)
+        sched->stats.max_delay_usec = delay;
+    spf_sim_spf_done(instance, spf_root, timing->run_nsec[SPF_PHASE_TOTAL]);
+}
+
+void
+spf_sched_show(instance_t *instance){
+
+    spf_sched_instance_t *sched_inst = &instance->spf_sched;
+    singly_ll_node_t *list_node = NULL;
+    spf_sched_t *sched = NULL;
+    node_t *node = NULL;
+    LEVEL level_it;
+
+    printf("SPF scheduler : initial-wait %u msec, secondary-wait %u msec, max-wait %u msec\n",
+        sched_inst->initial_wait, sched_inst->secondary_wait, sched_inst->max_wait);
+    printf("clock : %s, %llu.%03llu msec\n", instance->spf_sim.manual_clock ? "manual" : "auto",
+        instance->spf_sim.clock_usec / 1000, instance->spf_sim.clock_usec % 1000);
+
+    printf("%-16s %-6s %8s %9s %9s %8s %8s %13s %13s  %s\n",
+        "Node", "Level", "Events", "Coalesced", "Full-runs", "PRC-runs",
+        "Max-coal", "Avg-delay(ms)", "Max-delay(ms)", "Pending");
+
+    ITERATE_LIST_BEGIN(instance->instance_node_list, list_node){
+
+        node = list_node->data;
+        for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+
+            unsigned long long runs, avg_delay;
+
+            sched = &node->spf_info.spf_sched[level_it];
+            if(!sched->stats.events)
+                continue;
+            runs = sched->stats.full_runs + sched->stats.prc_runs;
+            avg_delay = runs ? sched->stats.total_delay_usec / runs : 0;
+            printf("%-16s %-6s %8llu %9llu %9llu %8llu %8u %9llu.%03llu %9llu.%03llu  ",
+                node->node_name, get_str_level(level_it), sched->stats.events,
+                sched->stats.coalesced, sched->stats.full_runs, sched->stats.prc_runs,
+                sched->stats.max_coalesced, avg_delay / 1000, avg_delay % 1000,
+                sched->stats.max_delay_usec / 1000, sched->stats.max_delay_usec % 1000);
+            if(sched->pending)
+                printf("%s at %llu.%03llu msec, %u events\n", sched->full_run ? "FULL_RUN" : "PRC_RUN",
+                    sched->run_at_usec / 1000, sched->run_at_usec % 1000, sched->n_pending_events);
+            else
+                printf("-\n");
+        }
+    } ITERATE_LIST_END;
+}
@@ -0,0 +1,113 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  spfsched.h
+ *
+ *    Description:  SPF scheduler : SPF triggers of a node are throttled with
+ *                  exponential backoff and coalesced into one run
+ *
+ *        Version:  1.0
+ *        Created:  Sunday 18 October 2026 20:23:50  UTC
+ *       Revision:  1.0
+ *       Compiler:  gcc
+ *
+ *         Author:  agent, agent@local
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        Copyright (c) 2026 agent.
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#ifndef __SPFSCHED__
+#define __SPFSCHED__
+
+#include "instanceconst.h"
+
+/* Throttling as IS-IS spf-interval : the first trigger after a quiet period
+ * runs SPF initial-wait later, the next trigger secondary-wait later, and
+ * every next one twice the previous wait, up to max-wait. No trigger for
+ * twice max-wait is a quiet period again. Triggers arriving while a run is
+ * pending are coalesced into it, the run is a FULL_RUN if any of them
+ * changed the topology, a PRC_RUN if they changed prefixes only.
+ *
+ * Time is the virtual time of the flooding simulation, a pending run is an
+ * SPF_RUN event of it (spfsim.h)*/
+
+#define SPF_SCHED_DEF_INITIAL_WAIT      50      /*msec*/
+#define SPF_SCHED_DEF_SECONDARY_WAIT    200     /*msec*/
+#define SPF_SCHED_DEF_MAX_WAIT          5000    /*msec*/
+
+typedef struct _node_t node_t;
+typedef struct instance_ instance_t;
+
+typedef enum{
+
+    SPF_SCHED_EVENT_PREFIX,     /*TLV128 : PRC is enough*/
+    SPF_SCHED_EVENT_TOPOLOGY,   /*adjacency or overload change : full SPF*/
+    SPF_SCHED_EVENT_MAX
+} spf_sched_event_t;
+
+typedef struct spf_sched_stats_{
+
+    unsigned long long events;
+    unsigned long long coalesced;       /*events absorbed by a pending run*/
+    unsigned long long full_runs;
+    unsigned long long prc_runs;
+    unsigned int max_coalesced;         /*most events served by one run*/
+    unsigned long long total_delay_usec;/*first event to run, summed over runs*/
+    unsigned long long max_delay_usec;
+} spf_sched_stats_t;
+
+/*Scheduler of a node at a level, a member of spf_info_t*/
+typedef struct spf_sched_{
+
+    node_t *node;
+    LEVEL level;
+    boolean pending;
+    boolean full_run;                   /*accumulated over pending events*/
+    unsigned int n_pending_events;
+    unsigned int backoff_step;          /*0 : initial-wait, 1 : secondary-wait, then doubling*/
+    unsigned long long first_event_usec;
+    unsigned long long last_event_usec;
+    unsigned long long run_at_usec;
+    unsigned long long last_run_usec;
+    spf_sched_stats_t stats;
+} spf_sched_t;
+
+/*Scheduler configuration of the instance, msec*/
+typedef struct spf_sched_instance_{
+
+    unsigned int initial_wait;
+    unsigned int secondary_wait;
+    unsigned int max_wait;
+} spf_sched_instance_t;
+
+void
+spf_sched_init(spf_sched_instance_t *sched_inst);
+
+/*Record a topology or prefix change at spf_root for level, and schedule
+ * its SPF run if none is pending*/
+void
+spf_sched_trigger(instance_t *instance, node_t *spf_root, LEVEL level,
+                  spf_sched_event_t event);
+
+/*Run the pending SPF of sched, now due*/
+void
+spf_sched_run(instance_t *instance, spf_sched_t *sched);
+
+void
+spf_sched_show(instance_t *instance);
+
+#endif /* __SPFSCHED__ */
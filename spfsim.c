@@ -0,0 +1,426 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  spfsim.c
+ *
+ *    Description:  Discrete event simulation of LSP flooding and SPF runs in
+ *                  virtual time, with per node convergence reporting
+ *
+ *        Version:  1.0
+ *        Created:  Sunday 18 October 2026 20:33:55  UTC
+ *       Revision:  1.0
+ *       Compiler:  gcc
+ *
+ *         Author:  agent, agent@local
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        Copyright (c) 2026 agent.
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "instance.h"
+#include "spfsim.h"
+#include "spfsched.h"
+#include "spfutil.h"
+#include "spftrace.h"
+
+void
+spf_sim_init(spf_sim_t *sim){
+
+    sim->clock_usec = 0;
+    sim->seq = 0;
+    sim->manual_clock = FALSE;
+    sim->link_delay_usec = SPF_SIM_DEF_LINK_DELAY;
+    sim->lsp_proc_delay_usec = SPF_SIM_DEF_LSP_PROC_DELAY;
+    sim->events = NULL;
+    sim->n_events = 0;
+    sim->max_events = 0;
+    sim->epoch = 0;
+    sim->epoch_start_usec = 0;
+    sim->n_floods = 0;
+    sim->n_events_processed = 0;
+}
+
+/*Heap order : earlier time first, FIFO among events of the same time*/
+static inline boolean
+spf_sim_event_before(spf_sim_event_t *ev1, spf_sim_event_t *ev2){
+
+    if(ev1->time_usec != ev2->time_usec)
+        return ev1->time_usec < ev2->time_usec;
+    return ev1->seq < ev2->seq;
+}
+
+static void
+spf_sim_push(spf_sim_t *sim, spf_sim_event_t *event){
+
+    unsigned int i, parent;
+    spf_sim_event_t *events;
+
+    if(sim->n_events == sim->max_events){
+        sim->max_events = sim->max_events ? sim->max_events << 1 : SPF_SIM_MIN_EVENTS;
+        sim->events = realloc(sim->events, sim->max_events * sizeof(spf_sim_event_t));
+        assert(sim->events);
+    }
+
+    event->seq = sim->seq++;
+    events = sim->events;
+    i = sim->n_events++;
+    while(i){
+        parent = (i - 1) >> 1;
+        if(!spf_sim_event_before(event, &events[parent]))
+            break;
+        events[i] = events[parent];
+        i = parent;
+    }
+    events[i] = *event;
+}
+
+static void
+spf_sim_pop(spf_sim_t *sim, spf_sim_event_t *event){
+
+    unsigned int i = 0, child;
+    spf_sim_event_t *events = sim->events, last;
+
+    assert(sim->n_events);
+    *event = events[0];
+    last = events[--sim->n_events];
+
+    while((child = (i << 1) + 1) < sim->n_events){
+        if(child + 1 < sim->n_events &&
+           spf_sim_event_before(&events[child + 1], &events[child]))
+            child++;
+        if(!spf_sim_event_before(&events[child], &last))
+            break;
+        events[i] = events[child];
+        i = child;
+    }
+    events[i] = last;
+}
+
+/*Convergence record of node, reset when it is first touched in an epoch*/
+static spf_sim_conv_t *
+spf_sim_conv(spf_sim_t *sim, node_t *node){
+
+    spf_sim_conv_t *conv = &node->sim_conv;
+
+    if(conv->epoch != sim->epoch){
+        memset(conv, 0, sizeof(spf_sim_conv_t));
+        conv->epoch = sim->epoch;
+    }
+    return conv;
+}
+
+static inline unsigned int
+spf_sim_edge_delay(spf_sim_t *sim, edge_t *edge){
+
+    return edge->delay_usec ? edge->delay_usec : sim->link_delay_usec;
+}
+
+static inline unsigned int
+spf_sim_lsp_proc_delay(spf_sim_t *sim, node_t *node){
+
+    return node->lsp_proc_delay_usec ? node->lsp_proc_delay_usec : sim->lsp_proc_delay_usec;
+}
+
+static void
+spf_sim_schedule_lsp(spf_sim_t *sim, spf_sim_event_type_t type, unsigned long long time_usec,
+                     node_t *node, node_t *from, spf_sim_flood_t *flood){
+
+    spf_sim_event_t event;
+
+    memset(&event, 0, sizeof(spf_sim_event_t));
+    event.time_usec = time_usec;
+    event.type = type;
+    event.node = node;
+    event.from = from;
+    event.flood = flood;
+    flood->n_pending_events++;
+    spf_sim_push(sim, &event);
+}
+
+void
+spf_sim_originate_lsp(instance_t *instance, node_t *lsp_generator,
+                      info_dist_fn_ptr fn_ptr, dist_info_hdr_t *dist_info){
+
+    spf_sim_t *sim = &instance->spf_sim;
+    spf_sim_flood_t *flood = NULL;
+    LEVEL level_it;
+
+    if(!sim->n_events){
+        sim->epoch++;
+        sim->epoch_start_usec = sim->clock_usec;
+        sim->n_floods = 0;
+        sim->n_events_processed = 0;
+    }
+    spf_sim_conv(sim, lsp_generator)->last_lsp_usec = sim->clock_usec;
+
+    /*distribute the info to self*/
+    fn_ptr(lsp_generator, lsp_generator, dist_info);
+
+    for(level_it = LEVEL1 ; level_it < MAX_LEVEL; level_it++){
+
+        if(!IS_LEVEL_SET(dist_info->info_dist_level, level_it))
+            continue;
+
+        flood = calloc(1, sizeof(spf_sim_flood_t));
+        flood->dist_info = *dist_info;
+        if(sim->manual_clock)
+            flood->dist_info.info_data = NULL;
+        flood->fn_ptr = fn_ptr;
+        flood->lsp_generator = lsp_generator;
+        flood->level = level_it;
+        flood->origin_usec = sim->clock_usec;
+        flood->n_nodes = instance->n_node_index;
+        flood->received = calloc(flood->n_nodes, sizeof(unsigned char));
+        flood->received[lsp_generator->node_index] = 1;
+        sim->n_floods++;
+
+        spf_sim_schedule_lsp(sim, SPF_SIM_EV_LSP_PROCESSED, sim->clock_usec,
+            lsp_generator, NULL, flood);
+    }
+}
+
+void
+spf_sim_schedule_spf(instance_t *instance, spf_sched_t *sched,
+                     unsigned long long time_usec){
+
+    spf_sim_event_t event;
+
+    memset(&event, 0, sizeof(spf_sim_event_t));
+    event.time_usec = time_usec;
+    event.type = SPF_SIM_EV_SPF_RUN;
+    event.node = sched->node;
+    event.sched = sched;
+    spf_sim_push(&instance->spf_sim, &event);
+}
+
+void
+spf_sim_spf_done(instance_t *instance, node_t *node, unsigned long long spf_nsec){
+
+    spf_sim_t *sim = &instance->spf_sim;
+    spf_sim_conv_t *conv = spf_sim_conv(sim, node);
+
+    conv->spf_runs++;
+    conv->last_spf_usec = sim->clock_usec;
+    conv->last_spf_nsec = spf_nsec;
+}
+
+static void
+spf_sim_flood_lsp(spf_sim_t *sim, spf_sim_event_t *event){
+
+    node_t *curr_node = event->node,
+           *nbr_node = NULL,
+           *pn_node = NULL;
+
+    edge_t *edge1 = NULL,  /*Edge connecting curr node with PN*/
+           *edge2 = NULL;  /*Edge connecting PN to its nbr*/
+
+    spf_sim_flood_t *flood = event->flood;
+    unsigned long long delay = 0;
+
+    ITERATE_NODE_PHYSICAL_NBRS_BEGIN(curr_node, nbr_node, pn_node, edge1,
+                                     edge2, flood->level){
+
+        if(nbr_node == event->from){
+            ITERATE_NODE_PHYSICAL_NBRS_CONTINUE(curr_node, nbr_node, pn_node, flood->level);
+        }
+        delay = spf_sim_edge_delay(sim, edge1);
+        if(edge2 != edge1)
+            delay += spf_sim_edge_delay(sim, edge2);
+        spf_sim_schedule_lsp(sim, SPF_SIM_EV_LSP_RX, sim->clock_usec + delay,
+            nbr_node, curr_node, flood);
+    }
+    ITERATE_NODE_PHYSICAL_NBRS_END(curr_node, nbr_node, pn_node, flood->level);
+}
+
+static void
+spf_sim_process_event(instance_t *instance, spf_sim_event_t *event){
+
+    spf_sim_t *sim = &instance->spf_sim;
+    spf_sim_flood_t *flood = event->flood;
+    spf_sim_conv_t *conv = NULL;
+    node_t *node = event->node;
+
+    sim->n_events_processed++;
+
+    switch(event->type){
+        case SPF_SIM_EV_LSP_RX:
+            conv = spf_sim_conv(sim, node);
+            if(node->node_index >= flood->n_nodes ||
+               flood->received[node->node_index]){
+                conv->lsps_dup++;
+                break;
+            }
+            flood->received[node->node_index] = 1;
+            spf_sim_schedule_lsp(sim, SPF_SIM_EV_LSP_PROCESSED,
+                sim->clock_usec + spf_sim_lsp_proc_delay(sim, node),
+                node, event->from, flood);
+            break;
+        case SPF_SIM_EV_LSP_PROCESSED:
+            if(node != flood->lsp_generator){
+                conv = spf_sim_conv(sim, node);
+                conv->lsps_rx++;
+                conv->last_lsp_usec = sim->clock_usec;
+#ifdef __ENABLE_TRACE__
+                SPF_TRACE(SPF_EVENTS_BIT, "LSP Distribution Src : %s, Des Node : %s",
+                        flood->lsp_generator->node_name, node->node_name);
+#endif
+                flood->fn_ptr(flood->lsp_generator, node, &flood->dist_info);
+            }
+            spf_sim_flood_lsp(sim, event);
+            break;
+        case SPF_SIM_EV_SPF_RUN:
+            spf_sched_run(instance, event->sched);
+            break;
+        default:
+            assert(0);
+    }
+
+    if(flood && --flood->n_pending_events == 0){
+        free(flood->received);
+        free(flood);
+    }
+}
+
+void
+spf_sim_advance(instance_t *instance, unsigned long long usec){
+
+    spf_sim_t *sim = &instance->spf_sim;
+    unsigned long long until = sim->clock_usec + usec;
+    spf_sim_event_t event;
+
+    while(sim->n_events && sim->events[0].time_usec <= until){
+        spf_sim_pop(sim, &event);
+        sim->clock_usec = event.time_usec;
+        spf_sim_process_event(instance, &event);
+    }
+    sim->clock_usec = until;
+}
+
+void
+spf_sim_drain(instance_t *instance){
+
+    spf_sim_t *sim = &instance->spf_sim;
+    spf_sim_event_t event;
+
+    while(sim->n_events){
+        spf_sim_pop(sim, &event);
+        sim->clock_usec = event.time_usec;
+        spf_sim_process_event(instance, &event);
+    }
+}
+
+void
+spf_sim_settle(instance_t *instance){
+
+    if(!instance->spf_sim.manual_clock)
+        spf_sim_drain(instance);
+}
+
+static void
+spf_sim_print_usec(unsigned long long usec){
+
+    printf(" %9llu.%03llu", usec / 1000, usec % 1000);
+}
+
+void
+spf_sim_show_convergence(instance_t *instance){
+
+    spf_sim_t *sim = &instance->spf_sim;
+    singly_ll_node_t *list_node = NULL;
+    spf_sim_conv_t *conv = NULL;
+    node_t *node = NULL;
+    unsigned int n_converged = 0, n_pending = 0;
+    unsigned long long converged_usec = 0,
+                       max_converged_usec = 0,
+                       total_converged_usec = 0;
+    node_t *slowest_node = NULL;
+    LEVEL level_it;
+
+    printf("Flooding : link-delay %u usec, lsp-processing-delay %u usec, clock %s, %llu.%03llu msec\n",
+        sim->link_delay_usec, sim->lsp_proc_delay_usec,
+        sim->manual_clock ? "manual" : "auto",
+        sim->clock_usec / 1000, sim->clock_usec % 1000);
+
+    if(!sim->epoch){
+        printf("No LSP flooded yet\n");
+        return;
+    }
+
+    printf("Epoch %llu started at %llu.%03llu msec, %llu floods, %llu events processed, %u pending\n",
+        sim->epoch, sim->epoch_start_usec / 1000, sim->epoch_start_usec % 1000,
+        sim->n_floods, sim->n_events_processed, sim->n_events);
+
+    /*Times are msec since the start of the epoch*/
+    printf("%-16s %7s %7s %13s %8s %13s %13s\n",
+        "Node", "LSPs", "Dup", "Last-LSP(ms)", "SPF-runs", "Last-SPF(ms)", "Converged(ms)");
+
+    ITERATE_LIST_BEGIN(instance->instance_node_list, list_node){
+
+        node = list_node->data;
+        conv = &node->sim_conv;
+        if(conv->epoch != sim->epoch)
+            continue;
+
+        printf("%-16s %7u %7u", node->node_name, conv->lsps_rx, conv->lsps_dup);
+        spf_sim_print_usec(conv->last_lsp_usec - sim->epoch_start_usec);
+        printf(" %8u", conv->spf_runs);
+
+        for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+            if(node->spf_info.spf_sched[level_it].pending)
+                break;
+        }
+
+        if(conv->spf_runs)
+            spf_sim_print_usec(conv->last_spf_usec - sim->epoch_start_usec);
+        else
+            printf(" %13s", "-");
+
+        if(level_it < MAX_LEVEL){
+            printf(" %13s\n", "pending");
+            n_pending++;
+            continue;
+        }
+        if(!conv->spf_runs){
+            printf(" %13s\n", "-");
+            continue;
+        }
+        converged_usec = conv->last_spf_usec + conv->last_spf_nsec / 1000 -
+                         sim->epoch_start_usec;
+        spf_sim_print_usec(converged_usec);
+        printf("\n");
+
+        n_converged++;
+        total_converged_usec += converged_usec;
+        if(!slowest_node || converged_usec > max_converged_usec){
+            max_converged_usec = converged_usec;
+            slowest_node = node;
+        }
+    } ITERATE_LIST_END;
+
+    printf("Converged nodes : %u, pending : %u", n_converged, n_pending);
+    if(n_converged){
+        printf(", avg %llu.%03llu msec, max %llu.%03llu msec (%s)",
+            total_converged_usec / n_converged / 1000,
+            total_converged_usec / n_converged % 1000,
+            max_converged_usec / 1000, max_converged_usec % 1000,
+            slowest_node->node_name);
+    }
+    printf("\n");
+}
@@ -0,0 +1,163 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  spfsim.h
+ *
+ *    Description:  Discrete event simulation of LSP flooding and SPF runs in
+ *                  virtual time, with per node convergence reporting
+ *
+ *        Version:  1.0
+ *        Created:  Sunday 18 October 2026 20:33:55  UTC
+ *       Revision:  1.0
+ *       Compiler:  gcc
+ *
+ *         Author:  agent, agent@local
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        Copyright (c) 2026 agent.
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#ifndef __SPFSIM__
+#define __SPFSIM__
+
+#include "instanceconst.h"
+#include "advert.h"
+
+/* generate_lsp() originates an LSP flood as events of a min heap ordered by
+ * virtual time (usec), FIFO among events of the same time :
+ *
+ *  LSP_RX          the LSP reaches a node, link propagation delay after its
+ *                  neighbour flooded it. Copies after the first are dropped
+ *  LSP_PROCESSED   the node has processed the LSP, its lsp-processing-delay
+ *                  after LSP_RX : the receiver routine runs (which schedules
+ *                  SPF, see spfsched.h) and the LSP is flooded to all
+ *                  neighbours of the level but the one it came from
+ *  SPF_RUN         an SPF throttled by the scheduler of the node is due
+ *
+ * The delay over a LAN is the sum of the delays of the edges to and from the
+ * pseudonode. SPF runs over the topology of the instance, which is changed
+ * as soon as the event is configured, flooding decides when each node runs.
+ *
+ * Events are processed as fast as the CPU allows : with the auto clock, till
+ * none is left before generate_lsp() returns, with the manual clock on
+ * "run instance spf-clock advance <msec>".
+ *
+ * A convergence epoch starts with an LSP originated while no event is
+ * pending. A node has converged when its last SPF of the epoch completes,
+ * at the virtual time the SPF ran plus the CPU time the SPF took*/
+
+#define SPF_SIM_DEF_LINK_DELAY          1000    /*usec*/
+#define SPF_SIM_DEF_LSP_PROC_DELAY      500     /*usec*/
+#define SPF_SIM_MIN_EVENTS              64
+
+typedef struct _node_t node_t;
+typedef struct instance_ instance_t;
+typedef struct spf_sched_ spf_sched_t;
+
+typedef enum{
+
+    SPF_SIM_EV_LSP_RX,
+    SPF_SIM_EV_LSP_PROCESSED,
+    SPF_SIM_EV_SPF_RUN
+} spf_sim_event_type_t;
+
+/*An LSP being flooded at a level*/
+typedef struct spf_sim_flood_{
+
+    dist_info_hdr_t dist_info;          /*info_data is NULL with the manual clock, the flood outlives it*/
+    info_dist_fn_ptr fn_ptr;
+    node_t *lsp_generator;
+    LEVEL level;
+    unsigned long long origin_usec;
+    unsigned int n_pending_events;      /*The flood is freed with its last event*/
+    unsigned int n_nodes;
+    unsigned char *received;            /*By node_index*/
+} spf_sim_flood_t;
+
+typedef struct spf_sim_event_{
+
+    unsigned long long time_usec;
+    unsigned long long seq;
+    spf_sim_event_type_t type;
+    node_t *node;
+    node_t *from;                       /*Neighbour the LSP is received from*/
+    spf_sim_flood_t *flood;
+    spf_sched_t *sched;
+} spf_sim_event_t;
+
+/*Convergence of a node in the current epoch, a member of node_t*/
+typedef struct spf_sim_conv_{
+
+    unsigned long long epoch;
+    unsigned int lsps_rx;
+    unsigned int lsps_dup;
+    unsigned int spf_runs;
+    unsigned long long last_lsp_usec;   /*last LSP processed*/
+    unsigned long long last_spf_usec;   /*last SPF run*/
+    unsigned long long last_spf_nsec;   /*CPU time of the last SPF run*/
+} spf_sim_conv_t;
+
+typedef struct spf_sim_{
+
+    unsigned long long clock_usec;
+    unsigned long long seq;
+    boolean manual_clock;
+    unsigned int link_delay_usec;       /*of links with no delay configured*/
+    unsigned int lsp_proc_delay_usec;   /*of nodes with no delay configured*/
+
+    spf_sim_event_t *events;            /*Binary min heap*/
+    unsigned int n_events;
+    unsigned int max_events;
+
+    unsigned long long epoch;
+    unsigned long long epoch_start_usec;
+    unsigned long long n_floods;            /*of the epoch*/
+    unsigned long long n_events_processed;  /*of the epoch*/
+} spf_sim_t;
+
+void
+spf_sim_init(spf_sim_t *sim);
+
+/*Flood the LSP of lsp_generator at every level of dist_info*/
+void
+spf_sim_originate_lsp(instance_t *instance, node_t *lsp_generator,
+                      info_dist_fn_ptr fn_ptr, dist_info_hdr_t *dist_info);
+
+/*Schedule the SPF run of sched, due at time_usec*/
+void
+spf_sim_schedule_spf(instance_t *instance, spf_sched_t *sched,
+                     unsigned long long time_usec);
+
+/*Record the SPF run of node for convergence reporting*/
+void
+spf_sim_spf_done(instance_t *instance, node_t *node, unsigned long long spf_nsec);
+
+/*Advance the clock by usec, processing the events due by then in order*/
+void
+spf_sim_advance(instance_t *instance, unsigned long long usec);
+
+/*Process all events, the clock stops at the last one*/
+void
+spf_sim_drain(instance_t *instance);
+
+/*Process all events unless the clock is manual*/
+void
+spf_sim_settle(instance_t *instance);
+
+void
+spf_sim_show_convergence(instance_t *instance);
+
+#endif /* __SPFSIM__ */
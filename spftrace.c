@@ -36,6 +36,24 @@
 
 extern instance_t *instance;
 
+__thread char spf_trace_buf[TRACEOPTIONS_BUFFER_SiZE];
+
+/*Log the message of a trace point as trace() does*/
+void
+spf_trace_emit(const char *fn, unsigned int line, char *msg){
+
+    char fn_line[FN_LINE_BUFFER_SIZE];
+
+    if(instance->traceopts->logstorage == CONSOLE){
+        printf("%s(%u) : %s\n", fn, line, msg);
+        return;
+    }
+    snprintf(fn_line, FN_LINE_BUFFER_SIZE, "%s(%u) : ", fn, line);
+    fwrite(fn_line, sizeof(char), strlen(fn_line), instance->traceopts->logf_fd);
+    fwrite(msg, sizeof(char), strlen(msg), instance->traceopts->logf_fd);
+    fwrite("\n", 1, 1, instance->traceopts->logf_fd);
+}
+
 char 
 *get_str_trace(spf_trace_t trace_type){
     switch(trace_type){
@@ -105,6 +123,7 @@ _spf_display_trace_options(unsigned long long bit_mask){
         printf("\t%-30s : %s\n", get_str_trace(trace_type), 
             is_spf_trace_enabled(instance, trace_type) ? "ENABLED" : "DISABLED");
     }
+    spf_trace_bin_show();
 }
 
 void
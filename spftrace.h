@@ -33,6 +33,16 @@
 #ifndef __SPF_TRACE__
 #define __SPF_TRACE__
 
+#include <stdio.h>
+#include "Libtrace/libtrace.h"
+#include "spftrace_bin.h"
+
+/*Trace points are compiled out by building with -D__DISABLE_TRACE__,
+ * e.g. make TRACE=-D__DISABLE_TRACE__*/
+#ifndef __DISABLE_TRACE__
+#define __ENABLE_TRACE__
+#endif
+
 typedef enum{
 
     DIJKSTRA_BIT,
@@ -75,5 +85,48 @@ is_spf_trace_enabled(instance_t *instance, spf_trace_t spf_trace);
 void
 spf_display_trace_options();
 
-#define __ENABLE_TRACE__
+/*Trace message buffer, one per thread*/
+extern __thread char spf_trace_buf[TRACEOPTIONS_BUFFER_SiZE];
+
+void
+spf_trace_emit(const char *fn, unsigned int line, char *msg);
+
+/* SPF_TRACE(bit, fmt, ...) formats and logs the message only if tracing
+ * and the trace bit are enabled, arguments are not even evaluated
+ * otherwise. Trace points are expected to be disabled, the test is
+ * hinted as unlikely. With the binary backend on (debug log enable binary),
+ * the message is not formatted, its raw arguments are recorded instead*/
+#ifdef __ENABLE_TRACE__
+
+#define SPF_TRACE_ENABLED(bit)                                                  \
+    __builtin_expect(instance->traceopts->enable == TR_TRUE &&                  \
+                     TR_IS_BIT_SET(instance->traceopts->bit_mask, bit), 0)
+
+#define SPF_TRACE(bit, ...)                                                     \
+    do{                                                                         \
+        if(SPF_TRACE_ENABLED(bit)){                                             \
+            if(spf_trace_bin_enabled){                                          \
+                static uint32_t _spf_trace_site_id;                             \
+                spf_trace_bin_record(&_spf_trace_site_id, bit,                  \
+                    __FUNCTION__, __LINE__, __VA_ARGS__);                       \
+            }                                                                   \
+            else{                                                               \
+                snprintf(spf_trace_buf, TRACEOPTIONS_BUFFER_SiZE, __VA_ARGS__); \
+                spf_trace_emit(__FUNCTION__, __LINE__, spf_trace_buf);          \
+            }                                                                   \
+        }                                                                       \
+    } while(0)
+
+#else
+
+/*Arguments stay type checked, the dead branch is elided by the compiler*/
+#define SPF_TRACE_ENABLED(bit)  0
+
+#define SPF_TRACE(bit, ...)                                                     \
+    do{                                                                         \
+        if(0) snprintf(spf_trace_buf, TRACEOPTIONS_BUFFER_SiZE, __VA_ARGS__);   \
+    } while(0)
+
+#endif /* __ENABLE_TRACE__ */
+
 #endif /* __SPF_TRACE__ */
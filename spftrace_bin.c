@@ -0,0 +1,543 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  spftrace_bin.c
+ *
+ *    Description:  Binary trace backend : per thread ring buffers of fixed size
+ *                  trace records, flushed to a file decoded by spftrace-decode
+ *
+ *        Version:  1.0
+ *        Created:  Sunday 18 October 2026 20:18:00  UTC
+ *       Revision:  1.0
+ *       Compiler:  gcc
+ *
+ *         Author:  agent, agent@local
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        Copyright (c) 2026 agent.
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <time.h>
+#include <pthread.h>
+#include "spftrace_bin.h"
+
+#define SPF_TRACE_BIN_MAX_THREADS   64
+#define SPF_TRACE_BIN_MAX_STRINGS   65536
+#define SPF_TRACE_BIN_STR_HASH_SIZE (2 * SPF_TRACE_BIN_MAX_STRINGS)
+#define SPF_TRACE_BIN_STR_CACHE_SIZE    256 /*per thread, power of 2*/
+#define SPF_TRACE_BIN_OUT_SIZE      (64 * 1024)
+
+/*Interned id of the string last traced from address str by the thread*/
+typedef struct spf_trace_str_cache_{
+
+    const char *str;
+    uint32_t id;
+} spf_trace_str_cache_t;
+
+/* Single producer (the owning thread), single consumer (whoever holds
+ * spf_trace_bin_flush_lock) ring. The producer publishes a record by a
+ * release store of head, the consumer frees slots by a release store of
+ * tail*/
+typedef struct spf_trace_ring_{
+
+    unsigned long head;
+    unsigned long tail;
+    unsigned long drops;
+    unsigned long drops_written;
+    uint16_t thread_id;
+    spf_trace_str_cache_t str_cache[SPF_TRACE_BIN_STR_CACHE_SIZE];
+    spf_trace_bin_record_t records[SPF_TRACE_BIN_RING_SIZE];
+} spf_trace_ring_t;
+
+typedef struct spf_trace_site_{
+
+    const char *fn;
+    const char *fmt;
+    unsigned int line;
+    unsigned int n_args;
+    uint8_t arg_types[SPF_TRACE_BIN_MAX_ARGS];
+} spf_trace_site_t;
+
+typedef struct spf_trace_string_{
+
+    char *str;
+    unsigned int len;
+} spf_trace_string_t;
+
+int spf_trace_bin_enabled = 0;
+
+/* spf_trace_bin_lock guards the ring, site and string tables, trace points
+ * take it only to register a new thread, site or string.
+ * spf_trace_bin_flush_lock guards the trace file and the drain of the
+ * rings, trace points only try it. Lock order is flush lock, then lock*/
+static pthread_mutex_t spf_trace_bin_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t spf_trace_bin_flush_lock = PTHREAD_MUTEX_INITIALIZER;
+static FILE *spf_trace_bin_fp = NULL;
+static char spf_trace_bin_file_name[256];
+static uint64_t spf_trace_bin_bytes = 0;
+/*Entries are copied out of the rings into this buffer, written in chunks*/
+static unsigned char spf_trace_bin_out[SPF_TRACE_BIN_OUT_SIZE];
+static size_t spf_trace_bin_out_len = 0;
+static uint64_t spf_trace_bin_records = 0;
+
+static pthread_t spf_trace_bin_flusher;
+static int spf_trace_bin_flusher_stop = 0;
+
+static __thread spf_trace_ring_t *spf_trace_ring = NULL;
+static spf_trace_ring_t *spf_trace_rings[SPF_TRACE_BIN_MAX_THREADS];
+static unsigned int spf_trace_n_rings = 0;
+
+/*Site ids start from 1, 0 is an unregistered call site*/
+static spf_trace_site_t spf_trace_sites[SPF_TRACE_BIN_MAX_SITES + 1];
+static unsigned int spf_trace_n_sites = 0;
+static unsigned int spf_trace_sites_written = 0;
+
+/*String ids start from 1, 0 is NULL*/
+static spf_trace_string_t spf_trace_strings[SPF_TRACE_BIN_MAX_STRINGS + 1];
+static uint32_t spf_trace_str_hash[SPF_TRACE_BIN_STR_HASH_SIZE];
+static unsigned int spf_trace_n_strings = 0;
+static unsigned int spf_trace_strings_written = 0;
+
+static inline uint64_t
+spf_trace_bin_now(void){
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void
+spf_trace_bin_out_flush(void){
+
+    if(spf_trace_bin_out_len)
+        fwrite(spf_trace_bin_out, spf_trace_bin_out_len, 1, spf_trace_bin_fp);
+    spf_trace_bin_out_len = 0;
+}
+
+static void
+spf_trace_bin_append(const void *data, size_t size){
+
+    if(spf_trace_bin_out_len + size > SPF_TRACE_BIN_OUT_SIZE)
+        spf_trace_bin_out_flush();
+    if(size > SPF_TRACE_BIN_OUT_SIZE)
+        fwrite(data, size, 1, spf_trace_bin_fp);
+    else{
+        memcpy(spf_trace_bin_out + spf_trace_bin_out_len, data, size);
+        spf_trace_bin_out_len += size;
+    }
+    spf_trace_bin_bytes += size;
+}
+
+static void
+spf_trace_bin_write(unsigned char entry, const void *data, size_t size){
+
+    spf_trace_bin_append(&entry, 1);
+    spf_trace_bin_append(data, size);
+}
+
+/* Drain all rings, to be called with spf_trace_bin_flush_lock held. Sites
+ * and strings are never changed once registered, so the file is written
+ * without spf_trace_bin_lock and trace points do not wait on the file*/
+static void
+spf_trace_bin_flush_locked(void){
+
+    unsigned int i, n_rings, n_sites, n_strings;
+    unsigned long heads[SPF_TRACE_BIN_MAX_THREADS];
+    spf_trace_ring_t *ring = NULL;
+
+    pthread_mutex_lock(&spf_trace_bin_lock);
+    n_rings = spf_trace_n_rings;
+    pthread_mutex_unlock(&spf_trace_bin_lock);
+
+    /*Snapshot the heads first, the sites and strings of these records
+     * are registered by then*/
+    for(i = 0; i < n_rings; i++)
+        heads[i] = __atomic_load_n(&spf_trace_rings[i]->head, __ATOMIC_ACQUIRE);
+
+    pthread_mutex_lock(&spf_trace_bin_lock);
+    n_sites = spf_trace_n_sites;
+    n_strings = spf_trace_n_strings;
+    pthread_mutex_unlock(&spf_trace_bin_lock);
+
+    if(!spf_trace_bin_fp){
+        for(i = 0; i < n_rings; i++)
+            __atomic_store_n(&spf_trace_rings[i]->tail, heads[i], __ATOMIC_RELEASE);
+        return;
+    }
+
+    for(; spf_trace_sites_written < n_sites; spf_trace_sites_written++){
+
+        spf_trace_site_t *site = &spf_trace_sites[spf_trace_sites_written + 1];
+        spf_trace_bin_site_t site_def;
+
+        memset(&site_def, 0, sizeof(spf_trace_bin_site_t));
+        site_def.id = spf_trace_sites_written + 1;
+        site_def.line = site->line;
+        site_def.n_args = site->n_args;
+        memcpy(site_def.arg_types, site->arg_types, SPF_TRACE_BIN_MAX_ARGS);
+        site_def.fn_len = strlen(site->fn);
+        site_def.fmt_len = strlen(site->fmt);
+        spf_trace_bin_write(SPF_TRACE_BIN_SITE, &site_def, sizeof(spf_trace_bin_site_t));
+        spf_trace_bin_append(site->fn, site_def.fn_len);
+        spf_trace_bin_append(site->fmt, site_def.fmt_len);
+    }
+
+    for(; spf_trace_strings_written < n_strings; spf_trace_strings_written++){
+
+        spf_trace_string_t *string = &spf_trace_strings[spf_trace_strings_written + 1];
+        spf_trace_bin_string_t string_def;
+
+        string_def.id = spf_trace_strings_written + 1;
+        string_def.len = string->len;
+        spf_trace_bin_write(SPF_TRACE_BIN_STRING, &string_def, sizeof(spf_trace_bin_string_t));
+        spf_trace_bin_append(string->str, string->len);
+    }
+
+    for(i = 0; i < n_rings; i++){
+
+        unsigned long tail, drops;
+
+        ring = spf_trace_rings[i];
+        for(tail = ring->tail; tail != heads[i]; tail++){
+            spf_trace_bin_write(SPF_TRACE_BIN_RECORD,
+                &ring->records[tail & (SPF_TRACE_BIN_RING_SIZE - 1)],
+                sizeof(spf_trace_bin_record_t));
+            spf_trace_bin_records++;
+        }
+        __atomic_store_n(&ring->tail, heads[i], __ATOMIC_RELEASE);
+
+        drops = __atomic_load_n(&ring->drops, __ATOMIC_RELAXED);
+        if(drops != ring->drops_written){
+            uint64_t n_dropped = drops - ring->drops_written;
+            spf_trace_bin_write(SPF_TRACE_BIN_DROPS, &n_dropped, sizeof(uint64_t));
+            ring->drops_written = drops;
+        }
+    }
+    spf_trace_bin_out_flush();
+    fflush(spf_trace_bin_fp);
+}
+
+void
+spf_trace_bin_flush(void){
+
+    pthread_mutex_lock(&spf_trace_bin_flush_lock);
+    spf_trace_bin_flush_locked();
+    pthread_mutex_unlock(&spf_trace_bin_flush_lock);
+}
+
+static void *
+spf_trace_bin_flusher_fn(void *arg){
+
+    struct timespec period;
+
+    period.tv_sec = 0;
+    period.tv_nsec = SPF_TRACE_BIN_FLUSH_MSEC * 1000000L;
+
+    while(!__atomic_load_n(&spf_trace_bin_flusher_stop, __ATOMIC_ACQUIRE)){
+        nanosleep(&period, NULL);
+        spf_trace_bin_flush();
+    }
+    return NULL;
+}
+
+static spf_trace_ring_t *
+spf_trace_bin_ring_get(void){
+
+    spf_trace_ring_t *ring = NULL;
+
+    if(spf_trace_ring)
+        return spf_trace_ring;
+
+    pthread_mutex_lock(&spf_trace_bin_lock);
+    if(spf_trace_n_rings < SPF_TRACE_BIN_MAX_THREADS){
+        ring = calloc(1, sizeof(spf_trace_ring_t));
+        if(ring){
+            ring->thread_id = spf_trace_n_rings;
+            spf_trace_rings[spf_trace_n_rings++] = ring;
+        }
+    }
+    pthread_mutex_unlock(&spf_trace_bin_lock);
+    spf_trace_ring = ring;
+    return ring;
+}
+
+static uint32_t
+spf_trace_bin_site_register(const char *fn, unsigned int line, const char *fmt){
+
+    unsigned int pos = 0, spec_start = 0, n_args = 0;
+    spf_trace_arg_type_t arg_type;
+    spf_trace_site_t *site = NULL;
+
+    if(spf_trace_n_sites == SPF_TRACE_BIN_MAX_SITES)
+        return 0;
+
+    site = &spf_trace_sites[spf_trace_n_sites + 1];
+    memset(site, 0, sizeof(spf_trace_site_t));
+    site->fn = fn;
+    site->fmt = fmt;
+    site->line = line;
+
+    while((arg_type = spf_trace_fmt_next_arg(fmt, &pos, &spec_start)) != SPF_TRACE_ARG_NONE){
+
+        if(arg_type == SPF_TRACE_ARG_TEXT || n_args == SPF_TRACE_BIN_MAX_ARGS){
+            /*Not storable as raw args, the message is formatted at record time*/
+            site->arg_types[0] = SPF_TRACE_ARG_TEXT;
+            n_args = 1;
+            break;
+        }
+        site->arg_types[n_args++] = arg_type;
+    }
+    site->n_args = n_args;
+    return ++spf_trace_n_sites;
+}
+
+/*To be called with spf_trace_bin_lock held. Return 0 if the table is full*/
+static uint32_t
+spf_trace_bin_string_intern(const char *str){
+
+    unsigned int len = strlen(str);
+    uint32_t hash = 2166136261u, id;
+    unsigned int i, slot;
+
+    for(i = 0; i < len; i++){
+        hash ^= (unsigned char)str[i];
+        hash *= 16777619u;
+    }
+
+    for(slot = hash % SPF_TRACE_BIN_STR_HASH_SIZE; ;
+        slot = (slot + 1) % SPF_TRACE_BIN_STR_HASH_SIZE){
+
+        id = spf_trace_str_hash[slot];
+        if(!id)
+            break;
+        if(spf_trace_strings[id].len == len &&
+           memcmp(spf_trace_strings[id].str, str, len) == 0)
+            return id;
+    }
+
+    if(spf_trace_n_strings == SPF_TRACE_BIN_MAX_STRINGS)
+        return 0;
+
+    id = ++spf_trace_n_strings;
+    spf_trace_strings[id].str = malloc(len);
+    memcpy(spf_trace_strings[id].str, str, len);
+    spf_trace_strings[id].len = len;
+    spf_trace_str_hash[slot] = id;
+    return id;
+}
+
+/* Trace points mostly pass the same few strings (node names, interface
+ * names) from the same addresses : look the address up in the cache of
+ * the thread and check the string still reads the same, before hashing
+ * and interning it under spf_trace_bin_lock. Return 0 if the table is full*/
+static uint32_t
+spf_trace_bin_string_id(spf_trace_ring_t *ring, const char *str){
+
+    spf_trace_str_cache_t *entry = &ring->str_cache[
+        ((uintptr_t)str >> 3) & (SPF_TRACE_BIN_STR_CACHE_SIZE - 1)];
+    spf_trace_string_t *string = NULL;
+
+    if(entry->str == str){
+        string = &spf_trace_strings[entry->id];
+        if(strncmp(str, string->str, string->len) == 0 && !str[string->len])
+            return entry->id;
+    }
+
+    pthread_mutex_lock(&spf_trace_bin_lock);
+    entry->id = spf_trace_bin_string_intern(str);
+    pthread_mutex_unlock(&spf_trace_bin_lock);
+    entry->str = entry->id ? str : NULL;
+    return entry->id;
+}
+
+void
+spf_trace_bin_record(uint32_t *site_id, unsigned int bit, const char *fn,
+                     unsigned int line, const char *fmt, ...){
+
+    va_list ap;
+    unsigned int i;
+    unsigned long head;
+    spf_trace_site_t *site = NULL;
+    spf_trace_bin_record_t *record = NULL;
+    spf_trace_ring_t *ring = spf_trace_bin_ring_get();
+
+    if(!ring)
+        return;
+
+    if(!*site_id){
+        pthread_mutex_lock(&spf_trace_bin_lock);
+        if(!*site_id)
+            *site_id = spf_trace_bin_site_register(fn, line, fmt);
+        pthread_mutex_unlock(&spf_trace_bin_lock);
+        if(!*site_id){
+            ring->drops++;
+            return;
+        }
+    }
+    site = &spf_trace_sites[*site_id];
+
+    head = ring->head;
+    if(head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) == SPF_TRACE_BIN_RING_SIZE){
+        /*Ring full, drain it now unless a flush is on already*/
+        if(pthread_mutex_trylock(&spf_trace_bin_flush_lock) == 0){
+            spf_trace_bin_flush_locked();
+            pthread_mutex_unlock(&spf_trace_bin_flush_lock);
+        }
+        if(head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) == SPF_TRACE_BIN_RING_SIZE){
+            __atomic_store_n(&ring->drops, ring->drops + 1, __ATOMIC_RELAXED);
+            return;
+        }
+    }
+
+    record = &ring->records[head & (SPF_TRACE_BIN_RING_SIZE - 1)];
+    record->nsec = spf_trace_bin_now();
+    record->site_id = *site_id;
+    record->thread_id = ring->thread_id;
+    record->bit = bit;
+    record->pad = 0;
+
+    va_start(ap, fmt);
+    if(site->n_args && site->arg_types[0] == SPF_TRACE_ARG_TEXT){
+        vsnprintf((char *)record->args, sizeof(record->args), fmt, ap);
+    }
+    else{
+        for(i = 0; i < site->n_args; i++){
+            switch(site->arg_types[i]){
+                case SPF_TRACE_ARG_INT:
+                    record->args[i] = va_arg(ap, unsigned int);
+                    break;
+                case SPF_TRACE_ARG_LONG:
+                    record->args[i] = va_arg(ap, unsigned long long);
+                    break;
+                case SPF_TRACE_ARG_DOUBLE:
+                    {
+                        double d = va_arg(ap, double);
+                        memcpy(&record->args[i], &d, sizeof(double));
+                    }
+                    break;
+                case SPF_TRACE_ARG_PTR:
+                    record->args[i] = (uintptr_t)va_arg(ap, void *);
+                    break;
+                case SPF_TRACE_ARG_STRING:
+                    {
+                        const char *str = va_arg(ap, const char *);
+                        if(!str){
+                            record->args[i] = SPF_TRACE_BIN_NULL_STRING;
+                            break;
+                        }
+                        record->args[i] = spf_trace_bin_string_id(ring, str);
+                        if(!record->args[i]){
+                            /*String table full*/
+                            va_end(ap);
+                            __atomic_store_n(&ring->drops, ring->drops + 1, __ATOMIC_RELAXED);
+                            return;
+                        }
+                    }
+                    break;
+                default:
+                    ;
+            }
+        }
+    }
+    va_end(ap);
+
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+}
+
+int
+spf_trace_bin_start(const char *file_name){
+
+    spf_trace_bin_hdr_t hdr;
+
+    if(spf_trace_bin_enabled)
+        return 0;
+
+    pthread_mutex_lock(&spf_trace_bin_flush_lock);
+    spf_trace_bin_fp = fopen(file_name, "w");
+    if(!spf_trace_bin_fp){
+        pthread_mutex_unlock(&spf_trace_bin_flush_lock);
+        return -1;
+    }
+    strncpy(spf_trace_bin_file_name, file_name, sizeof(spf_trace_bin_file_name) - 1);
+
+    memset(&hdr, 0, sizeof(spf_trace_bin_hdr_t));
+    memcpy(hdr.magic, SPF_TRACE_BIN_MAGIC, sizeof(hdr.magic));
+    hdr.start_nsec = spf_trace_bin_now();
+    fwrite(&hdr, sizeof(spf_trace_bin_hdr_t), 1, spf_trace_bin_fp);
+    spf_trace_bin_bytes = sizeof(spf_trace_bin_hdr_t);
+    spf_trace_bin_records = 0;
+
+    /*A new file, sites and strings are to be written again*/
+    spf_trace_sites_written = 0;
+    spf_trace_strings_written = 0;
+    pthread_mutex_unlock(&spf_trace_bin_flush_lock);
+
+    spf_trace_bin_flusher_stop = 0;
+    if(pthread_create(&spf_trace_bin_flusher, NULL, spf_trace_bin_flusher_fn, NULL)){
+        pthread_mutex_lock(&spf_trace_bin_flush_lock);
+        fclose(spf_trace_bin_fp);
+        spf_trace_bin_fp = NULL;
+        pthread_mutex_unlock(&spf_trace_bin_flush_lock);
+        return -1;
+    }
+    spf_trace_bin_enabled = 1;
+    return 0;
+}
+
+void
+spf_trace_bin_stop(void){
+
+    if(!spf_trace_bin_enabled)
+        return;
+
+    spf_trace_bin_enabled = 0;
+    __atomic_store_n(&spf_trace_bin_flusher_stop, 1, __ATOMIC_RELEASE);
+    pthread_join(spf_trace_bin_flusher, NULL);
+
+    pthread_mutex_lock(&spf_trace_bin_flush_lock);
+    spf_trace_bin_flush_locked();
+    fclose(spf_trace_bin_fp);
+    spf_trace_bin_fp = NULL;
+    pthread_mutex_unlock(&spf_trace_bin_flush_lock);
+}
+
+void
+spf_trace_bin_show(void){
+
+    unsigned int i;
+    unsigned long pending = 0, drops = 0;
+
+    pthread_mutex_lock(&spf_trace_bin_flush_lock);
+    pthread_mutex_lock(&spf_trace_bin_lock);
+    for(i = 0; i < spf_trace_n_rings; i++){
+        pending += spf_trace_rings[i]->head - spf_trace_rings[i]->tail;
+        drops += spf_trace_rings[i]->drops;
+    }
+    printf("binary trace : %s", spf_trace_bin_enabled ? "ENABLE" : "DISABLE");
+    if(spf_trace_bin_fp)
+        printf(", file %s", spf_trace_bin_file_name);
+    printf("\n\trecords written = %llu, bytes written = %llu, pending = %lu, dropped = %lu\n",
+        (unsigned long long)spf_trace_bin_records,
+        (unsigned long long)spf_trace_bin_bytes, pending, drops);
+    printf("\tthreads = %u, trace sites = %u, strings = %u\n",
+        spf_trace_n_rings, spf_trace_n_sites, spf_trace_n_strings);
+    pthread_mutex_unlock(&spf_trace_bin_lock);
+    pthread_mutex_unlock(&spf_trace_bin_flush_lock);
+}
@@ -0,0 +1,197 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  spftrace_bin.h
+ *
+ *    Description:  Binary trace backend : per thread ring buffers of fixed size
+ *                  trace records, flushed to a file decoded by spftrace-decode
+ *
+ *        Version:  1.0
+ *        Created:  Sunday 18 October 2026 20:18:00  UTC
+ *       Revision:  1.0
+ *       Compiler:  gcc
+ *
+ *         Author:  agent, agent@local
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        Copyright (c) 2026 agent.
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#ifndef __SPF_TRACE_BIN__
+#define __SPF_TRACE_BIN__
+
+#include <stdint.h>
+
+/* With the binary backend, a trace point does not format its message. It
+ * stores the raw values of its arguments in a fixed size record, strings
+ * (node names, prefixes ..) are interned and stored as ids. The format of
+ * the trace point is registered once as a call site. Records go into a
+ * ring buffer of the tracing thread, which a background thread drains into
+ * the trace file every SPF_TRACE_BIN_FLUSH_MSEC, or the tracing thread
+ * itself when its ring is full.
+ *
+ * Trace file, host byte order :
+ *  spf_trace_bin_hdr_t, then entries, each a one byte spf_trace_bin_entry_t
+ *  followed by :
+ *  SPF_TRACE_BIN_SITE      spf_trace_bin_site_t, fn_len bytes of function
+ *                          name and fmt_len bytes of format
+ *  SPF_TRACE_BIN_STRING    spf_trace_bin_string_t and len bytes of string
+ *  SPF_TRACE_BIN_RECORD    spf_trace_bin_record_t
+ *  SPF_TRACE_BIN_DROPS     uint64_t, records lost on a full ring
+ * A site or string is written before the first record referring to it*/
+
+#define SPF_TRACE_BIN_MAGIC         "SPFTRC01"
+#define SPF_TRACE_BIN_FILE          "spftrace.bin"
+#define SPF_TRACE_BIN_MAX_ARGS      12
+#define SPF_TRACE_BIN_MAX_SITES     4096
+#define SPF_TRACE_BIN_RING_SIZE     65536   /*records per thread, power of 2*/
+#define SPF_TRACE_BIN_FLUSH_MSEC    20
+#define SPF_TRACE_BIN_NULL_STRING   0       /*string id of NULL*/
+
+typedef enum{
+
+    SPF_TRACE_BIN_SITE = 1,
+    SPF_TRACE_BIN_STRING,
+    SPF_TRACE_BIN_RECORD,
+    SPF_TRACE_BIN_DROPS
+} spf_trace_bin_entry_t;
+
+typedef enum{
+
+    SPF_TRACE_ARG_INT,      /*d i u o x X c, up to 32 bit*/
+    SPF_TRACE_ARG_LONG,     /*with l, ll or z*/
+    SPF_TRACE_ARG_DOUBLE,
+    SPF_TRACE_ARG_STRING,   /*interned string id*/
+    SPF_TRACE_ARG_PTR,
+    SPF_TRACE_ARG_TEXT,     /*format not storable as raw args, the record carries the message text*/
+    SPF_TRACE_ARG_NONE      /*no conversion left*/
+} spf_trace_arg_type_t;
+
+typedef struct spf_trace_bin_hdr_{
+
+    char magic[8];
+    uint64_t start_nsec;    /*CLOCK_MONOTONIC when the file was opened*/
+} spf_trace_bin_hdr_t;
+
+typedef struct spf_trace_bin_site_{
+
+    uint32_t id;
+    uint32_t line;
+    uint8_t n_args;
+    uint8_t arg_types[SPF_TRACE_BIN_MAX_ARGS]; /*SPF_TRACE_ARG_TEXT alone for text records*/
+    uint16_t fn_len;
+    uint16_t fmt_len;
+} spf_trace_bin_site_t;
+
+typedef struct spf_trace_bin_string_{
+
+    uint32_t id;
+    uint32_t len;
+} spf_trace_bin_string_t;
+
+typedef struct spf_trace_bin_record_{
+
+    uint64_t nsec;          /*CLOCK_MONOTONIC*/
+    uint32_t site_id;
+    uint16_t thread_id;
+    uint8_t bit;
+    uint8_t pad;
+    uint64_t args[SPF_TRACE_BIN_MAX_ARGS];
+} spf_trace_bin_record_t;
+
+/* Find the next conversion of fmt from *pos, and return the type of its
+ * argument. [*spec_start, *pos) is then the conversion spec. Returns
+ * SPF_TRACE_ARG_TEXT for conversions not handled (* width or precision),
+ * SPF_TRACE_ARG_NONE at the end of fmt*/
+static inline spf_trace_arg_type_t
+spf_trace_fmt_next_arg(const char *fmt, unsigned int *pos,
+                       unsigned int *spec_start){
+
+    unsigned int i = *pos,
+                 n_long = 0;
+
+    for(; fmt[i]; i++){
+
+        if(fmt[i] != '%')
+            continue;
+        if(fmt[i + 1] == '%'){
+            i++;
+            continue;
+        }
+
+        *spec_start = i++;
+        n_long = 0;
+        while(fmt[i] && (fmt[i] == '-' || fmt[i] == '+' || fmt[i] == ' ' ||
+                         fmt[i] == '#' || fmt[i] == '0'))
+            i++;
+        while(fmt[i] >= '0' && fmt[i] <= '9') i++;
+        if(fmt[i] == '*') break;
+        if(fmt[i] == '.'){
+            i++;
+            if(fmt[i] == '*') break;
+            while(fmt[i] >= '0' && fmt[i] <= '9') i++;
+        }
+        while(fmt[i] == 'h') i++;
+        while(fmt[i] == 'l' || fmt[i] == 'z' || fmt[i] == 'j'){
+            n_long++;
+            i++;
+        }
+        if(!fmt[i]) break;
+
+        *pos = i + 1;
+        switch(fmt[i]){
+            case 'd': case 'i': case 'u': case 'o':
+            case 'x': case 'X': case 'c':
+                return n_long ? SPF_TRACE_ARG_LONG : SPF_TRACE_ARG_INT;
+            case 'f': case 'F': case 'e': case 'E':
+            case 'g': case 'G':
+                return SPF_TRACE_ARG_DOUBLE;
+            case 's':
+                return SPF_TRACE_ARG_STRING;
+            case 'p':
+                return SPF_TRACE_ARG_PTR;
+            default:
+                return SPF_TRACE_ARG_TEXT;
+        }
+    }
+    *pos = i;
+    return fmt[i] ? SPF_TRACE_ARG_TEXT : SPF_TRACE_ARG_NONE;
+}
+
+/*Trace points record into the ring buffers, see SPF_TRACE()*/
+extern int spf_trace_bin_enabled;
+
+/*Open the trace file and start the flusher thread. Return 0 on success*/
+int
+spf_trace_bin_start(const char *file_name);
+
+/*Flush, stop the flusher thread and close the trace file*/
+void
+spf_trace_bin_stop(void);
+
+/*Drain the ring buffers of all threads into the trace file*/
+void
+spf_trace_bin_flush(void);
+
+void
+spf_trace_bin_record(uint32_t *site_id, unsigned int bit, const char *fn,
+                     unsigned int line, const char *fmt, ...)
+                     __attribute__((format(printf, 5, 6)));
+
+void
+spf_trace_bin_show(void);
+
+#endif /* __SPF_TRACE_BIN__ */
@@ -0,0 +1,258 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  spftrace_decode.c
+ *
+ *    Description:  spftrace-decode : renders the binary trace file written by
+ *                  "debug log enable binary" as text trace lines
+ *
+ *        Version:  1.0
+ *        Created:  Sunday 18 October 2026 20:18:00  UTC
+ *       Revision:  1.0
+ *       Compiler:  gcc
+ *
+ *         Author:  agent, agent@local
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        Copyright (c) 2026 agent.
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+/* Usage : spftrace-decode [-t] [<trace-file>]
+ *  -t          prefix each line with the time since tracing started and the thread
+ *  trace-file  defaults to spftrace.bin
+ * Lines are rendered as the text trace renders them, "fn(line) : message"*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "spftrace_bin.h"
+
+#define DECODE_MSG_SIZE 2048
+
+typedef struct decode_site_{
+
+    spf_trace_bin_site_t def;
+    char *fn;
+    char *fmt;
+} decode_site_t;
+
+static decode_site_t *sites = NULL;
+static unsigned int n_sites = 0;
+static char **strings = NULL;
+static unsigned int n_strings = 0;
+
+static char *
+read_bytes(FILE *fp, unsigned int len){
+
+    char *buf = calloc(1, len + 1);
+    if(len && fread(buf, len, 1, fp) != 1){
+        free(buf);
+        return NULL;
+    }
+    return buf;
+}
+
+/*Append to msg what the conversion [spec, spec + spec_len) renders for arg*/
+static unsigned int
+render_arg(char *msg, unsigned int off, const char *spec, unsigned int spec_len,
+           spf_trace_arg_type_t arg_type, uint64_t arg){
+
+    char conv[32];
+    unsigned int room = DECODE_MSG_SIZE - off;
+    int n = 0;
+
+    if(spec_len >= sizeof(conv))
+        spec_len = sizeof(conv) - 1;
+    memcpy(conv, spec, spec_len);
+    conv[spec_len] = '\0';
+
+    switch(arg_type){
+        case SPF_TRACE_ARG_INT:
+            n = snprintf(msg + off, room, conv, (unsigned int)arg);
+            break;
+        case SPF_TRACE_ARG_LONG:
+            n = snprintf(msg + off, room, conv, (unsigned long long)arg);
+            break;
+        case SPF_TRACE_ARG_DOUBLE:
+            {
+                double d;
+                memcpy(&d, &arg, sizeof(double));
+                n = snprintf(msg + off, room, conv, d);
+            }
+            break;
+        case SPF_TRACE_ARG_PTR:
+            n = snprintf(msg + off, room, conv, (void *)(uintptr_t)arg);
+            break;
+        case SPF_TRACE_ARG_STRING:
+            if(arg == SPF_TRACE_BIN_NULL_STRING)
+                n = snprintf(msg + off, room, conv, "(null)");
+            else if(arg > n_strings || !strings[arg])
+                n = snprintf(msg + off, room, "<string %llu ?>", (unsigned long long)arg);
+            else
+                n = snprintf(msg + off, room, conv, strings[arg]);
+            break;
+        default:
+            ;
+    }
+    if(n < 0)
+        return off;
+    return (unsigned int)n >= room ? DECODE_MSG_SIZE - 1 : off + n;
+}
+
+static void
+render_record(spf_trace_bin_record_t *record, uint64_t start_nsec, int timestamps){
+
+    char msg[DECODE_MSG_SIZE];
+    unsigned int off = 0, pos = 0, lit = 0, spec_start = 0, i = 0;
+    spf_trace_arg_type_t arg_type;
+    decode_site_t *site = NULL;
+
+    if(record->site_id == 0 || record->site_id > n_sites || !sites[record->site_id].fmt){
+        printf("<record of unknown trace site %u>\n", record->site_id);
+        return;
+    }
+    site = &sites[record->site_id];
+
+    if(timestamps){
+        uint64_t nsec = record->nsec - start_nsec;
+        printf("[%llu.%09llu] [%u] ", (unsigned long long)(nsec / 1000000000ULL),
+            (unsigned long long)(nsec % 1000000000ULL), record->thread_id);
+    }
+
+    if(site->def.n_args && site->def.arg_types[0] == SPF_TRACE_ARG_TEXT){
+        ((char *)record->args)[sizeof(record->args) - 1] = '\0';
+        printf("%s(%u) : %s\n", site->fn, site->def.line, (char *)record->args);
+        return;
+    }
+
+    while(1){
+        arg_type = spf_trace_fmt_next_arg(site->fmt, &pos, &spec_start);
+        /*Literal text up to the conversion, %% rendered as %*/
+        for(; lit < (arg_type == SPF_TRACE_ARG_NONE ? pos : spec_start) &&
+              off < DECODE_MSG_SIZE - 1; lit++){
+            msg[off++] = site->fmt[lit];
+            if(site->fmt[lit] == '%' && site->fmt[lit + 1] == '%')
+                lit++;
+        }
+        if(arg_type == SPF_TRACE_ARG_NONE || i == site->def.n_args)
+            break;
+        off = render_arg(msg, off, site->fmt + spec_start, pos - spec_start,
+                         arg_type, record->args[i++]);
+        lit = pos;
+    }
+    msg[off] = '\0';
+    printf("%s(%u) : %s\n", site->fn, site->def.line, msg);
+}
+
+int
+main(int argc, char **argv){
+
+    int opt, timestamps = 0;
+    unsigned char entry;
+    const char *file_name = SPF_TRACE_BIN_FILE;
+    spf_trace_bin_hdr_t hdr;
+    spf_trace_bin_site_t site_def;
+    spf_trace_bin_string_t string_def;
+    spf_trace_bin_record_t record;
+    uint64_t drops;
+    FILE *fp = NULL;
+
+    while((opt = getopt(argc, argv, "th")) != -1){
+        switch(opt){
+            case 't':
+                timestamps = 1;
+                break;
+            default:
+                fprintf(stderr, "Usage : %s [-t] [<trace-file>]\n", argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    if(optind < argc)
+        file_name = argv[optind];
+
+    fp = fopen(file_name, "r");
+    if(!fp){
+        perror(file_name);
+        return 1;
+    }
+
+    if(fread(&hdr, sizeof(spf_trace_bin_hdr_t), 1, fp) != 1 ||
+       memcmp(hdr.magic, SPF_TRACE_BIN_MAGIC, sizeof(hdr.magic))){
+        fprintf(stderr, "%s : not a binary trace file\n", file_name);
+        fclose(fp);
+        return 1;
+    }
+
+    while(fread(&entry, 1, 1, fp) == 1){
+
+        switch(entry){
+            case SPF_TRACE_BIN_SITE:
+                if(fread(&site_def, sizeof(spf_trace_bin_site_t), 1, fp) != 1)
+                    goto truncated;
+                if(site_def.id >= n_sites + 1){
+                    sites = realloc(sites, (site_def.id + 1) * sizeof(decode_site_t));
+                    memset(&sites[n_sites + 1], 0, (site_def.id - n_sites) * sizeof(decode_site_t));
+                    n_sites = site_def.id;
+                }
+                if(site_def.n_args > SPF_TRACE_BIN_MAX_ARGS)
+                    site_def.n_args = SPF_TRACE_BIN_MAX_ARGS;
+                free(sites[site_def.id].fn);
+                free(sites[site_def.id].fmt);
+                sites[site_def.id].def = site_def;
+                sites[site_def.id].fn = read_bytes(fp, site_def.fn_len);
+                sites[site_def.id].fmt = read_bytes(fp, site_def.fmt_len);
+                if(!sites[site_def.id].fn || !sites[site_def.id].fmt)
+                    goto truncated;
+                break;
+            case SPF_TRACE_BIN_STRING:
+                if(fread(&string_def, sizeof(spf_trace_bin_string_t), 1, fp) != 1)
+                    goto truncated;
+                if(string_def.id >= n_strings + 1){
+                    strings = realloc(strings, (string_def.id + 1) * sizeof(char *));
+                    memset(&strings[n_strings + 1], 0, (string_def.id - n_strings) * sizeof(char *));
+                    n_strings = string_def.id;
+                }
+                free(strings[string_def.id]);
+                strings[string_def.id] = read_bytes(fp, string_def.len);
+                if(!strings[string_def.id])
+                    goto truncated;
+                break;
+            case SPF_TRACE_BIN_RECORD:
+                if(fread(&record, sizeof(spf_trace_bin_record_t), 1, fp) != 1)
+                    goto truncated;
+                render_record(&record, hdr.start_nsec, timestamps);
+                break;
+            case SPF_TRACE_BIN_DROPS:
+                if(fread(&drops, sizeof(uint64_t), 1, fp) != 1)
+                    goto truncated;
+                printf("*** %llu trace records dropped ***\n", (unsigned long long)drops);
+                break;
+            default:
+                fprintf(stderr, "%s : corrupt entry type %u at offset %ld\n",
+                    file_name, entry, ftell(fp) - 1);
+                fclose(fp);
+                return 1;
+        }
+    }
+    fclose(fp);
+    return 0;
+
+    truncated:
+    fprintf(stderr, "%s : truncated\n", file_name);
+    fclose(fp);
+    return 1;
+}
@@ -37,6 +37,7 @@
 #include "advert.h"
 #include "spftrace.h"
 #include "LinuxMemoryManager/uapi_mm.h"
+#include "spfcounters.h"
 #include <stdint.h>
 
 extern instance_t *instance;
@@ -70,6 +71,7 @@ copy_nh_list2(internal_nh_t *src_direct_nh_list, internal_nh_t *dst_nh_list){
     
     unsigned int i = 0;
 
+    SPF_COUNTER_INC(SPF_CTR_NH_LIST_COPIES);
     for(; i < MAX_NXT_HOPS; i++){
         init_internal_nh_t(dst_nh_list[i]);
     }
@@ -105,6 +107,7 @@ union_nh_list2(internal_nh_t *src_nh_list, internal_nh_t *dst_nh_list){
 
     unsigned int i = 0, j = 0;
 
+    SPF_COUNTER_INC(SPF_CTR_NH_LIST_UNIONS);
     for(; i < MAX_NXT_HOPS; i++){
         if(!is_nh_list_empty2(&dst_nh_list[i]))
             continue;
@@ -133,6 +136,7 @@ union_direct_nh_list2(internal_nh_t *src_direct_nh_list, internal_nh_t *dst_nh_l
 
     unsigned int nh_count = 0;
 
+    SPF_COUNTER_INC(SPF_CTR_NH_LIST_UNIONS);
     if(is_nh_list_empty2(src_direct_nh_list))
         return;
 
@@ -211,9 +215,8 @@ spf_determine_multi_area_attachment(spf_info_t *spf_info,
                 is_two_way_nbrship(res->node, spf_root, LEVEL2)){
             spf_info->spff_multi_area = 1;
 #ifdef __ENABLE_TRACE__            
-            sprintf(instance->traceopts->b, "spf_root : %s is L2 Attached with remote Area node : %s", 
-                            spf_root->node_name, res->node->node_name); 
-            trace(instance->traceopts, ROUTE_CALCULATION_BIT);
+            SPF_TRACE(ROUTE_CALCULATION_BIT, "spf_root : %s is L2 Attached with remote Area node : %s", 
+                            spf_root->node_name, res->node->node_name);
 #endif
             break;   
         }
@@ -221,8 +224,7 @@ spf_determine_multi_area_attachment(spf_info_t *spf_info,
 
     if(spf_info->spff_multi_area == 0){
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "spf_root : %s is not L2 Attached with remote Area", spf_root->node_name);
-        trace(instance->traceopts, ROUTE_CALCULATION_BIT);
+        SPF_TRACE(ROUTE_CALCULATION_BIT, "spf_root : %s is not L2 Attached with remote Area", spf_root->node_name);
 #endif
     }
 }
@@ -332,15 +334,13 @@ print_nh_list2(internal_nh_t *nh_list){
     unsigned int i = 0;
 
 #ifdef __ENABLE_TRACE__    
-    sprintf(instance->traceopts->b, "printing next hop list"); 
-    trace(instance->traceopts, DIJKSTRA_BIT);
+    SPF_TRACE(DIJKSTRA_BIT, "printing next hop list");
 #endif
     for(; i < MAX_NXT_HOPS; i++){
         if(is_nh_list_empty2(&nh_list[i])) return;
 #ifdef __ENABLE_TRACE__        
-        sprintf(instance->traceopts->b, "oif = %s, NH =  %s , Level = %s, gw_prefix = %s", 
+        SPF_TRACE(DIJKSTRA_BIT, "oif = %s, NH =  %s , Level = %s, gw_prefix = %s", 
             nh_list[i].oif->intf_name, nh_list[i].node->node_name, get_str_level(nh_list[i].level), nh_list[i].gw_prefix);
-        trace(instance->traceopts, DIJKSTRA_BIT);
 #endif
     }
 }
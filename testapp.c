@@ -32,7 +32,11 @@
 
 #include "instance.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
 #include "libcli.h"
+#include "topo_loader.h"
+#include "topo_snapshot.h"
 
 /*import from spfdcm.c*/
 extern void
@@ -68,9 +72,47 @@ instance_t *instance = NULL;
 int
 main(int argc, char **argv){
 
+    int opt;
+    char *topo_file_name = NULL,
+         *snapshot_file_name = NULL;
+
+    /*rpd [-f <topology-file>] [-s <snapshot-file>]*/
+    while((opt = getopt(argc, argv, "f:s:")) != -1){
+        switch(opt){
+            case 'f':
+                topo_file_name = optarg;
+                break;
+            case 's':
+                snapshot_file_name = optarg;
+                break;
+            default:
+                printf("Usage : %s [-f <topology-file>] [-s <snapshot-file>]\n", argv[0]);
+                return 1;
+        }
+    }
+
     /* Lib cli initialization */
     spf_init_dcm();
 
+    if(topo_file_name){
+        instance = topo_load_file(topo_file_name);
+        if(!instance)
+            return 1;
+    }
+
+    /*A mapped snapshot needs no instance, SPF runs over the mapped arrays*/
+    if(snapshot_file_name){
+        if(topo_snapshot_load(snapshot_file_name) < 0)
+            return 1;
+        if(!instance)
+            instance = get_new_instance();
+    }
+
+    if(topo_file_name || snapshot_file_name){
+        start_shell();
+        return 0;
+    }
+
     /* Topology Initialization*/
     //instance = build_linear_topo();
     //instance = pseudonode_ecmp_topo();
@@ -48,8 +48,14 @@ typedef struct fn_ptr_arg_{
     tilfa_info_t *tilfa_info;
     protected_resource_t *pr_res;
     LEVEL level;
+    spf_path_dag_t *dag;            /*post-convergence spf paths to the destination*/
+    unsigned char *q_node_test;     /*Q-node test result per DAG node*/
 } fn_ptr_arg_t;
 
+#define TILFA_Q_NODE_TEST_UNKNOWN   0
+#define TILFA_Q_NODE_TEST_PASS      1
+#define TILFA_Q_NODE_TEST_FAIL      2
+
 static ll_t *
 tilfa_get_post_convergence_spf_result_list(
         tilfa_info_t *tilfa_info, LEVEL level){
@@ -71,6 +77,13 @@ tilfa_get_post_convergence_spf_path_head(
     return &tilfa_info->post_convergence_spf_path[level];
 }
 
+spf_path_result_table_t *
+tilfa_get_post_convergence_spf_path_table(
+        tilfa_info_t *tilfa_info, LEVEL level){
+
+    return &tilfa_info->post_convergence_spf_path_table[level];
+}
+
 static internal_nh_t *
 tilfa_lookup_pre_convergence_primary_nexthops
             (tilfa_info_t *tilfa_info, node_t *node, LEVEL level){
@@ -113,97 +126,211 @@ tilfa_dist_from_self(tilfa_info_t *tilfa_info,
     return (uint32_t)res->spf_metric;
 }
 
-static ll_t *
-tilfa_get_remote_spf_result_lst(tilfa_info_t *tilfa_info, 
-                             node_t *node, LEVEL level,
-                             boolean flush_old_lst,
-                             boolean reverse_spf){
+static tilfa_remote_spf_cache_t tilfa_remote_spf_cache[MAX_LEVEL];
 
-    singly_ll_node_t *curr = NULL, *prev = NULL;
-    singly_ll_node_t *curr1 = NULL, *prev1 = NULL;
-
-    spf_result_t *spf_res = NULL;
-    tilfa_remote_spf_result_t *tilfa_rem_spf_result = NULL;
+static void
+tilfa_remote_spf_cache_flush(tilfa_remote_spf_cache_t *cache, LEVEL level){
 
-    ll_t *inner_lst = NULL;
-    
-    ll_t *outer_lst = reverse_spf ? 
-        tilfa_info->pre_convergence_remote_reverse_spf_results[level] : 
-        tilfa_info->pre_convergence_remote_forward_spf_results[level]; 
-    
-    assert(node);
+    unsigned int i = 0;
+    node_t *node = NULL;
+    singly_ll_node_t *list_node = NULL;
 
-    ITERATE_LIST_BEGIN2(outer_lst, curr, prev){
+    cache->node_count = 0;
+    ITERATE_LIST_BEGIN(instance->instance_node_list, list_node){
 
-        tilfa_rem_spf_result = curr->data;
-        if(tilfa_rem_spf_result->node == node){
-            inner_lst = tilfa_rem_spf_result->rem_spf_result_lst;
-            
-            if(!flush_old_lst) return inner_lst;
-
-            ITERATE_LIST_BEGIN2(inner_lst, curr1, prev1){    
-                spf_res = curr1->data;
-                XFREE(spf_res);
-            }ITERATE_LIST_END2(inner_lst, curr1, prev1);
-            delete_singly_ll(inner_lst);
-            return inner_lst;
+        node = list_node->data;
+        if(cache->node_count == cache->node_alloc){
+            cache->node_alloc = cache->node_alloc ? cache->node_alloc * 2 : 64;
+            cache->nodes = realloc(cache->nodes, 
+                            cache->node_alloc * sizeof(node_t *));
+            assert(cache->nodes);
         }
-    } ITERATE_LIST_END2(outer_lst, curr, prev);
+        node->tilfa_rspf_index[level] = cache->node_count;
+        node->tilfa_rspf_row[level][0] = TILFA_REMOTE_SPF_ROW_NONE;
+        node->tilfa_rspf_row[level][1] = TILFA_REMOTE_SPF_ROW_NONE;
+        cache->nodes[cache->node_count++] = node;
+    } ITERATE_LIST_END;
 
-    tilfa_rem_spf_result = XCALLOC(1, tilfa_remote_spf_result_t);
-    tilfa_rem_spf_result->node = node;
-    tilfa_rem_spf_result->rem_spf_result_lst = init_singly_ll();
+    for(i = 0; i < cache->row_count; i++){
+        cache->rows[i].root = NULL;
+    }
+    cache->row_count = 0;
+    cache->row_max = cache->node_count ? 
+        TILFA_REMOTE_SPF_CACHE_MAX_BYTES / (cache->node_count * sizeof(unsigned int)) : 0;
+    if(cache->row_max < 1)
+        cache->row_max = 1;
+    cache->lru_head = TILFA_REMOTE_SPF_ROW_NONE;
+    cache->lru_tail = TILFA_REMOTE_SPF_ROW_NONE;
+
+    cache->instance = instance;
+    cache->topo_version = instance->topo_version[level];
+    cache->valid = TRUE;
+    cache->flushes++;
+}
 
-    singly_ll_set_comparison_fn(
-            tilfa_rem_spf_result->rem_spf_result_lst,
-            spf_run_result_comparison_fn);
+static inline boolean
+is_tilfa_remote_spf_cache_indexed(tilfa_remote_spf_cache_t *cache,
+                                  node_t *node, LEVEL level){
+
+    unsigned int index = node->tilfa_rspf_index[level];
 
-    singly_ll_add_node_by_val(outer_lst, (void *)tilfa_rem_spf_result);
-    return tilfa_rem_spf_result->rem_spf_result_lst;
+    return index < cache->node_count && cache->nodes[index] == node;
 }
 
+static void
+tilfa_remote_spf_cache_lru_unlink(tilfa_remote_spf_cache_t *cache, int row){
 
-static uint32_t
-tilfa_dist_from_x_to_y(tilfa_info_t *tilfa_info,
-                node_t *x, node_t *y, LEVEL level){
+    tilfa_remote_spf_row_t *rem_row = &cache->rows[row];
 
-    /*Get spf result of remote node X*/
-    ll_t *x_spf_result_lst = 
-        tilfa_get_remote_spf_result_lst(tilfa_info, x, level, FALSE, FALSE);
+    if(rem_row->lru_prev != TILFA_REMOTE_SPF_ROW_NONE)
+        cache->rows[rem_row->lru_prev].lru_next = rem_row->lru_next;
+    else
+        cache->lru_head = rem_row->lru_next;
+
+    if(rem_row->lru_next != TILFA_REMOTE_SPF_ROW_NONE)
+        cache->rows[rem_row->lru_next].lru_prev = rem_row->lru_prev;
+    else
+        cache->lru_tail = rem_row->lru_prev;
+}
 
-    if(is_singly_ll_empty(x_spf_result_lst)){
-        spf_computation(x, &x->spf_info, level, 
-            TILFA_RUN, x_spf_result_lst);
+static void
+tilfa_remote_spf_cache_lru_add_head(tilfa_remote_spf_cache_t *cache, int row){
+
+    tilfa_remote_spf_row_t *rem_row = &cache->rows[row];
+
+    rem_row->lru_prev = TILFA_REMOTE_SPF_ROW_NONE;
+    rem_row->lru_next = cache->lru_head;
+    if(cache->lru_head != TILFA_REMOTE_SPF_ROW_NONE)
+        cache->rows[cache->lru_head].lru_prev = row;
+    else
+        cache->lru_tail = row;
+    cache->lru_head = row;
+}
+
+/*Grab a free row, or recycle the least recently used one*/
+static int
+tilfa_remote_spf_cache_alloc_row(tilfa_remote_spf_cache_t *cache, LEVEL level){
+
+    int row = TILFA_REMOTE_SPF_ROW_NONE;
+    tilfa_remote_spf_row_t *rem_row = NULL;
+
+    if(cache->row_count < cache->row_max){
+
+        if(cache->row_count == cache->row_alloc){
+            cache->row_alloc = cache->row_alloc ? cache->row_alloc * 2 : 16;
+            if(cache->row_alloc > cache->row_max)
+                cache->row_alloc = cache->row_max;
+            cache->rows = realloc(cache->rows, 
+                            cache->row_alloc * sizeof(tilfa_remote_spf_row_t));
+            cache->dist = realloc(cache->dist, 
+                            (size_t)cache->row_alloc * cache->node_count * sizeof(unsigned int));
+            assert(cache->rows && cache->dist);
+        }
+        return cache->row_count++;
     }
 
-    spf_result_t *y_res = singly_ll_search_by_key(
-                x_spf_result_lst, (void *)y); 
+    row = cache->lru_tail;
+    assert(row != TILFA_REMOTE_SPF_ROW_NONE);
+    tilfa_remote_spf_cache_lru_unlink(cache, row);
+    rem_row = &cache->rows[row];
+    rem_row->root->tilfa_rspf_row[level][rem_row->reverse_spf ? 1 : 0] = 
+        TILFA_REMOTE_SPF_ROW_NONE;
+    rem_row->root = NULL;
+    cache->evictions++;
+    return row;
+}
+
+/* Distance row of the forward (DIST(root, *)) or reverse (DIST(*, root))
+ * SPF rooted at root, indexed by node->tilfa_rspf_index[level]. The row
+ * stays valid till the next lookup*/
+static unsigned int *
+tilfa_remote_spf_cache_lookup(node_t *root, LEVEL level, boolean reverse_spf){
+
+    int row = TILFA_REMOTE_SPF_ROW_NONE;
+    unsigned int i = 0,
+                 *dist = NULL;
+    spf_result_t *res = NULL;
+    singly_ll_node_t *curr = NULL, *prev = NULL;
+    ll_t *res_lst = NULL;
+    tilfa_remote_spf_cache_t *cache = &tilfa_remote_spf_cache[level];
 
-    if(!y_res) return INFINITE_METRIC;
+    if(!cache->valid || cache->instance != instance ||
+            cache->topo_version != instance->topo_version[level] ||
+            !is_tilfa_remote_spf_cache_indexed(cache, root, level)){
+        tilfa_remote_spf_cache_flush(cache, level);
+    }
 
-    return (uint32_t)y_res->spf_metric;
+    row = root->tilfa_rspf_row[level][reverse_spf ? 1 : 0];
+    if(row != TILFA_REMOTE_SPF_ROW_NONE){
+        cache->hits++;
+        tilfa_remote_spf_cache_lru_unlink(cache, row);
+        tilfa_remote_spf_cache_lru_add_head(cache, row);
+        return &cache->dist[(size_t)row * cache->node_count];
+    }
+
+    cache->misses++;
+    row = tilfa_remote_spf_cache_alloc_row(cache, level);
+    cache->rows[row].root = root;
+    cache->rows[row].reverse_spf = reverse_spf;
+    root->tilfa_rspf_row[level][reverse_spf ? 1 : 0] = row;
+    tilfa_remote_spf_cache_lru_add_head(cache, row);
+
+    dist = &cache->dist[(size_t)row * cache->node_count];
+    for(i = 0; i < cache->node_count; i++){
+        dist[i] = INFINITE_METRIC;
+    }
+
+    res_lst = init_singly_ll();
+    singly_ll_set_comparison_fn(res_lst, spf_run_result_comparison_fn);
+
+    if(reverse_spf)
+        inverse_topology(instance, level);
+    spf_computation(root, &root->spf_info, level, 
+            TILFA_RUN, res_lst);
+    if(reverse_spf)
+        inverse_topology(instance, level);
+
+    ITERATE_LIST_BEGIN2(res_lst, curr, prev){
+
+        res = curr->data;
+        if(is_tilfa_remote_spf_cache_indexed(cache, res->node, level))
+            dist[res->node->tilfa_rspf_index[level]] = (unsigned int)res->spf_metric;
+        XFREE(res);
+        curr->data = NULL;
+    } ITERATE_LIST_END2(res_lst, curr, prev);
+
+    delete_singly_ll(res_lst);
+    XFREE(res_lst);
+    return dist;
 }
 
 static uint32_t
-tilfa_dist_from_x_to_y_reverse_spf(tilfa_info_t *tilfa_info,
+tilfa_dist_from_x_to_y(tilfa_info_t *tilfa_info,
                 node_t *x, node_t *y, LEVEL level){
 
-    ll_t *y_spf_result_lst = 
-        tilfa_get_remote_spf_result_lst(tilfa_info, y, level, FALSE, TRUE);
+    /*Get spf result of remote node X*/
+    unsigned int *x_dist = 
+        tilfa_remote_spf_cache_lookup(x, level, FALSE);
 
-    if(is_singly_ll_empty(y_spf_result_lst)){
-        inverse_topology(instance, level);
-        spf_computation(y, &y->spf_info, level, 
-            TILFA_RUN, y_spf_result_lst);
-        inverse_topology(instance, level);
-    }
+    if(!is_tilfa_remote_spf_cache_indexed(
+            &tilfa_remote_spf_cache[level], y, level))
+        return INFINITE_METRIC;
 
-    spf_result_t *x_res = singly_ll_search_by_key(
-                y_spf_result_lst, (void *)x); 
+    return (uint32_t)x_dist[y->tilfa_rspf_index[level]];
+}
 
-    if(!x_res) return INFINITE_METRIC;
+static uint32_t
+tilfa_dist_from_x_to_y_reverse_spf(tilfa_info_t *tilfa_info,
+                node_t *x, node_t *y, LEVEL level){
+
+    unsigned int *y_dist = 
+        tilfa_remote_spf_cache_lookup(y, level, TRUE);
+
+    if(!is_tilfa_remote_spf_cache_indexed(
+            &tilfa_remote_spf_cache[level], x, level))
+        return INFINITE_METRIC;
 
-    return (uint32_t)x_res->spf_metric;
+    return (uint32_t)y_dist[x->tilfa_rspf_index[level]];
 }
 
 void
@@ -216,6 +343,7 @@ init_tilfa(node_t *node){
     node->tilfa_info = XCALLOC(1, tilfa_info_t);
     
     node->tilfa_info->tilfa_gl_var.max_segments_allowed = TILFA_MAX_SEGMENTS;
+    node->tilfa_info->tilfa_gl_var.incremental_spf = TRUE;
     init_glthread(&node->tilfa_info->tilfa_lcl_config_head);
     node->tilfa_info->current_resource_pruned = NULL;
     
@@ -231,19 +359,14 @@ init_tilfa(node_t *node){
         singly_ll_set_comparison_fn(node->tilfa_info->\
             tilfa_post_convergence_spf_results[level_it], spf_run_result_comparison_fn);
 
-        node->tilfa_info->pre_convergence_remote_reverse_spf_results[level_it] = init_singly_ll();
-        singly_ll_set_comparison_fn(node->tilfa_info->\
-            pre_convergence_remote_reverse_spf_results[level_it], 
-            spf_run_result_comparison_fn);
-
-        init_glthread(&(node->tilfa_info->post_convergence_spf_path[level_it]));
+        spf_path_result_table_init(
+            &node->tilfa_info->post_convergence_spf_path_table[level_it],
+            &node->tilfa_info->post_convergence_spf_path[level_it]);
 
-        node->tilfa_info->pre_convergence_remote_forward_spf_results[level_it] = init_singly_ll();
-    
         init_glthread(&node->tilfa_info->tilfa_segment_list_head[level_it]);
     }
 
-    node->tilfa_info->is_tilfa_pruned = FALSE;
+    tilfa_prune_mask_clear(node);
 }
 
 boolean
@@ -329,6 +452,8 @@ show_tilfa_database(node_t *node){
     printf("Tilfa Globals : \n");
     printf("\tmax_segments_allowed = %d\n", 
         tilfa_info->tilfa_gl_var.max_segments_allowed);
+    printf("\tpost-convergence spf = %s\n",
+        tilfa_info->tilfa_gl_var.incremental_spf ? "incremental" : "full");
     printf("\tTilfa Config : \n");
     
     ITERATE_GLTHREAD_BEGIN(&tilfa_info->tilfa_lcl_config_head, curr){
@@ -362,45 +487,275 @@ show_tilfa_database(node_t *node){
 
             for(i = 0 ; i < tilfa_segment_list->n_segment_list; i++){
                 printf("%s\n", tilfa_print_one_liner_segment_list
-                    (&tilfa_segment_list->gen_segment_list[i], TRUE, TRUE));
+                    (tilfa_segment_list->gen_segment_list[i], TRUE, TRUE));
             }
         } ITERATE_GLTHREAD_END(&tilfa_info->tilfa_segment_list_head[level_it], curr);
     }
+
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+
+        tilfa_seglist_pool_t *pool = &tilfa_info->seglist_pool[level_it];
+
+        if(!pool->count) continue;
+        printf("\tSID lists %s : %u stored, %lu shared\n",
+                get_str_level(level_it), pool->count, pool->shared);
+    }
+
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+
+        tilfa_remote_spf_cache_t *cache = &tilfa_remote_spf_cache[level_it];
+
+        if(!cache->hits && !cache->misses) continue;
+        printf("\tRemote SPF cache %s : %u/%u rows, %lu hits, %lu misses, %lu evictions, %u flushes\n",
+                get_str_level(level_it), cache->row_count, cache->row_max,
+                cache->hits, cache->misses, cache->evictions, cache->flushes);
+    }
+
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+
+        tilfa_pre_spt_t *pre_spt = &tilfa_info->pre_spt[level_it];
+
+        if(!pre_spt->incremental_runs) continue;
+        printf("\tIncremental post-convergence SPF %s : %u runs, %lu nodes re-settled, %lu nodes reused\n",
+                get_str_level(level_it), pre_spt->incremental_runs,
+                pre_spt->resettled, pre_spt->reused);
+    }
 }
 
 void
-tilfa_clear_post_convergence_spf_path(
-        glthread_t *post_convergence_spf_path_head){
+tilfa_clear_post_convergence_spf_path(tilfa_info_t *tilfa_info, LEVEL level){
 
-    glthread_t *curr = NULL, *curr1= NULL;
-    spf_path_result_t *spf_path_result = NULL;
-    pred_info_t *pred_info = NULL;
+    spf_path_result_table_reset(
+        &tilfa_info->post_convergence_spf_path_table[level]);
+}
 
-        ITERATE_GLTHREAD_BEGIN(post_convergence_spf_path_head, curr){
+#define TILFA_SEGLIST_HASH_INIT     2166136261U
+#define TILFA_SEGLIST_HASH_PRIME    16777619U
 
-            spf_path_result = glthread_to_spf_path_result(curr);
+static inline uint32_t
+tilfa_seglist_hash_bytes(uint32_t hash, const void *data, size_t len){
 
-            ITERATE_GLTHREAD_BEGIN(&spf_path_result->pred_db, curr1){
+    const unsigned char *byte = data;
 
-                pred_info = glthread_to_pred_info(curr1);
-                remove_glthread(&pred_info->glue);
-                XFREE(pred_info);
-            } ITERATE_GLTHREAD_END(&spf_path_result->pred_db, curr1);
+    while(len--){
+        hash ^= *byte++;
+        hash *= TILFA_SEGLIST_HASH_PRIME;
+    }
+    return hash;
+}
 
-            remove_glthread(&spf_path_result->glue);
-            XFREE(spf_path_result);
-        } ITERATE_GLTHREAD_END(post_convergence_spf_path_head, curr);
+static uint32_t
+tilfa_seglist_hash_stack(uint32_t hash, 
+                         struct s_t *mpls_label_out,
+                         MPLS_STACK_OP *stack_op){
+
+    int i = 0;
 
-        init_glthread(post_convergence_spf_path_head);
+    for(i = 0; i < MPLS_STACK_OP_LIMIT_MAX; i++){
+
+        if(stack_op[i] == STACK_OPS_UNKNOWN) break;
+
+        hash = tilfa_seglist_hash_bytes(hash, &stack_op[i], sizeof(MPLS_STACK_OP));
+        hash = tilfa_seglist_hash_bytes(hash, &mpls_label_out[i].seg_type, 
+                    sizeof(tilfa_seg_type));
+        if(mpls_label_out[i].seg_type == TILFA_PREFIX_SID_REFERENCE){
+            hash = tilfa_seglist_hash_bytes(hash, &mpls_label_out[i].u.node, 
+                    sizeof(node_t *));
+        }
+        else{
+            hash = tilfa_seglist_hash_bytes(hash, &mpls_label_out[i].u.adj_sid,
+                    sizeof(mpls_label_out[i].u.adj_sid));
+        }
+    }
+    return hash;
+}
+
+/*Hash of the canonical form of the SID list*/
+static uint32_t
+tilfa_gen_segment_list_hash(gen_segment_list_t *gen_segment_list){
+
+    uint32_t hash = TILFA_SEGLIST_HASH_INIT;
+
+    hash = tilfa_seglist_hash_bytes(hash, &gen_segment_list->oif, 
+                sizeof(interface_t *));
+    hash = tilfa_seglist_hash_bytes(hash, gen_segment_list->gw_ip, 
+                strlen(gen_segment_list->gw_ip));
+    hash = tilfa_seglist_hash_bytes(hash, &gen_segment_list->nxthop,
+                sizeof(node_t *));
+    hash = tilfa_seglist_hash_bytes(hash, &gen_segment_list->is_fhs_rsvp_lsp,
+                sizeof(boolean));
+    hash = tilfa_seglist_hash_stack(hash, gen_segment_list->inet3_mpls_label_out,
+                gen_segment_list->inet3_stack_op);
+    hash = tilfa_seglist_hash_stack(hash, gen_segment_list->mpls0_mpls_label_out,
+                gen_segment_list->mpls0_stack_op);
+    return hash;
+}
+
+static boolean
+tilfa_is_identical_seglist_stack(struct s_t *mpls_label_out1,
+                                 MPLS_STACK_OP *stack_op1,
+                                 struct s_t *mpls_label_out2,
+                                 MPLS_STACK_OP *stack_op2){
+
+    int i = 0;
+
+    for(i = 0; i < MPLS_STACK_OP_LIMIT_MAX; i++){
+
+        if(stack_op1[i] != stack_op2[i])
+            return FALSE;
+        if(stack_op1[i] == STACK_OPS_UNKNOWN)
+            return TRUE;
+        if(mpls_label_out1[i].seg_type != mpls_label_out2[i].seg_type)
+            return FALSE;
+        if(mpls_label_out1[i].seg_type == TILFA_PREFIX_SID_REFERENCE){
+            if(mpls_label_out1[i].u.node != mpls_label_out2[i].u.node)
+                return FALSE;
+            continue;
+        }
+        if(mpls_label_out1[i].u.adj_sid.adj_sid != mpls_label_out2[i].u.adj_sid.adj_sid ||
+           mpls_label_out1[i].u.adj_sid.from_node != mpls_label_out2[i].u.adj_sid.from_node ||
+           mpls_label_out1[i].u.adj_sid.to_node != mpls_label_out2[i].u.adj_sid.to_node)
+            return FALSE;
+    }
+    return TRUE;
+}
+
+static boolean
+tilfa_is_identical_gen_segment_list(
+    gen_segment_list_t *gen_segment_list1,
+    gen_segment_list_t *gen_segment_list2){
+
+    if(gen_segment_list1->oif != gen_segment_list2->oif ||
+       gen_segment_list1->nxthop != gen_segment_list2->nxthop ||
+       gen_segment_list1->is_fhs_rsvp_lsp != gen_segment_list2->is_fhs_rsvp_lsp ||
+       strncmp(gen_segment_list1->gw_ip, gen_segment_list2->gw_ip, PREFIX_LEN))
+        return FALSE;
+
+    return tilfa_is_identical_seglist_stack(
+                gen_segment_list1->inet3_mpls_label_out,
+                gen_segment_list1->inet3_stack_op,
+                gen_segment_list2->inet3_mpls_label_out,
+                gen_segment_list2->inet3_stack_op) &&
+           tilfa_is_identical_seglist_stack(
+                gen_segment_list1->mpls0_mpls_label_out,
+                gen_segment_list1->mpls0_stack_op,
+                gen_segment_list2->mpls0_mpls_label_out,
+                gen_segment_list2->mpls0_stack_op);
+}
+
+static inline tilfa_seglist_entry_t *
+tilfa_gen_segment_list_to_seglist_entry(gen_segment_list_t *gen_segment_list){
+
+    return (tilfa_seglist_entry_t *)((char *)gen_segment_list - 
+            offsetof(tilfa_seglist_entry_t, gen_segment_list));
+}
+
+static void
+tilfa_seglist_pool_resize(tilfa_seglist_pool_t *pool, unsigned int n_buckets){
+
+    unsigned int i = 0;
+    tilfa_seglist_entry_t *entry = NULL,
+                          *next = NULL;
+    tilfa_seglist_entry_t **buckets = calloc(n_buckets, 
+                            sizeof(tilfa_seglist_entry_t *));
+
+    for(i = 0; i < pool->n_buckets; i++){
+        for(entry = pool->buckets[i]; entry; entry = next){
+            next = entry->next;
+            entry->next = buckets[entry->hash & (n_buckets - 1)];
+            buckets[entry->hash & (n_buckets - 1)] = entry;
+        }
+    }
+    free(pool->buckets);
+    pool->buckets = buckets;
+    pool->n_buckets = n_buckets;
+}
+
+/* Return the stored copy of the SID list, storing it first if
+ * not seen before. Caller holds a reference on the stored copy*/
+static gen_segment_list_t *
+tilfa_seglist_pool_get(tilfa_seglist_pool_t *pool, 
+                       gen_segment_list_t *gen_segment_list){
+
+    uint32_t hash = tilfa_gen_segment_list_hash(gen_segment_list);
+    tilfa_seglist_entry_t *entry = NULL;
+
+    if(!pool->n_buckets)
+        tilfa_seglist_pool_resize(pool, 64);
+
+    for(entry = pool->buckets[hash & (pool->n_buckets - 1)]; 
+            entry; entry = entry->next){
+
+        if(entry->hash == hash && 
+            tilfa_is_identical_gen_segment_list(
+                &entry->gen_segment_list, gen_segment_list)){
+            entry->ref_count++;
+            pool->shared++;
+            return &entry->gen_segment_list;
+        }
+    }
+
+    if(pool->count >= pool->n_buckets)
+        tilfa_seglist_pool_resize(pool, pool->n_buckets * 2);
+
+    entry = calloc(1, sizeof(tilfa_seglist_entry_t));
+    entry->hash = hash;
+    entry->ref_count = 1;
+    memcpy(&entry->gen_segment_list, gen_segment_list, 
+            sizeof(gen_segment_list_t));
+    entry->next = pool->buckets[hash & (pool->n_buckets - 1)];
+    pool->buckets[hash & (pool->n_buckets - 1)] = entry;
+    pool->count++;
+    return &entry->gen_segment_list;
+}
+
+static void
+tilfa_seglist_pool_put(tilfa_seglist_pool_t *pool, 
+                       gen_segment_list_t *gen_segment_list){
+
+    tilfa_seglist_entry_t **link = NULL;
+    tilfa_seglist_entry_t *entry = 
+        tilfa_gen_segment_list_to_seglist_entry(gen_segment_list);
+
+    assert(entry->ref_count);
+    if(--entry->ref_count) return;
+
+    for(link = &pool->buckets[entry->hash & (pool->n_buckets - 1)]; 
+            *link; link = &(*link)->next){
+
+        if(*link != entry) continue;
+        *link = entry->next;
+        pool->count--;
+        free(entry);
+        return;
+    }
+    assert(0);
+}
+
+static void
+tilfa_free_segment_list(tilfa_info_t *tilfa_info, LEVEL level,
+                        tilfa_segment_list_t *tilfa_segment_list){
+
+    int i = 0;
+
+    for(i = 0; i < tilfa_segment_list->n_segment_list; i++){
+        tilfa_seglist_pool_put(&tilfa_info->seglist_pool[level],
+            tilfa_segment_list->gen_segment_list[i]);
+    }
+    tilfa_unlock_protected_resource(tilfa_segment_list->pr_res);
+    free(tilfa_segment_list);
 }
 
 static void
 tilfa_clear_segments_list(
-        glthread_t *tilfa_segment_list_head, 
+        tilfa_info_t *tilfa_info,
+        LEVEL level,
         protected_resource_t *pr_res){
 
     glthread_t *curr;
     tilfa_segment_list_t *tilfa_segment_list = NULL;
+    glthread_t *tilfa_segment_list_head = 
+        &tilfa_info->tilfa_segment_list_head[level];
 
     ITERATE_GLTHREAD_BEGIN(tilfa_segment_list_head, curr){
 
@@ -408,22 +763,33 @@ tilfa_clear_segments_list(
         
         if(!pr_res){
             remove_glthread(&tilfa_segment_list->gen_segment_list_glue);
-            tilfa_unlock_protected_resource(tilfa_segment_list->pr_res);
-            free(tilfa_segment_list);
+            tilfa_free_segment_list(tilfa_info, level, tilfa_segment_list);
             tilfa_segment_list = NULL;
             continue;
         }
         else if(tlfa_protected_resource_equal(tilfa_segment_list->pr_res,
                     pr_res)){
             remove_glthread(&tilfa_segment_list->gen_segment_list_glue);
-            tilfa_unlock_protected_resource(tilfa_segment_list->pr_res);
-            free(tilfa_segment_list);
+            tilfa_free_segment_list(tilfa_info, level, tilfa_segment_list);
             tilfa_segment_list = NULL;
             return;
         }
     } ITERATE_GLTHREAD_END(tilfa_segment_list_head, curr);
 }
 
+static void
+tilfa_clear_pre_spt(tilfa_pre_spt_t *pre_spt){
+
+    unsigned int i = 0;
+
+    for(i = 0; i < pre_spt->count; i++){
+        if(pre_spt->nodes[i].is_res_private){
+            XFREE(pre_spt->nodes[i].res);
+        }
+    }
+    pre_spt->count = 0;
+}
+
 static void
 tilfa_clear_all_pre_convergence_results(node_t *node, LEVEL level){
 
@@ -444,11 +810,9 @@ tilfa_clear_all_pre_convergence_results(node_t *node, LEVEL level){
    
    delete_singly_ll(tilfa_info->tilfa_pre_convergence_spf_results[level]);
 
-   tilfa_clear_preconvergence_remote_spf_results(tilfa_info, 0, level, FALSE);
-   
-   tilfa_clear_preconvergence_remote_spf_results(tilfa_info, 0, level, TRUE);
+   tilfa_clear_segments_list(tilfa_info, level, 0);
 
-   tilfa_clear_segments_list(&(tilfa_info->tilfa_segment_list_head[level]), 0);
+   tilfa_clear_pre_spt(&tilfa_info->pre_spt[level]);
 }
 
 static void
@@ -472,39 +836,362 @@ tilfa_clear_all_post_convergence_results(node_t *spf_root, LEVEL level,
 
     delete_singly_ll(tilfa_info->tilfa_post_convergence_spf_results[level]);
 
-    tilfa_clear_post_convergence_spf_path(
-            tilfa_get_post_convergence_spf_path_head(spf_root->tilfa_info, level));
+    tilfa_clear_post_convergence_spf_path(tilfa_info, level);
 
-    tilfa_clear_segments_list(&(tilfa_info->tilfa_segment_list_head[level]), pr_res);
+    tilfa_clear_segments_list(tilfa_info, level, pr_res);
 }
 
-boolean
-tilfa_topology_prune_protected_resource(node_t *node,
+void
+tilfa_prune_mask_set(node_t *node,
     protected_resource_t *pr_res){
 
     assert(pr_res);
     assert(pr_res->plr_node == node);
     edge_t *link = GET_EGDE_PTR_FROM_FROM_EDGE_END(pr_res->protected_link);
-    if(pr_res->link_protection){
-        link->is_tilfa_pruned = TRUE;
+    tilfa_prune_mask_t *prune_mask = &node->tilfa_info->prune_mask;
+
+    prune_mask->link = pr_res->link_protection ? link : NULL;
+    prune_mask->node = pr_res->node_protection ? link->to.node : NULL;
+}
+
+void
+tilfa_prune_mask_clear(node_t *node){
+
+    node->tilfa_info->prune_mask.link = NULL;
+    node->tilfa_info->prune_mask.node = NULL;
+}
+
+static tilfa_spt_node_t *
+tilfa_pre_spt_lookup(tilfa_pre_spt_t *pre_spt, node_t *node, LEVEL level){
+
+    unsigned int index = node->tilfa_spt_index[level];
+
+    if(index < pre_spt->count && pre_spt->nodes[index].node == node)
+        return &pre_spt->nodes[index];
+    return NULL;
+}
+
+static void
+tilfa_pre_spt_add(tilfa_pre_spt_t *pre_spt, node_t *node, LEVEL level){
+
+    tilfa_spt_node_t *spt_node = NULL;
+
+    if(pre_spt->count == pre_spt->alloc){
+        pre_spt->alloc = pre_spt->alloc ? pre_spt->alloc * 2 : 64;
+        pre_spt->nodes = realloc(pre_spt->nodes, 
+                            pre_spt->alloc * sizeof(tilfa_spt_node_t));
+        pre_spt->work = realloc(pre_spt->work, 
+                            pre_spt->alloc * sizeof(node_t *));
+        assert(pre_spt->nodes && pre_spt->work);
     }
-    if(pr_res->node_protection){
-        node_t *nbr_node = link->to.node;
-        nbr_node->tilfa_info->is_tilfa_pruned = TRUE;
+
+    spt_node = &pre_spt->nodes[pre_spt->count];
+    memset(spt_node, 0, sizeof(tilfa_spt_node_t));
+    spt_node->node = node;
+    spt_node->spf_metric = node->spf_metric[level];
+    spt_node->lsp_metric = node->lsp_metric[level];
+    spt_node->seq = pre_spt->count;
+    node->tilfa_spt_index[level] = pre_spt->count++;
+}
+
+static LEVEL tilfa_spt_sort_level;
+
+/*Settle order of Dijkstra : by metric, PN ahead of routers at same metric*/
+static int
+tilfa_spt_node_compare_fn(const void *_spt_node1, const void *_spt_node2){
+
+    const tilfa_spt_node_t *spt_node1 = _spt_node1,
+                           *spt_node2 = _spt_node2;
+    boolean is_pn1 = spt_node1->node->node_type[tilfa_spt_sort_level] == PSEUDONODE,
+            is_pn2 = spt_node2->node->node_type[tilfa_spt_sort_level] == PSEUDONODE;
+
+    if(spt_node1->spf_metric != spt_node2->spf_metric)
+        return spt_node1->spf_metric < spt_node2->spf_metric ? -1 : 1;
+    if(is_pn1 != is_pn2)
+        return is_pn1 ? -1 : 1;
+    return spt_node1->seq < spt_node2->seq ? -1 : 1;
+}
+
+/* Record the SPT the pre-convergence SPF has just left on the nodes. Walk
+ * it down from the root along its DAG edges, which reaches every node the
+ * SPF has settled, and sort it in settle order*/
+static void
+tilfa_snapshot_pre_convergence_spt(node_t *spf_root, LEVEL level){
+
+    unsigned int i = 0;
+    nh_type_t nh;
+    node_t *node = NULL, 
+           *nbr_node = NULL;
+    edge_t *edge = NULL;
+    spf_result_t *res = NULL;
+    singly_ll_node_t *list_node = NULL;
+    tilfa_spt_node_t *spt_node = NULL;
+    tilfa_pre_spt_t *pre_spt = &spf_root->tilfa_info->pre_spt[level];
+
+    tilfa_clear_pre_spt(pre_spt);
+    tilfa_pre_spt_add(pre_spt, spf_root, level);
+
+    for(i = 0; i < pre_spt->count; i++){
+
+        node = pre_spt->nodes[i].node;
+        if(IS_OVERLOADED(node, level))
+            continue;
+
+        ITERATE_NODE_LOGICAL_NBRS_BEGIN(node, nbr_node, edge, level){
+
+            if(!is_two_way_nbrship(node, nbr_node, level) || 
+                    edge->status == 0)
+                continue;
+            if((unsigned long long)node->spf_metric[level] + edge->metric[level] != 
+                    (unsigned long long)nbr_node->spf_metric[level])
+                continue;
+            if(tilfa_pre_spt_lookup(pre_spt, nbr_node, level))
+                continue;
+            tilfa_pre_spt_add(pre_spt, nbr_node, level);
+        } ITERATE_NODE_LOGICAL_NBRS_END;
+    }
+
+    ITERATE_LIST_BEGIN(tilfa_get_pre_convergence_spf_result_list(
+                spf_root->tilfa_info, level), list_node){
+
+        res = list_node->data;
+        spt_node = tilfa_pre_spt_lookup(pre_spt, res->node, level);
+        if(spt_node)
+            spt_node->res = res;
+    } ITERATE_LIST_END;
+
+    /*PN are not in the result list, keep their nexthops privately*/
+    for(i = 0; i < pre_spt->count; i++){
+
+        spt_node = &pre_spt->nodes[i];
+        if(spt_node->res) continue;
+
+        node = spt_node->node;
+        res = XCALLOC(1, spf_result_t);
+        res->node = node;
+        res->spf_metric = spt_node->spf_metric;
+        res->lsp_metric = spt_node->lsp_metric;
+        ITERATE_NH_TYPE_BEGIN(nh){
+            copy_nh_list2(&node->next_hop[level][nh][0], &res->next_hop[nh][0]);
+        } ITERATE_NH_TYPE_END;
+        spt_node->res = res;
+        spt_node->is_res_private = TRUE;
+    }
+
+    tilfa_spt_sort_level = level;
+    qsort(pre_spt->nodes, pre_spt->count, sizeof(tilfa_spt_node_t),
+            tilfa_spt_node_compare_fn);
+
+    for(i = 0; i < pre_spt->count; i++){
+        pre_spt->nodes[i].node->tilfa_spt_index[level] = i;
     }
-    return TRUE; 
 }
 
-void
-tilfa_topology_unprune_protected_resource(node_t *node,
-    protected_resource_t *pr_res){
+/*Does the pre-convergence SPT reach the far end of the link over it*/
+static boolean
+tilfa_pre_spt_is_link_used(tilfa_spt_node_t *spt_node, 
+                           edge_t *link, LEVEL level){
 
-    assert(pr_res);
-    assert(pr_res->plr_node == node);
-    edge_t *link = GET_EGDE_PTR_FROM_FROM_EDGE_END(pr_res->protected_link);
-    link->is_tilfa_pruned = FALSE;
-    node_t *nbr_node = link->to.node;
-    nbr_node->tilfa_info->is_tilfa_pruned = FALSE;
+    unsigned int i = 0;
+    nh_type_t nh;
+
+    if(link->metric[level] == spt_node->spf_metric)
+        return TRUE;
+
+    ITERATE_NH_TYPE_BEGIN(nh){
+        for(i = 0; i < MAX_NXT_HOPS; i++){
+            if(is_internal_nh_t_empty(spt_node->res->next_hop[nh][i]))
+                break;
+            if(spt_node->res->next_hop[nh][i].oif == &link->from)
+                return TRUE;
+        }
+    } ITERATE_NH_TYPE_END;
+    return FALSE;
+}
+
+/* Invalidate the subtree of the pre-convergence SPT hanging below the
+ * resources in the prune mask of spf_root, and mark the nodes of the rest
+ * of the SPT which are adjacent to it as frontier. Returns the number of
+ * invalidated nodes, frontier nodes are collected in pre_spt->work*/
+static unsigned int
+tilfa_pre_spt_invalidate(node_t *spf_root, LEVEL level, 
+                         unsigned int *n_frontier){
+
+    unsigned int i = 0,
+                 n_invalidated = 0;
+    node_t *node = NULL,
+           *nbr_node = NULL;
+    edge_t *edge = NULL;
+    tilfa_spt_node_t *spt_node = NULL,
+                     *nbr_spt_node = NULL;
+    tilfa_pre_spt_t *pre_spt = &spf_root->tilfa_info->pre_spt[level];
+    tilfa_prune_mask_t *prune_mask = &spf_root->tilfa_info->prune_mask;
+
+    for(i = 0; i < pre_spt->count; i++){
+        pre_spt->nodes[i].invalidated = FALSE;
+        pre_spt->nodes[i].frontier = FALSE;
+    }
+
+    if(prune_mask->node){
+        spt_node = tilfa_pre_spt_lookup(pre_spt, prune_mask->node, level);
+        if(spt_node)
+            spt_node->invalidated = TRUE;
+    }
+
+    if(prune_mask->link){
+        spt_node = tilfa_pre_spt_lookup(pre_spt, prune_mask->link->to.node, level);
+        if(spt_node && 
+            tilfa_pre_spt_is_link_used(spt_node, prune_mask->link, level))
+            spt_node->invalidated = TRUE;
+    }
+
+    /*Descendants come later in settle order, one pass invalidates
+     * the whole subtree*/
+    for(i = 0; i < pre_spt->count; i++){
+
+        spt_node = &pre_spt->nodes[i];
+        if(!spt_node->invalidated) continue;
+
+        n_invalidated++;
+        node = spt_node->node;
+        if(IS_OVERLOADED(node, level))
+            continue;
+
+        ITERATE_NODE_LOGICAL_NBRS_BEGIN(node, nbr_node, edge, level){
+
+            if(!is_two_way_nbrship(node, nbr_node, level) || 
+                    edge->status == 0)
+                continue;
+            nbr_spt_node = tilfa_pre_spt_lookup(pre_spt, nbr_node, level);
+            if(!nbr_spt_node || nbr_spt_node->invalidated)
+                continue;
+            if((unsigned long long)spt_node->spf_metric + edge->metric[level] ==
+                    (unsigned long long)nbr_spt_node->spf_metric)
+                nbr_spt_node->invalidated = TRUE;
+        } ITERATE_NODE_LOGICAL_NBRS_END;
+    }
+
+    *n_frontier = 0;
+    if(!n_invalidated)
+        return 0;
+
+    for(i = 0; i < pre_spt->count; i++){
+
+        spt_node = &pre_spt->nodes[i];
+        if(!spt_node->invalidated) continue;
+
+        node = spt_node->node;
+        ITERATE_NODE_LOGICAL_NBRS_BEGIN(node, nbr_node, edge, level){
+
+            nbr_spt_node = tilfa_pre_spt_lookup(pre_spt, nbr_node, level);
+            if(!nbr_spt_node || nbr_spt_node->invalidated ||
+                    nbr_spt_node->frontier)
+                continue;
+            nbr_spt_node->frontier = TRUE;
+            pre_spt->work[(*n_frontier)++] = nbr_node;
+        } ITERATE_NODE_LOGICAL_NBRS_END;
+    }
+    return n_invalidated;
+}
+
+/* Post-convergence SPF starting from the pre-convergence SPT. Pruning a
+ * resource only changes the nodes below it in the SPT, the rest keep
+ * their metric, nexthops and predecessors. Those nodes are frozen and
+ * reused, only the invalidated nodes are re-settled by both the primary
+ * nexthop run and the spf paths run*/
+static void
+tilfa_run_incremental_post_convergence_spf(node_t *spf_root, LEVEL level){
+
+    unsigned int i = 0,
+                 n_invalidated = 0,
+                 n_frontier = 0,
+                 n_settled = 0;
+    nh_type_t nh;
+    node_t *node = NULL;
+    spf_result_t *res = NULL;
+    tilfa_spt_node_t *spt_node = NULL;
+    tilfa_pre_spt_t *pre_spt = &spf_root->tilfa_info->pre_spt[level];
+    ll_t *res_lst = tilfa_get_post_convergence_spf_result_list(
+                        spf_root->tilfa_info, level);
+
+    assert(is_singly_ll_empty(res_lst));
+
+    n_invalidated = tilfa_pre_spt_invalidate(spf_root, level, &n_frontier);
+
+#ifdef __ENABLE_TRACE__
+    SPF_TRACE(TILFA_BIT, "Node : %s : level %s, incremental post-convergence SPF,"
+            " %u of %u nodes invalidated, %u frontier nodes", spf_root->node_name, 
+            get_str_level(level), n_invalidated, pre_spt->count, n_frontier);
+#endif
+
+    /*Primary nexthop run : metrics do not change, frozen nodes
+     * keep their pre-convergence result*/
+    for(i = 0; i < pre_spt->count; i++){
+
+        spt_node = &pre_spt->nodes[i];
+        node = spt_node->node;
+        node->is_node_frozen = !spt_node->invalidated;
+
+        if(spt_node->invalidated){
+            node->spf_metric[level] = INFINITE_METRIC;
+            node->lsp_metric[level] = INFINITE_METRIC;
+            ITERATE_NH_TYPE_BEGIN(nh){
+                empty_nh_list(node, level, nh);
+            } ITERATE_NH_TYPE_END;
+            continue;
+        }
+
+        node->spf_metric[level] = spt_node->spf_metric;
+        node->lsp_metric[level] = spt_node->lsp_metric;
+
+        if(spt_node->frontier){
+            ITERATE_NH_TYPE_BEGIN(nh){
+                copy_nh_list2(&spt_node->res->next_hop[nh][0], 
+                              &node->next_hop[level][nh][0]);
+            } ITERATE_NH_TYPE_END;
+        }
+
+        if(node->node_type[level] == PSEUDONODE)
+            continue;
+
+        res = XCALLOC(1, spf_result_t);
+        res->node = node;
+        res->spf_metric = spt_node->spf_metric;
+        res->lsp_metric = spt_node->lsp_metric;
+        ITERATE_NH_TYPE_BEGIN(nh){
+            copy_nh_list2(&spt_node->res->next_hop[nh][0], &res->next_hop[nh][0]);
+        } ITERATE_NH_TYPE_END;
+        singly_ll_add_node_by_val(res_lst, res);
+    }
+
+    spf_incremental_computation(spf_root, level, pre_spt->work, n_frontier, res_lst);
+
+    /*Spf paths run : frozen nodes are settled in order to rebuild
+     * their predecessors, invalidated nodes are settled afresh*/
+    for(i = 0; i < pre_spt->count; i++){
+
+        spt_node = &pre_spt->nodes[i];
+        node = spt_node->node;
+
+        node->spf_metric[level] = spt_node->invalidated ? 
+                INFINITE_METRIC : spt_node->spf_metric;
+        node->lsp_metric[level] = spt_node->invalidated ? 
+                INFINITE_METRIC : spt_node->lsp_metric;
+        clear_spf_predecessors(&node->pred_lst[level][IPNH]);
+
+        if(!spt_node->invalidated)
+            pre_spt->work[n_settled++] = node;
+    }
+
+    compute_spf_paths_incremental(spf_root, level, pre_spt->work, n_settled);
+
+    for(i = 0; i < pre_spt->count; i++){
+        pre_spt->nodes[i].node->is_node_frozen = FALSE;
+    }
+
+    pre_spt->incremental_runs++;
+    pre_spt->resettled += n_invalidated;
+    pre_spt->reused += pre_spt->count - n_invalidated;
 }
 
 static void
@@ -529,16 +1216,9 @@ spf_path_result_t *
 tilfa_lookup_spf_path_result(node_t *node, node_t *candidate_node, 
                              LEVEL level){
 
-    glthread_t *curr = NULL;
-
-    ITERATE_GLTHREAD_BEGIN(&node->tilfa_info->post_convergence_spf_path[level], curr){
-
-        spf_path_result_t *spf_path_result = glthread_to_spf_path_result(curr);
-        if(spf_path_result->node == candidate_node){
-            return spf_path_result;
-        }
-    } ITERATE_GLTHREAD_END(&node->tilfa_info->post_convergence_spf_path[level], curr);
-    return NULL;    
+    return spf_path_result_table_lookup(
+        &node->tilfa_info->post_convergence_spf_path_table[level], 
+        candidate_node);
 }
 
 static void
@@ -583,9 +1263,8 @@ compute_tilfa(node_t *spf_root, LEVEL level){
     glthread_t *curr;
     tilfa_lcl_config_t *tilfa_lcl_config = NULL;
 
-    sprintf(instance->traceopts->b, "Node : %s : %s() triggered, level %s",
+    SPF_TRACE(SPF_EVENTS_BIT, "Node : %s : %s() triggered, level %s",
         spf_root->node_name, __FUNCTION__, get_str_level(level));
-    trace(instance->traceopts, SPF_EVENTS_BIT);
 
     tilfa_clear_all_pre_convergence_results(spf_root, level);
 
@@ -593,7 +1272,13 @@ compute_tilfa(node_t *spf_root, LEVEL level){
         return;
 
     compute_tilfa_pre_convergence_spf_primary_nexthops(spf_root, level);
+    tilfa_snapshot_pre_convergence_spt(spf_root, level);
 
+    /*Protected resources are evaluated one after another. The prune mask
+     * leaves the topology untouched, but post-convergence SPF state (per node
+     * metrics, nexthops and predecessors, the candidate tree, the remote SPF
+     * cache) and the memory manager are shared by all SPF runs of the
+     * instance, hence runs of two protected resources must not overlap*/
     ITERATE_GLTHREAD_BEGIN(&tilfa_info->tilfa_lcl_config_head, curr){
         
         tilfa_lcl_config = tilfa_lcl_config_to_config_glue(curr);
@@ -608,80 +1293,52 @@ compute_tilfa(node_t *spf_root, LEVEL level){
     } ITERATE_GLTHREAD_END(&tilfa_info->tilfa_lcl_config_head, curr);
 }
 
-/* Pass node as NULL to clear remote spf results of all
- * nodes. Pass reverse_spf as TRUE or FALSE to clear remote
- * spf results for forward or reverse spf run*/
-void
-tilfa_clear_preconvergence_remote_spf_results(tilfa_info_t *tilfa_info,
-                            node_t *node, LEVEL level, 
-                            boolean reverse_spf){
-
-    singly_ll_node_t *curr = NULL, *prev = NULL;
-    singly_ll_node_t *curr1 = NULL, *prev1 = NULL;
-
-    spf_result_t *spf_res = NULL;
-    tilfa_remote_spf_result_t *tilfa_rem_spf_result = NULL;
+spf_path_result_t *
+TILFA_GET_SPF_PATH_RESULT(node_t *spf_root, node_t *node, LEVEL level){
 
-    ll_t *inner_lst = NULL;
-    ll_t *outer_lst = reverse_spf ? 
-        tilfa_info->pre_convergence_remote_reverse_spf_results[level]:
-        tilfa_info->pre_convergence_remote_forward_spf_results[level];
+    return tilfa_lookup_spf_path_result(spf_root, node, level);
+}
 
-    ITERATE_LIST_BEGIN2(outer_lst, curr, prev){
+/*Tilfa CLI handlers*/
+int
+show_tilfa_handler(param_t *param, 
+                   ser_buff_t *tlv_buf, 
+                   op_mode enable_or_disable){
 
-        tilfa_rem_spf_result = curr->data;
-        if(node && tilfa_rem_spf_result->node != node){
-            ITERATE_LIST_CONTINUE2(outer_lst, curr, prev);
-        }
+    int cmdcode = -1;
+    node_t *node = NULL;
+    char *node_name = NULL;
 
-        inner_lst = tilfa_rem_spf_result->rem_spf_result_lst;
+    tlv_struct_t *tlv = NULL;
 
-        ITERATE_LIST_BEGIN2(inner_lst, curr1, prev1){
+    TLV_LOOP_BEGIN(tlv_buf, tlv){
 
-            spf_res = curr1->data;
-            XFREE(spf_res);
-            curr1->data = NULL; 
-        } ITERATE_LIST_END2(inner_lst, curr1, prev1);
-        
-        delete_singly_ll(inner_lst);
-        XFREE(inner_lst);
-        tilfa_rem_spf_result->rem_spf_result_lst = NULL;
+        if(strncmp(tlv->leaf_id, "node-name", strlen("node-name")) ==0)
+            node_name = tlv->value;
+        else
+            assert(0);
+    }TLV_LOOP_END
 
-        XFREE(tilfa_rem_spf_result);
-        ITERATIVE_LIST_NODE_DELETE2(outer_lst, curr, prev);
-        
-        if(node) return;
+    cmdcode = EXTRACT_CMD_CODE(tlv_buf);
+    
+    node = (node_t *)singly_ll_search_by_key(
+            instance->instance_node_list, node_name);
 
-    } ITERATE_LIST_END2(outer_lst, curr, prev);
+    switch(cmdcode){
 
-    if(!node){
-        assert(is_singly_ll_empty(outer_lst));
+        case CMDCODE_DEBUG_SHOW_TILFA:
+            show_tilfa_database(node);
+            break;
+        default:
+            assert(0);
     }
+    return 0;
 }
 
-spf_path_result_t *
-TILFA_GET_SPF_PATH_RESULT(node_t *spf_root, node_t *node, LEVEL level){
-
-    glthread_t *curr = NULL;
-    glthread_t *spf_path_head = 
-        tilfa_get_post_convergence_spf_path_head(spf_root->tilfa_info, level); 
-
-    ITERATE_GLTHREAD_BEGIN(spf_path_head, curr){
-
-        spf_path_result_t *spf_path_result = glthread_to_spf_path_result(curr);
-
-        if(spf_path_result->node == node){
-            return spf_path_result;
-        }
-    } ITERATE_GLTHREAD_END(spf_path_head, curr);
-    return NULL;
-}
-
-/*Tilfa CLI handlers*/
 int
-show_tilfa_handler(param_t *param, 
-                   ser_buff_t *tlv_buf, 
-                   op_mode enable_or_disable){
+config_tilfa_handler(param_t *param, 
+                     ser_buff_t *tlv_buf, 
+                     op_mode enable_or_disable){
 
     int cmdcode = -1;
     node_t *node = NULL;
@@ -704,8 +1361,9 @@ show_tilfa_handler(param_t *param,
 
     switch(cmdcode){
 
-        case CMDCODE_DEBUG_SHOW_TILFA:
-            show_tilfa_database(node);
+        case CMDCODE_CONFIG_NODE_TILFA_INCREMENTAL_SPF:
+            node->tilfa_info->tilfa_gl_var.incremental_spf = 
+                (enable_or_disable == CONFIG_ENABLE);
             break;
         default:
             assert(0);
@@ -714,15 +1372,15 @@ show_tilfa_handler(param_t *param,
 }
 
 boolean
-tilfa_is_link_pruned(edge_t *edge){
+tilfa_is_link_pruned(node_t *spf_root, edge_t *edge){
 
-    return edge->is_tilfa_pruned;
+    return spf_root->tilfa_info->prune_mask.link == edge;
 }
 
 boolean 
-tilfa_is_node_pruned(node_t *node){
+tilfa_is_node_pruned(node_t *spf_root, node_t *node){
 
-    return node->tilfa_info->is_tilfa_pruned;
+    return node && spf_root->tilfa_info->prune_mask.node == node;
 }
 
 /*Code Duplicacy detected !!*/
@@ -897,11 +1555,10 @@ tilfa_p_node_qualification_test_wrt_root(
     if(!dst_pre_convergence_nhps || 
         is_nh_list_empty2(dst_pre_convergence_nhps)){
 
-        sprintf(instance->traceopts->b, "%s() : Root : %s, node_to_test : %s, dst_node : %s, "
+        SPF_TRACE(TILFA_BIT, "%s() : Root : %s, node_to_test : %s, dst_node : %s, "
         "first_hop_node : %s, level %s. Result : %s", __FUNCTION__, spf_root->node_name, 
-        node_to_test->node_name, dst_node->node_name, get_str_level(level), 
-        "FAILED. Reason : No Pre-convergence Primary Nexthops for Destination");
-        trace(instance->traceopts, TILFA_BIT);
+        node_to_test->node_name, dst_node->node_name, first_hop_node->node_name,
+        get_str_level(level), "FAILED. Reason : No Pre-convergence Primary Nexthops for Destination");
         return FALSE;
     }
 
@@ -932,11 +1589,10 @@ tilfa_p_node_qualification_test_wrt_root(
     /*loop XFREE wrt Source*/
     if(!(dist_nbr_to_pnode < dist_nbr_to_S + dist_S_to_pnode)){
         
-        sprintf(instance->traceopts->b, "%s() : Root : %s, node_to_test : %s, dst_node : %s, "
+        SPF_TRACE(TILFA_BIT, "%s() : Root : %s, node_to_test : %s, dst_node : %s, "
         "first_hop_node : %s, level %s. Result : %s", __FUNCTION__, spf_root->node_name, 
         node_to_test->node_name, dst_node->node_name, first_hop_node->node_name, get_str_level(level), 
         "FAILED. Reason : No Loop free wrt Source");
-        trace(instance->traceopts, TILFA_BIT);
         return FALSE;
     }
 
@@ -960,11 +1616,10 @@ tilfa_p_node_qualification_test_wrt_root(
                     first_hop_segments, level) != 0);
         }
         else{
-            sprintf(instance->traceopts->b, "%s() : Root : %s, node_to_test : %s, dst_node : %s, "
+            SPF_TRACE(TILFA_BIT, "%s() : Root : %s, node_to_test : %s, dst_node : %s, "
                     "first_hop_node : %s, level %s. Result : %s", __FUNCTION__, spf_root->node_name, 
                     node_to_test->node_name, dst_node->node_name, first_hop_node->node_name, get_str_level(level), 
                     "FAILED. Reason : Node Protection not provided");
-            trace(instance->traceopts, TILFA_BIT);
         }
     }
 
@@ -981,11 +1636,10 @@ tilfa_p_node_qualification_test_wrt_root(
         }
         else{
 
-            sprintf(instance->traceopts->b, "%s() : Root : %s, node_to_test : %s, dst_node : %s, "
+            SPF_TRACE(TILFA_BIT, "%s() : Root : %s, node_to_test : %s, dst_node : %s, "
                     "first_hop_node : %s, level %s. Result : %s", __FUNCTION__, spf_root->node_name, 
                     node_to_test->node_name, dst_node->node_name, get_str_level(level), 
                     first_hop_node->node_name, "FAILED. Reason : Link Protection not provided");
-            trace(instance->traceopts, TILFA_BIT);
         }
     }
 
@@ -1060,6 +1714,33 @@ tilfa_q_node_qualification_test_wrt_destination(
     return FALSE;
 }
 
+/*Q-node test depends on the node and the destination only, evaluate
+ * it once per node of the spf path DAG of the destination*/
+static boolean
+tilfa_q_node_qualification_test_cached(
+                fn_ptr_arg_t *fn_ptr_arg,
+                node_t *spf_root,
+                node_t *node_to_test,
+                node_t *destination){
+
+    int i = spf_path_dag_node_index(fn_ptr_arg->dag, node_to_test);
+
+    if(i < 0){
+        return tilfa_q_node_qualification_test_wrt_destination(
+                spf_root, node_to_test, destination, 
+                fn_ptr_arg->pr_res, fn_ptr_arg->level);
+    }
+
+    if(fn_ptr_arg->q_node_test[i] == TILFA_Q_NODE_TEST_UNKNOWN){
+        fn_ptr_arg->q_node_test[i] = 
+            tilfa_q_node_qualification_test_wrt_destination(
+                spf_root, node_to_test, destination, 
+                fn_ptr_arg->pr_res, fn_ptr_arg->level) ?
+            TILFA_Q_NODE_TEST_PASS : TILFA_Q_NODE_TEST_FAIL;
+    }
+    return fn_ptr_arg->q_node_test[i] == TILFA_Q_NODE_TEST_PASS;
+}
+
 static boolean
 tilfa_is_destination_impacted(tilfa_info_t *tilfa_info, 
                               node_t *dest, LEVEL level,
@@ -1098,34 +1779,29 @@ print_raw_tilfa_path(node_t *spf_root,
                  int q_distance, 
                  int pq_distance){
 
-    sprintf(instance->traceopts->b, "%s()\nPLR node = %s, DEST = %s", 
+    SPF_TRACE(TILFA_BIT, "%s()\nPLR node = %s, DEST = %s", 
         __FUNCTION__, spf_root->node_name, dest->node_name);
-    trace(instance->traceopts, TILFA_BIT);
 
     if(!nexthops){
-        sprintf(instance->traceopts->b, "Nexthop Array : NULL"); 
-        trace(instance->traceopts, TILFA_BIT);
+        SPF_TRACE(TILFA_BIT, "Nexthop Array : NULL");
     }
     else if(!nexthops[0]){
-        sprintf(instance->traceopts->b, "Nexthop Array : Empty");
-        trace(instance->traceopts, TILFA_BIT);
+        SPF_TRACE(TILFA_BIT, "Nexthop Array : Empty");
     }
     else{
         int i = 0;
         for( ; nexthops[i]; i++){
-            sprintf(instance->traceopts->b, "oif = %s, gw = %s", 
+            SPF_TRACE(TILFA_BIT, "oif = %s, gw = %s", 
                 nexthops[i]->oif->intf_name, 
                 nexthops[i]->gw_prefix);
-            trace(instance->traceopts, TILFA_BIT);
         }
     }
 
-    sprintf(instance->traceopts->b, "p_node = %s(%d), q_node = %s(%d)", 
+    SPF_TRACE(TILFA_BIT, "p_node = %s(%d), q_node = %s(%d)", 
             p_node ? p_node->node_name : "Nil" ,
             pq_distance,
             q_node ? q_node->node_name : "Nil",
             q_distance);
-    trace(instance->traceopts, TILFA_BIT);
 }
 
 void
@@ -1661,144 +2337,77 @@ tilfa_compute_segment_list_from_tilfa_raw_results
     return i;
 }
 
-static boolean
-tilfa_is_fhs_overlap(
-        tilfa_segment_list_t *tilfa_segment_list,
-        int count,
-        gen_segment_list_t *gen_segment_list){
-
-    int i;
-
-    return FALSE;
-    for(i = 0; i < count; i++){
-
-        if(gen_segment_list->oif == 
-                tilfa_segment_list->gen_segment_list[i].oif)
-            return TRUE;
-    }
-    return FALSE;;
-}
-
-static boolean
-tilfa_is_identical_gen_segment_list(
-    gen_segment_list_t *gen_segment_list1,
-    gen_segment_list_t *gen_segment_list2){
-
-        if(memcmp(gen_segment_list1, 
-                  gen_segment_list2, 
-                  sizeof(gen_segment_list_t)) == 0)
-            return TRUE;
-        return FALSE;
-}
+/*Set of stored SID lists, small enough to live on stack*/
+#define TILFA_SEGLIST_SET_SIZE  (2 * MAX_NXT_HOPS)
 
-/* Function to check if gen_segment_list already exists in
- * tilfa_segment_list which contains "n_seglist" SID lists*/
 static boolean
-tilfa_is_segment_already_exists(
-        tilfa_segment_list_t *tilfa_segment_list,
-        gen_segment_list_t *gen_segment_list,
-        int n_seglist){
+tilfa_seglist_set_add(gen_segment_list_t **set, 
+                      gen_segment_list_t *gen_segment_list){
 
-    int i  = 0;
-    for( ; i < n_seglist ; i++){
+    unsigned int i = tilfa_gen_segment_list_to_seglist_entry(
+                        gen_segment_list)->hash % TILFA_SEGLIST_SET_SIZE;
 
-        if(tilfa_is_identical_gen_segment_list(
-            &tilfa_segment_list->gen_segment_list[i], 
-            gen_segment_list)){
-    
-            return TRUE;
-        }
+    while(set[i]){
+        if(set[i] == gen_segment_list)
+            return FALSE;
+        i = (i + 1) % TILFA_SEGLIST_SET_SIZE;
     }
-    return FALSE;
+    set[i] = gen_segment_list;
+    return TRUE;
 }
 
+/* Merge the SID lists of src into dst, RSVP LSP first hop SID lists
+ * first. SID lists are stored once, so two different ECMP tilfa paths
+ * reducing to the same SID list share the same stored copy and the
+ * duplicate is dropped by a pointer lookup. References not carried
+ * over into dst are released*/
 static void
 tilfa_merge_tilfa_segment_lists_by_destination(
+        tilfa_info_t *tilfa_info,
+        LEVEL level,
         tilfa_segment_list_t *dst, 
         tilfa_segment_list_t *src){
 
     int i = 0,
-        j = 0;
-
-    tilfa_segment_list_t temp;
-    memset(&temp, 0, sizeof(tilfa_segment_list_t));
+        j = 0,
+        k = 0,
+        pass = 0;
 
+    gen_segment_list_t *gen_segment_list = NULL;
+    gen_segment_list_t *merged[MAX_NXT_HOPS];
+    gen_segment_list_t *set[TILFA_SEGLIST_SET_SIZE];
     tilfa_segment_list_t *array[] = {dst, src};
-    
-    int k = 0; 
-    /*copy all RSVP LSP FHS from dst and src into temp*/
-    for( ; k < 2; k++){
-        for( i = 0; i < array[k]->n_segment_list; i++){
-
-            if(!array[k]->gen_segment_list[i].is_fhs_rsvp_lsp)
-                continue;
-            
-            if( k == 1){
-                if(tilfa_is_fhs_overlap(&temp, j, 
-                        &array[k]->gen_segment_list[i]))
-                    continue;
-
-                /* Before adding the final the Generic SID list into the
-                 * collection of final results, check of the identical 
-                 * SID list already exists. It might be possible that
-                 * two different ECMP tilfa paths may reduce to same SID 
-                 * list*/
-                if(tilfa_is_segment_already_exists(&temp,
-                        &array[k]->gen_segment_list[i], j))
-                    continue;
-            }
-            memcpy(&temp.gen_segment_list[j], &array[k]->gen_segment_list[i], 
-                    sizeof(gen_segment_list_t));
-            j++;
-
-            if(j == MAX_NXT_HOPS){
-                memcpy(array[k]->gen_segment_list, temp.gen_segment_list,
-                        sizeof(temp.gen_segment_list));
-                array[k]->n_segment_list = MAX_NXT_HOPS;
-                return;
-            }
-        }
-    }
 
-    /*Now copy all IP FHS from src and dst into temp*/
-    for( k = 0; k < 2; k++){
-        for( i = 0; i < array[k]->n_segment_list; i++){
+    memset(set, 0, sizeof(set));
 
-            if(array[k]->gen_segment_list[i].is_fhs_rsvp_lsp)
-                continue;
+    for(pass = 0; pass < 2; pass++){
+        for(k = 0; k < 2; k++){
+            for(i = 0; i < array[k]->n_segment_list; i++){
 
-            if(k == 1){
-                if(tilfa_is_fhs_overlap(&temp, j, 
-                            &array[k]->gen_segment_list[i]))
+                gen_segment_list = array[k]->gen_segment_list[i];
+                /*pass 0 : RSVP LSP FHS, pass 1 : IP FHS*/
+                if(gen_segment_list->is_fhs_rsvp_lsp != (pass == 0))
                     continue;
-                
-                /* Before adding the final the Generic SID list into the
-                 * collection of final results, check of the identical 
-                 * SID list already exists. It might be possible that
-                 * two different ECMP tilfa paths may reduce to same SID 
-                 * list*/
-                if(tilfa_is_segment_already_exists(&temp,
-                            &array[k]->gen_segment_list[i], j))
-                    continue;
-            }
-
-            memcpy(&temp.gen_segment_list[j], &array[k]->gen_segment_list[i], 
-                    sizeof(gen_segment_list_t));
-            j++;
 
-            if(j == MAX_NXT_HOPS){
-                memcpy(array[k]->gen_segment_list, temp.gen_segment_list,
-                        sizeof(temp.gen_segment_list));
-                array[k]->n_segment_list = MAX_NXT_HOPS;
-                return;
+                if(j < MAX_NXT_HOPS && 
+                    tilfa_seglist_set_add(set, gen_segment_list)){
+                    merged[j++] = gen_segment_list;
+                    continue;
+                }
+                tilfa_seglist_pool_put(&tilfa_info->seglist_pool[level],
+                    gen_segment_list);
             }
         }
     }
-    memcpy(dst->gen_segment_list, temp.gen_segment_list,
-        sizeof(temp.gen_segment_list));
+
+    memcpy(dst->gen_segment_list, merged, j * sizeof(gen_segment_list_t *));
     dst->n_segment_list = j;
+    src->n_segment_list = 0;
 }
 
+/*SID lists of the tilfa path being examined, before they are stored*/
+static gen_segment_list_t tilfa_gen_segment_list_scratch[MAX_NXT_HOPS];
+
 static void
 tilfa_record_segment_list(node_t *spf_root, 
                           LEVEL level, 
@@ -1818,10 +2427,11 @@ tilfa_record_segment_list(node_t *spf_root,
         if(tilfa_segment_list_ptr->dest != dst_node) continue;
 
         tilfa_merge_tilfa_segment_lists_by_destination(
+                spf_root->tilfa_info, level,
                 tilfa_segment_list_ptr, 
                 tilfa_segment_list);
-        tilfa_unlock_protected_resource(tilfa_segment_list->pr_res);
-        free(tilfa_segment_list);
+        tilfa_free_segment_list(spf_root->tilfa_info, level, 
+                tilfa_segment_list);
         return;
     } ITERATE_GLTHREAD_END(&spf_root->tilfa_info->tilfa_segment_list_head[level], curr);
 
@@ -1938,8 +2548,8 @@ tilfa_examine_tilfa_path_for_segment_list(
             /*if we are searching Q-node*/
             if(search_for_q_node == TRUE){
 
-                if(tilfa_q_node_qualification_test_wrt_destination(
-                    spf_root, curr_node, dst_node, pr_res, level)){
+                if(tilfa_q_node_qualification_test_cached(
+                    fn_ptr_arg, spf_root, curr_node, dst_node)){
                     /*Q-node Test : Pass, recede.... */
                     q_node = last_entry;
                     q_distance++;
@@ -2039,8 +2649,8 @@ tilfa_examine_tilfa_path_for_segment_list(
             search_for_p_node == FALSE){
 
         /*Check if first-hop node is a Q-node ?*/
-        if(tilfa_q_node_qualification_test_wrt_destination(
-            spf_root, curr_node, dst_node, pr_res, level)){
+        if(tilfa_q_node_qualification_test_cached(
+            fn_ptr_arg, spf_root, curr_node, dst_node)){
             q_node = last_entry;
             q_distance++;
             search_for_q_node = FALSE;
@@ -2108,16 +2718,23 @@ tilfa_examine_tilfa_path_for_segment_list(
         q_node ? GET_PRED_INFO_NODE_FROM_GLTHREAD(q_node): 0, 
         dst_node, q_distance, pq_distance);
     
-    tilfa_segment_list_t *tilfa_segment_list = 
-        calloc(1, sizeof(tilfa_segment_list_t));
+    int i = 0,
+        n_segment_list = 0;
+    tilfa_segment_list_t *tilfa_segment_list = NULL;
+    gen_segment_list_t *stored = NULL;
+    gen_segment_list_t *set[TILFA_SEGLIST_SET_SIZE];
+    gen_segment_list_t *gen_segment_list = tilfa_gen_segment_list_scratch;
+
+    memset(tilfa_gen_segment_list_scratch, 0, 
+            sizeof(tilfa_gen_segment_list_scratch));
 
     if(pq_distance == 0){
-        tilfa_segment_list->n_segment_list = 
+        n_segment_list = 
             tilfa_compute_segment_list_from_tilfa_raw_results(
                     spf_root, GET_PRED_INFO_NODE_FROM_GLTHREAD(p_node),
                     GET_PRED_INFO_NODE_FROM_GLTHREAD(q_node),
                     dst_node, level,
-                    tilfa_segment_list->gen_segment_list,
+                    gen_segment_list,
                     q_distance, pq_distance,
                     first_hop_segments);
     }
@@ -2128,35 +2745,50 @@ tilfa_examine_tilfa_path_for_segment_list(
                     p_node,
                     q_node,
                     dst_node, level,
-                    tilfa_segment_list->gen_segment_list,
+                    gen_segment_list,
                     q_distance, pq_distance,
                     pr_res);
 
         if(!segment_list_len_from_p_to_q){
-            free(tilfa_segment_list);
             return;
         }
 
         /* Now analyze the segment list against first hop segments
          * and populate segment lists for inet3 and mpls0*/
 
-        tilfa_segment_list->n_segment_list = 
+        n_segment_list = 
             tilfa_compute_segment_list_from_tilfa_raw_results(
                     spf_root, GET_PRED_INFO_NODE_FROM_GLTHREAD(p_node),
                     GET_PRED_INFO_NODE_FROM_GLTHREAD(q_node),
                     dst_node, level,
                     /*In this case, the segment list at index 0 is input
                      * which will be copied to remaining other indexes*/
-                    tilfa_segment_list->gen_segment_list,
+                    gen_segment_list,
                     q_distance, pq_distance,
                     first_hop_segments);
     }
 
-    if(tilfa_segment_list->n_segment_list == 0){
-        free(tilfa_segment_list);
+    if(n_segment_list == 0){
         return;
     }
 
+    /*Refer to the stored copies of the SID lists, dropping duplicates*/
+    memset(set, 0, sizeof(set));
+    tilfa_segment_list = calloc(1, sizeof(tilfa_segment_list_t));
+    for(i = 0; i < n_segment_list; i++){
+
+        stored = tilfa_seglist_pool_get(
+                    &spf_root->tilfa_info->seglist_pool[level],
+                    &gen_segment_list[i]);
+
+        if(!tilfa_seglist_set_add(set, stored)){
+            tilfa_seglist_pool_put(&spf_root->tilfa_info->seglist_pool[level], 
+                    stored);
+            continue;
+        }
+        tilfa_segment_list->gen_segment_list[
+            tilfa_segment_list->n_segment_list++] = stored;
+    }
     tilfa_segment_list->pr_res = pr_res;
     tilfa_lock_protected_resource(pr_res);
 
@@ -2171,19 +2803,42 @@ tilfa_compute_segment_lists_per_destination(
                         protected_resource_t *pr_res,
                         node_t *dst_node){
 
+    static spf_path_dag_t dag;
+    static unsigned char *q_node_test = NULL;
+    static unsigned int q_node_test_size = 0;
+    boolean truncated = FALSE;
+
     fn_ptr_arg_t fn_ptr_arg;
     fn_ptr_arg.tilfa_info = spf_root->tilfa_info;
     fn_ptr_arg.pr_res = pr_res;
     fn_ptr_arg.level = level;
 
-    sprintf(instance->traceopts->b, "Node : %s : %s : "
-            "Examining post-C to Dest %s", spf_root->node_name,
-            get_str_level(level), dst_node->node_name);
-    trace(instance->traceopts, TILFA_BIT);
-    trace_spf_path_to_destination_node(spf_root, 
-                    dst_node, level, 
-                    tilfa_examine_tilfa_path_for_segment_list,
-                    (void *)&fn_ptr_arg, TRUE);     
+    if(!spf_path_dag_build(&dag, spf_root, dst_node, level, TRUE))
+        return;
+
+    if(dag.n_nodes > q_node_test_size){
+        q_node_test_size = dag.node_alloc;
+        q_node_test = realloc(q_node_test, q_node_test_size);
+        assert(q_node_test);
+    }
+    memset(q_node_test, TILFA_Q_NODE_TEST_UNKNOWN, dag.n_nodes);
+    fn_ptr_arg.dag = &dag;
+    fn_ptr_arg.q_node_test = q_node_test;
+
+    SPF_TRACE(TILFA_BIT, "Node : %s : %s : "
+            "Examining post-C to Dest %s, %llu paths over %u nodes", 
+            spf_root->node_name, get_str_level(level), dst_node->node_name,
+            spf_path_dag_n_paths(&dag), dag.n_nodes);
+
+    spf_path_dag_enumerate(&dag, tilfa_examine_tilfa_path_for_segment_list,
+                    (void *)&fn_ptr_arg, SPF_PATH_ENUMERATION_LIMIT, &truncated);
+
+    if(truncated){
+        SPF_TRACE(TILFA_BIT, "Node : %s : %s : "
+            "post-C paths to Dest %s truncated to %u of %llu",
+            spf_root->node_name, get_str_level(level), dst_node->node_name,
+            SPF_PATH_ENUMERATION_LIMIT, spf_path_dag_n_paths(&dag));
+    }
 }
 
 
@@ -2202,13 +2857,12 @@ tilfa_compute_segment_lists(node_t *spf_root, LEVEL level,
 
     node_t *dst_node = NULL;
 
-    sprintf(instance->traceopts->b, "Node : %s : level %s, Segment List "
+    SPF_TRACE(SPF_EVENTS_BIT, "Node : %s : level %s, Segment List "
             "Computation for Protected Res : %s, LP : %sset : NP : %sset",
         spf_root->node_name, get_str_level(level), 
         pr_res->protected_link->intf_name,
         pr_res->link_protection ? "" : "un", 
         pr_res->node_protection ? "" : "un");
-    trace(instance->traceopts, SPF_EVENTS_BIT);
 
     ITERATE_LIST_BEGIN(pre_convergence_spf_result_lst, curr){
 
@@ -2220,9 +2874,8 @@ tilfa_compute_segment_lists(node_t *spf_root, LEVEL level,
 
         if(!tilfa_is_destination_impacted(spf_root->tilfa_info,
             dst_node, level, pr_res)){
-            sprintf(instance->traceopts->b, "Node : %s : level %s, Dest Node %s is not impacted",
+            SPF_TRACE(TILFA_BIT, "Node : %s : level %s, Dest Node %s is not impacted",
                 spf_root->node_name, get_str_level(level), dst_node->node_name);
-            trace(instance->traceopts, TILFA_BIT);
             continue;
         }
 
@@ -2240,19 +2893,25 @@ tilfa_run_post_convergence_spf(node_t *spf_root, LEVEL level,
      * protected resource*/
     tilfa_clear_all_post_convergence_results(spf_root, level, pr_res);
 
-    /*Ostracize the protected resources from the topology*/
-    tilfa_topology_prune_protected_resource(spf_root, pr_res);
+    /*Ostracize the protected resources from the post-convergence SPF*/
+    tilfa_prune_mask_set(spf_root, pr_res);
 
-    /* We also need primary nexthops of first-hop nodes along the 
-     * Post-Convergence SPF path. However, Running full SPF is not 
-     * required, but this is already available code we have.*/
-    compute_tilfa_post_convergence_spf_primary_nexthops(spf_root, level);
+    if(spf_root->tilfa_info->tilfa_gl_var.incremental_spf &&
+        spf_root->tilfa_info->pre_spt[level].count){
+        /*Re-settle only the nodes below the pruned resources*/
+        tilfa_run_incremental_post_convergence_spf(spf_root, level);
+    }
+    else{
+        /* We also need primary nexthops of first-hop nodes along the 
+         * Post-Convergence SPF path.*/
+        compute_tilfa_post_convergence_spf_primary_nexthops(spf_root, level);
 
-    /*Now compute PC-spf paths to all destinations*/
-    compute_spf_paths(spf_root, level, TILFA_RUN);
+        /*Now compute PC-spf paths to all destinations*/
+        compute_spf_paths(spf_root, level, TILFA_RUN);
+    }
 
-    /*Add the protected resources back to the topology*/
-    tilfa_topology_unprune_protected_resource(spf_root, pr_res);
+    /*Subsequent SPF runs see the protected resources again*/
+    tilfa_prune_mask_clear(spf_root);
 
     /*Compute segment lists now*/
     tilfa_compute_segment_lists(spf_root, level, pr_res);
@@ -2577,7 +3236,7 @@ route_fetch_tilfa_backups(node_t *spf_root,
             for( i = 0; i < tilfa_segment_list->n_segment_list; i++){
                 
                 if(tilfa_fill_nxthop_from_segment_lst(route, &tilfa_bck_up_lcl, 
-                                  &tilfa_segment_list->gen_segment_list[i],
+                                  tilfa_segment_list->gen_segment_list[i],
                                   tilfa_segment_list->pr_res, inet3, mpls0)){
                     
                     tilfa_bck_up = XCALLOC(1, internal_nh_t);
@@ -223,12 +223,31 @@ tlfa_protected_resource_equal(protected_resource_t *pr_res1,
     return FALSE;
 }
 
+/*A SID list stored once per PLR and level, and referenced by
+ * all destinations whose TILFA paths reduce to it*/
+typedef struct tilfa_seglist_entry_{
+
+    uint32_t hash;
+    uint32_t ref_count;
+    struct tilfa_seglist_entry_ *next;
+    gen_segment_list_t gen_segment_list;
+} tilfa_seglist_entry_t;
+
+/*SID lists hashed by their canonical form : oif, gateway and label stacks*/
+typedef struct tilfa_seglist_pool_{
+
+    unsigned int n_buckets;
+    unsigned int count;
+    tilfa_seglist_entry_t **buckets;
+    unsigned long shared; /*SID lists found already stored*/
+} tilfa_seglist_pool_t;
+
 typedef struct tilfa_segment_list_{
 
     node_t *dest;
     protected_resource_t *pr_res;
     uint8_t n_segment_list;
-    gen_segment_list_t gen_segment_list[MAX_NXT_HOPS];
+    gen_segment_list_t *gen_segment_list[MAX_NXT_HOPS]; /*Held in tilfa_info->seglist_pool*/
     glthread_t gen_segment_list_glue;
 } tilfa_segment_list_t;
 GLTHREAD_TO_STRUCT(tilfa_segment_list_to_gensegment_list, 
@@ -248,13 +267,87 @@ typedef struct tilfa_cfg_globals_{
     
     boolean is_enabled;
     uint8_t max_segments_allowed;
+    boolean incremental_spf; /*Post-convergence SPF re-settles only the nodes below the pruned resources*/
 } tilfa_cfg_globals_t;
 
-typedef struct tilfa_remote_spf_result_{
-
-    node_t *node; /*root of rev spf result*/
-    ll_t *rem_spf_result_lst;
-} tilfa_remote_spf_result_t;
+/*Memory the remote SPF distance rows of a level may take*/
+#define TILFA_REMOTE_SPF_CACHE_MAX_BYTES    (4 * 1024 * 1024)
+
+#define TILFA_REMOTE_SPF_ROW_NONE           (-1)
+
+typedef struct tilfa_remote_spf_row_{
+
+    node_t *root;
+    boolean reverse_spf;    /*DIST(*, root) if set, else DIST(root, *)*/
+    int lru_prev;           /*Towards most recently used row*/
+    int lru_next;           /*Towards least recently used row*/
+} tilfa_remote_spf_row_t;
+
+/* SPF distance rows triggered on remote nodes, required for PQ node
+ * evaluation. Shared by the TILFA computations of all PLRs of the instance
+ * and kept across runs till the topology version of the level moves on.
+ * Least recently used rows are recycled once the memory cap is reached*/
+typedef struct tilfa_remote_spf_cache_{
+
+    instance_t *instance;
+    boolean valid;
+    unsigned int topo_version;
+
+    /*All nodes of the instance, indexed by node->tilfa_rspf_index[level]*/
+    unsigned int node_count;
+    unsigned int node_alloc;
+    node_t **nodes;
+
+    /*Row r holds node_count distances at dist[r * node_count]*/
+    unsigned int row_count;
+    unsigned int row_alloc;
+    unsigned int row_max;
+    tilfa_remote_spf_row_t *rows;
+    unsigned int *dist;
+    int lru_head;
+    int lru_tail;
+
+    unsigned long hits;
+    unsigned long misses;
+    unsigned long evictions;
+    unsigned int flushes;
+} tilfa_remote_spf_cache_t;
+
+/*Per run prune mask of post-convergence SPF. The topology itself is
+ * never modified, SPF runs of the PLR skip the masked resources*/
+typedef struct tilfa_prune_mask_{
+
+    edge_t *link;   /*pruned link, NULL if none*/
+    node_t *node;   /*pruned node, NULL if none*/
+} tilfa_prune_mask_t;
+
+/*Node of the pre-convergence SPT of the PLR*/
+typedef struct tilfa_spt_node_{
+
+    node_t *node;
+    unsigned int spf_metric;
+    unsigned int lsp_metric;
+    unsigned int seq;           /*discovery order, breaks ties of settle order*/
+    spf_result_t *res;          /*pre-convergence result of the node*/
+    boolean is_res_private;     /*res is not in the result list, as for PN*/
+    boolean invalidated;        /*below the pruned resources in the SPT*/
+    boolean frontier;           /*not invalidated, adjacent to invalidated node*/
+} tilfa_spt_node_t;
+
+/*Snapshot of the pre-convergence SPT of the PLR, taken once per TILFA
+ * computation. Incremental post-convergence SPF of every protected
+ * resource starts from it*/
+typedef struct tilfa_pre_spt_{
+
+    unsigned int count;
+    unsigned int alloc;
+    tilfa_spt_node_t *nodes;    /*in settle order of pre-convergence SPF*/
+    node_t **work;              /*frontier or settle list of a run*/
+    /*stats*/
+    unsigned int incremental_runs;
+    unsigned long resettled;
+    unsigned long reused;
+} tilfa_pre_spt_t;
 
 typedef struct tilfa_info_ {
 
@@ -270,16 +363,17 @@ typedef struct tilfa_info_ {
     
     /*SPF Results of FORWARD run without Pruning of Resources*/
     glthread_t post_convergence_spf_path[MAX_LEVEL];
+    spf_path_result_table_t post_convergence_spf_path_table[MAX_LEVEL];
 
-    /* SPF Results triggered on a remote node.
-     * Required for PQ node evaluation*/
-    ll_t *pre_convergence_remote_forward_spf_results[MAX_LEVEL];
+    glthread_t tilfa_segment_list_head[MAX_LEVEL];
 
-    ll_t *pre_convergence_remote_reverse_spf_results[MAX_LEVEL];
+    tilfa_seglist_pool_t seglist_pool[MAX_LEVEL];
 
-    glthread_t tilfa_segment_list_head[MAX_LEVEL];
+    /*Resources ostracized from the post-convergence SPF runs
+     * of this PLR for the protected resource being evaluated*/
+    tilfa_prune_mask_t prune_mask;
 
-    boolean is_tilfa_pruned;
+    tilfa_pre_spt_t pre_spt[MAX_LEVEL];
 } tilfa_info_t;
 
 gen_segment_list_t *
@@ -298,13 +392,18 @@ tilfa_update_config(node_t *plr_node,
                     boolean link_protection,
                     boolean node_protection);
 
-boolean
-tilfa_topology_prune_protected_resource(node_t *node,
+void
+tilfa_prune_mask_set(node_t *node,
     protected_resource_t *pr_res);
 
 void
-tilfa_topology_unprune_protected_resource(node_t *node,
-    protected_resource_t *pr_res);
+tilfa_prune_mask_clear(node_t *node);
+
+boolean
+tilfa_is_link_pruned(node_t *spf_root, edge_t *edge);
+
+boolean
+tilfa_is_node_pruned(node_t *spf_root, node_t *node);
 
 void
 tilfa_run_post_convergence_spf(node_t *spf_root, LEVEL level,
@@ -317,11 +416,6 @@ tilfa_lookup_spf_path_result(node_t *node, node_t *candidate_node,
 void
 compute_tilfa(node_t *spf_root, LEVEL level);
 
-void
-tilfa_clear_preconvergence_remote_spf_results(tilfa_info_t *tilfa_info, 
-                            node_t *node, LEVEL level,
-                            boolean reverse_spf);
-
 spf_path_result_t *
 TILFA_GET_SPF_PATH_RESULT(node_t *spf_root, node_t *node, LEVEL level);
 
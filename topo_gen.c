@@ -0,0 +1,712 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  topo_gen.c
+ *
+ *    Description:  Generators of large synthetic topologies for scale testing
+ *
+ *        Version:  1.0
+ *        Created:  Sunday 18 October 2026 19:06:29  UTC
+ *       Revision:  1.0
+ *       Compiler:  gcc
+ *
+ *         Author:  agent, agent@local
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        Copyright (c) 2026 agent.
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "topo_gen.h"
+#include "topo_loader.h"
+
+#define TOPO_GEN_WAXMAN_ALPHA   0.4
+#define TOPO_GEN_WAXMAN_CUTOFF  5.0     /*pairs farther than CUTOFF * beta * L are not linked*/
+#define TOPO_GEN_ISP_MAX_AREAS  5       /*AREA2 - AREA6, the core is in AREA1*/
+#define TOPO_GEN_ISP_AREA_SIZE  20      /*nodes per area below which areas are merged*/
+
+topo_gen_params_t topo_gen_params = {
+
+    .seed = 1,
+    .ecmp = 0,
+    .metric_min = LINK_DEFAULT_METRIC,
+    .metric_max = LINK_DEFAULT_METRIC,
+    .degree = 4,
+    .lan_size = 4
+};
+
+typedef struct topo_gen_{
+
+    topo_gen_params_t *params;
+    FILE *fp;
+    unsigned long long rand_state;
+    unsigned int n_nodes;
+    unsigned int max_nodes;
+    char (*names)[NODE_NAME_SIZE];
+    unsigned char *degree;          /*links of the node so far*/
+    unsigned int *uf_parent;        /*union find of the nodes linked so far*/
+    unsigned int n_links;
+    unsigned int n_lans;
+    unsigned int n_subnets;
+    /*node positions of geometric and waxman graphs*/
+    double *x;
+    double *y;
+} topo_gen_t;
+
+const char *
+topo_gen_type_str(topo_gen_type_t type){
+
+    switch(type){
+        case TOPO_GEN_CLOS:
+            return "clos";
+        case TOPO_GEN_GEOMETRIC:
+            return "geometric";
+        case TOPO_GEN_WAXMAN:
+            return "waxman";
+        case TOPO_GEN_ISP:
+            return "isp";
+        default:
+            return "unknown";
+    }
+}
+
+/*xorshift64*, seeded through splitmix64 so that small seeds spread*/
+static void
+topo_gen_seed(topo_gen_t *gen, unsigned int seed){
+
+    unsigned long long z = (unsigned long long)seed + 0x9E3779B97F4A7C15ULL;
+
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+    gen->rand_state = z ? z : 0x9E3779B97F4A7C15ULL;
+}
+
+static unsigned long long
+topo_gen_rand(topo_gen_t *gen){
+
+    gen->rand_state ^= gen->rand_state >> 12;
+    gen->rand_state ^= gen->rand_state << 25;
+    gen->rand_state ^= gen->rand_state >> 27;
+    return gen->rand_state * 0x2545F4914F6CDD1DULL;
+}
+
+static unsigned int
+topo_gen_rand_range(topo_gen_t *gen, unsigned int n){
+
+    return (unsigned int)(topo_gen_rand(gen) % n);
+}
+
+/*Uniform in [0, 1)*/
+static double
+topo_gen_rand_unit(topo_gen_t *gen){
+
+    return (double)(topo_gen_rand(gen) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static unsigned int
+topo_gen_metric(topo_gen_t *gen){
+
+    topo_gen_params_t *params = gen->params;
+
+    if(params->metric_max == params->metric_min ||
+        topo_gen_rand_range(gen, 100) < params->ecmp)
+        return params->metric_min;
+    return params->metric_min +
+        topo_gen_rand_range(gen, params->metric_max - params->metric_min + 1);
+}
+
+static unsigned int
+topo_gen_uf_find(topo_gen_t *gen, unsigned int i){
+
+    while(gen->uf_parent[i] != i){
+        gen->uf_parent[i] = gen->uf_parent[gen->uf_parent[i]];
+        i = gen->uf_parent[i];
+    }
+    return i;
+}
+
+static boolean
+topo_gen_alloc(topo_gen_t *gen, unsigned int max_nodes){
+
+    unsigned int i = 0;
+
+    gen->max_nodes = max_nodes;
+    gen->names = calloc(max_nodes, NODE_NAME_SIZE);
+    gen->degree = calloc(max_nodes, sizeof(unsigned char));
+    gen->uf_parent = calloc(max_nodes, sizeof(unsigned int));
+    gen->x = calloc(max_nodes, sizeof(double));
+    gen->y = calloc(max_nodes, sizeof(double));
+
+    if(!gen->names || !gen->degree || !gen->uf_parent || !gen->x || !gen->y){
+        printf("Error : Could not allocate generator state of %u nodes\n", max_nodes);
+        return FALSE;
+    }
+
+    for(i = 0; i < max_nodes; i++)
+        gen->uf_parent[i] = i;
+    return TRUE;
+}
+
+static void
+topo_gen_free(topo_gen_t *gen){
+
+    free(gen->names);
+    free(gen->degree);
+    free(gen->uf_parent);
+    free(gen->x);
+    free(gen->y);
+}
+
+/*Declare a router, returns its node index*/
+static unsigned int
+topo_gen_node(topo_gen_t *gen, char *name, AREA area){
+
+    unsigned int index = gen->n_nodes++,
+                 rtr_id = index + 1;
+
+    assert(index < gen->max_nodes);
+    strncpy(gen->names[index], name, NODE_NAME_SIZE - 1);
+    fprintf(gen->fp, "node %s 11.%u.%u.%u area %u\n", name,
+        (rtr_id >> 16) & 0xFF, (rtr_id >> 8) & 0xFF, rtr_id & 0xFF,
+        area - AREA1 + 1);
+    return index;
+}
+
+static const char *
+topo_gen_level_str(LEVEL level){
+
+    return level == LEVEL12 ? "12" : level == LEVEL2 ? "2" : "1";
+}
+
+/*p2p link on a /30 of 100.0.0.0 onwards, not created if either node
+ * already has max_degree links. Returns TRUE if the link is created*/
+static boolean
+topo_gen_link(topo_gen_t *gen, unsigned int node1, unsigned int node2,
+              LEVEL level, unsigned int max_degree){
+
+    unsigned int subnet = gen->n_links << 2,
+                 root1, root2;
+
+    if(node1 == node2 ||
+        gen->degree[node1] >= max_degree ||
+        gen->degree[node2] >= max_degree)
+        return FALSE;
+
+    fprintf(gen->fp, "link %s eth0/%u %s eth0/%u ip %u.%u.%u.%u/30 %u.%u.%u.%u/30 level %s metric %u\n",
+        gen->names[node1], gen->degree[node1], gen->names[node2], gen->degree[node2],
+        100 + (subnet >> 24), (subnet >> 16) & 0xFF, (subnet >> 8) & 0xFF, (subnet & 0xFF) + 1,
+        100 + (subnet >> 24), (subnet >> 16) & 0xFF, (subnet >> 8) & 0xFF, (subnet & 0xFF) + 2,
+        topo_gen_level_str(level), topo_gen_metric(gen));
+
+    gen->degree[node1]++;
+    gen->degree[node2]++;
+    gen->n_links++;
+
+    root1 = topo_gen_uf_find(gen, node1);
+    root2 = topo_gen_uf_find(gen, node2);
+    if(root1 != root2)
+        gen->uf_parent[root1] = root2;
+    return TRUE;
+}
+
+/*Broadcast LAN on a /24 of 20.0.0.0 onwards, the first member is the DIS.
+ * Members with no free interface stay off the LAN*/
+static void
+topo_gen_lan(topo_gen_t *gen, unsigned int *members, unsigned int n_members,
+             LEVEL level){
+
+    char pn_name[NODE_NAME_SIZE];
+    unsigned int subnet = gen->n_lans << 8,
+                 i = 0,
+                 pn_index = 0,
+                 dis_rtr_id = members[0] + 1,
+                 root1, root2;
+
+    snprintf(pn_name, sizeof(pn_name), "lan%u", gen->n_lans++);
+    pn_index = gen->n_nodes++;
+    assert(pn_index < gen->max_nodes);
+    strncpy(gen->names[pn_index], pn_name, NODE_NAME_SIZE - 1);
+
+    fprintf(gen->fp, "pseudonode %s 11.%u.%u.%u level %s\n", pn_name,
+        (dis_rtr_id >> 16) & 0xFF, (dis_rtr_id >> 8) & 0xFF, dis_rtr_id & 0xFF,
+        topo_gen_level_str(level));
+
+    for(i = 0; i < n_members; i++){
+
+        if(gen->degree[members[i]] >= TOPO_GEN_MAX_DEGREE)
+            continue;
+
+        fprintf(gen->fp, "link %s eth0/%u %s - ip %u.%u.%u.%u/24 - level %s metric %u\n",
+            gen->names[members[i]], gen->degree[members[i]], pn_name,
+            20 + (subnet >> 24), (subnet >> 16) & 0xFF, (subnet >> 8) & 0xFF, i + 1,
+            topo_gen_level_str(level), topo_gen_metric(gen));
+
+        gen->degree[members[i]]++;
+        gen->degree[pn_index]++;
+        gen->n_links++;
+
+        root1 = topo_gen_uf_find(gen, members[i]);
+        root2 = topo_gen_uf_find(gen, pn_index);
+        if(root1 != root2)
+            gen->uf_parent[root1] = root2;
+    }
+}
+
+/*Host subnet, a /24 of 30.0.0.0 onwards*/
+static void
+topo_gen_subnet(topo_gen_t *gen, unsigned int node, LEVEL level){
+
+    unsigned int subnet = gen->n_subnets++ << 8;
+
+    fprintf(gen->fp, "prefix %s %u.%u.%u.0/24 level %s\n", gen->names[node],
+        30 + (subnet >> 24), (subnet >> 16) & 0xFF, (subnet >> 8) & 0xFF,
+        topo_gen_level_str(level));
+}
+
+/*Link the components of nodes [first, first + count) into one with a chain
+ * of links between a node of each component. Generators keep two
+ * interface slots of every node free for the chain, returns FALSE if
+ * a chain link could not be created anyway*/
+static boolean
+topo_gen_connect(topo_gen_t *gen, unsigned int first, unsigned int count,
+                 LEVEL level){
+
+    unsigned int i = 0,
+                 *reps = calloc(count, sizeof(unsigned int)),
+                 n_reps = 0;
+    boolean linked = TRUE;
+
+    /*Component representatives first, the chain changes the components*/
+    for(i = first; i < first + count; i++){
+        if(topo_gen_uf_find(gen, i) == i)
+            reps[n_reps++] = i;
+    }
+
+    for(i = 1; i < n_reps && linked; i++){
+        linked = topo_gen_link(gen, reps[i - 1], reps[i], level, TOPO_GEN_MAX_DEGREE);
+        assert(linked);
+    }
+    free(reps);
+    return linked;
+}
+
+static void
+topo_gen_clos(topo_gen_t *gen, unsigned int k){
+
+    char name[2 * NODE_NAME_SIZE];      /*names fit NODE_NAME_SIZE, sized for -Wformat-truncation*/
+    unsigned int half = k / 2,
+                 n_core = half * half,
+                 pod, i, j, m,
+                 core_base = 0,
+                 agg_base = 0,
+                 edge_base = 0;
+
+    fprintf(gen->fp, "# clos k %u, seed %u\n", k, gen->params->seed);
+    fprintf(gen->fp, "nodes %u\n", n_core + k * k);
+
+    core_base = gen->n_nodes;
+    for(i = 0; i < n_core; i++){
+        snprintf(name, sizeof(name), "c%u", i);
+        topo_gen_node(gen, name, AREA1);
+    }
+
+    for(pod = 0; pod < k; pod++){
+
+        agg_base = gen->n_nodes;
+        for(j = 0; j < half; j++){
+            snprintf(name, sizeof(name), "a%u-%u", pod, j);
+            topo_gen_node(gen, name, AREA1);
+        }
+
+        edge_base = gen->n_nodes;
+        for(i = 0; i < half; i++){
+            snprintf(name, sizeof(name), "e%u-%u", pod, i);
+            topo_gen_node(gen, name, AREA1);
+        }
+
+        for(i = 0; i < half; i++){
+            for(j = 0; j < half; j++)
+                topo_gen_link(gen, edge_base + i, agg_base + j, LEVEL1, TOPO_GEN_MAX_DEGREE);
+            topo_gen_subnet(gen, edge_base + i, LEVEL1);
+        }
+
+        /*Aggregation switch j of every pod uplinks to core group j*/
+        for(j = 0; j < half; j++){
+            for(m = 0; m < half; m++)
+                topo_gen_link(gen, agg_base + j, core_base + j * half + m, LEVEL1, TOPO_GEN_MAX_DEGREE);
+        }
+    }
+
+    fprintf(gen->fp, "root e0-0\n");
+}
+
+/*Nodes at random positions, bucketed in a grid of cells of size cell_size
+ * for the pairwise distance scan. cell_start has n_cells + 1 entries*/
+static void
+topo_gen_place(topo_gen_t *gen, unsigned int n, double cell_size,
+               unsigned int *n_cells_side, unsigned int **cell_start,
+               unsigned int **cell_nodes){
+
+    char name[2 * NODE_NAME_SIZE];      /*names fit NODE_NAME_SIZE, sized for -Wformat-truncation*/
+    unsigned int i = 0,
+                 side = (unsigned int)ceil(1.0 / cell_size),
+                 *start = NULL,
+                 *nodes = NULL,
+                 cell = 0;
+
+    if(!side) side = 1;
+    start = calloc(side * side + 1, sizeof(unsigned int));
+    nodes = calloc(n, sizeof(unsigned int));
+
+    for(i = 0; i < n; i++){
+        snprintf(name, sizeof(name), "R%u", i);
+        topo_gen_node(gen, name, AREA1);
+        gen->x[i] = topo_gen_rand_unit(gen);
+        gen->y[i] = topo_gen_rand_unit(gen);
+    }
+
+#define TOPO_GEN_CELL(_i)   \
+    ((unsigned int)(gen->x[_i] * side) * side + (unsigned int)(gen->y[_i] * side))
+
+    /*counting sort of the nodes by cell*/
+    for(i = 0; i < n; i++)
+        start[TOPO_GEN_CELL(i) + 1]++;
+    for(cell = 1; cell <= side * side; cell++)
+        start[cell] += start[cell - 1];
+    for(i = 0; i < n; i++){
+        cell = TOPO_GEN_CELL(i);
+        nodes[start[cell]++] = i;
+    }
+    for(cell = side * side; cell; cell--)
+        start[cell] = start[cell - 1];
+    start[0] = 0;
+#undef TOPO_GEN_CELL
+
+    *n_cells_side = side;
+    *cell_start = start;
+    *cell_nodes = nodes;
+}
+
+/*Pairs (i, j > i) closer than max_dist, waxman_scale != 0 links them with
+ * the waxman probability, else always. Returns FALSE if the graph could not
+ * be made connected*/
+static boolean
+topo_gen_link_near_pairs(topo_gen_t *gen, unsigned int n, double max_dist,
+                         double waxman_scale){
+
+    unsigned int side = 0,
+                 *cell_start = NULL,
+                 *cell_nodes = NULL,
+                 i, j, k,
+                 cx, cy;
+    int dx, dy;
+    double dist = 0;
+    boolean connected = FALSE;
+
+    topo_gen_place(gen, n, max_dist, &side, &cell_start, &cell_nodes);
+
+    for(i = 0; i < n; i++){
+
+        cx = (unsigned int)(gen->x[i] * side);
+        cy = (unsigned int)(gen->y[i] * side);
+
+        for(dx = -1; dx <= 1; dx++){
+            if((int)cx + dx < 0 || cx + dx >= side)
+                continue;
+            for(dy = -1; dy <= 1; dy++){
+                if((int)cy + dy < 0 || cy + dy >= side)
+                    continue;
+                k = (cx + dx) * side + (cy + dy);
+                for(j = cell_start[k]; j < cell_start[k + 1]; j++){
+
+                    if(cell_nodes[j] <= i)
+                        continue;
+
+                    dist = hypot(gen->x[i] - gen->x[cell_nodes[j]],
+                                 gen->y[i] - gen->y[cell_nodes[j]]);
+                    if(dist > max_dist)
+                        continue;
+
+                    if(waxman_scale != 0 &&
+                        topo_gen_rand_unit(gen) >= TOPO_GEN_WAXMAN_ALPHA * exp(-dist / waxman_scale))
+                        continue;
+
+                    topo_gen_link(gen, i, cell_nodes[j], LEVEL1, TOPO_GEN_MAX_DEGREE - 2);
+                }
+            }
+        }
+    }
+
+    connected = topo_gen_connect(gen, 0, n, LEVEL1);
+    fprintf(gen->fp, "root R0\n");
+    free(cell_start);
+    free(cell_nodes);
+    return connected;
+}
+
+static boolean
+topo_gen_geometric(topo_gen_t *gen, unsigned int n){
+
+    /*n * PI * r^2 nodes fall within distance r of a node*/
+    double radius = sqrt((double)gen->params->degree / (M_PI * n));
+
+    fprintf(gen->fp, "# geometric nodes %u degree %u, seed %u\n", n,
+        gen->params->degree, gen->params->seed);
+    fprintf(gen->fp, "nodes %u\n", n);
+    return topo_gen_link_near_pairs(gen, n, radius > 1.0 ? 1.0 : radius, 0);
+}
+
+static boolean
+topo_gen_waxman(topo_gen_t *gen, unsigned int n){
+
+    /*Expected degree of a node is about n * alpha * 2 * PI * (beta * L)^2*/
+    double scale = sqrt((double)gen->params->degree /
+                        (2 * M_PI * n * TOPO_GEN_WAXMAN_ALPHA)),
+           max_dist = TOPO_GEN_WAXMAN_CUTOFF * scale;
+
+    fprintf(gen->fp, "# waxman nodes %u degree %u, seed %u\n", n,
+        gen->params->degree, gen->params->seed);
+    fprintf(gen->fp, "nodes %u\n", n);
+    return topo_gen_link_near_pairs(gen, n, max_dist > 1.0 ? 1.0 : max_dist, scale);
+}
+
+/*Ring over nodes [first, first + count), then random chords up to the
+ * configured average degree. Chords keep two slots of every node free and
+ * are skipped when there is no room, returns FALSE if the ring is broken*/
+static boolean
+topo_gen_ring_chords(topo_gen_t *gen, unsigned int first, unsigned int count,
+                     LEVEL level){
+
+    unsigned int i = 0,
+                 n_chords = 0;
+
+    if(count < 2)
+        return TRUE;
+
+    for(i = 0; i + 1 < count; i++){
+        if(!topo_gen_link(gen, first + i, first + i + 1, level, TOPO_GEN_MAX_DEGREE))
+            return FALSE;
+    }
+    if(count > 2 &&
+        !topo_gen_link(gen, first + count - 1, first, level, TOPO_GEN_MAX_DEGREE))
+        return FALSE;
+
+    if(gen->params->degree <= 2 || count < 4)
+        return TRUE;
+
+    n_chords = (gen->params->degree - 2) * count / 2;
+    for(i = 0; i < n_chords; i++){
+        topo_gen_link(gen, first + topo_gen_rand_range(gen, count),
+                      first + topo_gen_rand_range(gen, count),
+                      level, TOPO_GEN_MAX_DEGREE - 2);
+    }
+    return TRUE;
+}
+
+/*Core and area links must all be created for the areas to be connected
+ * to the core, LAN membership is best effort*/
+static boolean
+topo_gen_isp(topo_gen_t *gen, unsigned int n){
+
+    char name[2 * NODE_NAME_SIZE];      /*names fit NODE_NAME_SIZE, sized for -Wformat-truncation*/
+    unsigned int n_core = n / 20,
+                 n_areas = 0,
+                 n_area_nodes = 0,
+                 n_access = 0,
+                 area, i, j,
+                 abr_base = 0,
+                 access_base = 0,
+                 members[TOPO_GEN_MAX_DEGREE];
+
+    if(n_core < 4)
+        n_core = 4;
+    n_areas = (n - n_core) / TOPO_GEN_ISP_AREA_SIZE;
+    if(n_areas < 1) n_areas = 1;
+    if(n_areas > TOPO_GEN_ISP_MAX_AREAS) n_areas = TOPO_GEN_ISP_MAX_AREAS;
+
+    fprintf(gen->fp, "# isp nodes %u degree %u lan-size %u, seed %u\n", n,
+        gen->params->degree, gen->params->lan_size, gen->params->seed);
+    fprintf(gen->fp, "nodes %u\n", n + (gen->params->lan_size ? n / gen->params->lan_size : 0));
+
+    /*L2 core*/
+    for(i = 0; i < n_core; i++){
+        snprintf(name, sizeof(name), "core%u", i);
+        topo_gen_node(gen, name, AREA1);
+    }
+    if(!topo_gen_ring_chords(gen, 0, n_core, LEVEL2)){
+        printf("Error : isp : core ring could not be built\n");
+        return FALSE;
+    }
+
+    for(area = 0; area < n_areas; area++){
+
+        n_area_nodes = (n - n_core) / n_areas;
+        if(area == n_areas - 1)
+            n_area_nodes += (n - n_core) % n_areas;
+        n_access = n_area_nodes - 2;
+
+        /*A pair of L1L2 area border routers, each dual homed to the core*/
+        abr_base = gen->n_nodes;
+        for(i = 0; i < 2; i++){
+            snprintf(name, sizeof(name), "abr%u-%u", area, i);
+            topo_gen_node(gen, name, AREA2 + area);
+        }
+        if(!topo_gen_link(gen, abr_base, abr_base + 1, LEVEL12, TOPO_GEN_MAX_DEGREE)){
+            printf("Error : isp : area %u border routers could not be linked\n", area);
+            return FALSE;
+        }
+        for(i = 0; i < 2; i++){
+            if(!topo_gen_link(gen, abr_base + i, (2 * area + i) % n_core, LEVEL2, TOPO_GEN_MAX_DEGREE) ||
+                !topo_gen_link(gen, abr_base + i, (2 * area + i + 1) % n_core, LEVEL2, TOPO_GEN_MAX_DEGREE)){
+                printf("Error : isp : area %u border router %u could not be linked to the core, "
+                    "no free interface left\n", area, i);
+                return FALSE;
+            }
+        }
+
+        access_base = gen->n_nodes;
+        for(i = 0; i < n_access; i++){
+            snprintf(name, sizeof(name), "r%u-%u", area, i);
+            topo_gen_node(gen, name, AREA2 + area);
+        }
+        if(!topo_gen_ring_chords(gen, access_base, n_access, LEVEL1) ||
+            !topo_gen_link(gen, abr_base, access_base, LEVEL1, TOPO_GEN_MAX_DEGREE) ||
+            !topo_gen_link(gen, abr_base + 1, access_base + n_access / 2, LEVEL1, TOPO_GEN_MAX_DEGREE)){
+            printf("Error : isp : area %u access routers could not be linked, no free interface left\n", area);
+            return FALSE;
+        }
+
+        for(i = 0; i < n_access; i++)
+            topo_gen_subnet(gen, access_base + i, LEVEL1);
+
+        /*Access routers share broadcast LANs lan_size at a time*/
+        if(gen->params->lan_size < 2)
+            continue;
+        for(i = 0; i + gen->params->lan_size <= n_access; i += gen->params->lan_size){
+            for(j = 0; j < gen->params->lan_size; j++)
+                members[j] = access_base + i + j;
+            topo_gen_lan(gen, members, gen->params->lan_size, LEVEL1);
+        }
+    }
+
+    fprintf(gen->fp, "root r0-0\n");
+    return TRUE;
+}
+
+int
+topo_gen_write(topo_gen_type_t type, unsigned int size,
+               topo_gen_params_t *params, FILE *fp){
+
+    topo_gen_t gen;
+    unsigned int max_nodes = 0;
+    boolean rc = TRUE;
+
+    if(params->metric_min == 0 || params->metric_min > params->metric_max ||
+        params->metric_max >= INFINITE_METRIC / 2 || params->ecmp > 100){
+        printf("Error : Invalid link metric range or ecmp percent\n");
+        return -1;
+    }
+
+    if(params->degree < 2 || params->degree > TOPO_GEN_MAX_DEGREE - 2 ||
+        params->lan_size == 1 || params->lan_size > TOPO_GEN_MAX_DEGREE){
+        printf("Error : degree must be in [2, %u], lan-size 0 or in [2, %u]\n",
+            TOPO_GEN_MAX_DEGREE - 2, TOPO_GEN_MAX_DEGREE);
+        return -1;
+    }
+
+    switch(type){
+        case TOPO_GEN_CLOS:
+            if(size < 2 || size % 2 || size > TOPO_GEN_MAX_DEGREE){
+                printf("Error : clos k must be even and in [2, %u]\n", TOPO_GEN_MAX_DEGREE);
+                return -1;
+            }
+            max_nodes = size * size / 4 + size * size;
+            break;
+        case TOPO_GEN_GEOMETRIC:
+        case TOPO_GEN_WAXMAN:
+        case TOPO_GEN_ISP:
+            if(size < TOPO_GEN_MIN_NODES * (type == TOPO_GEN_ISP ? 2 : 1) ||
+                size > TOPO_GEN_MAX_NODES){
+                printf("Error : nodes must be in [%u, %u]\n",
+                    TOPO_GEN_MIN_NODES * (type == TOPO_GEN_ISP ? 2 : 1), TOPO_GEN_MAX_NODES);
+                return -1;
+            }
+            /*pseudonodes of isp LANs count as nodes*/
+            max_nodes = size + size / 2;
+            break;
+        default:
+            return -1;
+    }
+
+    memset(&gen, 0, sizeof(topo_gen_t));
+    gen.params = params;
+    gen.fp = fp;
+    topo_gen_seed(&gen, params->seed);
+
+    if(!topo_gen_alloc(&gen, max_nodes)){
+        topo_gen_free(&gen);
+        return -1;
+    }
+
+    switch(type){
+        case TOPO_GEN_CLOS:
+            topo_gen_clos(&gen, size);
+            break;
+        case TOPO_GEN_GEOMETRIC:
+            rc = topo_gen_geometric(&gen, size);
+            break;
+        case TOPO_GEN_WAXMAN:
+            rc = topo_gen_waxman(&gen, size);
+            break;
+        case TOPO_GEN_ISP:
+            rc = topo_gen_isp(&gen, size);
+            break;
+        default:
+            ;
+    }
+
+    topo_gen_free(&gen);
+    return (!rc || ferror(fp)) ? -1 : 0;
+}
+
+instance_t *
+topo_gen_instance(topo_gen_type_t type, unsigned int size,
+                  topo_gen_params_t *params){
+
+    FILE *fp = NULL;
+    instance_t *new_instance = NULL;
+    char name[64];
+
+    fp = tmpfile();
+    if(!fp){
+        printf("Error : Could not create temporary file\n");
+        return NULL;
+    }
+
+    if(topo_gen_write(type, size, params, fp) == 0){
+        rewind(fp);
+        snprintf(name, sizeof(name), "%s %s %u seed %u", topo_gen_type_str(type),
+            type == TOPO_GEN_CLOS ? "k" : "nodes", size, params->seed);
+        new_instance = topo_load_stream(fp, name);
+    }
+
+    fclose(fp);
+    return new_instance;
+}
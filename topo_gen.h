@@ -0,0 +1,109 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  topo_gen.h
+ *
+ *    Description:  Generators of large synthetic topologies for scale testing
+ *
+ *        Version:  1.0
+ *        Created:  Sunday 18 October 2026 19:06:29  UTC
+ *       Revision:  1.0
+ *       Compiler:  gcc
+ *
+ *         Author:  agent, agent@local
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        Copyright (c) 2026 agent.
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#ifndef __TOPO_GEN__
+#define __TOPO_GEN__
+
+#include <stdio.h>
+#include "instance.h"
+
+/* Generators write topo_loader.h statements, the topology is then built
+ * by the topology loader. Same seed and parameters give the same
+ * topology.
+ *
+ * clos k <k>
+ *      3 tier fat tree of k pods : k/2 edge and k/2 aggregation switches
+ *      per pod, (k/2)^2 core switches, 5k^2/4 nodes. Level 1. Every edge
+ *      switch advertises a /24 server subnet.
+ *
+ * geometric nodes <n>
+ *      Random geometric graph, nodes are placed at random in a unit square
+ *      and linked if closer than the radius giving the configured average
+ *      degree. Level 1.
+ *
+ * waxman nodes <n>
+ *      Waxman graph, nodes at distance d are linked with probability
+ *      alpha * exp(-d / (beta * L)), beta is scaled to the configured
+ *      average degree. Level 1.
+ *
+ * isp nodes <n>
+ *      Two level ISP : an L2 core, L1 areas (up to 5) hanging off a pair
+ *      of L1L2 area border routers each, access routers of an area grouped
+ *      on broadcast LANs (pseudonodes) of lan-size routers. Every access
+ *      router advertises a /24 customer subnet.
+ *
+ * geometric and waxman are made connected by a chain of extra links. The
+ * isp core and every area are built on a ring, generation fails if a ring
+ * or border router link finds no free interface. Link metric is metric-min for ecmp percent of the
+ * links (equal cost paths) and uniform in [metric-min, metric-max]
+ * otherwise*/
+
+#define TOPO_GEN_MIN_NODES      4
+#define TOPO_GEN_MAX_NODES      100000
+#define TOPO_GEN_MAX_DEGREE     (MAX_NODE_INTF_SLOTS / 2)   /*a link takes two interface slots*/
+
+typedef enum{
+
+    TOPO_GEN_CLOS,
+    TOPO_GEN_GEOMETRIC,
+    TOPO_GEN_WAXMAN,
+    TOPO_GEN_ISP,
+    TOPO_GEN_MAX
+} topo_gen_type_t;
+
+typedef struct topo_gen_params_{
+
+    unsigned int seed;
+    unsigned int ecmp;          /*percent of links with metric_min*/
+    unsigned int metric_min;
+    unsigned int metric_max;
+    unsigned int degree;        /*average degree of geometric, waxman and isp graphs*/
+    unsigned int lan_size;      /*routers per broadcast LAN of isp areas, 0 for p2p links only*/
+} topo_gen_params_t;
+
+/*Parameters used by "config instance generate"*/
+extern topo_gen_params_t topo_gen_params;
+
+/*Write the statements of the topology into fp, size is k for clos and the
+ * no of nodes otherwise. Return 0 on success*/
+int
+topo_gen_write(topo_gen_type_t type, unsigned int size,
+               topo_gen_params_t *params, FILE *fp);
+
+/*Generate the topology into a new instance and make it the current instance*/
+instance_t *
+topo_gen_instance(topo_gen_type_t type, unsigned int size,
+                  topo_gen_params_t *params);
+
+const char *
+topo_gen_type_str(topo_gen_type_t type);
+
+#endif /* __TOPO_GEN__ */
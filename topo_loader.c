@@ -0,0 +1,774 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  topo_loader.c
+ *
+ *    Description:  Single pass loader of network topologies described in a text file
+ *
+ *        Version:  1.0
+ *        Created:  Sunday 18 October 2026 18:33:52  UTC
+ *       Revision:  1.0
+ *       Compiler:  gcc
+ *
+ *         Author:  agent, agent@local
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        Copyright (c) 2026 agent.
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <arpa/inet.h>
+#include "topo_loader.h"
+#include "prefix.h"
+#include "spfutil.h"
+#include "igp_sr_ext.h"
+#include "sr_tlv_api.h"
+#include "LinuxMemoryManager/uapi_mm.h"
+
+extern instance_t *instance;
+
+#define TOPO_LOADER_HASH_INIT       2166136261U
+#define TOPO_LOADER_HASH_PRIME      16777619U
+#define TOPO_LOADER_MIN_INDEX_SIZE  1024
+#define TOPO_LOADER_MAX_TOKENS      32
+
+/*Loader state of a node declared in the file*/
+typedef struct topo_loader_node_{
+
+    node_t *node;
+    unsigned int n_slots;   /*edge end slots used in node->edges*/
+    LEVEL pn_level;         /*Levels at which the node is a pseudonode*/
+} topo_loader_node_t;
+
+/* Open addressing indexes of node names and router-ids, slots hold
+ * 1 + index into nodes[], 0 if free*/
+typedef struct topo_loader_{
+
+    char *file_name;
+    unsigned int line_no;
+    instance_t *instance;
+
+    topo_loader_node_t *nodes;
+    unsigned int n_nodes;
+    unsigned int max_nodes;
+
+    unsigned int *name_index;
+    unsigned int *rtr_id_index;
+    unsigned int index_size;    /*power of 2*/
+
+    node_t *root;
+    unsigned int n_links;
+    unsigned int n_prefixes;
+} topo_loader_t;
+
+static uint32_t
+topo_loader_hash(char *key){
+
+    uint32_t hash = TOPO_LOADER_HASH_INIT;
+
+    while(*key){
+        hash ^= (unsigned char)*key++;
+        hash *= TOPO_LOADER_HASH_PRIME;
+    }
+    return hash;
+}
+
+static char *
+topo_loader_node_name(topo_loader_t *loader, unsigned int i){
+
+    return loader->nodes[i].node->node_name;
+}
+
+static char *
+topo_loader_node_rtr_id(topo_loader_t *loader, unsigned int i){
+
+    return loader->nodes[i].node->router_id;
+}
+
+/*Slot of key in the index, either holding key or the free slot to insert it*/
+static unsigned int *
+topo_loader_index_slot(topo_loader_t *loader, unsigned int *index, char *key,
+            char *(*key_fn)(topo_loader_t *, unsigned int)){
+
+    unsigned int mask = loader->index_size - 1;
+    unsigned int h = topo_loader_hash(key) & mask;
+
+    while(index[h] && strcmp(key_fn(loader, index[h] - 1), key))
+        h = (h + 1) & mask;
+    return &index[h];
+}
+
+static void
+topo_loader_index_resize(topo_loader_t *loader, unsigned int index_size){
+
+    unsigned int i;
+
+    free(loader->name_index);
+    free(loader->rtr_id_index);
+    loader->index_size = index_size;
+    loader->name_index = calloc(index_size, sizeof(unsigned int));
+    loader->rtr_id_index = calloc(index_size, sizeof(unsigned int));
+    assert(loader->name_index && loader->rtr_id_index);
+
+    for(i = 0; i < loader->n_nodes; i++){
+        *topo_loader_index_slot(loader, loader->name_index,
+            topo_loader_node_name(loader, i), topo_loader_node_name) = i + 1;
+        if(loader->nodes[i].pn_level)
+            continue;
+        *topo_loader_index_slot(loader, loader->rtr_id_index,
+            topo_loader_node_rtr_id(loader, i), topo_loader_node_rtr_id) = i + 1;
+    }
+}
+
+static void
+topo_loader_reserve_nodes(topo_loader_t *loader, unsigned int n_nodes){
+
+    if(n_nodes <= loader->max_nodes)
+        return;
+    loader->max_nodes = n_nodes;
+    loader->nodes = realloc(loader->nodes,
+        loader->max_nodes * sizeof(topo_loader_node_t));
+    assert(loader->nodes);
+}
+
+static void
+topo_loader_presize(topo_loader_t *loader, unsigned int n_nodes){
+
+    unsigned int index_size = TOPO_LOADER_MIN_INDEX_SIZE;
+
+    while(index_size < 2 * n_nodes)
+        index_size <<= 1;
+
+    topo_loader_reserve_nodes(loader, n_nodes);
+    if(index_size > loader->index_size)
+        topo_loader_index_resize(loader, index_size);
+}
+
+static topo_loader_node_t *
+topo_loader_lookup(topo_loader_t *loader, char *node_name){
+
+    unsigned int *slot = topo_loader_index_slot(loader,
+        loader->name_index, node_name, topo_loader_node_name);
+
+    return *slot ? &loader->nodes[*slot - 1] : NULL;
+}
+
+static void
+topo_loader_error(topo_loader_t *loader, const char *msg, char *arg){
+
+    printf("Error : %s:%u : %s%s%s\n", loader->file_name,
+        loader->line_no, msg, arg ? " : " : "", arg ? arg : "");
+}
+
+static boolean
+topo_loader_parse_uint(char *token, unsigned int *value){
+
+    char *end = NULL;
+    unsigned long val;
+
+    if(!token || !*token)
+        return FALSE;
+    val = strtoul(token, &end, 10);
+    if(*end || val > UINT32_MAX)
+        return FALSE;
+    *value = (unsigned int)val;
+    return TRUE;
+}
+
+static boolean
+topo_loader_parse_level(char *token, LEVEL *level){
+
+    if(!token)
+        return FALSE;
+    if(strcmp(token, "1") == 0)
+        *level = LEVEL1;
+    else if(strcmp(token, "2") == 0)
+        *level = LEVEL2;
+    else if(strcmp(token, "12") == 0)
+        *level = LEVEL12;
+    else
+        return FALSE;
+    return TRUE;
+}
+
+static boolean
+topo_loader_parse_ip(char *token){
+
+    struct in_addr addr;
+
+    return token && strlen(token) < PREFIX_LEN &&
+           inet_pton(AF_INET, token, &addr) == 1;
+}
+
+/*<prefix>/<mask>, splits the token in place*/
+static boolean
+topo_loader_parse_prefix(char *token, char **prefix, unsigned char *mask){
+
+    char *slash = NULL;
+    unsigned int _mask = 0;
+
+    if(!token || !(slash = strchr(token, '/')))
+        return FALSE;
+    *slash = '\0';
+    if(!topo_loader_parse_ip(token) ||
+        !topo_loader_parse_uint(slash + 1, &_mask) || _mask > 32)
+        return FALSE;
+    *prefix = token;
+    *mask = (unsigned char)_mask;
+    return TRUE;
+}
+
+static void
+topo_loader_enable_spring(node_t *node){
+
+    if(node->spring_enabled)
+        return;
+    node->spring_enabled = TRUE;
+    node->srgb = XCALLOC(1, srgb_t);
+    init_srgb_defaults(node->srgb);
+}
+
+static topo_loader_node_t *
+topo_loader_add_node(topo_loader_t *loader, char *node_name,
+                     char *router_id, AREA area, LEVEL pn_level){
+
+    unsigned int *name_slot = NULL,
+                 *rtr_id_slot = NULL;
+    topo_loader_node_t *lnode = NULL;
+
+    if(strlen(node_name) >= NODE_NAME_SIZE){
+        topo_loader_error(loader, "Node name too long", node_name);
+        return NULL;
+    }
+
+    if(!topo_loader_parse_ip(router_id)){
+        topo_loader_error(loader, "Invalid router-id", router_id);
+        return NULL;
+    }
+
+    if(loader->n_nodes == loader->max_nodes)
+        topo_loader_reserve_nodes(loader, loader->max_nodes << 1);
+
+    if(2 * (loader->n_nodes + 1) > loader->index_size)
+        topo_loader_index_resize(loader, loader->index_size << 1);
+
+    name_slot = topo_loader_index_slot(loader,
+        loader->name_index, node_name, topo_loader_node_name);
+    if(*name_slot){
+        topo_loader_error(loader, "Node already exists", node_name);
+        return NULL;
+    }
+
+    if(!pn_level){
+        rtr_id_slot = topo_loader_index_slot(loader,
+            loader->rtr_id_index, router_id, topo_loader_node_rtr_id);
+        if(*rtr_id_slot){
+            topo_loader_error(loader, "Router-id already in use", router_id);
+            return NULL;
+        }
+    }
+
+    lnode = &loader->nodes[loader->n_nodes];
+    lnode->node = _create_new_node(loader->instance, node_name, area, router_id);
+    lnode->n_slots = 0;
+    lnode->pn_level = pn_level;
+
+    *name_slot = ++loader->n_nodes;
+    if(rtr_id_slot)
+        *rtr_id_slot = loader->n_nodes;
+
+    if(!loader->root)
+        loader->root = lnode->node;
+    return lnode;
+}
+
+/*node <node-name> <router-id> [area <1-6>] [srgb <start-label> <range>] [node-sid <index>]*/
+static boolean
+topo_loader_node_stmt(topo_loader_t *loader, char **tokens, unsigned int n_tokens){
+
+    unsigned int i = 3, area_no = 1,
+                 first_sid = 0, range = 0,
+                 node_sid = 0;
+    boolean srgb = FALSE,
+            has_node_sid = FALSE;
+    topo_loader_node_t *lnode = NULL;
+
+    if(n_tokens < 3){
+        topo_loader_error(loader, "Usage : node <node-name> <router-id> [options]", NULL);
+        return FALSE;
+    }
+
+    while(i < n_tokens){
+        if(strcmp(tokens[i], "area") == 0 && i + 1 < n_tokens){
+            if(!topo_loader_parse_uint(tokens[i + 1], &area_no) ||
+                area_no < 1 || area_no > AREA_UNKNOWN){
+                topo_loader_error(loader, "Invalid area", tokens[i + 1]);
+                return FALSE;
+            }
+            i += 2;
+        }
+        else if(strcmp(tokens[i], "srgb") == 0 && i + 2 < n_tokens){
+            if(!topo_loader_parse_uint(tokens[i + 1], &first_sid) ||
+                !topo_loader_parse_uint(tokens[i + 2], &range) || !range){
+                topo_loader_error(loader, "Invalid srgb", tokens[i + 1]);
+                return FALSE;
+            }
+            srgb = TRUE;
+            i += 3;
+        }
+        else if(strcmp(tokens[i], "node-sid") == 0 && i + 1 < n_tokens){
+            if(!topo_loader_parse_uint(tokens[i + 1], &node_sid)){
+                topo_loader_error(loader, "Invalid node-sid", tokens[i + 1]);
+                return FALSE;
+            }
+            has_node_sid = TRUE;
+            i += 2;
+        }
+        else{
+            topo_loader_error(loader, "Unknown node option", tokens[i]);
+            return FALSE;
+        }
+    }
+
+    lnode = topo_loader_add_node(loader, tokens[1], tokens[2],
+                AREA1 + area_no - 1, LEVEL_UNKNOWN);
+    if(!lnode)
+        return FALSE;
+
+    if(srgb){
+        topo_loader_enable_spring(lnode->node);
+        lnode->node->srgb->first_sid.sid = first_sid;
+        lnode->node->srgb->range = range;
+        /*index array was sized for the default range, no index is in use yet*/
+        free_bit_array(&lnode->node->srgb->index_array);
+        init_bit_array(&lnode->node->srgb->index_array, range);
+    }
+
+    if(has_node_sid){
+        topo_loader_enable_spring(lnode->node);
+        if(node_sid >= lnode->node->srgb->range){
+            topo_loader_error(loader, "node-sid out of srgb range", tokens[1]);
+            return FALSE;
+        }
+        set_node_sid(lnode->node, node_sid);
+    }
+    return TRUE;
+}
+
+/*pseudonode <node-name> <router-id> [level <level>]*/
+static boolean
+topo_loader_pseudonode_stmt(topo_loader_t *loader, char **tokens, unsigned int n_tokens){
+
+    LEVEL level = LEVEL1;
+
+    if(n_tokens != 3 &&
+        (n_tokens != 5 || strcmp(tokens[3], "level") ||
+         !topo_loader_parse_level(tokens[4], &level))){
+        topo_loader_error(loader, "Usage : pseudonode <node-name> <router-id> [level <1|2|12>]", NULL);
+        return FALSE;
+    }
+
+    return topo_loader_add_node(loader, tokens[1], tokens[2], AREA1, level) != NULL;
+}
+
+/*link <node-name1> <if-name1> <node-name2> <if-name2> ip <prefix1>/<mask> <prefix2>/<mask>
+ *     [level <level>] [metric <metric>] [l2-metric <metric>]*/
+static boolean
+topo_loader_link_stmt(topo_loader_t *loader, char **tokens, unsigned int n_tokens){
+
+    topo_loader_node_t *lnode1 = NULL,
+                       *lnode2 = NULL;
+    char *if_name1 = NULL, *if_name2 = NULL,
+         *ip1 = NULL, *ip2 = NULL;
+    unsigned char mask1 = 0, mask2 = 0;
+    unsigned int i = 5, metric = 10, l2_metric = 0;
+    boolean has_l2_metric = FALSE;
+    LEVEL level = LEVEL1;
+    edge_t *edge = NULL;
+
+    if(n_tokens < 5){
+        topo_loader_error(loader, "Usage : link <node-name1> <if-name1> <node-name2> <if-name2> [options]", NULL);
+        return FALSE;
+    }
+
+    lnode1 = topo_loader_lookup(loader, tokens[1]);
+    if(!lnode1){
+        topo_loader_error(loader, "Node do not exist", tokens[1]);
+        return FALSE;
+    }
+
+    lnode2 = topo_loader_lookup(loader, tokens[3]);
+    if(!lnode2){
+        topo_loader_error(loader, "Node do not exist", tokens[3]);
+        return FALSE;
+    }
+
+    if(lnode1 == lnode2){
+        topo_loader_error(loader, "Link to self", tokens[1]);
+        return FALSE;
+    }
+
+    if_name1 = strcmp(tokens[2], "-") ? tokens[2] : NULL;
+    if_name2 = strcmp(tokens[4], "-") ? tokens[4] : NULL;
+
+    while(i < n_tokens){
+        if(strcmp(tokens[i], "level") == 0 && i + 1 < n_tokens){
+            if(!topo_loader_parse_level(tokens[i + 1], &level)){
+                topo_loader_error(loader, "Invalid level", tokens[i + 1]);
+                return FALSE;
+            }
+            i += 2;
+        }
+        else if(strcmp(tokens[i], "metric") == 0 && i + 1 < n_tokens){
+            if(!topo_loader_parse_uint(tokens[i + 1], &metric) ||
+                metric >= INFINITE_METRIC){
+                topo_loader_error(loader, "Invalid metric", tokens[i + 1]);
+                return FALSE;
+            }
+            i += 2;
+        }
+        else if(strcmp(tokens[i], "l2-metric") == 0 && i + 1 < n_tokens){
+            if(!topo_loader_parse_uint(tokens[i + 1], &l2_metric) ||
+                l2_metric >= INFINITE_METRIC){
+                topo_loader_error(loader, "Invalid l2-metric", tokens[i + 1]);
+                return FALSE;
+            }
+            has_l2_metric = TRUE;
+            i += 2;
+        }
+        else if(strcmp(tokens[i], "ip") == 0 && i + 2 < n_tokens){
+            if(strcmp(tokens[i + 1], "-") &&
+                !topo_loader_parse_prefix(tokens[i + 1], &ip1, &mask1)){
+                topo_loader_error(loader, "Invalid prefix", tokens[i + 1]);
+                return FALSE;
+            }
+            if(strcmp(tokens[i + 2], "-") &&
+                !topo_loader_parse_prefix(tokens[i + 2], &ip2, &mask2)){
+                topo_loader_error(loader, "Invalid prefix", tokens[i + 2]);
+                return FALSE;
+            }
+            i += 3;
+        }
+        else if(strcmp(tokens[i], "ip") == 0){
+            topo_loader_error(loader, "Missing address, ip takes a prefix for each end, - for a pseudonode end",
+                i + 1 < n_tokens ? tokens[i + 1] : NULL);
+            return FALSE;
+        }
+        else if(strcmp(tokens[i], "level") == 0 || strcmp(tokens[i], "metric") == 0 ||
+                strcmp(tokens[i], "l2-metric") == 0){
+            topo_loader_error(loader, "Missing value", tokens[i]);
+            return FALSE;
+        }
+        else{
+            topo_loader_error(loader, "Unknown link option", tokens[i]);
+            return FALSE;
+        }
+    }
+
+    /*SPF takes the gateway of a nexthop from the prefix of the far end, a
+     * router end of a link needs a prefix, a pseudonode end has none*/
+    if(!ip1 != !!lnode1->pn_level || !if_name1 != !!lnode1->pn_level){
+        topo_loader_error(loader, lnode1->pn_level ? 
+            "Pseudonode end takes no interface or prefix" :
+            "Router end needs an interface and a prefix", tokens[1]);
+        return FALSE;
+    }
+
+    if(!ip2 != !!lnode2->pn_level || !if_name2 != !!lnode2->pn_level){
+        topo_loader_error(loader, lnode2->pn_level ? 
+            "Pseudonode end takes no interface or prefix" :
+            "Router end needs an interface and a prefix", tokens[3]);
+        return FALSE;
+    }
+
+    if((if_name1 && strlen(if_name1) >= IF_NAME_SIZE) ||
+        (if_name2 && strlen(if_name2) >= IF_NAME_SIZE)){
+        topo_loader_error(loader, "Interface name too long", NULL);
+        return FALSE;
+    }
+
+    if((if_name1 && get_interface_from_intf_name(lnode1->node, if_name1)) ||
+        (if_name2 && get_interface_from_intf_name(lnode2->node, if_name2))){
+        topo_loader_error(loader, "Interface already exists",
+            if_name1 && get_interface_from_intf_name(lnode1->node, if_name1) ?
+            if_name1 : if_name2);
+        return FALSE;
+    }
+
+    /*A bidirectional link takes an outgoing and an incoming edge end slot on both nodes*/
+    if(lnode1->n_slots + 2 > MAX_NODE_INTF_SLOTS ||
+        lnode2->n_slots + 2 > MAX_NODE_INTF_SLOTS){
+        topo_loader_error(loader, "No interface slots left on node",
+            lnode1->n_slots + 2 > MAX_NODE_INTF_SLOTS ? tokens[1] : tokens[3]);
+        return FALSE;
+    }
+
+    edge = create_new_edge(if_name1, if_name2, metric,
+                ip1 ? create_new_prefix(ip1, mask1, level) : NULL,
+                ip2 ? create_new_prefix(ip2, mask2, level) : NULL,
+                level);
+
+    insert_edge_between_2_nodes(edge, lnode1->node, lnode2->node, BIDIRECTIONAL);
+    lnode1->n_slots += 2;
+    lnode2->n_slots += 2;
+
+    if(has_l2_metric && IS_LEVEL_SET(level, LEVEL2)){
+        edge->metric[LEVEL2] = l2_metric;
+        edge->inv_edge->metric[LEVEL2] = l2_metric;
+    }
+
+    loader->n_links++;
+    return TRUE;
+}
+
+/*prefix <node-name> <prefix>/<mask> [level <level>] [metric <metric>] [sid <index>]*/
+static boolean
+topo_loader_prefix_stmt(topo_loader_t *loader, char **tokens, unsigned int n_tokens){
+
+    topo_loader_node_t *lnode = NULL;
+    char *ip = NULL;
+    unsigned char mask = 0;
+    unsigned int i = 3, metric = 0, sid = 0;
+    boolean has_sid = FALSE;
+    LEVEL level = LEVEL1, level_it;
+    prefix_t *prefix = NULL;
+
+    if(n_tokens < 3){
+        topo_loader_error(loader, "Usage : prefix <node-name> <prefix>/<mask> [options]", NULL);
+        return FALSE;
+    }
+
+    lnode = topo_loader_lookup(loader, tokens[1]);
+    if(!lnode){
+        topo_loader_error(loader, "Node do not exist", tokens[1]);
+        return FALSE;
+    }
+
+    if(!topo_loader_parse_prefix(tokens[2], &ip, &mask)){
+        topo_loader_error(loader, "Invalid prefix", tokens[2]);
+        return FALSE;
+    }
+
+    while(i < n_tokens){
+        if(strcmp(tokens[i], "level") == 0 && i + 1 < n_tokens){
+            if(!topo_loader_parse_level(tokens[i + 1], &level)){
+                topo_loader_error(loader, "Invalid level", tokens[i + 1]);
+                return FALSE;
+            }
+            i += 2;
+        }
+        else if(strcmp(tokens[i], "metric") == 0 && i + 1 < n_tokens){
+            if(!topo_loader_parse_uint(tokens[i + 1], &metric)){
+                topo_loader_error(loader, "Invalid metric", tokens[i + 1]);
+                return FALSE;
+            }
+            i += 2;
+        }
+        else if(strcmp(tokens[i], "sid") == 0 && i + 1 < n_tokens){
+            if(!topo_loader_parse_uint(tokens[i + 1], &sid)){
+                topo_loader_error(loader, "Invalid sid", tokens[i + 1]);
+                return FALSE;
+            }
+            has_sid = TRUE;
+            i += 2;
+        }
+        else{
+            topo_loader_error(loader, "Unknown prefix option", tokens[i]);
+            return FALSE;
+        }
+    }
+
+    if(has_sid){
+        topo_loader_enable_spring(lnode->node);
+        if(sid >= lnode->node->srgb->range){
+            topo_loader_error(loader, "sid out of srgb range", tokens[2]);
+            return FALSE;
+        }
+    }
+
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+
+        if(!IS_LEVEL_SET(level, level_it))
+            continue;
+
+        prefix = attach_prefix_on_node(lnode->node, ip, mask, level_it, metric, 0);
+        if(!prefix){
+            topo_loader_error(loader, "Prefix already exists", ip);
+            return FALSE;
+        }
+        if(has_sid)
+            update_prefix_sid(lnode->node, prefix, sid, level_it);
+    }
+
+    loader->n_prefixes++;
+    return TRUE;
+}
+
+static boolean
+topo_loader_stmt(topo_loader_t *loader, char **tokens, unsigned int n_tokens){
+
+    topo_loader_node_t *lnode = NULL;
+    unsigned int n_nodes = 0;
+
+    if(strcmp(tokens[0], "node") == 0)
+        return topo_loader_node_stmt(loader, tokens, n_tokens);
+    if(strcmp(tokens[0], "link") == 0)
+        return topo_loader_link_stmt(loader, tokens, n_tokens);
+    if(strcmp(tokens[0], "prefix") == 0)
+        return topo_loader_prefix_stmt(loader, tokens, n_tokens);
+    if(strcmp(tokens[0], "pseudonode") == 0)
+        return topo_loader_pseudonode_stmt(loader, tokens, n_tokens);
+
+    if(strcmp(tokens[0], "root") == 0){
+        if(n_tokens != 2 || !(lnode = topo_loader_lookup(loader, tokens[1]))){
+            topo_loader_error(loader, "Usage : root <node-name>, node must exist", NULL);
+            return FALSE;
+        }
+        loader->root = lnode->node;
+        return TRUE;
+    }
+
+    if(strcmp(tokens[0], "nodes") == 0){
+        if(n_tokens != 2 || !topo_loader_parse_uint(tokens[1], &n_nodes) ||
+            loader->n_nodes){
+            topo_loader_error(loader, "Usage : nodes <count>, before the first node", NULL);
+            return FALSE;
+        }
+        topo_loader_presize(loader, n_nodes);
+        return TRUE;
+    }
+
+    topo_loader_error(loader, "Unknown statement", tokens[0]);
+    return FALSE;
+}
+
+static boolean
+topo_loader_read(topo_loader_t *loader, FILE *fp){
+
+    char line[TOPO_LOADER_MAX_LINE];
+    char *tokens[TOPO_LOADER_MAX_TOKENS];
+    char *token = NULL, *save_ptr = NULL, *comment = NULL;
+    unsigned int n_tokens = 0, i;
+
+    while(fgets(line, sizeof(line), fp)){
+
+        loader->line_no++;
+
+        if(!strchr(line, '\n') && !feof(fp)){
+            topo_loader_error(loader, "Line too long", NULL);
+            return FALSE;
+        }
+
+        if((comment = strchr(line, '#')))
+            *comment = '\0';
+
+        n_tokens = 0;
+        for(token = strtok_r(line, " \t\r\n", &save_ptr); token;
+                token = strtok_r(NULL, " \t\r\n", &save_ptr)){
+
+            if(n_tokens == TOPO_LOADER_MAX_TOKENS){
+                topo_loader_error(loader, "Too many tokens", NULL);
+                return FALSE;
+            }
+            tokens[n_tokens++] = token;
+        }
+
+        if(!n_tokens)
+            continue;
+
+        if(!topo_loader_stmt(loader, tokens, n_tokens))
+            return FALSE;
+    }
+
+    if(ferror(fp)){
+        topo_loader_error(loader, "Read error", NULL);
+        return FALSE;
+    }
+
+    if(!loader->n_nodes){
+        topo_loader_error(loader, "No nodes", NULL);
+        return FALSE;
+    }
+
+    /*Pseudonodes are marked once all their links are in place*/
+    for(i = 0; i < loader->n_nodes; i++){
+        if(IS_LEVEL_SET(loader->nodes[i].pn_level, LEVEL1))
+            mark_node_pseudonode(loader->nodes[i].node, LEVEL1);
+        if(IS_LEVEL_SET(loader->nodes[i].pn_level, LEVEL2))
+            mark_node_pseudonode(loader->nodes[i].node, LEVEL2);
+    }
+    return TRUE;
+}
+
+instance_t *
+topo_load_stream(FILE *fp, char *name){
+
+    topo_loader_t loader;
+    instance_t *old_instance = instance;
+    boolean rc = FALSE;
+    struct timespec start_time, end_time;
+
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+    memset(&loader, 0, sizeof(topo_loader_t));
+    loader.file_name = name;
+    topo_loader_presize(&loader, TOPO_LOADER_MIN_INDEX_SIZE / 2);
+
+    /*Node creation and prefix attachment trace against the current instance*/
+    loader.instance = get_new_instance();
+    instance = loader.instance;
+
+    rc = topo_loader_read(&loader, fp);
+
+    if(rc){
+        set_instance_root(loader.instance, loader.root);
+        clock_gettime(CLOCK_MONOTONIC, &end_time);
+        printf("Info : Loaded %s : %u nodes, %u links, %u prefixes in %llu ms\n",
+            name, loader.n_nodes, loader.n_links, loader.n_prefixes,
+            ((unsigned long long)(end_time.tv_sec - start_time.tv_sec) * 1000000000ULL +
+            end_time.tv_nsec - start_time.tv_nsec) / 1000000ULL);
+    }
+    else{
+        /*Partially built instance is kept, like the replaced one, see topo_loader.h*/
+        instance = old_instance;
+    }
+
+    free(loader.nodes);
+    free(loader.name_index);
+    free(loader.rtr_id_index);
+    return rc ? loader.instance : NULL;
+}
+
+instance_t *
+topo_load_file(char *file_name){
+
+    FILE *fp = NULL;
+    instance_t *new_instance = NULL;
+
+    fp = fopen(file_name, "r");
+    if(!fp){
+        printf("Error : Could not open topology file %s\n", file_name);
+        return NULL;
+    }
+
+    new_instance = topo_load_stream(fp, file_name);
+    fclose(fp);
+    return new_instance;
+}
@@ -0,0 +1,98 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  topo_loader.h
+ *
+ *    Description:  Loader of network topologies described in a text file
+ *
+ *        Version:  1.0
+ *        Created:  Sunday 18 October 2026 18:33:52  UTC
+ *       Revision:  1.0
+ *       Compiler:  gcc
+ *
+ *         Author:  agent, agent@local
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        Copyright (c) 2026 agent.
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#ifndef __TOPO_LOADER__
+#define __TOPO_LOADER__
+
+#include <stdio.h>
+#include "instance.h"
+
+/* Topology file format. One statement per line, tokens are separated by
+ * white space, '#' starts a comment. The file is read in a single pass,
+ * a node must be declared before the first statement which refers to it.
+ * <level> is 1, 2 or 12.
+ *
+ * nodes <count>
+ *      Optional sizing hint, expected number of nodes. Must come before
+ *      the first node.
+ *
+ * node <node-name> <router-id> [area <1-6>] [srgb <start-label> <range>]
+ *                                           [node-sid <index>]
+ *      Router. srgb or node-sid enable source packet routing on the node,
+ *      node-sid is the prefix SID index of the router-id.
+ *
+ * pseudonode <node-name> <router-id> [level <level>]
+ *      LAN pseudonode (default level 1). Its router-id is the one of the
+ *      DIS and may repeat the router-id of a node.
+ *
+ * link <node-name1> <if-name1> <node-name2> <if-name2> ip <prefix1>/<mask> <prefix2>/<mask>
+ *      [level <level>] [metric <metric>] [l2-metric <metric>]
+ *      Bidirectional link (default level 1, metric 10). metric applies to
+ *      both levels unless l2-metric is given. A router end needs an
+ *      interface and a prefix, the interface and the prefix of the
+ *      pseudonode end of a LAN link are written as '-'.
+ *
+ * prefix <node-name> <prefix>/<mask> [level <level>] [metric <metric>] [sid <index>]
+ *      Prefix advertised by the node (default level 1, metric 0).
+ *
+ * root <node-name>
+ *      Instance root, the first node declared if absent.
+ *
+ * Example :
+ *
+ *  nodes 3
+ *  node A 192.168.0.1 node-sid 1
+ *  node B 192.168.0.2 node-sid 2
+ *  pseudonode PN 192.168.0.1
+ *  link A eth0/1 B eth0/1 metric 10 ip 10.1.1.1/24 10.1.1.2/24
+ *  link A eth0/2 PN - ip 20.1.1.1/24 -
+ *  link B eth0/2 PN - ip 20.1.1.2/24 -
+ *  prefix B 100.1.1.0/24 metric 5 sid 100
+ *  root A
+ */
+
+#define TOPO_LOADER_MAX_LINE    512
+
+/* Load the topology file into a new instance and make it the current
+ * instance. On error the current instance is left as is and NULL is
+ * returned. The replaced instance (or the partially built one on error)
+ * is kept on purpose : there is no instance teardown, and per level state
+ * outside the instance (batched nbr SPF, TI-LFA remote SPF cache, SPF
+ * scheduler) keeps pointers to its nodes until recomputed*/
+instance_t *
+topo_load_file(char *file_name);
+
+/*Same as topo_load_file(), statements are read from fp, name is used in
+ * messages only*/
+instance_t *
+topo_load_stream(FILE *fp, char *name);
+
+#endif /* __TOPO_LOADER__ */
@@ -0,0 +1,652 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  topo_snapshot.c
+ *
+ *    Description:  Binary snapshot of an instance, memory mapped and used by SPF as is
+ *
+ *        Version:  1.0
+ *        Created:  Sunday 18 October 2026 18:40:18  UTC
+ *       Revision:  1.0
+ *       Compiler:  gcc
+ *
+ *         Author:  agent, agent@local
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        Copyright (c) 2026 agent.
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "topo_snapshot.h"
+#include "spfutil.h"
+#include "sr_tlv_api.h"
+#include "CommandParser/serialize.h"
+
+topo_snapshot_t *curr_topo_snapshot = NULL;
+
+/*Writer*/
+
+/*Adjacencies of the node written to the snapshot at level, the same
+ * which run_dijkastra() relaxes*/
+#define ITERATE_SNAPSHOT_ADJS_BEGIN(_node, _nbr_node, _edge, _level)    \
+    ITERATE_NODE_LOGICAL_NBRS_BEGIN(_node, _nbr_node, _edge, _level){   \
+        if(!is_two_way_nbrship(_node, _nbr_node, _level))               \
+            continue;
+
+#define ITERATE_SNAPSHOT_ADJS_END   } ITERATE_NODE_LOGICAL_NBRS_END
+
+int
+topo_snapshot_write(instance_t *instance, char *file_name){
+
+    FILE *fp = NULL;
+    ser_buff_t *b = NULL;
+    singly_ll_node_t *list_node = NULL,
+                     *prefix_list_node = NULL;
+    node_t *node = NULL,
+           *nbr_node = NULL;
+    edge_t *edge = NULL;
+    prefix_t *prefix = NULL;
+    LEVEL level_it;
+    uint32_t n_nodes = 0,
+             offset = 0,
+             *node_snapshot_index = NULL;
+    uint64_t file_offset = 0;
+    topo_snapshot_hdr_t hdr;
+    topo_snapshot_node_t snode;
+    topo_snapshot_adj_t sadj;
+    topo_snapshot_prefix_t sprefix;
+    int rc = -1;
+
+    if(!instance || !instance->instance_root){
+        printf("Error : No instance to snapshot\n");
+        return -1;
+    }
+
+    /*Pass 1 : assign snapshot node indices and count the records*/
+    memset(&hdr, 0, sizeof(topo_snapshot_hdr_t));
+    node_snapshot_index = calloc(instance->n_node_index, sizeof(uint32_t));
+
+    ITERATE_LIST_BEGIN(instance->instance_node_list, list_node){
+        node = list_node->data;
+        node_snapshot_index[node->node_index] = n_nodes++;
+    } ITERATE_LIST_END;
+
+    ITERATE_LIST_BEGIN(instance->instance_node_list, list_node){
+        node = list_node->data;
+        for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+            ITERATE_SNAPSHOT_ADJS_BEGIN(node, nbr_node, edge, level_it){
+                hdr.n_adjs[level_it]++;
+            } ITERATE_SNAPSHOT_ADJS_END;
+            hdr.n_prefixes += GET_NODE_COUNT_SINGLY_LL(GET_NODE_PREFIX_LIST(node, level_it));
+        }
+    } ITERATE_LIST_END;
+
+    hdr.magic = TOPO_SNAPSHOT_MAGIC;
+    hdr.version = TOPO_SNAPSHOT_VERSION;
+    hdr.hdr_size = sizeof(topo_snapshot_hdr_t);
+    hdr.node_size = sizeof(topo_snapshot_node_t);
+    hdr.adj_size = sizeof(topo_snapshot_adj_t);
+    hdr.prefix_size = sizeof(topo_snapshot_prefix_t);
+    hdr.n_nodes = n_nodes;
+    hdr.root = node_snapshot_index[instance->instance_root->node_index];
+
+    file_offset = sizeof(topo_snapshot_hdr_t);
+    hdr.nodes_offset = file_offset;
+    file_offset += (uint64_t)n_nodes * sizeof(topo_snapshot_node_t);
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+        hdr.adj_offset_offset[level_it] = file_offset;
+        file_offset += (uint64_t)(n_nodes + 1) * sizeof(uint32_t);
+        hdr.adjs_offset[level_it] = file_offset;
+        file_offset += (uint64_t)hdr.n_adjs[level_it] * sizeof(topo_snapshot_adj_t);
+    }
+    hdr.prefix_offset_offset = file_offset;
+    file_offset += (uint64_t)(n_nodes + 1) * sizeof(uint32_t);
+    hdr.prefixes_offset = file_offset;
+    file_offset += (uint64_t)hdr.n_prefixes * sizeof(topo_snapshot_prefix_t);
+    hdr.file_size = file_offset;
+
+    if(file_offset > INT32_MAX){
+        printf("Error : Snapshot of %llu bytes is too large\n", (unsigned long long)file_offset);
+        free(node_snapshot_index);
+        return -1;
+    }
+
+    /*Pass 2 : serialize the sections in file order*/
+    init_serialized_buffer_of_defined_size(&b, (int)file_offset);
+    serialize_string(b, (char *)&hdr, sizeof(topo_snapshot_hdr_t));
+
+    ITERATE_LIST_BEGIN(instance->instance_node_list, list_node){
+        node = list_node->data;
+        memset(&snode, 0, sizeof(topo_snapshot_node_t));
+        strncpy(snode.node_name, node->node_name, NODE_NAME_SIZE - 1);
+        strncpy(snode.router_id, node->router_id, PREFIX_LEN);
+        for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+            snode.node_type[level_it] = node->node_type[level_it];
+            snode.overloaded[level_it] = IS_OVERLOADED(node, level_it) ? 1 : 0;
+        }
+        snode.area = node->area;
+        snode.spring_enabled = node->spring_enabled ? 1 : 0;
+        if(node->spring_enabled && node->srgb){
+            snode.srgb_first_label = node->srgb->first_sid.sid;
+            snode.srgb_range = node->srgb->range;
+        }
+        serialize_string(b, (char *)&snode, sizeof(topo_snapshot_node_t));
+    } ITERATE_LIST_END;
+
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+
+        offset = 0;
+        ITERATE_LIST_BEGIN(instance->instance_node_list, list_node){
+            node = list_node->data;
+            serialize_string(b, (char *)&offset, sizeof(uint32_t));
+            ITERATE_SNAPSHOT_ADJS_BEGIN(node, nbr_node, edge, level_it){
+                offset++;
+            } ITERATE_SNAPSHOT_ADJS_END;
+        } ITERATE_LIST_END;
+        serialize_string(b, (char *)&offset, sizeof(uint32_t));
+
+        ITERATE_LIST_BEGIN(instance->instance_node_list, list_node){
+            node = list_node->data;
+            ITERATE_SNAPSHOT_ADJS_BEGIN(node, nbr_node, edge, level_it){
+                sadj.nbr = node_snapshot_index[nbr_node->node_index];
+                sadj.metric = edge->metric[level_it];
+                sadj.etype = edge->etype;
+                serialize_string(b, (char *)&sadj, sizeof(topo_snapshot_adj_t));
+            } ITERATE_SNAPSHOT_ADJS_END;
+        } ITERATE_LIST_END;
+    }
+
+    offset = 0;
+    ITERATE_LIST_BEGIN(instance->instance_node_list, list_node){
+        node = list_node->data;
+        serialize_string(b, (char *)&offset, sizeof(uint32_t));
+        for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++)
+            offset += GET_NODE_COUNT_SINGLY_LL(GET_NODE_PREFIX_LIST(node, level_it));
+    } ITERATE_LIST_END;
+    serialize_string(b, (char *)&offset, sizeof(uint32_t));
+
+    ITERATE_LIST_BEGIN(instance->instance_node_list, list_node){
+        node = list_node->data;
+        for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+            ITERATE_LIST_BEGIN(GET_NODE_PREFIX_LIST(node, level_it), prefix_list_node){
+                prefix = prefix_list_node->data;
+                memset(&sprefix, 0, sizeof(topo_snapshot_prefix_t));
+                strncpy(sprefix.prefix, prefix->prefix, PREFIX_LEN);
+                sprefix.mask = prefix->mask;
+                sprefix.level = level_it;
+                sprefix.metric = prefix->metric;
+                sprefix.sid = prefix->psid_thread_ptr ?
+                    PREFIX_SID_INDEX(prefix) : TOPO_SNAPSHOT_NO_SID;
+                serialize_string(b, (char *)&sprefix, sizeof(topo_snapshot_prefix_t));
+            } ITERATE_LIST_END;
+        }
+    } ITERATE_LIST_END;
+
+    assert((uint64_t)get_serialize_buffer_size(b) == hdr.file_size);
+
+    fp = fopen(file_name, "wb");
+    if(!fp){
+        printf("Error : Could not open %s, error no = %d\n", file_name, errno);
+        goto done;
+    }
+
+    if(fwrite(b->b, 1, get_serialize_buffer_size(b), fp) != (size_t)get_serialize_buffer_size(b)){
+        printf("Error : Could not write %s, error no = %d\n", file_name, errno);
+        fclose(fp);
+        goto done;
+    }
+
+    if(fclose(fp) == 0){
+        printf("Info : Snapshot %s : %u nodes, %u L1 adjacencies, %u L2 adjacencies, %u prefixes, %llu bytes\n",
+                file_name, n_nodes, hdr.n_adjs[LEVEL1], hdr.n_adjs[LEVEL2], hdr.n_prefixes,
+                (unsigned long long)hdr.file_size);
+        rc = 0;
+    }
+done:
+    free_serialize_buffer(b);
+    free(node_snapshot_index);
+    return rc;
+}
+
+/*Reader*/
+
+static int
+topo_snapshot_validate(topo_snapshot_t *snapshot){
+
+    topo_snapshot_hdr_t *hdr = snapshot->hdr;
+    LEVEL level_it;
+    uint32_t i = 0;
+
+#define SNAPSHOT_SECTION_FITS(_offset, _count, _size)   \
+    ((_offset) <= snapshot->size &&                     \
+     (uint64_t)(_count) * (_size) <= snapshot->size - (_offset))
+
+    if(snapshot->size < sizeof(topo_snapshot_hdr_t) ||
+            hdr->magic != TOPO_SNAPSHOT_MAGIC){
+        printf("Error : %s is not a topology snapshot\n", snapshot->file_name);
+        return -1;
+    }
+
+    if(hdr->version != TOPO_SNAPSHOT_VERSION ||
+            hdr->hdr_size != sizeof(topo_snapshot_hdr_t) ||
+            hdr->node_size != sizeof(topo_snapshot_node_t) ||
+            hdr->adj_size != sizeof(topo_snapshot_adj_t) ||
+            hdr->prefix_size != sizeof(topo_snapshot_prefix_t)){
+        printf("Error : %s : snapshot version or record layout mismatch\n", snapshot->file_name);
+        return -1;
+    }
+
+    if(hdr->file_size != snapshot->size || !hdr->n_nodes || hdr->root >= hdr->n_nodes ||
+            !SNAPSHOT_SECTION_FITS(hdr->nodes_offset, hdr->n_nodes, sizeof(topo_snapshot_node_t)) ||
+            !SNAPSHOT_SECTION_FITS(hdr->prefix_offset_offset, hdr->n_nodes + 1, sizeof(uint32_t)) ||
+            !SNAPSHOT_SECTION_FITS(hdr->prefixes_offset, hdr->n_prefixes, sizeof(topo_snapshot_prefix_t))){
+        printf("Error : %s : snapshot is truncated or corrupt\n", snapshot->file_name);
+        return -1;
+    }
+
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+        if(!SNAPSHOT_SECTION_FITS(hdr->adj_offset_offset[level_it], hdr->n_nodes + 1, sizeof(uint32_t)) ||
+                !SNAPSHOT_SECTION_FITS(hdr->adjs_offset[level_it], hdr->n_adjs[level_it], sizeof(topo_snapshot_adj_t))){
+            printf("Error : %s : snapshot is truncated or corrupt\n", snapshot->file_name);
+            return -1;
+        }
+    }
+#undef SNAPSHOT_SECTION_FITS
+
+    snapshot->nodes = (topo_snapshot_node_t *)((char *)snapshot->base + hdr->nodes_offset);
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+        snapshot->adj_offset[level_it] = (uint32_t *)((char *)snapshot->base + hdr->adj_offset_offset[level_it]);
+        snapshot->adjs[level_it] = (topo_snapshot_adj_t *)((char *)snapshot->base + hdr->adjs_offset[level_it]);
+    }
+    snapshot->prefix_offset = (uint32_t *)((char *)snapshot->base + hdr->prefix_offset_offset);
+    snapshot->prefixes = (topo_snapshot_prefix_t *)((char *)snapshot->base + hdr->prefixes_offset);
+
+    /*SPF indexes the mapped arrays with these, check them once here*/
+    for(level_it = LEVEL1; level_it < MAX_LEVEL; level_it++){
+        if(snapshot->adj_offset[level_it][hdr->n_nodes] != hdr->n_adjs[level_it])
+            goto corrupt;
+        for(i = 0; i < hdr->n_nodes; i++){
+            if(snapshot->adj_offset[level_it][i] > snapshot->adj_offset[level_it][i + 1])
+                goto corrupt;
+        }
+        for(i = 0; i < hdr->n_adjs[level_it]; i++){
+            if(snapshot->adjs[level_it][i].nbr >= hdr->n_nodes)
+                goto corrupt;
+        }
+    }
+    if(snapshot->prefix_offset[hdr->n_nodes] != hdr->n_prefixes)
+        goto corrupt;
+    for(i = 0; i < hdr->n_nodes; i++){
+        if(snapshot->prefix_offset[i] > snapshot->prefix_offset[i + 1])
+            goto corrupt;
+    }
+
+    /*Names are printed and compared as C strings straight from the mapping*/
+    for(i = 0; i < hdr->n_nodes; i++){
+        if(!memchr(snapshot->nodes[i].node_name, '\0', NODE_NAME_SIZE) ||
+                !memchr(snapshot->nodes[i].router_id, '\0', PREFIX_LEN + 1))
+            goto corrupt;
+    }
+    for(i = 0; i < hdr->n_prefixes; i++){
+        if(!memchr(snapshot->prefixes[i].prefix, '\0', PREFIX_LEN + 1))
+            goto corrupt;
+    }
+    return 0;
+
+corrupt:
+    printf("Error : %s : snapshot is corrupt\n", snapshot->file_name);
+    return -1;
+}
+
+topo_snapshot_t *
+topo_snapshot_map(char *file_name){
+
+    int fd = -1;
+    struct stat st;
+    topo_snapshot_t *snapshot = NULL;
+
+    fd = open(file_name, O_RDONLY);
+    if(fd < 0){
+        printf("Error : Could not open %s, error no = %d\n", file_name, errno);
+        return NULL;
+    }
+
+    if(fstat(fd, &st) < 0 || st.st_size <= 0){
+        printf("Error : Could not stat %s, error no = %d\n", file_name, errno);
+        close(fd);
+        return NULL;
+    }
+
+    snapshot = calloc(1, sizeof(topo_snapshot_t));
+    strncpy(snapshot->file_name, file_name, sizeof(snapshot->file_name) - 1);
+    snapshot->size = (size_t)st.st_size;
+    snapshot->base = mmap(NULL, snapshot->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    /*The mapping stays valid after the descriptor is closed*/
+    close(fd);
+
+    if(snapshot->base == MAP_FAILED){
+        printf("Error : Could not mmap %s, error no = %d\n", file_name, errno);
+        free(snapshot);
+        return NULL;
+    }
+
+    snapshot->hdr = (topo_snapshot_hdr_t *)snapshot->base;
+    if(topo_snapshot_validate(snapshot) < 0){
+        topo_snapshot_unmap(snapshot);
+        return NULL;
+    }
+    return snapshot;
+}
+
+void
+topo_snapshot_unmap(topo_snapshot_t *snapshot){
+
+    if(!snapshot)
+        return;
+    munmap(snapshot->base, snapshot->size);
+    free(snapshot);
+}
+
+uint32_t
+topo_snapshot_node_lookup(topo_snapshot_t *snapshot, char *node_name){
+
+    uint32_t i = 0;
+
+    for(i = 0; i < snapshot->hdr->n_nodes; i++){
+        if(strncmp(snapshot->nodes[i].node_name, node_name, NODE_NAME_SIZE) == 0)
+            return i;
+    }
+    return snapshot->hdr->n_nodes;
+}
+
+/*SPF over the mapped arrays*/
+
+/* key is the distance shifted left by one, plus one for a router : at equal
+ * distance pseudonodes are popped first, so that the nexthops a pseudonode
+ * hands to its routers over zero metric edges are merged before the
+ * routers are settled*/
+typedef struct snapshot_spf_heap_entry_{
+
+    uint64_t key;
+    uint32_t node_index;
+} snapshot_spf_heap_entry_t;
+
+#define SNAPSHOT_SPF_HEAP_KEY(_dist, _is_pn)    \
+    (((uint64_t)(_dist) << 1) | ((_is_pn) ? 0 : 1))
+#define SNAPSHOT_SPF_HEAP_DIST(_key)    ((uint32_t)((_key) >> 1))
+
+static snapshot_spf_heap_entry_t *snapshot_spf_heap = NULL;
+static uint32_t snapshot_spf_heap_alloc = 0;
+
+static void
+snapshot_spf_heap_push(uint32_t *heap_size, uint64_t key, uint32_t node_index){
+
+    uint32_t i = *heap_size,
+             parent = 0;
+
+    if(*heap_size == snapshot_spf_heap_alloc){
+        snapshot_spf_heap_alloc = snapshot_spf_heap_alloc ? snapshot_spf_heap_alloc << 1 : 64;
+        snapshot_spf_heap = realloc(snapshot_spf_heap,
+                snapshot_spf_heap_alloc * sizeof(snapshot_spf_heap_entry_t));
+        assert(snapshot_spf_heap);
+    }
+
+    while(i){
+        parent = (i - 1) >> 1;
+        if(snapshot_spf_heap[parent].key <= key)
+            break;
+        snapshot_spf_heap[i] = snapshot_spf_heap[parent];
+        i = parent;
+    }
+    snapshot_spf_heap[i].key = key;
+    snapshot_spf_heap[i].node_index = node_index;
+    (*heap_size)++;
+}
+
+static snapshot_spf_heap_entry_t
+snapshot_spf_heap_pop(uint32_t *heap_size){
+
+    uint32_t i = 0, child = 0;
+    snapshot_spf_heap_entry_t top = snapshot_spf_heap[0],
+                              last = snapshot_spf_heap[--(*heap_size)];
+
+    while((child = (i << 1) + 1) < *heap_size){
+        if(child + 1 < *heap_size &&
+                snapshot_spf_heap[child + 1].key < snapshot_spf_heap[child].key)
+            child++;
+        if(last.key <= snapshot_spf_heap[child].key)
+            break;
+        snapshot_spf_heap[i] = snapshot_spf_heap[child];
+        i = child;
+    }
+    snapshot_spf_heap[i] = last;
+    return top;
+}
+
+static void
+snapshot_spf_union_nh(topo_snapshot_spf_result_t *dst,
+                      topo_snapshot_nh_t *nh, uint32_t n_nh){
+
+    uint32_t i = 0, j = 0;
+
+    for(i = 0; i < n_nh; i++){
+        for(j = 0; j < dst->n_nh; j++){
+            if(dst->nh[j].node == nh[i].node &&
+                    dst->nh[j].nh_type == nh[i].nh_type)
+                break;
+        }
+        if(j == dst->n_nh && dst->n_nh < MAX_NXT_HOPS)
+            dst->nh[dst->n_nh++] = nh[i];
+    }
+}
+
+/* Same nexthop rules as run_dijkastra() : nbrs of the root and of a
+ * pseudonode attached to the root are their own nexthops (a pseudonode
+ * is never a nexthop), any other nbr inherits the nexthops of the
+ * candidate. An overloaded node other than the root is not transited*/
+uint32_t
+topo_snapshot_spf(topo_snapshot_t *snapshot, uint32_t root, LEVEL level,
+                  topo_snapshot_spf_result_t *results,
+                  uint32_t *settle_order){
+
+    uint32_t i = 0,
+             heap_size = 0,
+             n_settled = 0,
+             n_nodes = snapshot->hdr->n_nodes,
+             *adj_offset = snapshot->adj_offset[level];
+    unsigned long long new_metric = 0;
+    unsigned char *settled = NULL;
+    topo_snapshot_adj_t *adj = NULL;
+    topo_snapshot_node_t *nodes = snapshot->nodes;
+    topo_snapshot_spf_result_t *cand_res = NULL,
+                               *nbr_res = NULL;
+    topo_snapshot_nh_t direct_nh,
+                       *nh = NULL;
+    snapshot_spf_heap_entry_t top;
+    uint32_t n_nh = 0;
+
+    assert(level == LEVEL1 || level == LEVEL2);
+    assert(root < n_nodes);
+
+    settled = calloc(n_nodes, sizeof(unsigned char));
+    for(i = 0; i < n_nodes; i++){
+        results[i].spf_metric = INFINITE_METRIC;
+        results[i].n_nh = 0;
+    }
+
+    results[root].spf_metric = 0;
+    snapshot_spf_heap_push(&heap_size,
+        SNAPSHOT_SPF_HEAP_KEY(0, nodes[root].node_type[level] == PSEUDONODE), root);
+
+    while(heap_size){
+
+        top = snapshot_spf_heap_pop(&heap_size);
+        if(settled[top.node_index] ||
+                SNAPSHOT_SPF_HEAP_DIST(top.key) != results[top.node_index].spf_metric)
+            continue;
+
+        settled[top.node_index] = 1;
+        cand_res = &results[top.node_index];
+        if(nodes[top.node_index].node_type[level] != PSEUDONODE){
+            if(settle_order)
+                settle_order[n_settled] = top.node_index;
+            n_settled++;
+        }
+
+        if(top.node_index != root && nodes[top.node_index].overloaded[level])
+            continue;
+
+        for(i = adj_offset[top.node_index]; i < adj_offset[top.node_index + 1]; i++){
+
+            adj = &snapshot->adjs[level][i];
+            nbr_res = &results[adj->nbr];
+            new_metric = (unsigned long long)cand_res->spf_metric + adj->metric;
+
+            if(settled[adj->nbr] || new_metric > nbr_res->spf_metric)
+                continue;
+
+            /*Nexthops the candidate hands over to the nbr*/
+            if(cand_res->n_nh){
+                nh = cand_res->nh;
+                n_nh = cand_res->n_nh;
+            }
+            else if(nodes[adj->nbr].node_type[level] != PSEUDONODE){
+                direct_nh.node = adj->nbr;
+                direct_nh.nh_type = adj->etype == LSP ? LSPNH : IPNH;
+                nh = &direct_nh;
+                n_nh = 1;
+            }
+            else{
+                nh = NULL;
+                n_nh = 0;
+            }
+
+            if(new_metric < nbr_res->spf_metric){
+                nbr_res->spf_metric = (uint32_t)new_metric;
+                nbr_res->n_nh = 0;
+                snapshot_spf_union_nh(nbr_res, nh, n_nh);
+                snapshot_spf_heap_push(&heap_size,
+                    SNAPSHOT_SPF_HEAP_KEY(nbr_res->spf_metric,
+                        nodes[adj->nbr].node_type[level] == PSEUDONODE), adj->nbr);
+            }
+            else{
+                /*ECMP*/
+                snapshot_spf_union_nh(nbr_res, nh, n_nh);
+            }
+        }
+    }
+
+    free(settled);
+    return n_settled;
+}
+
+/*CLI backends*/
+
+int
+topo_snapshot_load(char *file_name){
+
+    topo_snapshot_t *snapshot = topo_snapshot_map(file_name);
+
+    if(!snapshot)
+        return -1;
+
+    topo_snapshot_unmap(curr_topo_snapshot);
+    curr_topo_snapshot = snapshot;
+    printf("Info : Mapped snapshot %s : %u nodes, %llu bytes\n",
+            file_name, snapshot->hdr->n_nodes, (unsigned long long)snapshot->size);
+    return 0;
+}
+
+void
+topo_snapshot_show(topo_snapshot_t *snapshot){
+
+    if(!snapshot){
+        printf("No snapshot mapped\n");
+        return;
+    }
+
+    printf("Snapshot : %s\n", snapshot->file_name);
+    printf("\tversion        : %u\n", snapshot->hdr->version);
+    printf("\tsize           : %llu bytes\n", (unsigned long long)snapshot->size);
+    printf("\tnodes          : %u\n", snapshot->hdr->n_nodes);
+    printf("\troot           : %s\n", snapshot->nodes[snapshot->hdr->root].node_name);
+    printf("\tL1 adjacencies : %u\n", snapshot->hdr->n_adjs[LEVEL1]);
+    printf("\tL2 adjacencies : %u\n", snapshot->hdr->n_adjs[LEVEL2]);
+    printf("\tprefixes       : %u\n", snapshot->hdr->n_prefixes);
+}
+
+void
+topo_snapshot_show_spf(topo_snapshot_t *snapshot, char *root_name, LEVEL level){
+
+    uint32_t root = 0,
+             i = 0, j = 0,
+             n_settled = 0,
+             *settle_order = NULL;
+    topo_snapshot_spf_result_t *results = NULL,
+                               *res = NULL;
+    struct timespec start_time, end_time;
+
+    if(!snapshot){
+        printf("No snapshot mapped\n");
+        return;
+    }
+
+    root = root_name ? topo_snapshot_node_lookup(snapshot, root_name) :
+        snapshot->hdr->root;
+    if(root == snapshot->hdr->n_nodes){
+        printf("Error : Node %s not in snapshot\n", root_name);
+        return;
+    }
+
+    results = calloc(snapshot->hdr->n_nodes, sizeof(topo_snapshot_spf_result_t));
+    settle_order = calloc(snapshot->hdr->n_nodes, sizeof(uint32_t));
+
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+    n_settled = topo_snapshot_spf(snapshot, root, level, results, settle_order);
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+
+    printf("\nSnapshot SPF run results for LEVEL%u, ROOT = %s\n", level,
+            snapshot->nodes[root].node_name);
+
+    for(i = 0; i < n_settled; i++){
+        res = &results[settle_order[i]];
+        printf("DEST : %-10s spf_metric : %-6u", snapshot->nodes[settle_order[i]].node_name,
+                res->spf_metric);
+        printf(" Nxt Hop : ");
+        if(!res->n_nh)
+            printf("\n");
+        for(j = 0; j < res->n_nh; j++){
+            printf("%s%s|%s\n", j ? "                                              : " : "",
+                    snapshot->nodes[res->nh[j].node].node_name,
+                    res->nh[j].nh_type == LSPNH ? "LSPNH" : "IPNH");
+        }
+    }
+
+    printf("Info : %u nodes reached in %lu usec\n", n_settled,
+            (unsigned long)((end_time.tv_sec - start_time.tv_sec) * 1000000UL +
+            (end_time.tv_nsec - start_time.tv_nsec) / 1000));
+
+    free(results);
+    free(settle_order);
+}
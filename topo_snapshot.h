@@ -0,0 +1,172 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  topo_snapshot.h
+ *
+ *    Description:  Binary snapshot of an instance, memory mapped and used by SPF as is
+ *
+ *        Version:  1.0
+ *        Created:  Sunday 18 October 2026 18:40:18  UTC
+ *       Revision:  1.0
+ *       Compiler:  gcc
+ *
+ *         Author:  agent, agent@local
+ *
+ *        This file is part of the SPFComputation distribution (https://github.com/sachinites).
+ *        Copyright (c) 2026 agent.
+ *        This program is free software: you can redistribute it and/or modify
+ *        it under the terms of the GNU General Public License as published by
+ *        the Free Software Foundation, version 3.
+ *
+ *        This program is distributed in the hope that it will be useful, but
+ *        WITHOUT ANY WARRANTY; without even the implied warranty of
+ *        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ *        General Public License for more details.
+ *
+ *        You should have received a copy of the GNU General Public License
+ *        along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * =====================================================================================
+ */
+
+#ifndef __TOPO_SNAPSHOT__
+#define __TOPO_SNAPSHOT__
+
+#include <stdint.h>
+#include <stddef.h>
+#include "instance.h"
+
+/* Snapshot file layout, all sections are arrays of fixed size records in
+ * host byte order :
+ *
+ *  topo_snapshot_hdr_t
+ *  topo_snapshot_node_t    nodes[n_nodes]
+ *  per level (LEVEL1, LEVEL2) :
+ *      uint32_t            adj_offset[n_nodes + 1]
+ *      topo_snapshot_adj_t adjs[n_adjs[level]]
+ *  uint32_t                prefix_offset[n_nodes + 1]
+ *  topo_snapshot_prefix_t  prefixes[n_prefixes]
+ *
+ * Adjacencies of node i at a level are adjs[adj_offset[i] .. adj_offset[i + 1] - 1],
+ * prefixes are laid out the same way. Only adjacencies SPF would consider
+ * are written : outgoing, up, and with a two way nbrship.
+ * Record sizes are kept in the header, a snapshot is only mapped by
+ * a build with the same record layout*/
+
+#define TOPO_SNAPSHOT_MAGIC     0x53465053  /*"SPFS"*/
+#define TOPO_SNAPSHOT_VERSION   1
+#define TOPO_SNAPSHOT_NO_SID    0xFFFFFFFF
+
+typedef struct topo_snapshot_hdr_{
+
+    uint32_t magic;
+    uint32_t version;
+    uint32_t hdr_size;
+    uint32_t node_size;
+    uint32_t adj_size;
+    uint32_t prefix_size;
+    uint32_t n_nodes;
+    uint32_t root;                      /*node index of instance root*/
+    uint32_t n_adjs[MAX_LEVEL];
+    uint32_t n_prefixes;
+    uint64_t file_size;
+    uint64_t nodes_offset;
+    uint64_t adj_offset_offset[MAX_LEVEL];
+    uint64_t adjs_offset[MAX_LEVEL];
+    uint64_t prefix_offset_offset;
+    uint64_t prefixes_offset;
+} topo_snapshot_hdr_t;
+
+typedef struct topo_snapshot_node_{
+
+    char node_name[NODE_NAME_SIZE];
+    char router_id[PREFIX_LEN + 1];
+    uint8_t node_type[MAX_LEVEL];       /*NON_PSEUDONODE | PSEUDONODE*/
+    uint8_t overloaded[MAX_LEVEL];
+    uint8_t spring_enabled;
+    uint8_t area;
+    uint32_t srgb_first_label;
+    uint32_t srgb_range;
+} topo_snapshot_node_t;
+
+typedef struct topo_snapshot_adj_{
+
+    uint32_t nbr;                       /*node index of the nbr*/
+    uint32_t metric;
+    uint32_t etype;                     /*UNICAST | LSP*/
+} topo_snapshot_adj_t;
+
+typedef struct topo_snapshot_prefix_{
+
+    char prefix[PREFIX_LEN + 1];
+    uint8_t mask;
+    uint8_t level;
+    uint8_t reserved[2];
+    uint32_t metric;
+    uint32_t sid;                       /*prefix SID index, TOPO_SNAPSHOT_NO_SID if none*/
+} topo_snapshot_prefix_t;
+
+/*A mapped snapshot, section pointers point into the mapping*/
+typedef struct topo_snapshot_{
+
+    char file_name[256];
+    void *base;
+    size_t size;
+    topo_snapshot_hdr_t *hdr;
+    topo_snapshot_node_t *nodes;
+    uint32_t *adj_offset[MAX_LEVEL];
+    topo_snapshot_adj_t *adjs[MAX_LEVEL];
+    uint32_t *prefix_offset;
+    topo_snapshot_prefix_t *prefixes;
+} topo_snapshot_t;
+
+/*Result of a SPF run over a snapshot, one entry per node index*/
+typedef struct topo_snapshot_nh_{
+
+    uint32_t node;                      /*node index of the nexthop router*/
+    uint32_t nh_type;                   /*IPNH | LSPNH*/
+} topo_snapshot_nh_t;
+
+typedef struct topo_snapshot_spf_result_{
+
+    uint32_t spf_metric;                /*INFINITE_METRIC if not reached*/
+    uint32_t n_nh;
+    topo_snapshot_nh_t nh[MAX_NXT_HOPS];
+} topo_snapshot_spf_result_t;
+
+/*Write the snapshot of the instance, return 0 on success*/
+int
+topo_snapshot_write(instance_t *instance, char *file_name);
+
+/*Map the snapshot file read only, NULL on error*/
+topo_snapshot_t *
+topo_snapshot_map(char *file_name);
+
+void
+topo_snapshot_unmap(topo_snapshot_t *snapshot);
+
+/*Node index of the node, or n_nodes if absent*/
+uint32_t
+topo_snapshot_node_lookup(topo_snapshot_t *snapshot, char *node_name);
+
+/*Run SPF at level over the mapped arrays from the root node index. results
+ * must have n_nodes entries, settle_order (optional) receives the node
+ * indices in the order they are settled. Returns the no of nodes settled*/
+uint32_t
+topo_snapshot_spf(topo_snapshot_t *snapshot, uint32_t root, LEVEL level,
+                  topo_snapshot_spf_result_t *results,
+                  uint32_t *settle_order);
+
+/*Snapshot mapped by "config snapshot load" or "rpd -s"*/
+extern topo_snapshot_t *curr_topo_snapshot;
+
+int
+topo_snapshot_load(char *file_name);
+
+void
+topo_snapshot_show(topo_snapshot_t *snapshot);
+
+void
+topo_snapshot_show_spf(topo_snapshot_t *snapshot, char *root_name, LEVEL level);
+
+#endif /* __TOPO_SNAPSHOT__ */